@@ -26,12 +26,14 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
 
         check_table_exist(query->tables);
 
-        // 检查是否有SEMI JOIN
+        // 检查是否有SEMI JOIN或ANTI JOIN，二者都只输出左表的列
         bool has_semi_join = false;
         std::string left_table_name;
+        std::string join_type_name;
         for (const auto& join_expr : x->jointree) {
-            if (join_expr->type == SEMI_JOIN) {
+            if (join_expr->type == SEMI_JOIN || join_expr->type == ANTI_JOIN) {
                 has_semi_join = true;
+                join_type_name = join_expr->type == SEMI_JOIN ? "Semi Join" : "Anti Join";
                 left_table_name = join_expr->left;
                 break;
             }
@@ -66,7 +68,7 @@ std::shared_ptr<Query> Analyze::do_analyze(std::shared_ptr<ast::TreeNode> parse)
                 if (!(ast_col->isAgg && ast_col->aggType == ast::AggFuncType::COUNT_ALL)) {
                     if (has_semi_join) {
                         if (!sel_col.tab_name.empty() && sel_col.tab_name != left_table_name) {
-                            throw RMDBError("Semi Join can only select columns from left table: " + left_table_name);
+                            throw RMDBError(join_type_name + " can only select columns from left table: " + left_table_name);
                         }
                     }
                     sel_col = check_column(all_cols, sel_col); // 列元数据校验
@@ -283,7 +285,6 @@ void Analyze::check_clause(const std::vector<std::string> &tab_names, std::vecto
         ColType lhs_type = lhs_col->type;
         ColType rhs_type;
         if (cond.is_rhs_val) {
-            cond.rhs_val.init_raw(lhs_col->len);
             rhs_type = cond.rhs_val.type;
         } else {
             TabMeta &rhs_tab = sm_manager_->db_.get_table(cond.rhs_col.tab_name);
@@ -315,7 +316,10 @@ void Analyze::check_clause(const std::vector<std::string> &tab_names, std::vecto
                 throw IncompatibleTypeError(coltype2str(lhs_type), coltype2str(rhs_type));
             }
         }
-        //
+        // 常量按转换后的类型编码，供执行器直接与字段比较
+        if (cond.is_rhs_val) {
+            cond.rhs_val.init_raw(lhs_col->len);
+        }
 
     }
 
@@ -16,6 +16,7 @@ See the Mulan PSL v2 for more details. */
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 
 #include "parser/parser.h"
 #include "system/sm.h"
@@ -37,6 +38,10 @@ class Query{
     std::vector<SetClause> set_clauses;
     //insert 的values值
     std::vector<Value> values;
+    // 投影下推：每个表的扫描需要输出的列名，没有记录的表输出所有列
+    std::map<std::string, std::set<std::string>> scan_cols;
+    // 每个表中只在select列表中出现的列名，多表连接时可以延迟到最终投影再按Rid回表读取
+    std::map<std::string, std::set<std::string>> late_cols;
 
     Query(){}
 
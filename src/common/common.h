@@ -19,7 +19,9 @@ See the Mulan PSL v2 for more details. */
 #include <unordered_set>
 #include <mutex>
 #include <atomic>
+#include <functional>
 #include <optional>
+#include <queue>
 #include "defs.h"
 #include "record/rm_defs.h"
 #include "transaction/txn_defs.h"
@@ -381,6 +383,14 @@ class MVCCManager
 {
 private:
     std::unordered_map<int64_t, std::shared_ptr<VersionChain>> version_chains_; 
+    // 可见性映射：每个堆页面上存在版本链的记录数，为0即页面all visible。
+    // 版本链创建时加一；整条链回滚、链头写回堆上后清理（purge_version_chains）或表被删除时减一
+    std::unordered_map<int64_t, int> page_chain_cnt_;
+    // 每个事务写过的版本链，提交和回滚时只处理这些链
+    std::unordered_map<txn_id_t, std::unordered_set<int64_t>> txn_chains_;
+    // 等待清理的版本链：(链头的提交时间戳, version_key)，提交时加入，按提交时间戳从小到大取出
+    std::priority_queue<std::pair<timestamp_t, int64_t>, std::vector<std::pair<timestamp_t, int64_t>>, std::greater<>>
+        purge_queue_;
     std::mutex manager_latch_;
     std::atomic<timestamp_t> last_committed_ts_{0}; 
     std::atomic<timestamp_t> next_ts_{1};          
@@ -425,6 +435,16 @@ public:
     void rollback_transaction(txn_id_t txn_id);                          
     std::vector<std::pair<Rid, int>> get_inserted_rids(txn_id_t txn_id); 
     void cleanup_version_chains(timestamp_t current_ts); 
+
+    /**
+     * @brief 清理提交时间戳不大于watermark（活跃事务最小的读时间戳）的版本链，只检查purge_queue_中到期的项。
+     * 链头已提交时所有活跃事务和之后开始的事务读到的都是链头版本：先不持有manager_latch_调用apply(fd, 链头)
+     * 把它写回堆上，再删除链头没有变化的版本链
+     */
+    void purge_version_chains(timestamp_t watermark, const std::function<void(int fd, const UndoLog &head)> &apply);
+
+    // 表被删除或关闭时丢弃文件fd上的所有版本链，文件描述符之后可能被其他表复用
+    void discard_version_chains(int fd);
    //活跃事务集合中remove事务
     void remove_active_txn(txn_id_t txn_id);
     bool is_txn_active(txn_id_t txn_id);
@@ -432,6 +452,9 @@ public:
 
     std::unordered_set<txn_id_t> get_active_txns(); 
     std::shared_ptr<VersionChain> get_version_chain(const Rid &rid, int fd); 
+
+    // 页面上没有任何记录挂着版本链时，堆上的基础记录即为所有事务可见的版本，index-only scan可跳过回表
+    bool is_page_all_visible(int fd, int page_no);
                
 
 private:
@@ -443,6 +466,16 @@ private:
                (static_cast<int64_t>(rid.page_no) << 16) |
                static_cast<int64_t>(rid.slot_no);
     }
+
+    int64_t page_to_key(int fd, int page_no)
+    {
+        return (static_cast<int64_t>(fd) << 32) | static_cast<int64_t>(static_cast<uint32_t>(page_no));
+    }
+
+    // 需持有manager_latch_
+    void create_version_chain(int64_t version_key, const Rid &rid, int fd);
+    // 需持有manager_latch_，版本链删除后减少所在页面的计数，页面上没有其他版本链时恢复all visible
+    void release_page_chain(int64_t version_key);
 };
 
 
@@ -450,8 +483,6 @@ private:
 auto ReconstructTuple(const TabMeta *schema, const RmRecord &base_tuple, const TupleMeta &base_meta,
                       const std::vector<UndoLog> &undo_logs) -> std::optional<RmRecord>;
 
-//计算值
-Value evaluate_expr(const ExprNode *expr, const RmRecord *record, const std::vector<ColMeta> &cols);
 //检测是写写冲突
 auto IsWriteWriteConflict(timestamp_t tuple_ts, Transaction *txn) -> bool;
 
@@ -132,6 +132,12 @@ public:
     }
 };
 
+class IndexFormatError : public RMDBError {
+public:
+    IndexFormatError(int version)
+        : RMDBError("Index file format version " + std::to_string(version) + " is not supported") {}
+};
+
 // QL errors
 class InvalidValueCountError : public RMDBError {
 public:
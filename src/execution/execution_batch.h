@@ -0,0 +1,277 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/common.h"
+#include "execution_simd.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @brief 列式存储的一批元组，供NextBatch接口使用
+ * 每个字段一个定长的列向量，第row行的值位于column(i) + row * cols()[i].len。
+ * 选择向量记录批中仍然有效的行（按行号递增），没有选择向量时所有行都有效；
+ * cols()中的offset仍是行式元组中的偏移，用于与RmRecord互相转换
+ */
+class RecordBatch {
+   public:
+    static constexpr size_t CAPACITY = 1024;    // 每批最多容纳的行数
+
+    explicit RecordBatch(const std::vector<ColMeta> &cols, bool allocate = true) : cols_(cols), columns_(cols.size()) {
+        if (!allocate) return;
+        for (size_t i = 0; i < cols_.size(); i++) {
+            columns_[i].resize(CAPACITY * cols_[i].len);
+        }
+    }
+
+    const std::vector<ColMeta> &cols() const { return cols_; }
+
+    size_t size() const { return size_; }
+
+    void set_size(size_t size) { size_ = size; }
+
+    bool full() const { return size_ == CAPACITY; }
+
+    char *column(size_t i) { return columns_[i].data(); }
+
+    const char *column(size_t i) const { return columns_[i].data(); }
+
+    const char *value(size_t col, size_t row) const { return columns_[col].data() + row * cols_[col].len; }
+
+    // 直接访问列向量，用于在批之间转移整列
+    std::vector<char> &column_buffer(size_t i) { return columns_[i]; }
+
+    bool has_selection() const { return has_sel_; }
+
+    // 有效行数
+    size_t num_selected() const { return has_sel_ ? sel_.size() : size_; }
+
+    // 第i个有效行的行号
+    size_t selected(size_t i) const { return has_sel_ ? sel_[i] : i; }
+
+    const std::vector<uint16_t> &selection() const { return sel_; }
+
+    void set_selection(std::vector<uint16_t> sel) {
+        sel_ = std::move(sel);
+        has_sel_ = true;
+    }
+
+    // 把行式元组拆到各个列向量的末尾
+    void append_row(const char *tuple) {
+        for (size_t i = 0; i < cols_.size(); i++) {
+            int len = cols_[i].len;
+            memcpy(columns_[i].data() + size_ * len, tuple + cols_[i].offset, len);
+        }
+        size_++;
+    }
+
+    // 把第row行拼成行式元组
+    void gather_row(size_t row, char *tuple) const {
+        for (size_t i = 0; i < cols_.size(); i++) {
+            int len = cols_[i].len;
+            memcpy(tuple + cols_[i].offset, columns_[i].data() + row * len, len);
+        }
+    }
+
+    void clear() {
+        size_ = 0;
+        sel_.clear();
+        has_sel_ = false;
+    }
+
+   private:
+    std::vector<ColMeta> cols_;
+    std::vector<std::vector<char>> columns_;
+    size_t size_ = 0;
+    std::vector<uint16_t> sel_;
+    bool has_sel_ = false;
+};
+
+// 预先解析好的单表过滤条件：左侧是批中的一列，右侧是常量或批中的另一列
+struct BatchPredicate {
+    size_t lhs_idx;
+    bool rhs_is_val;
+    size_t rhs_idx;
+    const char *rhs_val;                // 常量，指向条件中Value的raw数据
+    ColType lhs_type;
+    ColType rhs_type;
+    int len;                            // 左侧字段的长度，也是比较的长度
+    int rhs_len;                        // 右侧字段的长度（列向量中每行的步长）
+    CompOp op;
+};
+
+/**
+ * @brief 把条件解析为批中的列下标
+ * @param cond_owner 条件的所有者，rhs_val指向其中的数据，生命周期需要覆盖所有过滤
+ */
+inline std::vector<BatchPredicate> make_batch_predicates(const std::vector<ColMeta> &cols,
+                                                         const std::vector<Condition> &cond_owner) {
+    auto find = [&](const TabCol &target) {
+        for (size_t i = 0; i < cols.size(); i++) {
+            if ((target.tab_name.empty() || cols[i].tab_name == target.tab_name) && cols[i].name == target.col_name) {
+                return i;
+            }
+        }
+        throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+    };
+    std::vector<BatchPredicate> preds;
+    for (auto &cond : cond_owner) {
+        BatchPredicate pred{};
+        pred.lhs_idx = find(cond.lhs_col);
+        pred.lhs_type = cols[pred.lhs_idx].type;
+        pred.len = cols[pred.lhs_idx].len;
+        pred.rhs_is_val = cond.is_rhs_val;
+        if (cond.is_rhs_val) {
+            pred.rhs_val = cond.rhs_val.raw->data;
+            pred.rhs_type = cond.rhs_val.type;
+        } else {
+            pred.rhs_idx = find(cond.rhs_col);
+            pred.rhs_type = cols[pred.rhs_idx].type;
+            pred.rhs_len = cols[pred.rhs_idx].len;
+        }
+        pred.op = cond.op;
+        preds.push_back(pred);
+    }
+    return preds;
+}
+
+template <typename Cmp>
+inline void filter_batch_loop(const RecordBatch &batch, std::vector<uint16_t> *out, Cmp match) {
+    size_t n = batch.num_selected();
+    if (!batch.has_selection()) {
+        for (size_t row = 0; row < n; row++) {
+            if (match(row)) out->push_back(static_cast<uint16_t>(row));
+        }
+        return;
+    }
+    for (auto row : batch.selection()) {
+        if (match(row)) out->push_back(row);
+    }
+}
+
+template <typename T>
+inline bool compare_op(T a, T b, CompOp op) {
+    switch (op) {
+        case OP_EQ: return a == b;
+        case OP_NE: return a != b;
+        case OP_LT: return a < b;
+        case OP_GT: return a > b;
+        case OP_LE: return a <= b;
+        case OP_GE: return a >= b;
+        default: throw InternalError("compare_op: unsupported operator");
+    }
+}
+
+// 数值列与常量比较的紧凑循环，按运算符展开，避免逐行分支
+template <typename T>
+inline void filter_numeric_val(const RecordBatch &batch, const BatchPredicate &pred, std::vector<uint16_t> *out) {
+    const T *col = reinterpret_cast<const T *>(batch.column(pred.lhs_idx));
+    T val;
+    memcpy(&val, pred.rhs_val, sizeof(T));
+    switch (pred.op) {
+        case OP_EQ: filter_batch_loop(batch, out, [&](size_t r) { return col[r] == val; }); break;
+        case OP_NE: filter_batch_loop(batch, out, [&](size_t r) { return col[r] != val; }); break;
+        case OP_LT: filter_batch_loop(batch, out, [&](size_t r) { return col[r] < val; }); break;
+        case OP_GT: filter_batch_loop(batch, out, [&](size_t r) { return col[r] > val; }); break;
+        case OP_LE: filter_batch_loop(batch, out, [&](size_t r) { return col[r] <= val; }); break;
+        case OP_GE: filter_batch_loop(batch, out, [&](size_t r) { return col[r] >= val; }); break;
+        default: throw InternalError("filter_batch: unsupported operator");
+    }
+}
+
+// 能否用simd过滤内核求值：列与同类型常量比较，整数和浮点数支持所有运算符，定长字符串只支持等于和不等于
+inline bool is_simd_predicate(const BatchPredicate &pred) {
+    if (!pred.rhs_is_val || pred.lhs_type != pred.rhs_type) return false;
+    if (pred.lhs_type == TYPE_INT || pred.lhs_type == TYPE_FLOAT) return true;
+    return pred.lhs_type == TYPE_STRING && (pred.op == OP_EQ || pred.op == OP_NE);
+}
+
+/**
+ * @brief 用simd过滤内核在整批上求值，要求批没有选择向量且所有条件满足is_simd_predicate
+ * 每个条件在整列上生成位图，按位与之后一次转换为选择向量。已经不满足前面条件的行也参与比较，
+ * 换来没有逐行分支的循环，扫描的速度取决于内存带宽
+ */
+inline void filter_batch_simd(RecordBatch *batch, const std::vector<BatchPredicate> &preds) {
+    constexpr size_t WORDS = RecordBatch::CAPACITY / 64;
+    const simd::FilterKernels &kernels = simd::kernels();
+    size_t n = batch->size();
+    size_t num_words = (n + 63) / 64;
+    uint64_t bits[WORDS];
+    uint64_t pred_bits[WORDS];
+    for (size_t i = 0; i < preds.size(); i++) {
+        auto &pred = preds[i];
+        uint64_t *out = i == 0 ? bits : pred_bits;
+        const char *col = batch->column(pred.lhs_idx);
+        if (pred.lhs_type == TYPE_INT) {
+            int val;
+            memcpy(&val, pred.rhs_val, sizeof(int));
+            kernels.filter_int(reinterpret_cast<const int *>(col), n, val, pred.op, out);
+        } else if (pred.lhs_type == TYPE_FLOAT) {
+            float val;
+            memcpy(&val, pred.rhs_val, sizeof(float));
+            kernels.filter_float(reinterpret_cast<const float *>(col), n, val, pred.op, out);
+        } else {
+            kernels.filter_string(col, n, pred.len, pred.rhs_val, pred.op, out);
+        }
+        if (i > 0) {
+            for (size_t w = 0; w < num_words; w++) bits[w] &= pred_bits[w];
+        }
+    }
+    std::vector<uint16_t> sel;
+    sel.reserve(n);
+    for (size_t w = 0; w < num_words; w++) {
+        for (uint64_t word = bits[w]; word != 0; word &= word - 1) {
+            sel.push_back(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+        }
+    }
+    batch->set_selection(std::move(sel));
+}
+
+/**
+ * @brief 在批上依次应用过滤条件，结果写入选择向量
+ * 批没有选择向量且所有条件都是列与常量的比较时使用simd过滤内核；否则逐个条件处理，
+ * 整数和浮点数与常量的比较走按类型展开的循环，其余情况逐行调用ix_compare；
+ * 两侧类型不同时与SeqScanExecutor一样抛出IncompatibleTypeError
+ */
+inline void filter_batch(RecordBatch *batch, const std::vector<BatchPredicate> &preds) {
+    if (batch->size() == 0) return;
+    if (!preds.empty() && !batch->has_selection() && std::all_of(preds.begin(), preds.end(), is_simd_predicate)) {
+        filter_batch_simd(batch, preds);
+        return;
+    }
+    for (auto &pred : preds) {
+        if (batch->num_selected() == 0) return;
+        if (pred.lhs_type != pred.rhs_type) {
+            throw IncompatibleTypeError(coltype2str(pred.lhs_type), coltype2str(pred.rhs_type));
+        }
+        std::vector<uint16_t> out;
+        out.reserve(batch->num_selected());
+        if (pred.rhs_is_val && pred.lhs_type == TYPE_INT) {
+            filter_numeric_val<int>(*batch, pred, &out);
+        } else if (pred.rhs_is_val && pred.lhs_type == TYPE_FLOAT) {
+            filter_numeric_val<float>(*batch, pred, &out);
+        } else {
+            const char *lhs = batch->column(pred.lhs_idx);
+            const char *rhs = pred.rhs_is_val ? pred.rhs_val : batch->column(pred.rhs_idx);
+            size_t rhs_step = pred.rhs_is_val ? 0 : pred.rhs_len;
+            filter_batch_loop(*batch, &out, [&](size_t r) {
+                int cmp = ix_compare(lhs + r * pred.len, rhs + r * rhs_step, pred.lhs_type, pred.len);
+                return compare_op(cmp, 0, pred.op);
+            });
+        }
+        batch->set_selection(std::move(out));
+    }
+}
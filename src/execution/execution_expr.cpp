@@ -0,0 +1,195 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "execution_expr.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+bool is_numeric(ColType type) { return type == TYPE_INT || type == TYPE_FLOAT; }
+
+template <typename T>
+T apply_arith(ExprOp op, T a, T b) {
+    switch (op) {
+        case EXPR_ADD: return a + b;
+        case EXPR_SUB: return a - b;
+        case EXPR_MUL: return a * b;
+        case EXPR_DIV:
+            if (b == 0) throw RMDBError("Arithmetic: division by zero");
+            if constexpr (std::is_integral_v<T>) {
+                if (a == INT_MIN && b == -1) throw RMDBError("Arithmetic: integer overflow");
+            }
+            return a / b;
+        default: throw InternalError("Unsupported arithmetic operator");
+    }
+}
+
+}  // namespace
+
+ExprProgram::ExprProgram(const ExprNode *expr, const std::vector<ColMeta> &cols, const ColMeta &target)
+    : target_len_(target.len) {
+    Operand result = compile(expr, cols, 0);
+    bool convertible = result.type == target.type || (target.type == TYPE_FLOAT && result.type == TYPE_INT);
+    if (!convertible) {
+        throw IncompatibleTypeError(coltype2str(target.type), coltype2str(result.type));
+    }
+    if (result.is_const) {
+        // 整个表达式是常量，编码一次，求值时直接复制
+        Value val = result.str_val;
+        val.raw = nullptr;
+        if (target.type == TYPE_INT) {
+            val.set_int(result.val.i);
+        } else if (target.type == TYPE_FLOAT) {
+            val.set_float(result.type == TYPE_INT ? static_cast<float>(result.val.i) : result.val.f);
+        }
+        val.init_raw(target.len);
+        consts_.assign(val.raw->data, val.raw->data + target.len);
+        instrs_.push_back(Instr{COPY_CONST, 0, 0, 0, 0, target.len, {0}});
+        return;
+    }
+    switch (target.type) {
+        case TYPE_INT:
+            emit(STORE_INT, 0, 0);
+            break;
+        case TYPE_FLOAT:
+            materialize(result, 0, TYPE_FLOAT);
+            emit(STORE_FLOAT, 0, 0);
+            break;
+        case TYPE_STRING:
+            instrs_.push_back(Instr{COPY_STR, 0, 0, 0, result.col->offset, result.col->len, {0}});
+            break;
+        default:
+            throw InternalError("Unsupported data type for expression");
+    }
+}
+
+ExprProgram::Operand ExprProgram::compile(const ExprNode *expr, const std::vector<ColMeta> &cols, int reg) {
+    if (expr == nullptr) throw InternalError("Null expression node encountered");
+    if (reg >= MAX_REGS) throw InternalError("Expression is nested too deeply");
+    Operand result{};
+    switch (expr->op_) {
+        case EXPR_CONST: {
+            result.type = expr->val_.type;
+            result.is_const = true;
+            if (result.type == TYPE_INT) {
+                result.val.i = expr->val_.int_val;
+            } else if (result.type == TYPE_FLOAT) {
+                result.val.f = expr->val_.float_val;
+            } else {
+                result.str_val = expr->val_;
+            }
+            return result;
+        }
+        case EXPR_COL: {
+            auto col = std::find_if(cols.begin(), cols.end(),
+                                    [&](const ColMeta &c) { return c.name == expr->col_.col_name; });
+            if (col == cols.end()) throw ColumnNotFoundError(expr->col_.col_name);
+            result.type = col->type;
+            result.col = &*col;
+            // 字符串字段只能直接赋值，到存储时再复制
+            if (col->type == TYPE_INT || col->type == TYPE_FLOAT) {
+                emit(col->type == TYPE_INT ? LOAD_INT : LOAD_FLOAT, reg);
+                instrs_.back().offset = col->offset;
+            }
+            return result;
+        }
+        case EXPR_ADD:
+        case EXPR_SUB:
+        case EXPR_MUL:
+        case EXPR_DIV: {
+            Operand lhs = compile(expr->left_.get(), cols, reg);
+            Operand rhs = compile(expr->right_.get(), cols, reg + 1);
+            if (!is_numeric(lhs.type) || !is_numeric(rhs.type)) {
+                throw IncompatibleTypeError(coltype2str(lhs.type), coltype2str(rhs.type));
+            }
+            result.type = lhs.type == TYPE_INT && rhs.type == TYPE_INT ? TYPE_INT : TYPE_FLOAT;
+            if (lhs.is_const && rhs.is_const) {
+                // 常量折叠
+                result.is_const = true;
+                if (result.type == TYPE_INT) {
+                    result.val.i = apply_arith(expr->op_, lhs.val.i, rhs.val.i);
+                } else {
+                    float a = lhs.type == TYPE_INT ? static_cast<float>(lhs.val.i) : lhs.val.f;
+                    float b = rhs.type == TYPE_INT ? static_cast<float>(rhs.val.i) : rhs.val.f;
+                    result.val.f = apply_arith(expr->op_, a, b);
+                }
+                return result;
+            }
+            // 右侧的指令只使用reg + 1及之后的寄存器，此时再把左侧的常量或类型转换写入reg不会被覆盖
+            materialize(lhs, reg, result.type);
+            materialize(rhs, reg + 1, result.type);
+            int base = result.type == TYPE_INT ? ADD_INT : ADD_FLOAT;
+            emit(static_cast<Opcode>(base + (expr->op_ - EXPR_ADD)), reg, reg, reg + 1);
+            return result;
+        }
+        default:
+            throw InternalError("Unsupported expression type");
+    }
+}
+
+void ExprProgram::materialize(const Operand &operand, int reg, ColType type) {
+    if (operand.is_const) {
+        if (type == TYPE_INT) {
+            emit(CONST_INT, reg);
+            instrs_.back().imm.i = operand.val.i;
+        } else {
+            emit(CONST_FLOAT, reg);
+            instrs_.back().imm.f = operand.type == TYPE_INT ? static_cast<float>(operand.val.i) : operand.val.f;
+        }
+    } else if (operand.type == TYPE_INT && type == TYPE_FLOAT) {
+        emit(INT_TO_FLOAT, reg, reg);
+    }
+}
+
+void ExprProgram::eval(const char *rec, char *out) const {
+    Reg regs[MAX_REGS];
+    for (auto &ins : instrs_) {
+        switch (ins.op) {
+            case LOAD_INT: memcpy(&regs[ins.dst].i, rec + ins.offset, sizeof(int)); break;
+            case LOAD_FLOAT: memcpy(&regs[ins.dst].f, rec + ins.offset, sizeof(float)); break;
+            case CONST_INT:
+            case CONST_FLOAT: regs[ins.dst] = ins.imm; break;
+            case INT_TO_FLOAT: regs[ins.dst].f = static_cast<float>(regs[ins.lhs].i); break;
+            case ADD_INT: regs[ins.dst].i = regs[ins.lhs].i + regs[ins.rhs].i; break;
+            case SUB_INT: regs[ins.dst].i = regs[ins.lhs].i - regs[ins.rhs].i; break;
+            case MUL_INT: regs[ins.dst].i = regs[ins.lhs].i * regs[ins.rhs].i; break;
+            case DIV_INT:
+                if (regs[ins.rhs].i == 0) throw RMDBError("Arithmetic: division by zero");
+                // INT_MIN / -1的结果无法表示，在x86上会触发SIGFPE
+                if (regs[ins.lhs].i == INT_MIN && regs[ins.rhs].i == -1) {
+                    throw RMDBError("Arithmetic: integer overflow");
+                }
+                regs[ins.dst].i = regs[ins.lhs].i / regs[ins.rhs].i;
+                break;
+            case ADD_FLOAT: regs[ins.dst].f = regs[ins.lhs].f + regs[ins.rhs].f; break;
+            case SUB_FLOAT: regs[ins.dst].f = regs[ins.lhs].f - regs[ins.rhs].f; break;
+            case MUL_FLOAT: regs[ins.dst].f = regs[ins.lhs].f * regs[ins.rhs].f; break;
+            case DIV_FLOAT:
+                if (regs[ins.rhs].f == 0.0f) throw RMDBError("Arithmetic: division by zero");
+                regs[ins.dst].f = regs[ins.lhs].f / regs[ins.rhs].f;
+                break;
+            case STORE_INT: memcpy(out, &regs[ins.lhs].i, sizeof(int)); break;
+            case STORE_FLOAT: memcpy(out, &regs[ins.lhs].f, sizeof(float)); break;
+            case COPY_STR: {
+                // 与字符串常量赋值一样，内容超过目标字段长度时报错，不足的部分补0
+                size_t len = strnlen(rec + ins.offset, ins.len);
+                if (len > static_cast<size_t>(target_len_)) throw StringOverflowError();
+                memmove(out, rec + ins.offset, len);
+                memset(out + len, 0, target_len_ - len);
+                break;
+            }
+            case COPY_CONST: memcpy(out, consts_.data(), ins.len); break;
+        }
+    }
+}
@@ -0,0 +1,98 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/common.h"
+
+/**
+ * @brief 编译为字节码的算术表达式，用于UPDATE SET中的表达式赋值
+ * 编译时把列按名字解析为元组中的偏移，确定每个子表达式的类型，常量子表达式直接折叠。
+ * 字节码是基于寄存器的：子表达式的结果放在按深度分配的寄存器中，求值时依次执行各条指令，
+ * 直接读取元组中的字段，结果按目标字段的类型和长度写出，不构造Value
+ */
+class ExprProgram {
+   public:
+    static constexpr int MAX_REGS = 64;     // 寄存器数，也限制了表达式的嵌套深度
+
+    ExprProgram() = default;
+
+    /**
+     * @brief 编译赋给target字段的表达式
+     * 整数与整数运算得到整数，其余数值运算按浮点数计算；整数结果可以赋给浮点数字段，
+     * 其他类型不一致的情况抛出IncompatibleTypeError。字符串只能直接赋值，不能参与运算
+     */
+    ExprProgram(const ExprNode *expr, const std::vector<ColMeta> &cols, const ColMeta &target);
+
+    /**
+     * @brief 在元组rec上求值，结果写入out（目标字段的位置，可以就在rec中）
+     * 除数为0或整数除法溢出（INT_MIN / -1）时抛出RMDBError
+     */
+    void eval(const char *rec, char *out) const;
+
+   private:
+    enum Opcode : uint8_t {
+        LOAD_INT,           // regs[dst] = rec[offset]
+        LOAD_FLOAT,
+        CONST_INT,          // regs[dst] = imm
+        CONST_FLOAT,
+        INT_TO_FLOAT,       // regs[dst] = (float)regs[lhs]
+        ADD_INT,            // regs[dst] = regs[lhs] op regs[rhs]
+        SUB_INT,
+        MUL_INT,
+        DIV_INT,
+        ADD_FLOAT,
+        SUB_FLOAT,
+        MUL_FLOAT,
+        DIV_FLOAT,
+        STORE_INT,          // out = regs[lhs]
+        STORE_FLOAT,
+        COPY_STR,           // out = rec[offset, offset + len)，按目标字段长度补0
+        COPY_CONST,         // out = consts_
+    };
+
+    union Reg {
+        int i;
+        float f;
+    };
+
+    struct Instr {
+        Opcode op;
+        uint8_t dst;
+        uint8_t lhs;
+        uint8_t rhs;
+        int offset;
+        int len;
+        Reg imm;
+    };
+
+    // 子表达式编译的结果：常量在编译时已经求出，其余的值在寄存器reg中
+    struct Operand {
+        ColType type;
+        bool is_const;
+        Reg val;
+        const ColMeta *col;                 // 表达式就是一个字段时指向该字段，用于字符串赋值
+        Value str_val;                      // 字符串常量
+    };
+
+    Operand compile(const ExprNode *expr, const std::vector<ColMeta> &cols, int reg);
+
+    // 把操作数放进寄存器reg，需要时转换为浮点数
+    void materialize(const Operand &operand, int reg, ColType type);
+
+    void emit(Opcode op, int dst, int lhs = 0, int rhs = 0) { instrs_.push_back(Instr{op, (uint8_t)dst, (uint8_t)lhs, (uint8_t)rhs, 0, 0, {0}}); }
+
+    std::vector<Instr> instrs_;
+    std::vector<char> consts_;          // 结果是常量时按目标字段编码好的值
+    int target_len_ = 0;
+};
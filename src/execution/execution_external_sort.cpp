@@ -0,0 +1,174 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "execution_external_sort.h"
+
+#include <algorithm>
+
+static constexpr size_t RUN_BLOCK_SIZE = 64 << 10;     // 归并时每个run的读缓冲区大小
+
+SortKeyEncoder::SortKeyEncoder(std::vector<ColMeta> key_cols, std::vector<bool> is_desc)
+    : key_cols_(std::move(key_cols)), is_desc_(std::move(is_desc)) {
+    is_desc_.resize(key_cols_.size(), false);
+    for (auto &col : key_cols_) len_ += col.len;
+}
+
+/**
+ * @brief 生成元组的规范化排序键
+ * 整数翻转符号位、浮点数按符号翻转符号位或全部位后按大端序存放，字符串（以0填充）原样存放；
+ * 降序的列把所有字节取反。浮点数的-0先规范为+0，与ix_compare中二者相等保持一致
+ */
+void SortKeyEncoder::encode(const char *tuple, char *key) const {
+    for (size_t i = 0; i < key_cols_.size(); i++) {
+        auto &col = key_cols_[i];
+        const char *data = tuple + col.offset;
+        auto *out = reinterpret_cast<unsigned char *>(key);
+        if (col.type == TYPE_INT || col.type == TYPE_FLOAT) {
+            uint32_t bits;
+            if (col.type == TYPE_INT) {
+                int32_t v;
+                memcpy(&v, data, sizeof(v));
+                bits = static_cast<uint32_t>(v) ^ 0x80000000u;
+            } else {
+                float v;
+                memcpy(&v, data, sizeof(v));
+                if (v == 0.0f) v = 0.0f;
+                memcpy(&bits, &v, sizeof(bits));
+                bits = (bits & 0x80000000u) ? ~bits : bits ^ 0x80000000u;
+            }
+            for (int b = 0; b < 4; b++) out[b] = static_cast<unsigned char>(bits >> (24 - 8 * b));
+        } else {
+            memcpy(out, data, col.len);
+        }
+        if (is_desc_[i]) {
+            for (int b = 0; b < col.len; b++) out[b] = static_cast<unsigned char>(~out[b]);
+        }
+        key += col.len;
+    }
+}
+
+ExternalSorter::ExternalSorter(size_t tuple_len, std::vector<ColMeta> key_cols, std::vector<bool> is_desc,
+                               size_t mem_budget)
+    : tuple_len_(tuple_len), key_(std::move(key_cols), std::move(is_desc)), mem_budget_(mem_budget) {
+    key_len_ = key_.len();
+    entry_len_ = key_len_ + tuple_len_;
+}
+
+ExternalSorter::~ExternalSorter() {
+    for (auto &run : runs_) {
+        if (run.file != nullptr) fclose(run.file);
+    }
+}
+
+void ExternalSorter::add(const char *tuple) {
+    size_t pos = arena_.size();
+    arena_.resize(pos + entry_len_);
+    key_.encode(tuple, arena_.data() + pos);
+    memcpy(arena_.data() + pos + key_len_, tuple, tuple_len_);
+    if (arena_.size() >= mem_budget_) spill();
+}
+
+void ExternalSorter::sort_arena() {
+    size_t n = arena_.size() / entry_len_;
+    sorted_.resize(n);
+    for (size_t i = 0; i < n; i++) sorted_[i] = arena_.data() + i * entry_len_;
+    std::sort(sorted_.begin(), sorted_.end(), [this](const char *a, const char *b) { return less(a, b); });
+}
+
+// 把内存中的元组排好序写入一个新的临时文件
+void ExternalSorter::spill() {
+    if (arena_.empty()) return;
+    sort_arena();
+    Run run;
+    run.file = tmpfile();
+    if (run.file == nullptr) throw UnixError();
+    for (auto entry : sorted_) {
+        if (fwrite(entry, entry_len_, 1, run.file) != 1) {
+            fclose(run.file);
+            throw UnixError();
+        }
+    }
+    run.num_tuples = sorted_.size();
+    runs_.push_back(std::move(run));
+    arena_.clear();
+    sorted_.clear();
+}
+
+// 读入run的下一块，run已经读完时返回false
+bool ExternalSorter::fill(Run &run) {
+    if (run.read == run.num_tuples) return false;
+    size_t count = std::min(std::max<size_t>(RUN_BLOCK_SIZE / entry_len_, 1), run.num_tuples - run.read);
+    run.buf.resize(count * entry_len_);
+    if (fread(run.buf.data(), entry_len_, count, run.file) != count) throw UnixError();
+    run.read += count;
+    run.buf_tuples = count;
+    run.pos = 0;
+    return true;
+}
+
+bool ExternalSorter::beats(size_t a, size_t b) const {
+    if (runs_[a].done) return false;
+    if (runs_[b].done) return true;
+    int cmp = key_.compare(run_entry(runs_[a]), run_entry(runs_[b]));
+    return cmp < 0 || (cmp == 0 && a < b);
+}
+
+// run_idx的当前项发生变化后，沿叶子到根的路径重新比赛，k个run的归并每输出一项只需要log k次比较
+void ExternalSorter::replay(size_t run_idx) {
+    size_t k = runs_.size();
+    size_t winner = run_idx;
+    for (size_t node = (run_idx + k) / 2; node > 0; node /= 2) {
+        if (beats(tree_[node], winner)) std::swap(tree_[node], winner);
+    }
+    tree_[0] = winner;
+}
+
+void ExternalSorter::finish() {
+    cur_ = nullptr;
+    if (runs_.empty()) {
+        sort_arena();
+        pos_ = 0;
+        if (!sorted_.empty()) cur_ = sorted_[0];
+        return;
+    }
+    spill();
+    arena_.shrink_to_fit();
+    size_t k = runs_.size();
+    for (auto &run : runs_) {
+        rewind(run.file);
+        run.read = 0;
+        run.done = !fill(run);
+    }
+    // 叶子k+i对应第i个run，自底向上比赛，每个内部节点记录败者
+    std::vector<size_t> winners(2 * k);
+    tree_.assign(k, 0);
+    for (size_t i = 0; i < k; i++) winners[k + i] = i;
+    for (size_t node = k - 1; node > 0; node--) {
+        size_t a = winners[2 * node], b = winners[2 * node + 1];
+        bool a_wins = beats(a, b);
+        winners[node] = a_wins ? a : b;
+        tree_[node] = a_wins ? b : a;
+    }
+    tree_[0] = k == 1 ? 0 : winners[1];
+    if (!runs_[tree_[0]].done) cur_ = run_entry(runs_[tree_[0]]);
+}
+
+void ExternalSorter::next() {
+    if (cur_ == nullptr) return;
+    if (runs_.empty()) {
+        cur_ = ++pos_ < sorted_.size() ? sorted_[pos_] : nullptr;
+        return;
+    }
+    size_t top = tree_[0];
+    Run &run = runs_[top];
+    if (++run.pos == run.buf_tuples && !fill(run)) run.done = true;
+    replay(top);
+    cur_ = runs_[tree_[0]].done ? nullptr : run_entry(runs_[tree_[0]]);
+}
@@ -0,0 +1,113 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "execution_defs.h"
+#include "system/sm.h"
+
+/**
+ * @brief 规范化排序键
+ * 把元组中的各排序列编码成一段定长字节串，按字节比较（memcmp）的结果与按各排序列、各自方向比较的结果一致
+ */
+class SortKeyEncoder {
+   public:
+    SortKeyEncoder(std::vector<ColMeta> key_cols, std::vector<bool> is_desc);
+
+    size_t len() const { return len_; }
+
+    void encode(const char *tuple, char *key) const;
+
+    int compare(const char *a, const char *b) const { return memcmp(a, b, len_); }
+
+   private:
+    std::vector<ColMeta> key_cols_;
+    std::vector<bool> is_desc_;
+    size_t len_ = 0;
+};
+
+/**
+ * @brief 定长元组的外部排序
+ * 元组先放入内存缓冲区，缓冲区超过内存预算时排好序写入临时文件成为一个run；
+ * finish之后如果没有写出过run，直接按内存中的顺序输出，否则把剩余元组也写成run，再用败者树对所有run做k路归并。
+ * 每个元组前面附加一段规范化的排序键（SortKeyEncoder），排序和归并时只需要一次memcmp
+ */
+class ExternalSorter {
+   public:
+    static constexpr size_t DEFAULT_MEM_BUDGET = 16 << 20;   // 默认内存预算（字节）
+
+    ExternalSorter(size_t tuple_len, std::vector<ColMeta> key_cols, std::vector<bool> is_desc,
+                   size_t mem_budget = DEFAULT_MEM_BUDGET);
+
+    ~ExternalSorter();
+
+    ExternalSorter(const ExternalSorter &) = delete;
+    ExternalSorter &operator=(const ExternalSorter &) = delete;
+
+    void add(const char *tuple);
+
+    // 输入结束，之后可以按顺序读取
+    void finish();
+
+    bool is_end() const { return cur_ == nullptr; }
+
+    // 当前元组，在下一次next之前有效
+    const char *current() const { return cur_ == nullptr ? nullptr : cur_ + key_len_; }
+
+    void next();
+
+    size_t num_runs() const { return runs_.size(); }
+
+   private:
+    // 临时文件中的一个run，按块读回；run中每一项是排序键加元组
+    struct Run {
+        FILE *file = nullptr;
+        size_t num_tuples = 0;      // run中的元组总数
+        size_t read = 0;            // 已经读入缓冲区的元组数
+        std::vector<char> buf;
+        size_t buf_tuples = 0;      // 缓冲区中的元组数
+        size_t pos = 0;             // 缓冲区中当前元组的下标
+        bool done = false;          // run已经全部输出
+    };
+
+    size_t tuple_len_;
+    SortKeyEncoder key_;
+    size_t key_len_;                        // 规范化排序键的长度
+    size_t entry_len_;                      // 每一项的长度：key_len_ + tuple_len_
+    size_t mem_budget_;
+
+    std::vector<char> arena_;               // 内存中尚未写出的项
+    std::vector<const char *> sorted_;      // arena_中的项排序后的顺序
+    size_t pos_ = 0;
+    std::vector<Run> runs_;
+    std::vector<size_t> tree_;              // 败者树：tree_[0]是胜者，tree_[1..k-1]是各内部节点上的败者
+    const char *cur_ = nullptr;
+
+    bool less(const char *a, const char *b) const { return key_.compare(a, b) < 0; }
+
+    // 归并时run a的当前项是否排在run b之前，已经输出完的run排在最后，相等时下标小的在前
+    bool beats(size_t a, size_t b) const;
+
+    void replay(size_t run_idx);
+
+    void sort_arena();
+
+    void spill();
+
+    bool fill(Run &run);
+
+    const char *run_entry(const Run &run) const { return run.buf.data() + run.pos * entry_len_; }
+};
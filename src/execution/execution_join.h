@@ -0,0 +1,163 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "common/common.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+// 各种连接算子共用的连接条件处理
+
+// 一对等值连接列，分别是左、右输入元组中的字段
+struct JoinKeyCol {
+    ColMeta left;
+    ColMeta right;
+};
+
+// 不能作为连接键的条件，在拼接后的元组上求值，两侧字段的offset都是拼接后元组中的偏移
+struct JoinResidualCond {
+    ColMeta lhs;
+    ColMeta rhs;
+    CompOp op;
+};
+
+inline const ColMeta *find_join_col(const std::vector<ColMeta> &cols, const TabCol &target) {
+    for (auto &col : cols) {
+        if ((target.tab_name.empty() || col.tab_name == target.tab_name) && col.name == target.col_name) {
+            return &col;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief 把连接条件分为连接键和剩余条件
+ * 条件两侧的列可以以任意顺序出现在左右输入中；类型相同（字符串还要求长度相同）的等值条件作为连接键，
+ * 其余条件在拼接后的元组上求值
+ * @param left_len 左输入元组的长度，右输入字段在拼接后元组中的偏移需要加上它
+ */
+inline void split_join_conds(const std::vector<ColMeta> &left_cols, const std::vector<ColMeta> &right_cols,
+                             size_t left_len, const std::vector<Condition> &conds, std::vector<JoinKeyCol> *keys,
+                             std::vector<JoinResidualCond> *residual) {
+    auto locate = [&](const TabCol &target) {
+        if (auto col = find_join_col(left_cols, target)) return *col;
+        if (auto col = find_join_col(right_cols, target)) {
+            ColMeta shifted = *col;
+            shifted.offset += static_cast<int>(left_len);
+            return shifted;
+        }
+        throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+    };
+    for (auto &cond : conds) {
+        if (cond.is_rhs_val) {
+            throw InternalError("split_join_conds: join condition must compare two columns");
+        }
+        ColMeta lhs = locate(cond.lhs_col);
+        ColMeta rhs = locate(cond.rhs_col);
+        bool lhs_left = lhs.offset < static_cast<int>(left_len);
+        bool rhs_left = rhs.offset < static_cast<int>(left_len);
+        bool same_type = lhs.type == rhs.type && (lhs.type != TYPE_STRING || lhs.len == rhs.len);
+        if (cond.op == OP_EQ && lhs_left != rhs_left && same_type) {
+            JoinKeyCol key{lhs_left ? lhs : rhs, lhs_left ? rhs : lhs};
+            key.right.offset -= static_cast<int>(left_len);
+            keys->push_back(key);
+        } else {
+            residual->push_back(JoinResidualCond{lhs, rhs, cond.op});
+        }
+    }
+}
+
+inline bool eval_join_cond(const JoinResidualCond &cond, const char *rec) {
+    int len = std::min(cond.lhs.len, cond.rhs.len);
+    int cmp = ix_compare(rec + cond.lhs.offset, rec + cond.rhs.offset, cond.lhs.type, len);
+    switch (cond.op) {
+        case OP_EQ: return cmp == 0;
+        case OP_NE: return cmp != 0;
+        case OP_LT: return cmp < 0;
+        case OP_GT: return cmp > 0;
+        case OP_LE: return cmp <= 0;
+        case OP_GE: return cmp >= 0;
+        default: throw InternalError("eval_join_cond: unsupported operator");
+    }
+}
+
+inline bool eval_join_conds(const std::vector<JoinResidualCond> &conds, const char *rec) {
+    for (auto &cond : conds) {
+        if (!eval_join_cond(cond, rec)) return false;
+    }
+    return true;
+}
+
+// 不拼接元组，直接在左右两个元组上求值；字段的offset仍是拼接后元组中的偏移
+inline bool eval_join_cond(const JoinResidualCond &cond, const char *left, const char *right, size_t left_len) {
+    auto data = [&](const ColMeta &col) {
+        return col.offset < static_cast<int>(left_len) ? left + col.offset : right + (col.offset - left_len);
+    };
+    int len = std::min(cond.lhs.len, cond.rhs.len);
+    int cmp = ix_compare(data(cond.lhs), data(cond.rhs), cond.lhs.type, len);
+    switch (cond.op) {
+        case OP_EQ: return cmp == 0;
+        case OP_NE: return cmp != 0;
+        case OP_LT: return cmp < 0;
+        case OP_GT: return cmp > 0;
+        case OP_LE: return cmp <= 0;
+        case OP_GE: return cmp >= 0;
+        default: throw InternalError("eval_join_cond: unsupported operator");
+    }
+}
+
+inline bool eval_join_conds(const std::vector<JoinResidualCond> &conds, const char *left, const char *right,
+                            size_t left_len) {
+    for (auto &cond : conds) {
+        if (!eval_join_cond(cond, left, right, left_len)) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 计算元组中连接键的哈希值（FNV-1a + murmur3 finalizer）
+ * 浮点数+0和-0比较相等，哈希前统一为+0
+ */
+inline uint64_t hash_join_key(const char *rec, const std::vector<ColMeta> &key_cols) {
+    uint64_t h = 14695981039346656037ULL;
+    for (auto &col : key_cols) {
+        const char *data = rec + col.offset;
+        float zero = 0.0f;
+        if (col.type == TYPE_FLOAT && *reinterpret_cast<const float *>(data) == 0.0f) {
+            data = reinterpret_cast<const char *>(&zero);
+        }
+        for (int i = 0; i < col.len; i++) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ULL;
+        }
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb93fe53a3f5bULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// 按连接键比较两个元组，a、b分别使用a_cols、b_cols中的字段，返回值同ix_compare
+inline int compare_join_key(const char *a, const std::vector<ColMeta> &a_cols, const char *b,
+                            const std::vector<ColMeta> &b_cols) {
+    for (size_t i = 0; i < a_cols.size(); i++) {
+        int cmp = ix_compare(a + a_cols[i].offset, b + b_cols[i].offset, a_cols[i].type, a_cols[i].len);
+        if (cmp != 0) return cmp;
+    }
+    return 0;
+}
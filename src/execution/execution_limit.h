@@ -19,24 +19,30 @@ class LimitExecutor : public AbstractExecutor {
 private:
     std::unique_ptr<AbstractExecutor> prev_;
     int limit_count_;
+    int offset_;                // 输出前跳过的元组数
     int current_count_;
 
 public:
-    LimitExecutor(std::unique_ptr<AbstractExecutor> prev, int limit_count) {
+    LimitExecutor(std::unique_ptr<AbstractExecutor> prev, int limit_count, int offset = 0) {
         prev_ = std::move(prev);
         limit_count_ = limit_count;
+        offset_ = offset;
         current_count_ = 0;
     }
 
     void beginTuple() override {
         prev_->beginTuple();
         current_count_ = 0;
+        for (int i = 0; i < offset_ && !prev_->is_end(); i++) {
+            prev_->nextTuple();
+        }
     }
 
+    // 输出最后一个元组后不再推进下层，否则下层会为了找到用不上的下一个元组继续读取
     void nextTuple() override {
         if (!is_end()) {
-            prev_->nextTuple();
             current_count_++;
+            if (current_count_ < limit_count_) prev_->nextTuple();
         }
     }
 
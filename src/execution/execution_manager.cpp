@@ -61,7 +61,7 @@ void QlManager::run_mutli_query(std::shared_ptr<Plan> plan, Context *context){
             }
             case T_CreateIndex:
             {
-                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context);
+                sm_manager_->create_index(x->tab_name_, x->tab_col_names_, context, x->unique_);
                 break;
             }
             case T_DropIndex:
@@ -96,6 +96,11 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
                 sm_manager_->show_indexes(x->tab_name_,context);
                 break;
             }
+            case T_ShowIndexStats:
+            {
+                sm_manager_->show_index_stats(x->tab_name_, context);
+                break;
+            }
             case T_DescTable:
             {
                 sm_manager_->desc_table(x->tab_name_, context);
@@ -189,6 +194,27 @@ void QlManager::run_cmd_utility(std::shared_ptr<Plan> plan, txn_id_t *txn_id, Co
             planner_->set_enable_sortmerge_join(x->bool_value_);
             break;
         }
+        case ast::SetKnobType::IndexCacheSize: {
+            // 以KB为单位设置每个唯一索引的点查询缓存预算
+            sm_manager_->set_index_cache_size(static_cast<size_t>(x->int_value_) * 1024);
+            break;
+        }
+        case ast::SetKnobType::WorkMem: {
+            // 以KB为单位设置排序、聚合算子的内存预算
+            if (x->int_value_ <= 0) {
+                throw RMDBError("work_mem must be positive");
+            }
+            sm_manager_->set_work_mem(static_cast<size_t>(x->int_value_) * 1024);
+            break;
+        }
+        case ast::SetKnobType::MaxParallelWorkers: {
+            // 0或1表示不使用并行扫描
+            if (x->int_value_ < 0) {
+                throw RMDBError("max_parallel_workers must not be negative");
+            }
+            planner_->set_max_parallel_workers(x->int_value_);
+            break;
+        }
         default: {
             throw RMDBError("Not implemented!\n");
             break;
@@ -222,32 +248,37 @@ void QlManager::select_from(std::unique_ptr<AbstractExecutor> executorTreeRoot,
 
     // Print records
     size_t num_rec = 0;
-    // 执行query_plan
-    for (executorTreeRoot->beginTuple(); !executorTreeRoot->is_end(); executorTreeRoot->nextTuple()) {
-        auto Tuple = executorTreeRoot->Next();
-        std::vector<std::string> columns;
-        for (auto &col : executorTreeRoot->cols()) {
-            std::string col_str;
-            char *rec_buf = Tuple->data + col.offset;
-            if (col.type == TYPE_INT) {
-                col_str = std::to_string(*(int *)rec_buf);
-            } else if (col.type == TYPE_FLOAT) {
-                col_str = std::to_string(*(float *)rec_buf);
-            } else if (col.type == TYPE_STRING) {
-                col_str = std::string((char *)rec_buf, col.len);
-                col_str.resize(strlen(col_str.c_str()));
+    // 执行query_plan，按批读取结果
+    executorTreeRoot->beginTuple();
+    while (auto batch = executorTreeRoot->NextBatch()) {
+        auto &cols = batch->cols();
+        for (size_t i = 0; i < batch->num_selected(); ++i) {
+            size_t row = batch->selected(i);
+            std::vector<std::string> columns;
+            for (size_t j = 0; j < cols.size(); ++j) {
+                auto &col = cols[j];
+                std::string col_str;
+                const char *rec_buf = batch->value(j, row);
+                if (col.type == TYPE_INT) {
+                    col_str = std::to_string(*(const int *)rec_buf);
+                } else if (col.type == TYPE_FLOAT) {
+                    col_str = std::to_string(*(const float *)rec_buf);
+                } else if (col.type == TYPE_STRING) {
+                    col_str = std::string(rec_buf, col.len);
+                    col_str.resize(strlen(col_str.c_str()));
+                }
+                columns.push_back(col_str);
             }
-            columns.push_back(col_str);
-        }
-        // print record into buffer
-        rec_printer.print_record(columns, context);
-        // print record into file
-        outfile << "|";
-        for(size_t i = 0; i < columns.size(); ++i) {
-            outfile << " " << columns[i] << " |";
+            // print record into buffer
+            rec_printer.print_record(columns, context);
+            // print record into file
+            outfile << "|";
+            for(size_t k = 0; k < columns.size(); ++k) {
+                outfile << " " << columns[k] << " |";
+            }
+            outfile << "\n";
+            num_rec++;
         }
-        outfile << "\n";
-        num_rec++;
     }
     outfile.close();
     // Print footer into buffer
@@ -261,8 +292,39 @@ void QlManager::run_dml(std::unique_ptr<AbstractExecutor> exec){
     exec->Next();
 }
 
+/**
+ * @brief 执行EXPLAIN ANALYZE：完整执行查询但不输出结果，然后输出附带各算子运行统计的执行计划
+ * @param execs 计划节点到算子的映射，算子的生命周期由root管理
+ */
+void QlManager::explain_analyze(std::shared_ptr<Plan> plan, std::unique_ptr<AbstractExecutor> root,
+                                const PlanExecutorMap &execs, Context *context) {
+    auto explain = std::dynamic_pointer_cast<ExplainPlan>(plan);
+    size_t num_rows = 0;
+    root->beginTuple();
+    while (auto batch = root->NextBatch()) {
+        num_rows += batch->num_selected();
+    }
+
+    std::unordered_map<const Plan *, std::string> stats;
+    for (auto &[node, exec] : execs) {
+        std::string info = exec->analyze_info();
+        if (!info.empty()) stats[node] = info;
+    }
+    std::string explain_output = format_explain_plan(explain->subplan_, 0, &stats);
+    explain_output += "Rows: " + std::to_string(num_rows) + "\n";
+
+    memcpy(context->data_send_ + *(context->offset_), explain_output.c_str(), explain_output.length());
+    *(context->offset_) += explain_output.length();
+
+    std::fstream outfile;
+    outfile.open("output.txt", std::ios::out | std::ios::app);
+    outfile << explain_output;
+    outfile.close();
+}
+
 // 格式化EXPLAIN输出
-std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth) {
+std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth,
+                                           const std::unordered_map<const Plan *, std::string> *stats) {
     std::string indent(depth * 2, ' ');
     std::string result;
     
@@ -273,7 +335,11 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
     switch (plan->tag) {
         case T_SeqScan: {
             auto scan_plan = std::dynamic_pointer_cast<ScanPlan>(plan);
-            result += indent + "-> Seq Scan on " + scan_plan->tab_name_;
+            if (scan_plan->parallel_workers_ > 0) {
+                result += indent + "-> Parallel Seq Scan on " + scan_plan->tab_name_;
+            } else {
+                result += indent + "-> Seq Scan on " + scan_plan->tab_name_;
+            }
             if (!scan_plan->conds_.empty()) {
                 result += " (Filter: ";
                 for (size_t i = 0; i < scan_plan->conds_.size(); ++i) {
@@ -310,7 +376,8 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
         }
         case T_IndexScan: {
             auto scan_plan = std::dynamic_pointer_cast<ScanPlan>(plan);
-            result += indent + "-> Index Scan on " + scan_plan->tab_name_;
+            result += indent + (scan_plan->index_only_ ? "-> Index Only Scan" : "-> Index Scan") +
+                      (scan_plan->reverse_ ? " Backward on " : " on ") + scan_plan->tab_name_;
             if (!scan_plan->conds_.empty()) {
                 result += " (Index Cond: ";
                 for (size_t i = 0; i < scan_plan->conds_.size(); ++i) {
@@ -363,8 +430,8 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
                 result += ")";
             }
             result += "\n";
-            result += format_explain_plan(join_plan->left_, depth + 1);
-            result += format_explain_plan(join_plan->right_, depth + 1);
+            result += format_explain_plan(join_plan->left_, depth + 1, stats);
+            result += format_explain_plan(join_plan->right_, depth + 1, stats);
             break;
         }
         case T_SortMerge: {
@@ -385,8 +452,76 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
                 result += ")";
             }
             result += "\n";
-            result += format_explain_plan(join_plan->left_, depth + 1);
-            result += format_explain_plan(join_plan->right_, depth + 1);
+            result += format_explain_plan(join_plan->left_, depth + 1, stats);
+            result += format_explain_plan(join_plan->right_, depth + 1, stats);
+            break;
+        }
+        case T_SemiJoin:
+        case T_AntiJoin: {
+            auto join_plan = std::dynamic_pointer_cast<JoinPlan>(plan);
+            result += indent + (join_plan->tag == T_AntiJoin ? "-> Anti Join" : "-> Semi Join");
+            if (!join_plan->conds_.empty()) {
+                result += " (Join Cond: ";
+                for (size_t i = 0; i < join_plan->conds_.size(); ++i) {
+                    if (i > 0) result += " AND ";
+                    result += join_plan->conds_[i].lhs_col.tab_name + "." + join_plan->conds_[i].lhs_col.col_name + " " + 
+                             (join_plan->conds_[i].op == OP_EQ ? "=" :
+                              join_plan->conds_[i].op == OP_NE ? "<>" :
+                              join_plan->conds_[i].op == OP_LT ? "<" :
+                              join_plan->conds_[i].op == OP_GT ? ">" :
+                              join_plan->conds_[i].op == OP_LE ? "<=" : ">=") + " " +
+                             join_plan->conds_[i].rhs_col.tab_name + "." + join_plan->conds_[i].rhs_col.col_name;
+                }
+                result += ")";
+            }
+            result += "\n";
+            result += format_explain_plan(join_plan->left_, depth + 1, stats);
+            result += format_explain_plan(join_plan->right_, depth + 1, stats);
+            break;
+        }
+        case T_HashJoin: {
+            auto join_plan = std::dynamic_pointer_cast<JoinPlan>(plan);
+            bool parallel = join_plan->left_->tag == T_Gather || join_plan->right_->tag == T_Gather;
+            result += indent + (parallel ? "-> Parallel Hash Join" : "-> Hash Join");
+            if (!join_plan->conds_.empty()) {
+                result += " (Join Cond: ";
+                for (size_t i = 0; i < join_plan->conds_.size(); ++i) {
+                    if (i > 0) result += " AND ";
+                    result += join_plan->conds_[i].lhs_col.tab_name + "." + join_plan->conds_[i].lhs_col.col_name + " " + 
+                             (join_plan->conds_[i].op == OP_EQ ? "=" :
+                              join_plan->conds_[i].op == OP_NE ? "<>" :
+                              join_plan->conds_[i].op == OP_LT ? "<" :
+                              join_plan->conds_[i].op == OP_GT ? ">" :
+                              join_plan->conds_[i].op == OP_LE ? "<=" : ">=") + " " +
+                             join_plan->conds_[i].rhs_col.tab_name + "." + join_plan->conds_[i].rhs_col.col_name;
+                }
+                result += ")";
+            }
+            result += "\n";
+            result += format_explain_plan(join_plan->left_, depth + 1, stats);
+            result += format_explain_plan(join_plan->right_, depth + 1, stats);
+            break;
+        }
+        case T_IndexNestLoop: {
+            auto join_plan = std::dynamic_pointer_cast<JoinPlan>(plan);
+            result += indent + "-> Index Nested Loop Join";
+            if (!join_plan->conds_.empty()) {
+                result += " (Join Cond: ";
+                for (size_t i = 0; i < join_plan->conds_.size(); ++i) {
+                    if (i > 0) result += " AND ";
+                    result += join_plan->conds_[i].lhs_col.tab_name + "." + join_plan->conds_[i].lhs_col.col_name + " " + 
+                             (join_plan->conds_[i].op == OP_EQ ? "=" :
+                              join_plan->conds_[i].op == OP_NE ? "<>" :
+                              join_plan->conds_[i].op == OP_LT ? "<" :
+                              join_plan->conds_[i].op == OP_GT ? ">" :
+                              join_plan->conds_[i].op == OP_LE ? "<=" : ">=") + " " +
+                             join_plan->conds_[i].rhs_col.tab_name + "." + join_plan->conds_[i].rhs_col.col_name;
+                }
+                result += ")";
+            }
+            result += "\n";
+            result += format_explain_plan(join_plan->left_, depth + 1, stats);
+            result += format_explain_plan(join_plan->right_, depth + 1, stats);
             break;
         }
         case T_Projection: {
@@ -404,7 +539,7 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
                 result += ")";
             }
             result += "\n";
-            result += format_explain_plan(proj_plan->subplan_, depth + 1);
+            result += format_explain_plan(proj_plan->subplan_, depth + 1, stats);
             break;
         }
         case T_Sort: {
@@ -425,12 +560,49 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
                 result += ")";
             }
             result += "\n";
-            result += format_explain_plan(sort_plan->subplan_, depth + 1);
+            result += format_explain_plan(sort_plan->subplan_, depth + 1, stats);
+            break;
+        }
+        case T_Limit: {
+            auto limit_plan = std::dynamic_pointer_cast<LimitPlan>(plan);
+            result += indent + "-> Limit (Count: " + std::to_string(limit_plan->limit_count_);
+            if (limit_plan->offset_ > 0) {
+                result += ", Offset: " + std::to_string(limit_plan->offset_);
+            }
+            result += ")\n";
+            result += format_explain_plan(limit_plan->subplan_, depth + 1, stats);
             break;
         }
-        case T_Aggregate: {
+        case T_TopN: {
+            auto topn_plan = std::dynamic_pointer_cast<TopNPlan>(plan);
+            result += indent + "-> Top-N Sort (Order: ";
+            for (size_t i = 0; i < topn_plan->sel_cols_.size(); ++i) {
+                if (i > 0) result += ", ";
+                if (!topn_plan->sel_cols_[i].tab_name.empty()) {
+                    result += topn_plan->sel_cols_[i].tab_name + ".";
+                }
+                result += topn_plan->sel_cols_[i].col_name;
+                if (i < topn_plan->is_desc_list_.size()) {
+                    result += topn_plan->is_desc_list_[i] ? " DESC" : " ASC";
+                }
+            }
+            result += "; Count: " + std::to_string(topn_plan->limit_count_);
+            if (topn_plan->offset_ > 0) {
+                result += ", Offset: " + std::to_string(topn_plan->offset_);
+            }
+            result += ")\n";
+            result += format_explain_plan(topn_plan->subplan_, depth + 1, stats);
+            break;
+        }
+        case T_Gather: {
+            auto gather_plan = std::dynamic_pointer_cast<GatherPlan>(plan);
+            result += indent + "-> Gather (Workers: " + std::to_string(gather_plan->num_workers_) + ")\n";
+            result += format_explain_plan(gather_plan->subplan_, depth + 1, stats);
+            break;
+        }
+                case T_Aggregate: {
             auto agg_plan = std::dynamic_pointer_cast<AggregatePlan>(plan);
-            result += indent + "-> Aggregate";
+            result += indent + (agg_plan->prev_->tag == T_Gather ? "-> Parallel Aggregate" : "-> Aggregate");
             if (!agg_plan->group_by_cols_.empty()) {
                 result += " (Group By: ";
                 for (size_t i = 0; i < agg_plan->group_by_cols_.size(); ++i) {
@@ -440,13 +612,21 @@ std::string QlManager::format_explain_plan(std::shared_ptr<Plan> plan, int depth
                 result += ")";
             }
             result += "\n";
-            result += format_explain_plan(agg_plan->prev_, depth + 1);
+            result += format_explain_plan(agg_plan->prev_, depth + 1, stats);
             break;
         }
         default:
             result += indent + "-> Unknown Plan Type\n";
             break;
     }
+
+    // EXPLAIN ANALYZE：运行统计附加在本节点所在的第一行末尾
+    if (stats != nullptr) {
+        auto it = stats->find(plan.get());
+        if (it != stats->end()) {
+            result.insert(result.find('\n'), " [" + it->second + "]");
+        }
+    }
     
     return result;
 }
\ No newline at end of file
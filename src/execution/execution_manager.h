@@ -14,6 +14,7 @@ See the Mulan PSL v2 for more details. */
 #include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "execution_defs.h"
@@ -29,6 +30,9 @@ See the Mulan PSL v2 for more details. */
 
 class Planner;
 
+// EXPLAIN ANALYZE时记录每个计划节点对应的算子
+using PlanExecutorMap = std::unordered_map<const Plan *, const AbstractExecutor *>;
+
 class QlManager {
    private:
     SmManager *sm_manager_;
@@ -46,7 +50,11 @@ class QlManager {
                         Context *context);
 
     void run_dml(std::unique_ptr<AbstractExecutor> exec);
+
+    void explain_analyze(std::shared_ptr<Plan> plan, std::unique_ptr<AbstractExecutor> root,
+                         const PlanExecutorMap &execs, Context *context);
     
 private:
-    std::string format_explain_plan(std::shared_ptr<Plan> plan, int depth);
+    std::string format_explain_plan(std::shared_ptr<Plan> plan, int depth,
+                                    const std::unordered_map<const Plan *, std::string> *stats = nullptr);
 };
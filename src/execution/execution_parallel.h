@@ -0,0 +1,209 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "execution_batch.h"
+
+/**
+ * @brief 各查询共享的工作线程池
+ * 提交任务时没有空闲线程就新建一个，保证每个任务立即有线程执行：并行算子的工作线程会阻塞在exchange队列上
+ * 等待消费者，固定大小的线程池在多个并行算子同时运行时可能死锁。执行完任务的线程留在池中等待下一个任务，
+ * 线程数等于同时运行任务数的峰值。线程池在进程结束前一直存在
+ */
+class WorkerPool {
+   public:
+    static WorkerPool &get_instance() {
+        static WorkerPool *pool = new WorkerPool();     // 不析构，分离的线程在进程退出前始终可以访问
+        return *pool;
+    }
+
+    // 任务不应抛出异常，需要传递异常时使用TaskGroup
+    void submit(std::function<void()> task) {
+        std::lock_guard<std::mutex> lock(latch_);
+        tasks_.push_back(std::move(task));
+        if (tasks_.size() > idle_) {
+            std::thread(&WorkerPool::worker_loop, this).detach();
+        } else {
+            has_task_.notify_one();
+        }
+    }
+
+   private:
+    WorkerPool() = default;
+
+    void worker_loop() {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (true) {
+            idle_++;
+            has_task_.wait(lock, [&] { return !tasks_.empty(); });
+            idle_--;
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+        }
+    }
+
+    std::mutex latch_;
+    std::condition_variable has_task_;
+    std::deque<std::function<void()>> tasks_;
+    size_t idle_ = 0;                   // 正在等待任务的线程数
+};
+
+/**
+ * @brief 提交到WorkerPool的一组任务
+ * wait等待全部任务结束并重新抛出第一个异常；析构时等待全部任务结束
+ */
+class TaskGroup {
+   public:
+    TaskGroup() = default;
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+
+    ~TaskGroup() { join(); }
+
+    void spawn(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(latch_);
+            pending_++;
+        }
+        WorkerPool::get_instance().submit([this, task = std::move(task)]() {
+            std::exception_ptr error;
+            try {
+                task();
+            } catch (...) {
+                error = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(latch_);
+            if (error != nullptr && error_ == nullptr) error_ = error;
+            if (--pending_ == 0) done_.notify_all();
+        });
+    }
+
+    void wait() {
+        join();
+        std::lock_guard<std::mutex> lock(latch_);
+        if (error_ != nullptr) {
+            auto error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    // 等待全部任务结束，丢弃其中的异常，用于取消
+    void join() {
+        std::unique_lock<std::mutex> lock(latch_);
+        done_.wait(lock, [&] { return pending_ == 0; });
+        error_ = nullptr;
+    }
+
+   private:
+    std::mutex latch_;
+    std::condition_variable done_;
+    size_t pending_ = 0;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief 按页面范围分发扫描任务（morsel）
+ * 工作线程通过原子游标领取连续的若干页，先完成的线程领取更多的morsel，负载自然均衡
+ */
+class MorselCursor {
+   public:
+    static constexpr int DEFAULT_MORSEL_PAGES = 16;     // 每个morsel包含的页数
+
+    MorselCursor(int begin_page, int end_page, int morsel_pages = DEFAULT_MORSEL_PAGES)
+        : next_(begin_page), end_page_(end_page), morsel_pages_(morsel_pages) {}
+
+    // 领取下一个morsel [*begin, *end)，没有剩余页面时返回false
+    bool claim(int *begin, int *end) {
+        int page = next_.fetch_add(morsel_pages_);
+        if (page >= end_page_) return false;
+        *begin = page;
+        *end = std::min(page + morsel_pages_, end_page_);
+        return true;
+    }
+
+    // 放弃剩余的页面，之后的claim都返回false
+    void cancel() { next_ = end_page_; }
+
+   private:
+    std::atomic<int> next_;
+    int end_page_;
+    int morsel_pages_;
+};
+
+/**
+ * @brief 工作线程向消费者传递批的有界队列（exchange）
+ * 队列满时生产者阻塞，所有生产者结束且队列为空时pop返回nullptr；消费者提前结束时调用cancel使生产者退出
+ */
+class ExchangeQueue {
+   public:
+    ExchangeQueue(size_t capacity, int num_producers) : capacity_(capacity), num_producers_(num_producers) {}
+
+    // 放入一批，队列已被取消时丢弃并返回false
+    bool push(std::unique_ptr<RecordBatch> batch) {
+        std::unique_lock<std::mutex> lock(latch_);
+        not_full_.wait(lock, [&] { return cancelled_ || batches_.size() < capacity_; });
+        if (cancelled_) return false;
+        batches_.push_back(std::move(batch));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    std::unique_ptr<RecordBatch> pop() {
+        std::unique_lock<std::mutex> lock(latch_);
+        not_empty_.wait(lock, [&] { return !batches_.empty() || num_producers_ == 0; });
+        if (batches_.empty()) return nullptr;
+        auto batch = std::move(batches_.front());
+        batches_.pop_front();
+        not_full_.notify_one();
+        return batch;
+    }
+
+    void producer_done() {
+        std::lock_guard<std::mutex> lock(latch_);
+        num_producers_--;
+        not_empty_.notify_all();
+    }
+
+    void cancel() {
+        std::lock_guard<std::mutex> lock(latch_);
+        cancelled_ = true;
+        batches_.clear();
+        not_full_.notify_all();
+    }
+
+    bool cancelled() {
+        std::lock_guard<std::mutex> lock(latch_);
+        return cancelled_;
+    }
+
+   private:
+    std::mutex latch_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    std::deque<std::unique_ptr<RecordBatch>> batches_;
+    size_t capacity_;
+    int num_producers_;                 // 尚未结束的生产者数
+    bool cancelled_ = false;
+};
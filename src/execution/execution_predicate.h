@@ -0,0 +1,198 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "execution_join.h"
+
+// 按字段类型和运算符实例化的比较函数，语义与ix_compare加上运算符判断相同
+using PredicateCompareFn = bool (*)(const char *lhs, const char *rhs, int len);
+
+namespace predicate_kernels {
+
+template <CompOp op, typename T>
+inline bool apply_op(T a, T b) {
+    if constexpr (op == OP_EQ) return a == b;
+    else if constexpr (op == OP_NE) return a != b;
+    else if constexpr (op == OP_LT) return a < b;
+    else if constexpr (op == OP_GT) return a > b;
+    else if constexpr (op == OP_LE) return a <= b;
+    else return a >= b;
+}
+
+template <typename T, CompOp op>
+bool compare_num(const char *lhs, const char *rhs, int) {
+    T a, b;
+    memcpy(&a, lhs, sizeof(T));
+    memcpy(&b, rhs, sizeof(T));
+    return apply_op<op>(a, b);
+}
+
+template <CompOp op>
+bool compare_str(const char *lhs, const char *rhs, int len) {
+    return apply_op<op>(memcmp(lhs, rhs, len), 0);
+}
+
+inline bool compare_unsupported(const char *, const char *, int) {
+    throw InternalError("Unexpected data type");
+}
+
+// 两侧类型不同的条件在求值时才报错，与逐行比较时一致：没有元组需要检查时不报错
+template <ColType L, ColType R>
+bool type_mismatch(const char *, const char *, int) {
+    throw IncompatibleTypeError(coltype2str(L), coltype2str(R));
+}
+
+template <CompOp op>
+PredicateCompareFn choose(ColType type) {
+    switch (type) {
+        case TYPE_INT: return &compare_num<int, op>;
+        case TYPE_FLOAT: return &compare_num<float, op>;
+        case TYPE_STRING: return &compare_str<op>;
+        default: return &compare_unsupported;
+    }
+}
+
+inline PredicateCompareFn choose(ColType type, CompOp op) {
+    switch (op) {
+        case OP_EQ: return choose<OP_EQ>(type);
+        case OP_NE: return choose<OP_NE>(type);
+        case OP_LT: return choose<OP_LT>(type);
+        case OP_GT: return choose<OP_GT>(type);
+        case OP_LE: return choose<OP_LE>(type);
+        case OP_GE: return choose<OP_GE>(type);
+        default: throw InternalError("PredicateProgram: unsupported operator");
+    }
+}
+
+template <ColType L>
+PredicateCompareFn mismatch(ColType rhs) {
+    switch (rhs) {
+        case TYPE_INT: return &type_mismatch<L, TYPE_INT>;
+        case TYPE_FLOAT: return &type_mismatch<L, TYPE_FLOAT>;
+        case TYPE_STRING: return &type_mismatch<L, TYPE_STRING>;
+        default: return &type_mismatch<L, TYPE_DATETIME>;
+    }
+}
+
+inline PredicateCompareFn mismatch(ColType lhs, ColType rhs) {
+    switch (lhs) {
+        case TYPE_INT: return mismatch<TYPE_INT>(rhs);
+        case TYPE_FLOAT: return mismatch<TYPE_FLOAT>(rhs);
+        case TYPE_STRING: return mismatch<TYPE_STRING>(rhs);
+        default: return mismatch<TYPE_DATETIME>(rhs);
+    }
+}
+
+}  // namespace predicate_kernels
+
+/**
+ * @brief 编译后的谓词
+ * 条件在算子构造时解析一次：字段按名字解析为元组中的偏移，常量复制到程序自己的常量区，
+ * 比较函数按字段类型和运算符选好。逐行求值时只依次调用各条指令的比较函数，全部满足才返回true。
+ * 操作数可以来自左元组、右元组（连接条件）或常量区
+ */
+class PredicateProgram {
+   public:
+    PredicateProgram() = default;
+
+    /**
+     * @brief 编译单表条件：左侧是元组中的字段，右侧是常量或同一元组中的另一个字段
+     * 比较的类型和长度取左侧字段，与SeqScanExecutor逐行比较时相同
+     */
+    PredicateProgram(const std::vector<ColMeta> &cols, const std::vector<Condition> &conds) {
+        auto find = [&](const TabCol &target) -> const ColMeta & {
+            for (auto &col : cols) {
+                if ((target.tab_name.empty() || col.tab_name == target.tab_name) && col.name == target.col_name) {
+                    return col;
+                }
+            }
+            throw ColumnNotFoundError(target.tab_name + '.' + target.col_name);
+        };
+        for (auto &cond : conds) {
+            const ColMeta &lhs = find(cond.lhs_col);
+            Instr ins{};
+            ins.lhs_src = LEFT;
+            ins.lhs_offset = lhs.offset;
+            ins.len = lhs.len;
+            ColType rhs_type;
+            if (cond.is_rhs_val) {
+                rhs_type = cond.rhs_val.type;
+                ins.rhs_src = CONST;
+                ins.rhs_offset = static_cast<int>(consts_.size());
+                consts_.insert(consts_.end(), cond.rhs_val.raw->data, cond.rhs_val.raw->data + lhs.len);
+            } else {
+                const ColMeta &rhs = find(cond.rhs_col);
+                rhs_type = rhs.type;
+                ins.rhs_src = LEFT;
+                ins.rhs_offset = rhs.offset;
+            }
+            ins.fn = lhs.type == rhs_type ? predicate_kernels::choose(lhs.type, cond.op)
+                                          : predicate_kernels::mismatch(lhs.type, rhs_type);
+            instrs_.push_back(ins);
+        }
+    }
+
+    /**
+     * @brief 编译连接的剩余条件
+     * 字段的offset是拼接后元组中的偏移，小于left_len的字段在左元组中，其余在右元组中；
+     * 比较的类型取左侧字段，长度取两侧中较短的，与eval_join_cond相同
+     */
+    PredicateProgram(const std::vector<JoinResidualCond> &conds, size_t left_len) {
+        auto locate = [&](const ColMeta &col, Source *src, int *offset) {
+            bool in_left = col.offset < static_cast<int>(left_len);
+            *src = in_left ? LEFT : RIGHT;
+            *offset = in_left ? col.offset : col.offset - static_cast<int>(left_len);
+        };
+        for (auto &cond : conds) {
+            Instr ins{};
+            locate(cond.lhs, &ins.lhs_src, &ins.lhs_offset);
+            locate(cond.rhs, &ins.rhs_src, &ins.rhs_offset);
+            ins.len = std::min(cond.lhs.len, cond.rhs.len);
+            ins.fn = predicate_kernels::choose(cond.lhs.type, cond.op);
+            instrs_.push_back(ins);
+        }
+    }
+
+    bool empty() const { return instrs_.empty(); }
+
+    // 单表条件在一个元组上求值
+    bool eval(const char *rec) const { return eval(rec, nullptr); }
+
+    // 连接条件在左右两个元组上求值；拼接后的元组rec可以用eval(rec, rec + left_len)
+    bool eval(const char *left, const char *right) const {
+        const char *base[] = {left, right, consts_.data()};
+        for (auto &ins : instrs_) {
+            if (!ins.fn(base[ins.lhs_src] + ins.lhs_offset, base[ins.rhs_src] + ins.rhs_offset, ins.len)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+   private:
+    enum Source : uint8_t { LEFT = 0, RIGHT = 1, CONST = 2 };
+
+    struct Instr {
+        PredicateCompareFn fn;
+        Source lhs_src;
+        Source rhs_src;
+        int lhs_offset;
+        int rhs_offset;                 // 常量为在consts_中的偏移
+        int len;
+    };
+
+    std::vector<Instr> instrs_;
+    std::vector<char> consts_;
+};
@@ -0,0 +1,121 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution_batch.h"
+
+// 延迟物化时扫描附加在输出元组末尾的隐藏字段，内容是元组的Rid；最终投影据此回表读取只在select列表中出现的字段
+inline const std::string LATE_RID_COL = "$rid";
+
+/**
+ * @brief 扫描的输出布局（投影下推）
+ * 扫描只输出上层需要的字段，按在表中的顺序紧凑排列，需要延迟物化时在末尾附加LATE_RID_COL字段。
+ * 元组接口把完整记录转换为输出元组；批量接口先把输出字段和扫描条件引用的字段读入批中（read_cols，
+ * 偏移仍是完整记录中的偏移），过滤之后再移交输出字段的列向量
+ */
+class ScanProjection {
+   public:
+    ScanProjection() = default;
+
+    /**
+     * @param tab_cols 表的所有字段
+     * @param proj_cols 需要输出的字段名，为空时输出所有字段
+     * @param emit_rid 是否附加LATE_RID_COL字段
+     * @param conds 扫描条件
+     */
+    ScanProjection(const std::vector<ColMeta> &tab_cols, const std::vector<std::string> &proj_cols, bool emit_rid,
+                   const std::vector<Condition> &conds)
+        : identity_(proj_cols.empty() && !emit_rid), emit_rid_(emit_rid) {
+        auto in_conds = [&](const ColMeta &col) {
+            auto match = [&](const TabCol &target) {
+                return (target.tab_name.empty() || target.tab_name == col.tab_name) && target.col_name == col.name;
+            };
+            return std::any_of(conds.begin(), conds.end(), [&](const Condition &cond) {
+                return match(cond.lhs_col) || (!cond.is_rhs_val && match(cond.rhs_col));
+            });
+        };
+        int offset = 0;
+        for (auto &col : tab_cols) {
+            bool output = proj_cols.empty() || std::find(proj_cols.begin(), proj_cols.end(), col.name) != proj_cols.end();
+            if (!output && !in_conds(col)) continue;
+            if (output) {
+                read_idxs_.push_back(read_cols_.size());
+                ColMeta out = col;
+                out.offset = offset;
+                offset += out.len;
+                cols_.push_back(out);
+            }
+            read_cols_.push_back(col);
+        }
+        if (emit_rid_) {
+            cols_.push_back(ColMeta{tab_cols.front().tab_name, LATE_RID_COL, TYPE_STRING, static_cast<int>(sizeof(Rid)),
+                                    offset, false});
+            offset += sizeof(Rid);
+        }
+        len_ = offset;
+    }
+
+    // 输出就是完整记录，不需要转换
+    bool identity() const { return identity_; }
+
+    bool emit_rid() const { return emit_rid_; }
+
+    const std::vector<ColMeta> &cols() const { return cols_; }
+
+    size_t len() const { return len_; }
+
+    // 批量读取时读入批中的字段
+    const std::vector<ColMeta> &read_cols() const { return read_cols_; }
+
+    // 把位于rid的完整记录转换为输出元组
+    std::unique_ptr<RmRecord> apply(std::unique_ptr<RmRecord> rec, const Rid &rid) const {
+        if (identity_) return rec;
+        auto out = std::make_unique<RmRecord>(static_cast<int>(len_));
+        for (size_t i = 0; i < read_idxs_.size(); i++) {
+            memcpy(out->data + cols_[i].offset, rec->data + read_cols_[read_idxs_[i]].offset, cols_[i].len);
+        }
+        if (emit_rid_) memcpy(out->data + cols_.back().offset, &rid, sizeof(Rid));
+        return out;
+    }
+
+    /**
+     * @brief 把按read_cols读入并过滤过的批转换为输出批，移交列向量，不拷贝数据
+     * @param rids 批中每一行的Rid，只在emit_rid时使用
+     */
+    std::unique_ptr<RecordBatch> apply(std::unique_ptr<RecordBatch> batch, const std::vector<Rid> &rids) const {
+        if (identity_) return batch;
+        auto out = std::make_unique<RecordBatch>(cols_, false);
+        for (size_t i = 0; i < read_idxs_.size(); i++) {
+            out->column_buffer(i) = std::move(batch->column_buffer(read_idxs_[i]));
+        }
+        if (emit_rid_) {
+            auto &buffer = out->column_buffer(cols_.size() - 1);
+            buffer.resize(RecordBatch::CAPACITY * sizeof(Rid));
+            memcpy(buffer.data(), rids.data(), rids.size() * sizeof(Rid));
+        }
+        out->set_size(batch->size());
+        if (batch->has_selection()) out->set_selection(batch->selection());
+        return out;
+    }
+
+   private:
+    bool identity_ = true;
+    bool emit_rid_ = false;
+    std::vector<ColMeta> cols_;         // 输出字段，偏移按输出元组重新计算
+    size_t len_ = 0;
+    std::vector<ColMeta> read_cols_;    // 输出字段和条件引用的字段，偏移是完整记录中的偏移
+    std::vector<size_t> read_idxs_;     // 每个输出字段（不含rid）在read_cols_中的下标
+};
@@ -0,0 +1,292 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "execution_simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define RMDB_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace simd {
+namespace {
+
+template <CompOp op, typename T>
+inline bool compare(T a, T b) {
+    if constexpr (op == OP_EQ) return a == b;
+    else if constexpr (op == OP_NE) return a != b;
+    else if constexpr (op == OP_LT) return a < b;
+    else if constexpr (op == OP_GT) return a > b;
+    else if constexpr (op == OP_LE) return a <= b;
+    else return a >= b;
+}
+
+// 把运行时的运算符转换为模板参数，每个运算符实例化一个不含分支的循环
+template <typename F>
+inline void dispatch_op(CompOp op, F &&f) {
+    switch (op) {
+        case OP_EQ: f(std::integral_constant<CompOp, OP_EQ>{}); break;
+        case OP_NE: f(std::integral_constant<CompOp, OP_NE>{}); break;
+        case OP_LT: f(std::integral_constant<CompOp, OP_LT>{}); break;
+        case OP_GT: f(std::integral_constant<CompOp, OP_GT>{}); break;
+        case OP_LE: f(std::integral_constant<CompOp, OP_LE>{}); break;
+        case OP_GE: f(std::integral_constant<CompOp, OP_GE>{}); break;
+        default: throw InternalError("simd filter: unsupported operator");
+    }
+}
+
+// 标量实现：逐行比较，比较结果直接移位拼入位图，不产生分支
+
+template <CompOp op, typename T>
+void filter_num_scalar(const T *col, size_t n, T val, uint64_t *out) {
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        for (size_t i = base; i < end; i++) {
+            word |= static_cast<uint64_t>(compare<op>(col[i], val)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+void filter_int_scalar(const int *col, size_t n, int val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_num_scalar<decltype(c)::value>(col, n, val, out); });
+}
+
+void filter_float_scalar(const float *col, size_t n, float val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_num_scalar<decltype(c)::value>(col, n, val, out); });
+}
+
+// 字符串的比较函数返回是否相等，按op决定取反
+template <typename Eq>
+void filter_string_rows(const char *col, size_t n, int len, const char *val, CompOp op, uint64_t *out, Eq eq) {
+    if (op != OP_EQ && op != OP_NE) throw InternalError("simd filter: unsupported string operator");
+    uint64_t flip = op == OP_NE ? 1 : 0;
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        for (size_t i = base; i < end; i++) {
+            word |= (static_cast<uint64_t>(eq(col + i * len, val, len)) ^ flip) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+void filter_string_scalar(const char *col, size_t n, int len, const char *val, CompOp op, uint64_t *out) {
+    filter_string_rows(col, n, len, val, op, out,
+                       [](const char *a, const char *b, int l) { return memcmp(a, b, l) == 0; });
+}
+
+#ifdef RMDB_SIMD_X86
+
+// SSE4.2实现：每次比较4个值，字符串每次比较16字节
+
+template <CompOp op>
+__attribute__((target("sse4.2"))) void filter_int_sse4_op(const int *col, size_t n, int val, uint64_t *out) {
+    __m128i v = _mm_set1_epi32(val);
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        size_t i = base;
+        for (; i + 4 <= end; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(col + i));
+            __m128i m;
+            if constexpr (op == OP_EQ || op == OP_NE) m = _mm_cmpeq_epi32(x, v);
+            else if constexpr (op == OP_GT || op == OP_LE) m = _mm_cmpgt_epi32(x, v);
+            else m = _mm_cmpgt_epi32(v, x);
+            uint64_t bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(m)));
+            if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) bits ^= 0xF;
+            word |= bits << (i - base);
+        }
+        for (; i < end; i++) {
+            word |= static_cast<uint64_t>(compare<op>(col[i], val)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+template <CompOp op>
+__attribute__((target("sse4.2"))) void filter_float_sse4_op(const float *col, size_t n, float val, uint64_t *out) {
+    __m128 v = _mm_set1_ps(val);
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        size_t i = base;
+        for (; i + 4 <= end; i += 4) {
+            __m128 x = _mm_loadu_ps(col + i);
+            __m128 m;
+            if constexpr (op == OP_EQ) m = _mm_cmpeq_ps(x, v);
+            else if constexpr (op == OP_NE) m = _mm_cmpneq_ps(x, v);
+            else if constexpr (op == OP_LT) m = _mm_cmplt_ps(x, v);
+            else if constexpr (op == OP_GT) m = _mm_cmpgt_ps(x, v);
+            else if constexpr (op == OP_LE) m = _mm_cmple_ps(x, v);
+            else m = _mm_cmpge_ps(x, v);
+            word |= static_cast<uint64_t>(_mm_movemask_ps(m)) << (i - base);
+        }
+        for (; i < end; i++) {
+            word |= static_cast<uint64_t>(compare<op>(col[i], val)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+__attribute__((target("sse4.2"))) inline bool equal16(const char *a, const char *b) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) == 0xFFFF;
+}
+
+// 长度不是16的倍数时最后一段与前一段重叠，不读取字段之外的字节
+__attribute__((target("sse4.2"))) bool string_equal_sse4(const char *a, const char *b, int len) {
+    if (len < 16) return memcmp(a, b, len) == 0;
+    bool eq = true;
+    int i = 0;
+    for (; i + 16 <= len; i += 16) eq &= equal16(a + i, b + i);
+    if (i < len) eq &= equal16(a + len - 16, b + len - 16);
+    return eq;
+}
+
+void filter_int_sse4(const int *col, size_t n, int val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_int_sse4_op<decltype(c)::value>(col, n, val, out); });
+}
+
+void filter_float_sse4(const float *col, size_t n, float val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_float_sse4_op<decltype(c)::value>(col, n, val, out); });
+}
+
+void filter_string_sse4(const char *col, size_t n, int len, const char *val, CompOp op, uint64_t *out) {
+    filter_string_rows(col, n, len, val, op, out, &string_equal_sse4);
+}
+
+// AVX2实现：每次比较8个值，字符串每次比较32字节
+
+template <CompOp op>
+__attribute__((target("avx2"))) void filter_int_avx2_op(const int *col, size_t n, int val, uint64_t *out) {
+    __m256i v = _mm256_set1_epi32(val);
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        size_t i = base;
+        for (; i + 8 <= end; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(col + i));
+            __m256i m;
+            if constexpr (op == OP_EQ || op == OP_NE) m = _mm256_cmpeq_epi32(x, v);
+            else if constexpr (op == OP_GT || op == OP_LE) m = _mm256_cmpgt_epi32(x, v);
+            else m = _mm256_cmpgt_epi32(v, x);
+            uint64_t bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+            if constexpr (op == OP_NE || op == OP_LE || op == OP_GE) bits ^= 0xFF;
+            word |= bits << (i - base);
+        }
+        for (; i < end; i++) {
+            word |= static_cast<uint64_t>(compare<op>(col[i], val)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+template <CompOp op>
+__attribute__((target("avx2"))) void filter_float_avx2_op(const float *col, size_t n, float val, uint64_t *out) {
+    // 不等比较在有NaN时为真（unordered），其余比较为假（ordered），与标量比较相同
+    constexpr int pred = op == OP_EQ   ? _CMP_EQ_OQ
+                         : op == OP_NE ? _CMP_NEQ_UQ
+                         : op == OP_LT ? _CMP_LT_OQ
+                         : op == OP_GT ? _CMP_GT_OQ
+                         : op == OP_LE ? _CMP_LE_OQ
+                                       : _CMP_GE_OQ;
+    __m256 v = _mm256_set1_ps(val);
+    for (size_t base = 0; base < n; base += 64) {
+        size_t end = std::min(n, base + 64);
+        uint64_t word = 0;
+        size_t i = base;
+        for (; i + 8 <= end; i += 8) {
+            __m256 x = _mm256_loadu_ps(col + i);
+            word |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(x, v, pred))) << (i - base);
+        }
+        for (; i < end; i++) {
+            word |= static_cast<uint64_t>(compare<op>(col[i], val)) << (i - base);
+        }
+        out[base / 64] = word;
+    }
+}
+
+__attribute__((target("avx2"))) inline bool equal32(const char *a, const char *b) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y))) == 0xFFFFFFFFu;
+}
+
+__attribute__((target("avx2"))) bool string_equal_avx2(const char *a, const char *b, int len) {
+    if (len < 32) return string_equal_sse4(a, b, len);
+    bool eq = true;
+    int i = 0;
+    for (; i + 32 <= len; i += 32) eq &= equal32(a + i, b + i);
+    if (i < len) eq &= equal32(a + len - 32, b + len - 32);
+    return eq;
+}
+
+void filter_int_avx2(const int *col, size_t n, int val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_int_avx2_op<decltype(c)::value>(col, n, val, out); });
+}
+
+void filter_float_avx2(const float *col, size_t n, float val, CompOp op, uint64_t *out) {
+    dispatch_op(op, [&](auto c) { filter_float_avx2_op<decltype(c)::value>(col, n, val, out); });
+}
+
+void filter_string_avx2(const char *col, size_t n, int len, const char *val, CompOp op, uint64_t *out) {
+    filter_string_rows(col, n, len, val, op, out, &string_equal_avx2);
+}
+
+#endif
+
+Level detect_level() {
+#ifdef RMDB_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return Level::SSE4;
+#endif
+    return Level::SCALAR;
+}
+
+const FilterKernels SCALAR_KERNELS{Level::SCALAR, &filter_int_scalar, &filter_float_scalar, &filter_string_scalar};
+#ifdef RMDB_SIMD_X86
+const FilterKernels SSE4_KERNELS{Level::SSE4, &filter_int_sse4, &filter_float_sse4, &filter_string_sse4};
+const FilterKernels AVX2_KERNELS{Level::AVX2, &filter_int_avx2, &filter_float_avx2, &filter_string_avx2};
+#endif
+
+}  // namespace
+
+const FilterKernels &kernels() {
+    static const FilterKernels &best = kernels(detect_level());
+    return best;
+}
+
+const FilterKernels &kernels(Level level) {
+    static const Level supported = detect_level();
+    level = std::min(level, supported);
+#ifdef RMDB_SIMD_X86
+    if (level == Level::AVX2) return AVX2_KERNELS;
+    if (level == Level::SSE4) return SSE4_KERNELS;
+#endif
+    return SCALAR_KERNELS;
+}
+
+const char *level_name(Level level) {
+    switch (level) {
+        case Level::AVX2: return "avx2";
+        case Level::SSE4: return "sse4.2";
+        default: return "scalar";
+    }
+}
+
+}  // namespace simd
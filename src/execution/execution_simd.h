@@ -0,0 +1,50 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common/common.h"
+
+/**
+ * @brief 列向量与常量比较的过滤内核
+ * 每个内核比较列向量的前n个值，把结果写成位图：第row行满足条件时out[row / 64]的第row % 64位为1，
+ * n之后的位为0，out至少有(n + 63) / 64个字。内核不含逐行分支，分别有AVX2、SSE4.2和标量实现，
+ * 运行时按CPU支持的指令集选择
+ */
+namespace simd {
+
+enum class Level { SCALAR, SSE4, AVX2 };
+
+// 整数列与常量比较
+using IntFilterFn = void (*)(const int *col, size_t n, int val, CompOp op, uint64_t *out);
+// 浮点数列与常量比较，NaN的语义与标量比较相同
+using FloatFilterFn = void (*)(const float *col, size_t n, float val, CompOp op, uint64_t *out);
+// 定长字符串列与常量比较是否相等，op只能是OP_EQ或OP_NE
+using StringFilterFn = void (*)(const char *col, size_t n, int len, const char *val, CompOp op, uint64_t *out);
+
+struct FilterKernels {
+    Level level;
+    IntFilterFn filter_int;
+    FloatFilterFn filter_float;
+    StringFilterFn filter_string;
+};
+
+// 当前CPU支持的最高级别的内核，第一次调用时检测
+const FilterKernels &kernels();
+
+// 指定级别的内核，CPU不支持该级别时退回到支持的最高级别
+const FilterKernels &kernels(Level level);
+
+const char *level_name(Level level);
+
+}  // namespace simd
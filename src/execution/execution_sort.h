@@ -10,36 +10,35 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 #include "execution_defs.h"
+#include "execution_external_sort.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 #include <iostream>
 
+/**
+ * @brief 排序算子
+ * 输入交给ExternalSorter排序，超过内存预算的部分写出到临时文件，最后k路归并输出
+ */
 class SortExecutor : public AbstractExecutor {
    private:
     std::unique_ptr<AbstractExecutor> prev_;
     std::vector<ColMeta> cols_;                 // 支持多个键排序
     std::vector<bool> is_desc_;                 // 每列的排序方向
-    size_t tuple_num;
-    std::vector<size_t> used_tuple;
-    std::vector<std::unique_ptr<RmRecord>> tuples_;
-    size_t position;
-    std::unique_ptr<RmRecord> current_tuple;
+    size_t mem_budget_;                         // 排序的内存预算（字节）
+    std::unique_ptr<ExternalSorter> sorter_;
 
    public:
-    SortExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<TabCol> sel_cols, std::vector<bool> is_desc_list) 
-        : prev_(std::move(prev)), is_desc_(is_desc_list), tuple_num(0), position(0) {
+    SortExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<TabCol> sel_cols, std::vector<bool> is_desc_list,
+                 size_t mem_budget = ExternalSorter::DEFAULT_MEM_BUDGET)
+        : prev_(std::move(prev)), is_desc_(is_desc_list), mem_budget_(mem_budget) {
         
 
         for (size_t i = 0; i < sel_cols.size(); ++i) {
             ColMeta col_meta = prev_->get_col_offset(sel_cols[i]);
             cols_.push_back(col_meta);
         }
-        
-
-        used_tuple.clear();
-        tuples_.clear();
     }
 
     void beginTuple() override;
@@ -60,6 +59,8 @@ class SortExecutor : public AbstractExecutor {
         return prev_->get_col_offset(target);
     }
 
-private:
-    bool compare_tuples(const std::unique_ptr<RmRecord>& a, const std::unique_ptr<RmRecord>& b);
+    std::string analyze_info() const override {
+        if (sorter_ == nullptr) return "";
+        return "Spilled Runs: " + std::to_string(sorter_->num_runs());
+    }
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "execution_topn.h"
+
+#include <algorithm>
+
+static std::vector<ColMeta> resolve_sort_cols(AbstractExecutor *prev, const std::vector<TabCol> &sel_cols) {
+    std::vector<ColMeta> cols;
+    for (auto &sel_col : sel_cols) {
+        cols.push_back(prev->get_col_offset(sel_col));
+    }
+    return cols;
+}
+
+TopNExecutor::TopNExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<TabCol> sel_cols,
+                           std::vector<bool> is_desc_list, size_t limit, size_t offset)
+    : prev_(std::move(prev)),
+      cols_(resolve_sort_cols(prev_.get(), sel_cols)),
+      is_desc_(std::move(is_desc_list)),
+      limit_(limit),
+      offset_(offset),
+      key_(cols_, is_desc_) {
+    entry_len_ = key_.len() + sizeof(uint64_t) + prev_->tupleLen();
+    key_buf_.resize(key_.len());
+}
+
+bool TopNExecutor::less(const char *a, const char *b) const {
+    int cmp = key_.compare(a, b);
+    if (cmp != 0) return cmp < 0;
+    uint64_t seq_a, seq_b;
+    memcpy(&seq_a, a + key_.len(), sizeof(seq_a));
+    memcpy(&seq_b, b + key_.len(), sizeof(seq_b));
+    return seq_a < seq_b;
+}
+
+// 堆未满时直接加入；堆满时只有优于堆顶（当前第offset_ + limit_名）的元组才替换堆顶
+void TopNExecutor::add(const char *tuple, uint64_t seq) {
+    size_t capacity = offset_ + limit_;
+    auto heap_less = [this](uint32_t a, uint32_t b) { return less(entry(a), entry(b)); };
+    uint32_t slot;
+    if (heap_.size() < capacity) {
+        slot = static_cast<uint32_t>(heap_.size());
+        arena_.resize(arena_.size() + entry_len_);
+    } else {
+        // 输入序号递增，排序键与堆顶相同的新元组不会优于堆顶
+        key_.encode(tuple, key_buf_.data());
+        if (key_.compare(key_buf_.data(), entry(heap_.front())) >= 0) return;
+        std::pop_heap(heap_.begin(), heap_.end(), heap_less);
+        slot = heap_.back();
+        heap_.pop_back();
+    }
+    char *dst = entry(slot);
+    key_.encode(tuple, dst);
+    memcpy(dst + key_.len(), &seq, sizeof(seq));
+    memcpy(dst + key_.len() + sizeof(seq), tuple, prev_->tupleLen());
+    heap_.push_back(slot);
+    std::push_heap(heap_.begin(), heap_.end(), heap_less);
+}
+
+void TopNExecutor::beginTuple() {
+    arena_.clear();
+    heap_.clear();
+    sorted_.clear();
+    position_ = 0;
+    if (limit_ > 0) {
+        arena_.reserve(std::min<size_t>(offset_ + limit_, RecordBatch::CAPACITY) * entry_len_);
+        auto tuple = std::make_unique<RmRecord>(prev_->tupleLen());
+        uint64_t seq = 0;
+        prev_->beginTuple();
+        while (auto batch = prev_->NextBatch()) {
+            for (size_t i = 0; i < batch->num_selected(); ++i) {
+                batch->gather_row(batch->selected(i), tuple->data);
+                add(tuple->data, seq++);
+            }
+        }
+    }
+    sorted_ = heap_;
+    std::sort(sorted_.begin(), sorted_.end(), [this](uint32_t a, uint32_t b) { return less(entry(a), entry(b)); });
+    position_ = offset_;
+}
+
+void TopNExecutor::nextTuple() {
+    position_++;
+}
+
+std::unique_ptr<RmRecord> TopNExecutor::Next() {
+    if (is_end()) {
+        return nullptr;
+    }
+    return std::make_unique<RmRecord>(prev_->tupleLen(), const_cast<char *>(entry_tuple(sorted_[position_])));
+}
+
+bool TopNExecutor::is_end() const {
+    return position_ >= sorted_.size();
+}
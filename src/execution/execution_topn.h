@@ -0,0 +1,75 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+#include "execution_defs.h"
+#include "execution_external_sort.h"
+#include "execution_manager.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @brief ORDER BY ... LIMIT的Top-N算子
+ * 只保留排在最前面的offset + limit个元组：用排序键的大根堆维护当前最好的这些元组，
+ * 新元组不优于堆顶时直接丢弃，否则替换堆顶。输入读完后对堆中元组排序，跳过前offset个输出。
+ * 排序键相同的元组按输入顺序输出
+ */
+class TopNExecutor : public AbstractExecutor {
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    std::vector<ColMeta> cols_;                 // 排序列
+    std::vector<bool> is_desc_;                 // 每列的排序方向
+    size_t limit_;
+    size_t offset_;
+
+    SortKeyEncoder key_;
+    size_t entry_len_;                          // 每一项：排序键 + 输入序号 + 元组
+    std::vector<char> arena_;                   // 最多offset_ + limit_项
+    std::vector<uint32_t> heap_;                // arena_中各项的下标，按排序键组成大根堆
+    std::vector<uint32_t> sorted_;              // 输出顺序
+    std::vector<char> key_buf_;                 // 新元组的排序键
+    size_t position_ = 0;
+
+    char *entry(uint32_t i) { return arena_.data() + static_cast<size_t>(i) * entry_len_; }
+
+    const char *entry(uint32_t i) const { return arena_.data() + static_cast<size_t>(i) * entry_len_; }
+
+    const char *entry_tuple(uint32_t i) const { return entry(i) + key_.len() + sizeof(uint64_t); }
+
+    // 排序键相同时比较输入序号，使结果稳定
+    bool less(const char *a, const char *b) const;
+
+    void add(const char *tuple, uint64_t seq);
+
+   public:
+    TopNExecutor(std::unique_ptr<AbstractExecutor> prev, std::vector<TabCol> sel_cols, std::vector<bool> is_desc_list,
+                 size_t limit, size_t offset);
+
+    void beginTuple() override;
+    void nextTuple() override;
+    std::unique_ptr<RmRecord> Next() override;
+    bool is_end() const override;
+    Rid &rid() override { return _abstract_rid; }
+
+    const std::vector<ColMeta> &cols() const override {
+        return prev_->cols();
+    }
+
+    size_t tupleLen() const override {
+        return prev_->tupleLen();
+    }
+
+    std::string getType() override { return "TopNExecutor"; }
+
+    ColMeta get_col_offset(const TabCol &target) override {
+        return prev_->get_col_offset(target);
+    }
+};
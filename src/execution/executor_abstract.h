@@ -10,6 +10,7 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include "execution_batch.h"
 #include "execution_defs.h"
 #include "common/common.h"
 #include "index/ix.h"
@@ -42,7 +43,25 @@ class AbstractExecutor {
 
     virtual std::unique_ptr<RmRecord> Next() = 0;
 
-    virtual ColMeta get_col_offset(const TabCol &target) { return ColMeta();};
+    virtual ColMeta get_col_offset(const TabCol &target) { return *get_col(cols(), target); };
+
+    // EXPLAIN ANALYZE中附加在算子后面的运行统计，没有统计的算子返回空串
+    virtual std::string analyze_info() const { return ""; }
+
+    /**
+     * @brief 批量读取接口，在beginTuple之后调用，从当前元组开始返回下一批，没有更多元组时返回nullptr
+     * 返回的批中可能没有有效行（全部被过滤），调用方需要继续读取直到nullptr。
+     * 同一个算子只能使用元组接口或批量接口中的一种；默认实现通过元组接口逐个读取后拼成一批
+     */
+    virtual std::unique_ptr<RecordBatch> NextBatch() {
+        auto batch = std::make_unique<RecordBatch>(cols());
+        for (; !is_end() && !batch->full(); nextTuple()) {
+            auto rec = Next();
+            if (rec != nullptr) batch->append_row(rec->data);
+        }
+        if (batch->size() == 0) return nullptr;
+        return batch;
+    }
 
     std::vector<ColMeta>::const_iterator get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
 
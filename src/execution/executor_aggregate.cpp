@@ -10,16 +10,18 @@ See the Mulan PSL v2 for more details. */
 
 #include "executor_aggregate.h"
 
+#include "execution_join.h"
+#include "executor_gather.h"
+
 AggregateExecutor::AggregateExecutor(std::unique_ptr<AbstractExecutor> prev,
                                    std::vector<std::shared_ptr<ast::Col>> agg_exprs,
                                    std::vector<std::shared_ptr<ast::Col>> group_by_cols,
                                    std::vector<std::shared_ptr<ast::BinaryExpr>> having_conds,
                                    std::vector<std::shared_ptr<ast::Col>> select_cols,
                                    bool has_group_by,
-                                   bool has_having)
-    : prev_(std::move(prev)), context(nullptr), sm_manager_(nullptr) {
-    
-    dataMap.clear();
+                                   bool has_having,
+                                   size_t mem_budget)
+    : prev_(std::move(prev)), context(nullptr), sm_manager_(nullptr), memBudget(mem_budget) {
     
     int offset = 0;
     
@@ -85,6 +87,9 @@ AggregateExecutor::AggregateExecutor(std::unique_ptr<AbstractExecutor> prev,
             if (aggMeta.col.type == TYPE_STRING && aggMeta.ag_type == ast::AggFuncType::SUM) {
                 throw IncompatibleTypeError(coltype2str(aggMeta.col.type), "SUM function");
             }
+            if (aggMeta.col.type == TYPE_STRING && aggMeta.ag_type == ast::AggFuncType::AVG) {
+                throw IncompatibleTypeError(coltype2str(aggMeta.col.type), "AVG function");
+            }
             
             colMeta.tab_name = aCol->tab_name;
             colMeta.name = actual_col_name;
@@ -187,10 +192,40 @@ AggregateExecutor::AggregateExecutor(std::unique_ptr<AbstractExecutor> prev,
         havingConds.push_back(havingCondition);
     }
     
+    // 按字段名解析聚合所用字段在上游输出中的下标
+    for (auto& gCol : groupByCols) {
+        gCol.input_idx = FindInputCol(gCol.col);
+    }
+    for (auto& aggMeta : aggMetas) {
+        aggMeta.input_idx = FindInputCol(aggMeta.col);
+    }
+    for (auto& cond : havingConds) {
+        cond.agg_col.input_idx = FindInputCol(cond.agg_col.col);
+    }
+    InitSlots();
+    // 每个分组占用键、聚合状态、哈希值，以及哈希表中（负载不超过一半、扩容前后）至多4个槽位
+    size_t group_bytes = keyLen + stateLen + sizeof(uint64_t) + 4 * sizeof(uint32_t);
+    maxGroups = std::max<size_t>(memBudget / group_bytes, 1);
+    spillRow.resize(prev_->tupleLen());
+    
     tupleLength = GetTupleLen(aggMetas, groupByCols);
     resultIndex = 0;
 }
 
+// 同名字段以上游输出中最后一个为准
+int AggregateExecutor::FindInputCol(const ColMeta &col) const {
+    if (col.name.empty() || col.name == "*") {
+        return -1;
+    }
+    auto &prev_cols = prev_->cols();
+    for (int i = static_cast<int>(prev_cols.size()) - 1; i >= 0; i--) {
+        if (prev_cols[i].name == col.name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 void AggregateExecutor::GetCol(AggColMeta &aggMeta, ColMeta &colMeta) {
     switch (aggMeta.ag_type) {
         case ast::AggFuncType::SUM:
@@ -244,25 +279,222 @@ size_t AggregateExecutor::GetTupleLen(const std::vector<AggColMeta> &aggMetas, c
     return len;
 }
 
-void AggregateExecutor::beginTuple() {
-    groupByResults.clear();
-    dataMap.clear();
-    resultKeys.clear();
-    havingRes.clear();
-    count0 = false;
+namespace {
+
+template <typename T>
+T load(const char *data) {
+    T val;
+    memcpy(&val, data, sizeof(T));
+    return val;
+}
+
+// AVG的状态：整数字段用64位整数累加，避免溢出；浮点字段与SUM一样用float累加
+template <typename S>
+struct AvgState {
+    S sum;
+    int count;
+};
+
+// update用一行的字段值更新状态，merge合并同一分组的另一个状态；SUM/MIN/MAX的状态就是字段值，两者相同
+struct CountOp {
+    static void update(char *state, const char *, int) { (*reinterpret_cast<int *>(state))++; }
+    static void merge(char *dst, const char *src, int) { *reinterpret_cast<int *>(dst) += load<int>(src); }
+};
+
+template <typename T>
+struct SumOp {
+    static void update(char *state, const char *data, int) { *reinterpret_cast<T *>(state) += load<T>(data); }
+    static void merge(char *dst, const char *src, int len) { update(dst, src, len); }
+};
+
+template <typename S, typename T>
+struct AvgOp {
+    static void update(char *state, const char *data, int) {
+        auto *avg = reinterpret_cast<AvgState<S> *>(state);
+        avg->sum += load<T>(data);
+        avg->count++;
+    }
+    static void merge(char *dst, const char *src, int) {
+        auto *avg = reinterpret_cast<AvgState<S> *>(dst);
+        auto *other = reinterpret_cast<const AvgState<S> *>(src);
+        avg->sum += other->sum;
+        avg->count += other->count;
+    }
+};
+
+template <typename T>
+struct MinOp {
+    static void update(char *state, const char *data, int) {
+        T val = load<T>(data);
+        T &cur = *reinterpret_cast<T *>(state);
+        if (val < cur) cur = val;
+    }
+    static void merge(char *dst, const char *src, int len) { update(dst, src, len); }
+};
+
+template <typename T>
+struct MaxOp {
+    static void update(char *state, const char *data, int) {
+        T val = load<T>(data);
+        T &cur = *reinterpret_cast<T *>(state);
+        if (cur < val) cur = val;
+    }
+    static void merge(char *dst, const char *src, int len) { update(dst, src, len); }
+};
+
+// 字符串以0填充，按字节比较即可
+struct MinStrOp {
+    static void update(char *state, const char *data, int len) {
+        if (memcmp(data, state, len) < 0) memcpy(state, data, len);
+    }
+    static void merge(char *dst, const char *src, int len) { update(dst, src, len); }
+};
+
+struct MaxStrOp {
+    static void update(char *state, const char *data, int len) {
+        if (memcmp(data, state, len) > 0) memcpy(state, data, len);
+    }
+    static void merge(char *dst, const char *src, int len) { update(dst, src, len); }
+};
+
+template <typename Op>
+void update_batch(char *states, size_t state_len, size_t slot_offset, const uint32_t *groups,
+                  const RecordBatch &batch, int input_idx, int len) {
+    const char *col = input_idx >= 0 ? batch.column(input_idx) : nullptr;
+    size_t n = batch.num_selected();
+    for (size_t i = 0; i < n; i++) {
+        char *state = states + groups[i] * state_len + slot_offset;
+        Op::update(state, col == nullptr ? nullptr : col + batch.selected(i) * len, len);
+    }
+}
+
+struct AggOps {
+    AggBatchUpdateFn update;
+    AggMergeFn merge;
+};
+
+template <typename Op>
+AggOps make_ops() {
+    return {&update_batch<Op>, &Op::merge};
+}
+
+template <template <typename> class Op>
+AggOps typed_ops(ColType type) {
+    return type == TYPE_INT ? make_ops<Op<int>>() : make_ops<Op<float>>();
+}
+
+// 槽位的长度，MIN/MAX的字符串状态就是当前的最小/最大值
+size_t slot_len(const AggColMeta &meta) {
+    switch (meta.ag_type) {
+        case ast::AggFuncType::COUNT:
+        case ast::AggFuncType::COUNT_ALL:
+            return sizeof(int);
+        case ast::AggFuncType::AVG:
+            return meta.col.type == TYPE_INT ? sizeof(AvgState<int64_t>) : sizeof(AvgState<float>);
+        default:
+            return meta.col.len;
+    }
+}
+
+AggOps choose_ops(const AggColMeta &meta) {
+    switch (meta.ag_type) {
+        case ast::AggFuncType::COUNT:
+        case ast::AggFuncType::COUNT_ALL:
+            return make_ops<CountOp>();
+        case ast::AggFuncType::SUM:
+            return typed_ops<SumOp>(meta.col.type);
+        case ast::AggFuncType::AVG:
+            return meta.col.type == TYPE_INT ? make_ops<AvgOp<int64_t, int>>() : make_ops<AvgOp<float, float>>();
+        case ast::AggFuncType::MIN:
+            return meta.col.type == TYPE_STRING ? make_ops<MinStrOp>() : typed_ops<MinOp>(meta.col.type);
+        case ast::AggFuncType::MAX:
+            return meta.col.type == TYPE_STRING ? make_ops<MaxStrOp>() : typed_ops<MaxOp>(meta.col.type);
+        default:
+            throw std::runtime_error("Unknown AggFuncType");
+    }
+}
+
+}  // namespace
+
+// 确定分组键和各聚合槽位的布局
+void AggregateExecutor::InitSlots() {
+    keyLen = 0;
+    for (auto& gCol : groupByCols) {
+        ColMeta col = gCol.col;
+        col.offset = static_cast<int>(keyLen);
+        keyLen += col.len;
+        keyHasFloat = keyHasFloat || col.type == TYPE_FLOAT;
+        keyCols.push_back(col);
+    }
+
+    auto add_slot = [this](const AggColMeta &meta) {
+        AggOps ops = choose_ops(meta);
+        AggSlot slot{meta, stateLen, ops.update, ops.merge};
+        stateLen += (slot_len(meta) + 7) / 8 * 8;
+        slots.push_back(slot);
+        return slots.size() - 1;
+    };
+    for (auto& aggMeta : aggMetas) {
+        add_slot(aggMeta);
+    }
+    for (auto& cond : havingConds) {
+        havingSlots.push_back(cond.is_agg ? add_slot(cond.agg_col) : 0);
+    }
+}
+
+AggregateExecutor::~AggregateExecutor() {
+    ClosePartitions();
+}
+
+void AggregateExecutor::ClosePartitions() {
+    for (auto& part : spilling) {
+        fclose(part.file);
+    }
+    for (auto& part : pending) {
+        fclose(part.file);
+    }
+    spilling.clear();
+    pending.clear();
+}
+
+void AggregateExecutor::ResetTable(GroupTable &t) const {
+    t.numGroups = 0;
+    t.keys.clear();
+    t.states.clear();
+    t.hashes.clear();
+    t.keyBuf.resize(keyLen);
+    // 初始容量不超过内存预算能容纳的分组数
+    size_t capacity = 16;
+    while (capacity < std::min<size_t>(maxGroups, 512) * 2) capacity <<= 1;
+    t.table.assign(capacity, NIL);
+}
+
+void AggregateExecutor::ResetGroups() {
+    ResetTable(groups);
     resultIndex = 0;
-    prev_->beginTuple();
-    
-    // 如果没有group by，创建一个空键
-    if (groupByCols.empty()) {
-        std::vector<Value> key;
-        groupByResults[key] = std::vector<AggValue>(aggMetas.size());
-        resultKeys.push_back(key);
+}
+
+void AggregateExecutor::beginTuple() {
+    ClosePartitions();
+    ResetGroups();
+    level = 0;
+    totalGroups = 0;
+    peakMemory = 0;
+    spilledRows = 0;
+    spilledPartitions = 0;
+    parallelWorkers = 0;
+    parallelFallback = false;
+
+    auto gather = dynamic_cast<GatherExecutor *>(prev_.get());
+    if (gather == nullptr || !ProcessParallel(gather)) {
+        prev_->beginTuple();
+        while (auto batch = prev_->NextBatch()) {
+            ProcessBatch(groups, *batch, true);
+        }
     }
-    
-    // 处理空结果集的情况
-    if (prev_->is_end()) {
-        // 检查是否所有聚合函数都是COUNT
+
+    // 没有group by且输入为空时，只有全部是COUNT才输出一行0
+    if (groups.numGroups == 0 && groupByCols.empty()) {
         bool all_count = true;
         for (const auto& agg : aggMetas) {
             if (agg.ag_type != ast::AggFuncType::COUNT && agg.ag_type != ast::AggFuncType::COUNT_ALL) {
@@ -271,287 +503,330 @@ void AggregateExecutor::beginTuple() {
             }
         }
         if (all_count) {
-            count0 = true;
-        } else {
-            resultIndex++; // 跳过空结果
+            groups.numGroups = 1;
+            groups.keys.resize(keyLen);
+            groups.states.assign(stateLen, 0);
         }
-        return;
-    }
-    
-    // 处理所有元组
-    while (!prev_->is_end()) {
-        auto tuple = prev_->Next();
-        ProcessTuple(tuple);
-        dataMap.clear();
-        prev_->nextTuple();
     }
+    FinishPass();
     
     // 找到第一个满足having条件的结果
-    while (resultIndex < resultKeys.size() && !havingConds.empty() && !Check_Having_Conditions(resultKeys[resultIndex])) {
-        ++resultIndex;
-    }
+    SeekValidGroup();
 }
 
-void AggregateExecutor::ProcessTuple(std::unique_ptr<RmRecord> &tuple) {
-    // 读取数据到dataMap
-    for (const auto& col : prev_->cols()) {
-        dataMap[col.name] = tuple->data + col.offset;
+void AggregateExecutor::ProcessBatch(GroupTable &t, RecordBatch &batch, bool can_spill) {
+    size_t n = batch.num_selected();
+    t.rowGroups.resize(n);
+    bool spilled = false;
+    for (size_t i = 0; i < n; i++) {
+        t.rowGroups[i] = FindOrCreateGroup(t, batch, batch.selected(i), can_spill);
+        spilled = spilled || t.rowGroups[i] == NIL;
     }
-    
-    // 构建分组键
-    std::vector<Value> key;
-    for (const auto& gCol : groupByCols) {
-        char* data = dataMap[gCol.col.name];
-        Value val(gCol.col.type, data, gCol.col.len);
-        key.push_back(val);
+    // 写入分区的行从批中去掉，不参与本轮聚合
+    if (spilled) {
+        std::vector<uint16_t> sel;
+        size_t kept = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (t.rowGroups[i] == NIL) continue;
+            sel.push_back(static_cast<uint16_t>(batch.selected(i)));
+            t.rowGroups[kept++] = t.rowGroups[i];
+        }
+        batch.set_selection(std::move(sel));
     }
-    
-    // 如果是新的分组，初始化聚合结果
-    if (groupByResults.find(key) == groupByResults.end()) {
-        groupByResults[key] = std::vector<AggValue>(aggMetas.size());
-        resultKeys.push_back(key);
+    for (auto& slot : slots) {
+        slot.update(t.states.data(), stateLen, slot.offset, t.rowGroups.data(), batch, slot.meta.input_idx,
+                    slot.meta.col.len);
     }
-    
-    // 如果有having条件，初始化having结果
-    if (!havingConds.empty() && havingRes.find(key) == havingRes.end()) {
-        havingRes[key] = std::vector<AggValue>(havingConds.size());
+}
+
+/**
+ * @brief 查找第row行所属的分组，不存在时创建
+ * 新分组的COUNT/SUM/AVG状态置0，MIN/MAX状态取该行的值；
+ * can_spill且分组数已达到内存预算时把该行写入分区，返回NIL
+ */
+uint32_t AggregateExecutor::FindOrCreateGroup(GroupTable &t, const RecordBatch &batch, size_t row, bool can_spill) {
+    for (size_t i = 0; i < groupByCols.size(); i++) {
+        memcpy(t.keyBuf.data() + keyCols[i].offset, batch.value(groupByCols[i].input_idx, row), keyCols[i].len);
     }
-    
-    // 计算聚合值
-    std::vector<AggValue>& aggResult = groupByResults[key];
-    for (size_t i = 0; i < aggMetas.size(); i++) {
-        CalculateAggValue(aggMetas[i], aggResult[i]);
+    uint64_t hash = hash_join_key(t.keyBuf.data(), keyCols);
+    size_t pos;
+    uint32_t group = LookupGroup(t, t.keyBuf.data(), hash, &pos);
+    if (group != NIL) return group;
+    if (can_spill && t.numGroups >= maxGroups && level < MAX_SPILL_LEVEL) {
+        SpillRow(batch, row, hash);
+        return NIL;
     }
-    
-    // 计算having条件的聚合值
-    if (!havingConds.empty()) {
-        std::vector<AggValue>& havingResult = havingRes[key];
-        for (size_t i = 0; i < havingConds.size(); i++) {
-            const auto& cond = havingConds[i];
-            if (cond.is_agg) {
-                CalculateAggValue(cond.agg_col, havingResult[i]);
-            }
+
+    group = AddGroup(t, t.keyBuf.data(), hash, pos);
+    char *state = t.states.data() + group * stateLen;
+    for (auto& slot : slots) {
+        if (slot.meta.ag_type == ast::AggFuncType::MIN || slot.meta.ag_type == ast::AggFuncType::MAX) {
+            memcpy(state + slot.offset, batch.value(slot.meta.input_idx, row), slot.meta.col.len);
         }
     }
+    return group;
 }
 
-void AggregateExecutor::CalculateAggValue(const AggColMeta &aggMeta, AggValue& res) {
-    char* data = nullptr;
-    
-    // 对于COUNT(*)，不需要访问具体列数据
-    if (aggMeta.ag_type != ast::AggFuncType::COUNT_ALL && aggMeta.col.name != "*" && !aggMeta.col.name.empty()) {
-        auto it = dataMap.find(aggMeta.col.name);
-        if (it != dataMap.end()) {
-            data = it->second;
-        }
+// 查找键为key的分组，不存在时返回NIL，*pos为插入位置
+uint32_t AggregateExecutor::LookupGroup(const GroupTable &t, const char *key, uint64_t hash, size_t *pos) const {
+    uint64_t mask = t.table.size() - 1;
+    size_t p = hash & mask;
+    for (; t.table[p] != NIL; p = (p + 1) & mask) {
+        uint32_t group = t.table[p];
+        if (t.hashes[group] != hash) continue;
+        const char *group_key = t.keys.data() + group * keyLen;
+        bool equal = keyHasFloat ? compare_join_key(group_key, keyCols, key, keyCols) == 0
+                                 : memcmp(group_key, key, keyLen) == 0;
+        if (equal) return group;
     }
-    
-    switch (aggMeta.ag_type) {
-        case ast::AggFuncType::COUNT:
-        case ast::AggFuncType::COUNT_ALL:
-            res.type = TYPE_INT;
-            res.int_val++;
-            break;
-            
-        case ast::AggFuncType::SUM:
-            if (aggMeta.col.type == TYPE_INT) {
-                res.type = TYPE_INT;
-                res.int_val += *(int*)data;
-            } else if (aggMeta.col.type == TYPE_FLOAT) {
-                res.type = TYPE_FLOAT;
-                res.float_val += *(float*)data;
+    *pos = p;
+    return NIL;
+}
+
+// 在LookupGroup返回的位置插入新分组，聚合状态置0
+uint32_t AggregateExecutor::AddGroup(GroupTable &t, const char *key, uint64_t hash, size_t pos) {
+    uint32_t group = static_cast<uint32_t>(t.numGroups++);
+    t.table[pos] = group;
+    t.hashes.push_back(hash);
+    t.keys.insert(t.keys.end(), key, key + keyLen);
+    t.states.resize(t.numGroups * stateLen, 0);
+    if (t.numGroups * 2 > t.table.size()) {
+        Rehash(t, t.table.size() * 2);
+    }
+    return group;
+}
+
+void AggregateExecutor::Rehash(GroupTable &t, size_t capacity) {
+    t.table.assign(capacity, NIL);
+    uint64_t mask = capacity - 1;
+    for (size_t group = 0; group < t.numGroups; group++) {
+        size_t pos = t.hashes[group] & mask;
+        while (t.table[pos] != NIL) pos = (pos + 1) & mask;
+        t.table[pos] = static_cast<uint32_t>(group);
+    }
+}
+
+/**
+ * @brief 并行聚合
+ * 工作线程各自预聚合，预聚合的分组总数超过内存预算的一半时返回false，由调用方改为串行聚合；
+ * 之后每个合并任务负责若干个分区，把各线程中属于这些分区的分组合并到分区自己的哈希表中，最后按分区顺序拼接成groups
+ */
+bool AggregateExecutor::ProcessParallel(GatherExecutor *gather) {
+    int workers = gather->num_workers();
+    std::vector<GroupTable> locals(workers);
+    for (auto& t : locals) {
+        ResetTable(t);
+    }
+    std::atomic<size_t> total_groups{0};
+    std::atomic<bool> overflow{false};
+    size_t group_limit = std::max<size_t>(maxGroups / 2, 1);
+    gather->launch(
+        [&](int worker, std::unique_ptr<RecordBatch> batch) {
+            GroupTable &t = locals[worker];
+            size_t before = t.numGroups;
+            ProcessBatch(t, *batch, false);
+            if (t.numGroups > before && total_groups.fetch_add(t.numGroups - before) + t.numGroups - before > group_limit) {
+                overflow = true;
             }
-            break;
-            
-        case ast::AggFuncType::AVG:
-            res.count++;
-            if (aggMeta.col.type == TYPE_INT) {
-                res.type = TYPE_FLOAT;
-                res.float_val += *(int*)data;
-            } else if (aggMeta.col.type == TYPE_FLOAT) {
-                res.type = TYPE_FLOAT;
-                res.float_val += *(float*)data;
+            return !overflow;
+        },
+        [](int) {});
+    gather->wait();
+    parallelWorkers = workers;
+    if (overflow) {
+        parallelFallback = true;
+        return false;
+    }
+
+    std::vector<GroupTable> merged(MERGE_PARTITIONS);
+    TaskGroup tasks;
+    for (int w = 0; w < workers; w++) {
+        tasks.spawn([&, w]() {
+            for (size_t part = w; part < MERGE_PARTITIONS; part += workers) {
+                MergePartition(locals, part, merged[part]);
             }
-            break;
-            
-        case ast::AggFuncType::MAX:
-            if (aggMeta.col.type == TYPE_INT) {
-                if (!res.maxFlag) {
-                    res.int_val = *(int*)data;
-                    res.maxFlag = true;
-                }
-                res.type = TYPE_INT;
-                res.int_val = std::max(res.int_val, *(int*)data);
-            } else if (aggMeta.col.type == TYPE_FLOAT) {
-                if (!res.maxFlag) {
-                    res.float_val = *(float*)data;
-                    res.maxFlag = true;
-                }
-                res.type = TYPE_FLOAT;
-                res.float_val = std::max(res.float_val, *(float*)data);
-            } else if (aggMeta.col.type == TYPE_STRING) {
-                if (!res.maxFlag) {
-                    res.str_val = std::string(data, aggMeta.col.len);
-                    res.maxFlag = true;
-                }
-                res.type = TYPE_STRING;
-                res.str_val = std::max(res.str_val, std::string(data, aggMeta.col.len));
+        });
+    }
+    tasks.wait();
+
+    size_t memory = 0;
+    for (auto& t : locals) {
+        memory += t.memory();
+    }
+    for (auto& t : merged) {
+        memory += t.memory();
+    }
+    peakMemory = std::max(peakMemory, memory);
+    locals.clear();
+
+    for (auto& t : merged) {
+        groups.numGroups += t.numGroups;
+        groups.keys.insert(groups.keys.end(), t.keys.begin(), t.keys.end());
+        groups.states.insert(groups.states.end(), t.states.begin(), t.states.end());
+        t = GroupTable();
+    }
+    return true;
+}
+
+// 把各工作线程中哈希值最高几位等于part的分组合并到merged中
+void AggregateExecutor::MergePartition(std::vector<GroupTable> &locals, size_t part, GroupTable &merged) {
+    ResetTable(merged);
+    for (auto& t : locals) {
+        for (size_t group = 0; group < t.numGroups; group++) {
+            uint64_t hash = t.hashes[group];
+            if ((hash >> (64 - MERGE_PARTITION_BITS)) != part) continue;
+            const char *key = t.keys.data() + group * keyLen;
+            const char *src = t.states.data() + group * stateLen;
+            size_t pos;
+            uint32_t dst_group = LookupGroup(merged, key, hash, &pos);
+            if (dst_group == NIL) {
+                dst_group = AddGroup(merged, key, hash, pos);
+                memcpy(merged.states.data() + dst_group * stateLen, src, stateLen);
+                continue;
             }
-            break;
-            
-        case ast::AggFuncType::MIN:
-            if (aggMeta.col.type == TYPE_INT) {
-                if (!res.minFlag) {
-                    res.int_val = *(int*)data;
-                    res.minFlag = true;
-                }
-                res.type = TYPE_INT;
-                res.int_val = std::min(res.int_val, *(int*)data);
-            } else if (aggMeta.col.type == TYPE_FLOAT) {
-                if (!res.minFlag) {
-                    res.float_val = *(float*)data;
-                    res.minFlag = true;
-                }
-                res.type = TYPE_FLOAT;
-                res.float_val = std::min(res.float_val, *(float*)data);
-            } else if (aggMeta.col.type == TYPE_STRING) {
-                if (!res.minFlag) {
-                    res.str_val = std::string(data, aggMeta.col.len);
-                    res.minFlag = true;
-                }
-                res.type = TYPE_STRING;
-                res.str_val = std::min(res.str_val, std::string(data, aggMeta.col.len));
+            char *dst = merged.states.data() + dst_group * stateLen;
+            for (auto& slot : slots) {
+                slot.merge(dst + slot.offset, src + slot.offset, slot.meta.col.len);
             }
-            break;
-            
-        default:
-            throw std::runtime_error("Unknown AggFuncType");
+        }
     }
 }
 
-void AggregateExecutor::MergeKeyAndResult(const std::vector<Value>& key, const std::vector<AggValue>& result, RmRecord& record) {
-    char* data = record.data;
-    int offset = 0;
-    
-    // 合并分组键
-    for (size_t i = 0; i < key.size(); ++i) {
-        const Value& val = key[i];
-        const ColMeta& col = groupByCols[i].col;
-        
-        switch (col.type) {
-            case TYPE_INT:
-                *(int*)(data + offset) = val.int_val;
-                break;
-            case TYPE_FLOAT:
-                *(float*)(data + offset) = val.float_val;
-                break;
-            case TYPE_STRING:
-                memcpy(data + offset, val.str_val.c_str(), col.len);
-                break;
+// 按哈希值中本层对应的一段选择分区，从高位开始使用，与哈希表使用的低位错开
+void AggregateExecutor::SpillRow(const RecordBatch &batch, size_t row, uint64_t hash) {
+    if (spilling.empty()) {
+        spilling.resize(SPILL_FANOUT);
+        for (auto& part : spilling) {
+            part.level = level + 1;
+            part.file = tmpfile();
+            if (part.file == nullptr) throw UnixError();
         }
-        offset += col.len;
     }
-    
-    // 合并聚合结果
-    for (size_t i = 0; i < result.size(); ++i) {
-        const AggValue& aggVal = result[i];
-        const AggColMeta& aggMeta = aggMetas[i];
-        
-        // 根据聚合函数类型处理结果
-        switch (aggMeta.ag_type) {
-            case ast::AggFuncType::COUNT:
-            case ast::AggFuncType::COUNT_ALL:
-                *(int*)(data + offset) = aggVal.int_val;
-                break;
-            case ast::AggFuncType::AVG:
-                if (aggMeta.col.type == TYPE_INT) {
-                    float avg_val = static_cast<float>(aggVal.int_val) / aggVal.count;
-                    *(float*)(data + offset) = avg_val;
-                } else {
-                    float avg_val = aggVal.float_val / aggVal.count;
-                    *(float*)(data + offset) = avg_val;
-                }
-                break;
-            case ast::AggFuncType::SUM:
-            case ast::AggFuncType::MIN:
-            case ast::AggFuncType::MAX:
-                switch (aggMeta.col.type) {
-                    case TYPE_INT:
-                        *(int*)(data + offset) = aggVal.int_val;
-                        break;
-                    case TYPE_FLOAT:
-                        *(float*)(data + offset) = aggVal.float_val;
-                        break;
-                    case TYPE_STRING:
-                        memcpy(data + offset, aggVal.str_val.c_str(), aggMeta.col.len);
-                        break;
-                }
-                break;
+    size_t idx = (hash >> (64 - SPILL_FANOUT_BITS * (level + 1))) & (SPILL_FANOUT - 1);
+    SpillPartition &part = spilling[idx];
+    batch.gather_row(row, spillRow.data());
+    if (fwrite(spillRow.data(), spillRow.size(), 1, part.file) != 1) throw UnixError();
+    part.num_rows++;
+    spilledRows++;
+}
+
+// 一轮聚合结束：记录统计，把本轮写出的非空分区加入待聚合列表
+void AggregateExecutor::FinishPass() {
+    totalGroups += groups.numGroups;
+    peakMemory = std::max(peakMemory, groups.memory());
+    for (auto& part : spilling) {
+        if (part.num_rows == 0) {
+            fclose(part.file);
+            continue;
         }
-        // 根据聚合类型计算结果长度
-         switch (aggMeta.ag_type) {
-             case ast::AggFuncType::COUNT:
-             case ast::AggFuncType::COUNT_ALL:
-                 offset += sizeof(int);
-                 break;
-             case ast::AggFuncType::AVG:
-                 offset += sizeof(float);
-                 break;
-             case ast::AggFuncType::SUM:
-             case ast::AggFuncType::MIN:
-             case ast::AggFuncType::MAX:
-                 offset += aggMeta.col.len;
-                 break;
-             default:
-                 offset += aggMeta.col.len;
-                 break;
-         }
-    }
-}
-
-bool AggregateExecutor::Check_Having_Conditions(const std::vector<Value>& key) {
-    if (havingConds.empty()) {
-        return true;
+        rewind(part.file);
+        pending.push_back(part);
+        spilledPartitions++;
     }
-    
-    auto hRes = havingRes[key];
-    
+    spilling.clear();
+}
+
+// 读回一个分区重新聚合，分区中的行仍然可能写出到下一层分区
+void AggregateExecutor::LoadPartition() {
+    SpillPartition part = pending.back();
+    pending.pop_back();
+    ResetGroups();
+    level = part.level;
+
+    RecordBatch batch(prev_->cols());
+    size_t row_len = spillRow.size();
+    std::vector<char> buf(RecordBatch::CAPACITY * row_len);
+    for (size_t done = 0; done < part.num_rows;) {
+        size_t count = std::min(part.num_rows - done, RecordBatch::CAPACITY);
+        if (fread(buf.data(), row_len, count, part.file) != count) {
+            fclose(part.file);
+            throw UnixError();
+        }
+        batch.clear();
+        for (size_t i = 0; i < count; i++) {
+            batch.append_row(buf.data() + i * row_len);
+        }
+        ProcessBatch(groups, batch, true);
+        done += count;
+    }
+    fclose(part.file);
+    FinishPass();
+}
+
+// 从resultIndex开始找到下一个满足having条件的分组，内存中的分组输出完后继续聚合下一个分区
+void AggregateExecutor::SeekValidGroup() {
+    while (true) {
+        while (resultIndex < groups.numGroups && !Check_Having_Conditions(resultIndex)) {
+            ++resultIndex;
+        }
+        if (resultIndex < groups.numGroups || pending.empty()) return;
+        LoadPartition();
+    }
+}
+
+// 把聚合状态转换为输出值，输出的类型和长度同GetCol
+void AggregateExecutor::WriteAggValue(const AggSlot &slot, const char *state, char *out) const {
+    const char *data = state + slot.offset;
+    switch (slot.meta.ag_type) {
+        case ast::AggFuncType::AVG: {
+            float avg_val = 0;
+            if (slot.meta.col.type == TYPE_INT) {
+                auto *avg = reinterpret_cast<const AvgState<int64_t> *>(data);
+                if (avg->count > 0) avg_val = static_cast<float>(static_cast<double>(avg->sum) / avg->count);
+            } else {
+                auto *avg = reinterpret_cast<const AvgState<float> *>(data);
+                if (avg->count > 0) avg_val = avg->sum / avg->count;
+            }
+            memcpy(out, &avg_val, sizeof(float));
+            break;
+        }
+        case ast::AggFuncType::COUNT:
+        case ast::AggFuncType::COUNT_ALL:
+            memcpy(out, data, sizeof(int));
+            break;
+        default:
+            memcpy(out, data, slot.meta.col.len);
+            break;
+    }
+}
+
+bool AggregateExecutor::Check_Having_Conditions(size_t group) {
+    const char *state = groups.states.data() + group * stateLen;
     for (size_t i = 0; i < havingConds.size(); i++) {
         const auto& cond = havingConds[i];
         if (!cond.is_agg) continue;
-        
-        ColType left_t = hRes[i].type;
-        char* left = nullptr;
-        ColType right_t = cond.rhs_val.type;
-        char* right = nullptr;
-        
-        // 获取左值数据
-        if (left_t == TYPE_INT) {
-            left = (char*)&hRes[i].int_val;
-        } else if (left_t == TYPE_FLOAT) {
-            left = (char*)&hRes[i].float_val;
-        } else if (left_t == TYPE_STRING) {
-            left = (char*)hRes[i].str_val.c_str();
-        }
-        
-        // 获取右值数据
-        if (right_t == TYPE_INT) {
-            right = (char*)&cond.rhs_val.int_val;
-        } else if (right_t == TYPE_FLOAT) {
-            right = (char*)&cond.rhs_val.float_val;
-        } else if (right_t == TYPE_STRING) {
-            right = (char*)cond.rhs_val.str_val.c_str();
+        const AggSlot &slot = slots[havingSlots[i]];
+
+        ColType left_t = slot.meta.col.type;
+        int left_len = slot.meta.col.len;
+        if (slot.meta.ag_type == ast::AggFuncType::COUNT || slot.meta.ag_type == ast::AggFuncType::COUNT_ALL) {
+            left_t = TYPE_INT;
+            left_len = sizeof(int);
+        } else if (slot.meta.ag_type == ast::AggFuncType::AVG) {
+            left_t = TYPE_FLOAT;
+            left_len = sizeof(float);
         }
+        std::vector<char> left(left_len);
+        WriteAggValue(slot, state, left.data());
+        ColType right_t = cond.rhs_val.type;
         
         int cmp = 0;
         if (left_t == TYPE_INT && right_t == TYPE_FLOAT) {
-            float left_float = *(int*)left;
-            cmp = ix_compare((char*)&left_float, right, TYPE_FLOAT, sizeof(float));
+            float left_float = load<int>(left.data());
+            cmp = ix_compare((char*)&left_float, (char*)&cond.rhs_val.float_val, TYPE_FLOAT, sizeof(float));
         } else if (left_t == TYPE_FLOAT && right_t == TYPE_INT) {
-            float right_float = *(int*)right;
-            cmp = ix_compare(left, (char*)&right_float, TYPE_FLOAT, sizeof(float));
+            float right_float = cond.rhs_val.int_val;
+            cmp = ix_compare(left.data(), (char*)&right_float, TYPE_FLOAT, sizeof(float));
+        } else if (left_t == TYPE_STRING && right_t == TYPE_STRING) {
+            // 右值按字段长度以0填充后比较
+            std::vector<char> right(left_len, 0);
+            memcpy(right.data(), cond.rhs_val.str_val.data(), std::min<size_t>(left_len, cond.rhs_val.str_val.size()));
+            cmp = memcmp(left.data(), right.data(), left_len);
+        } else if (left_t == right_t) {
+            cmp = ix_compare(left.data(), left_t == TYPE_INT ? (char*)&cond.rhs_val.int_val : (char*)&cond.rhs_val.float_val,
+                             left_t, left_len);
         } else {
-            cmp = ix_compare(left, right, right_t, hRes[i].get_len());
+            throw IncompatibleTypeError(coltype2str(left_t), coltype2str(right_t));
         }
         
         switch (cond.op) {
@@ -569,9 +844,9 @@ bool AggregateExecutor::Check_Having_Conditions(const std::vector<Value>& key) {
 }
 
 void AggregateExecutor::nextTuple() {
-    do {
-        resultIndex++;
-    } while (resultIndex < resultKeys.size() && !havingConds.empty() && !Check_Having_Conditions(resultKeys[resultIndex]));
+    if (is_end()) return;
+    resultIndex++;
+    SeekValidGroup();
 }
 
 std::unique_ptr<RmRecord> AggregateExecutor::Next() {
@@ -579,22 +854,17 @@ std::unique_ptr<RmRecord> AggregateExecutor::Next() {
         return nullptr;
     }
     
-    if (count0) {
-        auto res = std::make_unique<RmRecord>(sizeof(int));
-        *(int*)res->data = 0;
-        return res;
-    }
-    
-    auto &key = resultKeys[resultIndex];
-    auto &result = groupByResults[key];
     auto res = std::make_unique<RmRecord>(tupleLength);
-    
-    MergeKeyAndResult(key, result, *res);
+    memcpy(res->data, groups.keys.data() + resultIndex * keyLen, keyLen);
+    const char *state = groups.states.data() + resultIndex * stateLen;
+    for (size_t i = 0; i < aggMetas.size(); i++) {
+        WriteAggValue(slots[i], state, res->data + colMetas[groupByCols.size() + i].offset);
+    }
     return res;
 }
 
 bool AggregateExecutor::is_end() const {
-    return resultIndex >= resultKeys.size();
+    return resultIndex >= groups.numGroups;
 }
 
 Rid &AggregateExecutor::rid() {
@@ -607,4 +877,13 @@ const std::vector<ColMeta> &AggregateExecutor::cols() const {
 
 size_t AggregateExecutor::tupleLen() const {
     return tupleLength;
-}
\ No newline at end of file
+}
+
+std::string AggregateExecutor::analyze_info() const {
+    std::string info;
+    if (parallelWorkers > 0) {
+        info = "Workers: " + std::to_string(parallelWorkers) + (parallelFallback ? " (fallback to serial), " : ", ");
+    }
+    return info + "Groups: " + std::to_string(totalGroups) + ", Peak Memory: " + std::to_string((peakMemory + 1023) / 1024) +
+           "kB, Spilled Rows: " + std::to_string(spilledRows) + ", Spill Partitions: " + std::to_string(spilledPartitions);
+}
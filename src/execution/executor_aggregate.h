@@ -10,9 +10,9 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <cstdint>
+#include <cstdio>
 #include <utility>
-#include <unordered_map>
-#include <map>
 #include "execution_defs.h"
 #include "execution_common.h"
 #include "executor_abstract.h"
@@ -20,33 +20,12 @@ See the Mulan PSL v2 for more details. */
 #include "system/sm.h"
 #include "parser/ast.h"
 
-// 聚合值结构体，继承自Value
-struct AggValue : public Value {
-    bool minFlag = false;
-    bool maxFlag = false;
-    int count = 0; // 用于AVG和COUNT计算
-    std::string colName;
-
-    AggValue() : Value() {
-        type = TYPE_INT;
-        int_val = 0;
-        minFlag = false;
-        maxFlag = false;
-        count = 0;
-    }
-
-    AggValue(const ColType& t, const char* val, int len) : Value(t, (char*)val, len) {
-        minFlag = false;
-        maxFlag = false;
-        count = 0;
-    }
-};
-
 // 聚合列元数据
 struct AggColMeta {
     ast::AggFuncType ag_type;
     ColMeta col;
     std::string alias;  // 别名
+    int input_idx = -1; // col在上游输出字段中的下标，COUNT(*)为-1
 };
 
 // Having条件
@@ -66,54 +45,126 @@ struct AggCol {
     std::string alias;
 };
 
-// Vector Value哈希器
-struct VectorValueHasher {
-    std::size_t operator()(const std::vector<Value>& vec) const {
-        std::size_t seed = vec.size();
-        for(const auto& val : vec) {
-            switch(val.type) {
-            case TYPE_INT:
-                seed ^= std::hash<int>{}(val.int_val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-                break;
-            case TYPE_FLOAT:
-                seed ^= std::hash<float>{}(val.float_val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-                break;
-            case TYPE_STRING:
-                seed ^= std::hash<std::string>{}(val.str_val) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-                break;
-            default:
-                break;
-            }
-        }
-        return seed;
-    }
+// 对一批中的所有有效行更新同一个聚合，groups[i]是第i个有效行所属的分组
+using AggBatchUpdateFn = void (*)(char *states, size_t state_len, size_t slot_offset, const uint32_t *groups,
+                                  const RecordBatch &batch, int input_idx, int len);
+
+// 把另一个分组的同一个聚合状态合并到dst中
+using AggMergeFn = void (*)(char *dst, const char *src, int len);
+
+// 一个聚合在分组状态中的槽位
+struct AggSlot {
+    AggColMeta meta;
+    size_t offset;              // 在分组状态中的偏移，按8字节对齐
+    AggBatchUpdateFn update;
+    AggMergeFn merge;
 };
 
+class GatherExecutor;
+
+/**
+ * @brief 分组聚合算子
+ * 分组键是各分组字段原样拼接成的定长字节串，哈希表使用开放定址（线性探测），只存放分组编号；
+ * 每个分组的键和聚合状态分别连续存放，聚合状态按聚合类型内联为定长槽位。
+ * 上游按批输入，先为批中每一行找到分组，再对每个聚合按列更新，更新函数按聚合类型和字段类型实例化。
+ * 分组数超过内存预算后不再创建新分组：已有分组的行照常聚合，新分组的行按哈希值写入临时文件中的分区，
+ * 内存中的分组输出完之后再逐个读回分区聚合，分区仍然放不下时按哈希值的下一段继续划分。
+ * 没有写出分区时分组按第一次出现的顺序输出。
+ * 上游是Gather时并行聚合：各工作线程先在自己的分组哈希表中预聚合，再按哈希值的最高几位把分组划分给各个合并任务，
+ * 合并任务之间没有共享的分组。预聚合的分组总数超过内存预算的一半时放弃并行结果，改为串行聚合（可以写出分区）
+ */
 class AggregateExecutor : public AbstractExecutor {
+public:
+    static constexpr size_t DEFAULT_MEM_BUDGET = 16 << 20;     // 默认内存预算（字节）
+
 private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr int SPILL_FANOUT_BITS = 4;                 // 每层分区使用的哈希值位数
+    static constexpr size_t SPILL_FANOUT = 1 << SPILL_FANOUT_BITS;
+    static constexpr int MAX_SPILL_LEVEL = 64 / SPILL_FANOUT_BITS;  // 哈希值用完后不再划分，超出预算也在内存中聚合
+    static constexpr int MERGE_PARTITION_BITS = 4;              // 并行聚合合并阶段按哈希值最高几位划分
+    static constexpr size_t MERGE_PARTITIONS = 1 << MERGE_PARTITION_BITS;
+
+    // 临时文件中的一个分区，按上游输出的格式保存元组
+    struct SpillPartition {
+        FILE *file = nullptr;
+        size_t num_rows = 0;
+        int level = 0;                        // 分区所在的层次，决定使用哈希值的哪一段
+    };
+
+    // 分组哈希表：开放定址（线性探测），只存放分组编号；并行聚合时每个工作线程各有一个
+    struct GroupTable {
+        size_t numGroups = 0;
+        std::vector<char> keys;               // 第i个分组的键位于keys[i * keyLen]
+        std::vector<char> states;             // 第i个分组的聚合状态位于states[i * stateLen]
+        std::vector<uint64_t> hashes;         // 第i个分组键的哈希值
+        std::vector<uint32_t> table;          // 存放分组编号
+        std::vector<char> keyBuf;             // 当前行的分组键
+        std::vector<uint32_t> rowGroups;      // 当前批每个有效行所属的分组
+
+        size_t memory() const {
+            return keys.capacity() + states.capacity() + hashes.capacity() * sizeof(uint64_t) +
+                   table.capacity() * sizeof(uint32_t);
+        }
+    };
+
     std::unique_ptr<AbstractExecutor> prev_;  // 上游执行器
     std::vector<AggColMeta> aggMetas;         // 聚合函数列表
     std::vector<AggColMeta> groupByCols;      // 分组字段列表
     std::vector<HavingCondition> havingConds; // having条件列表
-    std::unordered_map<std::vector<Value>, std::vector<AggValue>, VectorValueHasher> groupByResults; // 分组聚合结果
-    std::unordered_map<std::vector<Value>, std::vector<AggValue>, VectorValueHasher> havingRes; // having结果
     std::vector<ColMeta> colMetas;            // 输出列元数据
-    std::map<std::string, char*> dataMap;     // 字段名和数据的映射
     size_t tupleLength;                       // 每个元组的长度
-    std::vector<std::vector<Value>> resultKeys; // 聚合结果的键列表
     size_t resultIndex;                       // 当前结果索引
     Context* context;                         // 上下文信息
-    bool count0 = false;                      // 是否为空结果集
     SmManager* sm_manager_;
     Rid _abstract_rid;
+
+    // 分组哈希表
+    std::vector<ColMeta> keyCols;             // 分组字段，offset为在分组键中的偏移
+    size_t keyLen = 0;                        // 分组键的长度
+    bool keyHasFloat = false;                 // 分组键含浮点数时不能按字节比较（+0与-0相等）
+    std::vector<AggSlot> slots;               // 输出的聚合在前，having中的聚合在后
+    std::vector<size_t> havingSlots;          // 每个having条件对应的槽位下标
+    size_t stateLen = 0;                      // 每个分组聚合状态的长度
+    GroupTable groups;                        // 正在输出的分组
+
+    // 超出内存预算时的分区
+    size_t memBudget;                         // 内存预算（字节）
+    size_t maxGroups;                         // 内存预算内最多容纳的分组数
+    int level = 0;                            // 正在聚合的分区层次，0表示上游输入
+    std::vector<SpillPartition> spilling;     // 本轮正在写出的分区，没有写出时为空
+    std::vector<SpillPartition> pending;      // 等待聚合的分区
+    std::vector<char> spillRow;
+
+    // EXPLAIN ANALYZE统计
+    size_t totalGroups = 0;
+    size_t peakMemory = 0;                    // 各轮中分组哈希表占用内存的最大值（字节）
+    size_t spilledRows = 0;
+    size_t spilledPartitions = 0;
+    int parallelWorkers = 0;                  // 并行预聚合的工作线程数，0表示串行
+    bool parallelFallback = false;            // 并行预聚合超出预算，改为串行聚合
     
     // 辅助函数
     void GetCol(AggColMeta &aggMeta, ColMeta &colMeta);
     size_t GetTupleLen(const std::vector<AggColMeta> &aggMetas, const std::vector<AggColMeta> &groupByCols);
-    void ProcessTuple(std::unique_ptr<RmRecord> &tuple);
-    void CalculateAggValue(const AggColMeta &aggMeta, AggValue& res);
-    void MergeKeyAndResult(const std::vector<Value>& key, const std::vector<AggValue>& result, RmRecord& record);
-    bool Check_Having_Conditions(const std::vector<Value>& key);
+    int FindInputCol(const ColMeta &col) const;
+    void InitSlots();
+    void ProcessBatch(GroupTable &t, RecordBatch &batch, bool can_spill);
+    uint32_t FindOrCreateGroup(GroupTable &t, const RecordBatch &batch, size_t row, bool can_spill);
+    uint32_t LookupGroup(const GroupTable &t, const char *key, uint64_t hash, size_t *pos) const;
+    uint32_t AddGroup(GroupTable &t, const char *key, uint64_t hash, size_t pos);
+    void Rehash(GroupTable &t, size_t capacity);
+    void ResetTable(GroupTable &t) const;
+    void ResetGroups();
+    bool ProcessParallel(GatherExecutor *gather);
+    void MergePartition(std::vector<GroupTable> &locals, size_t part, GroupTable &merged);
+    void SpillRow(const RecordBatch &batch, size_t row, uint64_t hash);
+    void FinishPass();
+    void LoadPartition();
+    void SeekValidGroup();
+    void ClosePartitions();
+    void WriteAggValue(const AggSlot &slot, const char *state, char *out) const;
+    bool Check_Having_Conditions(size_t group);
     
 public:
     AggregateExecutor(std::unique_ptr<AbstractExecutor> prev,
@@ -122,7 +173,10 @@ public:
                      std::vector<std::shared_ptr<ast::BinaryExpr>> having_conds,
                      std::vector<std::shared_ptr<ast::Col>> select_cols,
                      bool has_group_by,
-                     bool has_having);
+                     bool has_having,
+                     size_t mem_budget = DEFAULT_MEM_BUDGET);
+
+    ~AggregateExecutor() override;
 
     void beginTuple() override;
     void nextTuple() override;
@@ -132,4 +186,5 @@ public:
     const std::vector<ColMeta> &cols() const override;
     size_t tupleLen() const override;
     std::string getType() override { return "AggregateExecutor"; }
+    std::string analyze_info() const override;
 };
\ No newline at end of file
@@ -68,7 +68,7 @@ public:
                     memcpy(key + offset,fh_->get_record(rid,context_)->data + index.cols[i].offset, index.cols[i].len);
                     offset = offset + index.cols[i].len;
                 }
-                ix_handler->delete_entry(key,context_->txn_);
+                ix_handler->delete_entry(key,rid,context_->txn_);
             }
 
             // 删除表中记录
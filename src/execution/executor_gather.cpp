@@ -0,0 +1,88 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "executor_gather.h"
+
+GatherExecutor::GatherExecutor(std::unique_ptr<AbstractExecutor> prev, int num_workers)
+    : prev_(std::move(prev)), num_workers_(std::max(num_workers, 1)) {
+    scan_ = dynamic_cast<ParallelSeqScanExecutor *>(prev_.get());
+    if (scan_ == nullptr) throw InternalError("Gather requires a parallel seq scan below it");
+}
+
+GatherExecutor::~GatherExecutor() {
+    stop();
+}
+
+void GatherExecutor::stop() {
+    scan_->cancel();
+    if (queue_ != nullptr) queue_->cancel();
+    tasks_.join();
+    queue_ = nullptr;
+    batch_ = nullptr;
+}
+
+void GatherExecutor::launch(BatchSink sink, std::function<void(int worker)> done) {
+    scan_->reset();
+    for (int i = 0; i < num_workers_; i++) {
+        tasks_.spawn([this, i, sink, done]() {
+            try {
+                scan_->scan_worker([&](std::unique_ptr<RecordBatch> batch) { return sink(i, std::move(batch)); });
+            } catch (...) {
+                scan_->cancel();
+                done(i);
+                throw;
+            }
+            done(i);
+        });
+    }
+}
+
+void GatherExecutor::beginTuple() {
+    stop();
+    queue_ = std::make_unique<ExchangeQueue>(2 * num_workers_, num_workers_);
+    launch([this](int, std::unique_ptr<RecordBatch> batch) { return queue_->push(std::move(batch)); },
+           [this](int) { queue_->producer_done(); });
+    next_batch();
+}
+
+void GatherExecutor::next_batch() {
+    batch_pos_ = 0;
+    do {
+        batch_ = queue_->pop();
+    } while (batch_ != nullptr && batch_->num_selected() == 0);
+    if (batch_ == nullptr) tasks_.wait();
+}
+
+void GatherExecutor::nextTuple() {
+    if (batch_ == nullptr) return;
+    if (++batch_pos_ >= batch_->num_selected()) next_batch();
+}
+
+std::unique_ptr<RmRecord> GatherExecutor::Next() {
+    if (batch_ == nullptr) return nullptr;
+    auto rec = std::make_unique<RmRecord>(tupleLen());
+    batch_->gather_row(batch_->selected(batch_pos_), rec->data);
+    return rec;
+}
+
+// 先返回元组接口当前所在批中剩余的行，之后直接转交队列中的批
+std::unique_ptr<RecordBatch> GatherExecutor::NextBatch() {
+    if (batch_ == nullptr) return nullptr;
+    if (batch_pos_ > 0) {
+        std::vector<uint16_t> rest;
+        for (size_t i = batch_pos_; i < batch_->num_selected(); i++) {
+            rest.push_back(static_cast<uint16_t>(batch_->selected(i)));
+        }
+        batch_->set_selection(std::move(rest));
+    }
+    auto batch = std::move(batch_);
+    next_batch();
+    return batch;
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <functional>
+
+#include "execution_defs.h"
+#include "execution_parallel.h"
+#include "executor_abstract.h"
+#include "executor_parallel_seq_scan.h"
+
+/**
+ * @brief 并行区域的边界（exchange）
+ * 在共享的WorkerPool上运行若干个工作线程，每个线程执行下方并行扫描的scan_worker。
+ * 单独使用时工作线程把批放入ExchangeQueue，本算子（NextBatch和元组接口）从队列中取批，相当于把并行的输入汇合成一路；
+ * 能够并行处理输入的父算子（并行聚合、并行哈希连接）用launch直接在工作线程中消费各自的批，不经过队列
+ */
+class GatherExecutor : public AbstractExecutor {
+   public:
+    // 在工作线程worker中处理一批，返回false表示不再需要更多的输入
+    using BatchSink = std::function<bool(int worker, std::unique_ptr<RecordBatch> batch)>;
+
+   private:
+    std::unique_ptr<AbstractExecutor> prev_;
+    ParallelSeqScanExecutor *scan_;
+    int num_workers_;
+    TaskGroup tasks_;
+
+    std::unique_ptr<ExchangeQueue> queue_;      // 单独使用时工作线程和本算子之间的队列
+    std::unique_ptr<RecordBatch> batch_;        // 元组接口当前所在的批
+    size_t batch_pos_ = 0;                      // 当前元组在batch_有效行中的下标
+
+    // 从队列中取出下一个有有效行的批，没有更多时batch_为空，并重新抛出工作线程中的异常
+    void next_batch();
+
+   public:
+    GatherExecutor(std::unique_ptr<AbstractExecutor> prev, int num_workers);
+
+    ~GatherExecutor() override;
+
+    int num_workers() const { return num_workers_; }
+
+    /**
+     * @brief 启动工作线程，各线程把输入的批依次交给sink
+     * 每个工作线程结束前（包括出错时）调用一次done(worker)；调用方之后用wait等待全部结束并取得异常
+     */
+    void launch(BatchSink sink, std::function<void(int worker)> done);
+
+    // 等待launch启动的工作线程全部结束，重新抛出其中的第一个异常
+    void wait() { tasks_.wait(); }
+
+    // 取消未完成的扫描并等待工作线程全部退出，忽略其中的异常
+    void stop();
+
+    void beginTuple() override;
+
+    void nextTuple() override;
+
+    std::unique_ptr<RmRecord> Next() override;
+
+    std::unique_ptr<RecordBatch> NextBatch() override;
+
+    bool is_end() const override { return batch_ == nullptr; }
+
+    size_t tupleLen() const override { return prev_->tupleLen(); }
+
+    const std::vector<ColMeta> &cols() const override { return prev_->cols(); }
+
+    std::string getType() override { return "GatherExecutor"; }
+
+    Rid &rid() override { return _abstract_rid; }
+};
@@ -0,0 +1,315 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "executor_hash_join.h"
+
+HashJoinExecutor::HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                                   std::vector<Condition> conds, bool build_left, size_t limit_hint) {
+    left_ = std::move(left);
+    right_ = std::move(right);
+    if (left_->tupleLen() == 0 || right_->tupleLen() == 0) {
+        throw InternalError("HashJoinExecutor::Constructor Error: left tupleLen=" + std::to_string(left_->tupleLen()) +
+                            ", right tupleLen=" + std::to_string(right_->tupleLen()));
+    }
+    len_ = left_->tupleLen() + right_->tupleLen();
+    cols_ = left_->cols();
+    auto right_cols = right_->cols();
+    for (auto &col : right_cols) {
+        col.offset += left_->tupleLen();
+    }
+    cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+    fed_conds_ = std::move(conds);
+    build_left_ = build_left;
+    probe_by_tuple_ = limit_hint > 0 && limit_hint < RecordBatch::CAPACITY;
+
+    std::vector<JoinKeyCol> keys;
+    split_join_conds(left_->cols(), right_->cols(), left_->tupleLen(), fed_conds_, &keys, &residual_);
+    if (keys.empty()) {
+        throw InternalError("HashJoinExecutor::Constructor Error: no equality join condition");
+    }
+    residual_pred_ = PredicateProgram(residual_, left_->tupleLen());
+    for (auto &key : keys) {
+        build_key_cols_.push_back(build_left_ ? key.left : key.right);
+        probe_key_cols_.push_back(build_left_ ? key.right : key.left);
+    }
+    build_len_ = build_child()->tupleLen();
+    probe_rec_ = std::make_unique<RmRecord>(probe_child()->tupleLen());
+    joined_ = std::make_unique<RmRecord>(len_);
+    build_gather_ = dynamic_cast<GatherExecutor *>(build_child());
+    probe_gather_ = dynamic_cast<GatherExecutor *>(probe_child());
+}
+
+HashJoinExecutor::~HashJoinExecutor() {
+    stop_probe();
+}
+
+/**
+ * @brief 读取build侧的全部元组并建立哈希表
+ */
+void HashJoinExecutor::build() {
+    if (build_gather_ != nullptr) {
+        build_parallel();
+    } else {
+        part_bits_ = 0;
+        parts_.assign(1, Partition());
+        Partition &part = parts_[0];
+        auto child = build_child();
+        child->beginTuple();
+        while (auto batch = child->NextBatch()) {
+            for (size_t i = 0; i < batch->num_selected(); i++) {
+                size_t pos = part.arena.size();
+                part.arena.resize(pos + build_len_);
+                batch->gather_row(batch->selected(i), part.arena.data() + pos);
+                part.hashes.push_back(hash_join_key(part.arena.data() + pos, build_key_cols_));
+            }
+        }
+        build_buckets(part);
+    }
+    build_rows_ = 0;
+    for (auto &part : parts_) {
+        build_rows_ += part.hashes.size();
+    }
+    built_ = true;
+}
+
+/**
+ * @brief 并行build
+ * 各工作线程把读到的元组按哈希值的最高几位放入自己的分区，全部读完之后每个任务负责若干个分区：
+ * 把各线程的同一分区拼接起来并建立桶
+ */
+void HashJoinExecutor::build_parallel() {
+    int workers = build_gather_->num_workers();
+    part_bits_ = PARALLEL_PARTITION_BITS;
+    size_t num_parts = size_t(1) << part_bits_;
+    std::vector<std::vector<Partition>> locals(workers, std::vector<Partition>(num_parts));
+    build_gather_->launch(
+        [&](int worker, std::unique_ptr<RecordBatch> batch) {
+            std::vector<char> rec(build_len_);
+            for (size_t i = 0; i < batch->num_selected(); i++) {
+                batch->gather_row(batch->selected(i), rec.data());
+                uint64_t hash = hash_join_key(rec.data(), build_key_cols_);
+                Partition &part = locals[worker][hash >> (64 - part_bits_)];
+                part.arena.insert(part.arena.end(), rec.begin(), rec.end());
+                part.hashes.push_back(hash);
+            }
+            return true;
+        },
+        [](int) {});
+    build_gather_->wait();
+
+    parts_.assign(num_parts, Partition());
+    TaskGroup tasks;
+    for (int w = 0; w < workers; w++) {
+        tasks.spawn([&, w]() {
+            for (size_t p = w; p < num_parts; p += workers) {
+                Partition &part = parts_[p];
+                for (auto &local : locals) {
+                    part.arena.insert(part.arena.end(), local[p].arena.begin(), local[p].arena.end());
+                    part.hashes.insert(part.hashes.end(), local[p].hashes.begin(), local[p].hashes.end());
+                    local[p] = Partition();
+                }
+                build_buckets(part);
+            }
+        });
+    }
+    tasks.wait();
+}
+
+// 桶的数量取不小于元组数两倍的2的幂；倒序插入链表头，使链表中的顺序与元组顺序一致
+void HashJoinExecutor::build_buckets(Partition &part) {
+    size_t n = part.hashes.size();
+    size_t num_buckets = 1;
+    while (num_buckets < n * 2) num_buckets <<= 1;
+    part.bucket_mask = num_buckets - 1;
+    part.buckets.assign(num_buckets, NIL);
+    part.next.assign(n, NIL);
+    for (size_t i = n; i-- > 0;) {
+        uint32_t &head = part.buckets[part.hashes[i] & part.bucket_mask];
+        part.next[i] = head;
+        head = static_cast<uint32_t>(i);
+    }
+}
+
+void HashJoinExecutor::beginTuple() {
+    stop_probe();
+    // build侧不依赖外层元组，作为嵌套循环的内层被重复扫描时复用已经建好的哈希表
+    if (!built_) build();
+    probe_batch_ = nullptr;
+    probe_pos_ = 0;
+    probe_started_ = false;
+    cur_part_ = nullptr;
+    cur_ = NIL;
+    if (build_rows_ == 0) {
+        isend_ = true;
+        return;
+    }
+    isend_ = false;
+    if (probe_gather_ != nullptr) {
+        launch_probe();
+    } else {
+        probe_child()->beginTuple();
+    }
+    advance();
+}
+
+void HashJoinExecutor::nextTuple() {
+    if (isend_) return;
+    advance();
+}
+
+// 从当前位置开始找到下一对匹配的元组，当前probe元组的桶链表检查完后再读取下一个probe元组
+void HashJoinExecutor::advance() {
+    if (out_queue_ != nullptr) {
+        next_output();
+        return;
+    }
+    while (true) {
+        while (cur_ != NIL) {
+            uint32_t idx = cur_;
+            cur_ = cur_part_->next[idx];
+            if (cur_part_->hashes[idx] == probe_hash_ && match(*cur_part_, idx, probe_rec_->data, joined_->data)) {
+                return;
+            }
+        }
+        if (!next_probe()) {
+            isend_ = true;
+            return;
+        }
+        probe_hash_ = hash_join_key(probe_rec_->data, probe_key_cols_);
+        cur_part_ = &partition_of(probe_hash_);
+        cur_ = cur_part_->buckets[probe_hash_ & cur_part_->bucket_mask];
+    }
+}
+
+// 把下一个probe元组读入probe_rec_，当前批读完时读取下一批，probe侧读完时返回false
+bool HashJoinExecutor::next_probe() {
+    if (probe_by_tuple_) {
+        // 用到下一个元组时才推进probe侧，输出最后一个需要的结果后不再多读
+        auto child = probe_child();
+        if (probe_started_) child->nextTuple();
+        probe_started_ = true;
+        for (; !child->is_end(); child->nextTuple()) {
+            auto rec = child->Next();
+            if (rec == nullptr) continue;
+            memcpy(probe_rec_->data, rec->data, child->tupleLen());
+            return true;
+        }
+        return false;
+    }
+    while (probe_batch_ == nullptr || probe_pos_ >= probe_batch_->num_selected()) {
+        probe_batch_ = probe_child()->NextBatch();
+        probe_pos_ = 0;
+        if (probe_batch_ == nullptr) return false;
+    }
+    probe_batch_->gather_row(probe_batch_->selected(probe_pos_++), probe_rec_->data);
+    return true;
+}
+
+// 检查分区中第idx个build元组与probe元组的连接键和剩余条件，匹配时把拼接结果写入joined
+bool HashJoinExecutor::match(const Partition &part, uint32_t idx, const char *probe_rec, char *joined) const {
+    const char *build_rec = part.arena.data() + idx * build_len_;
+    if (compare_join_key(build_rec, build_key_cols_, probe_rec, probe_key_cols_) != 0) return false;
+    const char *left_rec = build_left_ ? build_rec : probe_rec;
+    const char *right_rec = build_left_ ? probe_rec : build_rec;
+    if (!residual_pred_.eval(left_rec, right_rec)) return false;
+    memcpy(joined, left_rec, left_->tupleLen());
+    memcpy(joined + left_->tupleLen(), right_rec, right_->tupleLen());
+    return true;
+}
+
+// 并行probe：各工作线程探测自己的输入批，结果批满时放入out_queue_，结束时放入未满的结果批
+void HashJoinExecutor::launch_probe() {
+    int workers = probe_gather_->num_workers();
+    out_queue_ = std::make_unique<ExchangeQueue>(2 * workers, workers);
+    out_batches_.clear();
+    out_batches_.resize(workers);
+    out_batch_ = nullptr;
+    probe_gather_->launch(
+        [this](int worker, std::unique_ptr<RecordBatch> batch) { return probe_batch(worker, *batch); },
+        [this](int worker) {
+            auto &out = out_batches_[worker];
+            if (out != nullptr && out->size() > 0) out_queue_->push(std::move(out));
+            out_queue_->producer_done();
+        });
+}
+
+bool HashJoinExecutor::probe_batch(int worker, const RecordBatch &batch) {
+    auto &out = out_batches_[worker];
+    std::vector<char> probe_rec(probe_child()->tupleLen());
+    std::vector<char> joined(len_);
+    for (size_t i = 0; i < batch.num_selected(); i++) {
+        batch.gather_row(batch.selected(i), probe_rec.data());
+        uint64_t hash = hash_join_key(probe_rec.data(), probe_key_cols_);
+        const Partition &part = partition_of(hash);
+        for (uint32_t idx = part.buckets[hash & part.bucket_mask]; idx != NIL; idx = part.next[idx]) {
+            if (part.hashes[idx] != hash || !match(part, idx, probe_rec.data(), joined.data())) continue;
+            if (out == nullptr) out = std::make_unique<RecordBatch>(cols_);
+            out->append_row(joined.data());
+            if (out->full() && !out_queue_->push(std::move(out))) return false;
+        }
+    }
+    return true;
+}
+
+// 并行probe时把下一个连接结果读入joined_，工作线程全部结束时重新抛出其中的异常
+void HashJoinExecutor::next_output() {
+    if (out_batch_ != nullptr && out_pos_ + 1 < out_batch_->num_selected()) {
+        out_pos_++;
+    } else {
+        do {
+            out_batch_ = out_queue_->pop();
+        } while (out_batch_ != nullptr && out_batch_->num_selected() == 0);
+        if (out_batch_ == nullptr) {
+            isend_ = true;
+            probe_gather_->wait();
+            return;
+        }
+        out_pos_ = 0;
+    }
+    out_batch_->gather_row(out_batch_->selected(out_pos_), joined_->data);
+}
+
+// 取消未完成的并行probe并等待工作线程退出
+void HashJoinExecutor::stop_probe() {
+    if (out_queue_ == nullptr) return;
+    out_queue_->cancel();
+    probe_gather_->stop();
+    out_queue_ = nullptr;
+    out_batches_.clear();
+    out_batch_ = nullptr;
+}
+
+std::unique_ptr<RmRecord> HashJoinExecutor::Next() {
+    if (isend_) return nullptr;
+    return std::make_unique<RmRecord>(*joined_);
+}
+
+std::unique_ptr<RecordBatch> HashJoinExecutor::NextBatch() {
+    if (isend_) return nullptr;
+    if (out_queue_ != nullptr) {
+        // 并行probe时直接转交工作线程产生的结果批，去掉元组接口已经输出的行
+        if (out_pos_ > 0) {
+            std::vector<uint16_t> rest;
+            for (size_t i = out_pos_; i < out_batch_->num_selected(); i++) {
+                rest.push_back(static_cast<uint16_t>(out_batch_->selected(i)));
+            }
+            out_batch_->set_selection(std::move(rest));
+        }
+        auto batch = std::move(out_batch_);
+        next_output();
+        return batch;
+    }
+    auto batch = std::make_unique<RecordBatch>(cols_);
+    while (!isend_ && !batch->full()) {
+        batch->append_row(joined_->data);
+        advance();
+    }
+    return batch;
+}
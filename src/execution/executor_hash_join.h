@@ -0,0 +1,136 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_join.h"
+#include "execution_manager.h"
+#include "execution_predicate.h"
+#include "executor_abstract.h"
+#include "executor_gather.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @brief 等值连接的哈希连接算子
+ * 在较小的输入（build侧）上建立哈希表，另一侧（probe侧）逐条探测。build侧元组连续存放在arena_中，
+ * 每个元组的哈希值预先算好，桶内冲突用next_链起来，链中顺序与build侧的输出顺序一致。
+ * 输出元组的布局始终是左输入在前、右输入在后，与NestedLoopJoinExecutor相同。
+ * 两个输入都通过NextBatch按批读取，probe侧的一批元组逐个探测；上层预计只读取不到一批结果时（LIMIT下推）probe侧改为
+ * 逐个读取，不为凑满一批多读。
+ * 输入是Gather时并行执行：并行build时各工作线程按哈希值的最高几位把元组分到各自的分区中，之后每个分区由一个任务
+ * 合并并建立桶，分区之间互不相关；并行probe时各工作线程探测自己的输入批，把结果批放入本算子的ExchangeQueue
+ */
+class HashJoinExecutor : public AbstractExecutor {
+   private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr int PARALLEL_PARTITION_BITS = 4;   // 并行build时按哈希值最高几位划分分区
+
+    // 哈希表的一个分区，串行build时只有一个分区
+    struct Partition {
+        std::vector<char> arena;                // build侧元组，第i个元组位于arena[i * build_len_]
+        std::vector<uint64_t> hashes;           // 第i个元组连接键的哈希值
+        std::vector<uint32_t> next;             // 同一个桶中的下一个元组
+        std::vector<uint32_t> buckets;          // 每个桶中第一个元组
+        uint64_t bucket_mask = 0;
+    };
+
+    std::unique_ptr<AbstractExecutor> left_;
+    std::unique_ptr<AbstractExecutor> right_;
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件
+    bool build_left_;                           // 在左输入上建哈希表，否则在右输入上建
+    bool probe_by_tuple_;                       // 上层预计只读取不到一批结果（LIMIT下推），probe侧逐个读取
+
+    std::vector<ColMeta> build_key_cols_;       // build侧元组中的连接键
+    std::vector<ColMeta> probe_key_cols_;       // probe侧元组中的连接键，与build_key_cols_一一对应
+    std::vector<JoinResidualCond> residual_;    // 不能用哈希处理的连接条件
+    PredicateProgram residual_pred_;            // residual_编译后的形式
+
+    // 哈希表
+    size_t build_len_;
+    std::vector<Partition> parts_;
+    int part_bits_ = 0;                         // 选择分区使用的哈希值最高位数
+    size_t build_rows_ = 0;
+    bool built_ = false;
+    GatherExecutor *build_gather_;              // build侧是Gather时并行build，否则为空
+    GatherExecutor *probe_gather_;              // probe侧是Gather时并行probe，否则为空
+
+    // 探测状态
+    std::unique_ptr<RecordBatch> probe_batch_;  // 当前probe批
+    bool probe_started_ = false;                // 逐个读取时probe侧是否已经读过元组
+    size_t probe_pos_ = 0;                      // probe批中下一个待探测的有效行
+    std::unique_ptr<RmRecord> probe_rec_;       // 当前probe元组
+    uint64_t probe_hash_ = 0;
+    const Partition *cur_part_ = nullptr;       // 当前probe元组所在的分区
+    uint32_t cur_ = NIL;                        // 当前probe元组下一个待检查的build元组
+    std::unique_ptr<RmRecord> joined_;          // 当前输出的元组
+    bool isend_ = true;
+
+    // 并行probe
+    std::unique_ptr<ExchangeQueue> out_queue_;  // 工作线程产生的连接结果
+    std::vector<std::unique_ptr<RecordBatch>> out_batches_;    // 各工作线程正在填充的结果批
+    std::unique_ptr<RecordBatch> out_batch_;    // 元组接口当前所在的结果批
+    size_t out_pos_ = 0;                        // 当前元组在out_batch_有效行中的下标
+
+    AbstractExecutor *build_child() const { return build_left_ ? left_.get() : right_.get(); }
+
+    AbstractExecutor *probe_child() const { return build_left_ ? right_.get() : left_.get(); }
+
+    const Partition &partition_of(uint64_t hash) const {
+        return parts_[part_bits_ == 0 ? 0 : hash >> (64 - part_bits_)];
+    }
+
+    void build();
+
+    void build_parallel();
+
+    void build_buckets(Partition &part);
+
+    void advance();
+
+    bool next_probe();
+
+    bool match(const Partition &part, uint32_t idx, const char *probe_rec, char *joined) const;
+
+    void launch_probe();
+
+    bool probe_batch(int worker, const RecordBatch &batch);
+
+    void next_output();
+
+    void stop_probe();
+
+   public:
+    HashJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                     std::vector<Condition> conds, bool build_left, size_t limit_hint = 0);
+
+    ~HashJoinExecutor() override;
+
+    void beginTuple() override;
+
+    void nextTuple() override;
+
+    std::unique_ptr<RmRecord> Next() override;
+
+    std::unique_ptr<RecordBatch> NextBatch() override;
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "HashJoinExecutor"; }
+
+    bool is_end() const override { return isend_; }
+
+    Rid &rid() override { return _abstract_rid; }
+};
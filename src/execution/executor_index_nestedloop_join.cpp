@@ -0,0 +1,270 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "executor_index_nestedloop_join.h"
+
+#include <limits>
+#include <numeric>
+
+// 把索引key中的一个字段填成该类型的最小/最大值，用于前缀探测的范围上下界
+static void fill_key_limit(const ColMeta &col, char *dest, bool is_min) {
+    switch (col.type) {
+        case TYPE_INT: {
+            int val = is_min ? std::numeric_limits<int>::min() : std::numeric_limits<int>::max();
+            memcpy(dest, &val, sizeof(int));
+            break;
+        }
+        case TYPE_FLOAT: {
+            float val = is_min ? std::numeric_limits<float>::lowest() : std::numeric_limits<float>::max();
+            memcpy(dest, &val, sizeof(float));
+            break;
+        }
+        case TYPE_DATETIME: {
+            const char *val = is_min ? "0000-01-01 00:00:00" : "9999-12-31 23:59:59";
+            memcpy(dest, val, col.len);
+            break;
+        }
+        default:
+            memset(dest, is_min ? 0x00 : 0xff, col.len);
+    }
+}
+
+IndexNestedLoopJoinExecutor::IndexNestedLoopJoinExecutor(SmManager *sm_manager, std::unique_ptr<AbstractExecutor> outer,
+                                                         std::string inner_tab_name,
+                                                         std::vector<Condition> inner_conds,
+                                                         std::vector<std::string> index_col_names,
+                                                         std::vector<Condition> conds, bool inner_left,
+                                                         Context *context) {
+    sm_manager_ = sm_manager;
+    context_ = context;
+    outer_ = std::move(outer);
+    inner_tab_name_ = std::move(inner_tab_name);
+    inner_tab_ = sm_manager_->db_.get_table(inner_tab_name_);
+    inner_fh_ = sm_manager_->fhs_.at(inner_tab_name_).get();
+    index_meta_ = *(inner_tab_.get_index_meta(index_col_names));
+    ih_ = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(inner_tab_name_, index_col_names)).get();
+    inner_cols_ = inner_tab_.cols;
+    inner_len_ = inner_cols_.back().offset + inner_cols_.back().len;
+    inner_left_ = inner_left;
+    if (outer_->tupleLen() == 0) {
+        throw InternalError("IndexNestedLoopJoinExecutor::Constructor Error: outer tupleLen=0");
+    }
+
+    const std::vector<ColMeta> &left_cols = inner_left_ ? inner_cols_ : outer_->cols();
+    const std::vector<ColMeta> &right_cols = inner_left_ ? outer_->cols() : inner_cols_;
+    size_t left_len = inner_left_ ? inner_len_ : outer_->tupleLen();
+    len_ = inner_len_ + outer_->tupleLen();
+    cols_ = left_cols;
+    for (auto col : right_cols) {
+        col.offset += left_len;
+        cols_.push_back(col);
+    }
+    fed_conds_ = std::move(conds);
+
+    // 确保内层扫描条件的左侧是内层表的列
+    std::map<CompOp, CompOp> swap_op = {
+            {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
+    };
+    inner_conds_ = std::move(inner_conds);
+    for (auto &cond : inner_conds_) {
+        if (cond.lhs_col.tab_name != inner_tab_name_) {
+            std::swap(cond.lhs_col, cond.rhs_col);
+            cond.op = swap_op.at(cond.op);
+        }
+    }
+
+    std::vector<JoinKeyCol> keys;
+    split_join_conds(left_cols, right_cols, left_len, fed_conds_, &keys, &residual_);
+
+    // 按索引字段顺序拼出探测key的前缀，遇到第一个既不是连接键也没有等值常量的字段为止
+    std::vector<bool> key_used(keys.size(), false);
+    bool has_outer = false;
+    for (auto &index_col : index_meta_.cols) {
+        ProbePart part{};
+        part.len = index_col.len;
+        bool found = false;
+        for (size_t i = 0; i < keys.size() && !found; i++) {
+            const ColMeta &inner_col = inner_left_ ? keys[i].left : keys[i].right;
+            if (key_used[i] || inner_col.name != index_col.name) continue;
+            part.from_outer = true;
+            part.outer_col = inner_left_ ? keys[i].right : keys[i].left;
+            key_used[i] = true;
+            found = has_outer = true;
+        }
+        for (size_t i = 0; i < inner_conds_.size() && !found; i++) {
+            auto &cond = inner_conds_[i];
+            if (cond.op != OP_EQ || !cond.is_rhs_val || cond.lhs_col.col_name != index_col.name) continue;
+            part.from_outer = false;
+            part.value = cond.rhs_val.raw->data;
+            found = true;
+        }
+        if (!found) break;
+        probe_parts_.push_back(part);
+        prefix_len_ += part.len;
+    }
+    if (!has_outer) {
+        throw InternalError("IndexNestedLoopJoinExecutor::Constructor Error: no join key on index " +
+                            sm_manager_->get_ix_manager()->get_index_name(inner_tab_name_, index_col_names));
+    }
+    full_key_ = probe_parts_.size() == index_meta_.cols.size();
+    for (auto &index_col : index_meta_.cols) {
+        key_types_.push_back(index_col.type);
+        key_lens_.push_back(index_col.len);
+    }
+
+    // 没有用于探测的连接键仍需在拼接后的元组上检查
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (key_used[i]) continue;
+        ColMeta rhs = keys[i].right;
+        rhs.offset += left_len;
+        residual_.push_back(JoinResidualCond{keys[i].left, rhs, OP_EQ});
+    }
+    left_len_ = left_len;
+    inner_pred_ = PredicateProgram(inner_cols_, inner_conds_);
+    residual_pred_ = PredicateProgram(residual_, left_len);
+    joined_ = std::make_unique<RmRecord>(len_);
+}
+
+void IndexNestedLoopJoinExecutor::beginTuple() {
+    context_->lock_mgr_->lock_IS_on_table(context_->txn_, inner_fh_->GetFd());
+    outer_->beginTuple();
+    isend_ = false;
+    batch_count_ = 0;
+    batch_pos_ = 0;
+    match_pos_ = 0;
+    advance();
+}
+
+void IndexNestedLoopJoinExecutor::nextTuple() {
+    if (isend_) return;
+    advance();
+}
+
+/**
+ * @brief 读入下一批外层元组并探测索引
+ * @return 是否读到了外层元组
+ */
+bool IndexNestedLoopJoinExecutor::load_batch() {
+    size_t outer_len = outer_->tupleLen();
+    size_t key_len = index_meta_.col_tot_len;
+    outer_buf_.clear();
+    batch_count_ = 0;
+    batch_pos_ = 0;
+    match_pos_ = 0;
+    for (; batch_count_ < BATCH_SIZE && !outer_->is_end(); outer_->nextTuple()) {
+        auto rec = outer_->Next();
+        if (rec == nullptr) continue;
+        outer_buf_.insert(outer_buf_.end(), rec->data, rec->data + outer_len);
+        batch_count_++;
+    }
+    if (batch_count_ == 0) return false;
+
+    key_buf_.resize(batch_count_ * key_len);
+    for (size_t i = 0; i < batch_count_; i++) {
+        const char *outer_rec = outer_buf_.data() + i * outer_len;
+        char *key = key_buf_.data() + i * key_len;
+        for (auto &part : probe_parts_) {
+            memcpy(key, part.from_outer ? outer_rec + part.outer_col.offset : part.value, part.len);
+            key += part.len;
+        }
+    }
+    probe_batch();
+    return true;
+}
+
+// 完整key按顺序批量点查询，结果再按外层元组的原始顺序放回；前缀key逐个做范围扫描
+void IndexNestedLoopJoinExecutor::probe_batch() {
+    size_t key_len = index_meta_.col_tot_len;
+    matches_.assign(batch_count_, std::vector<Rid>());
+    if (!full_key_) {
+        for (size_t i = 0; i < batch_count_; i++) {
+            probe_range(key_buf_.data() + i * key_len, &matches_[i]);
+        }
+        return;
+    }
+    std::vector<size_t> order(batch_count_);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return ix_compare(key_buf_.data() + a * key_len, key_buf_.data() + b * key_len, key_types_, key_lens_) < 0;
+    });
+    std::vector<const char *> sorted_keys;
+    sorted_keys.reserve(batch_count_);
+    for (auto i : order) {
+        sorted_keys.push_back(key_buf_.data() + i * key_len);
+    }
+    std::vector<std::vector<Rid>> results;
+    ih_->get_values(sorted_keys, &results, context_->txn_);
+    for (size_t j = 0; j < batch_count_; j++) {
+        matches_[order[j]] = std::move(results[j]);
+    }
+}
+
+// 前缀之后的索引字段分别填最小、最大值作为上下界，扫描[lower_bound, upper_bound)
+void IndexNestedLoopJoinExecutor::probe_range(const char *key, std::vector<Rid> *rids) {
+    std::vector<char> lower(key, key + index_meta_.col_tot_len);
+    std::vector<char> upper(key, key + index_meta_.col_tot_len);
+    int offset = prefix_len_;
+    for (size_t i = probe_parts_.size(); i < index_meta_.cols.size(); i++) {
+        fill_key_limit(index_meta_.cols[i], lower.data() + offset, true);
+        fill_key_limit(index_meta_.cols[i], upper.data() + offset, false);
+        offset += index_meta_.cols[i].len;
+    }
+    IxScan scan(ih_, ih_->lower_bound(lower.data()), ih_->upper_bound(upper.data()), sm_manager_->get_bpm());
+    for (; !scan.is_end(); scan.next()) {
+        rids->push_back(scan.rid());
+    }
+}
+
+/**
+ * @brief 找到下一对满足所有条件的元组，写入joined_
+ * 依次回表读取当前外层元组匹配的记录，当前批处理完后读入下一批
+ */
+void IndexNestedLoopJoinExecutor::advance() {
+    size_t outer_len = outer_->tupleLen();
+    while (true) {
+        while (batch_pos_ < batch_count_) {
+            auto &rids = matches_[batch_pos_];
+            const char *outer_rec = outer_buf_.data() + batch_pos_ * outer_len;
+            while (match_pos_ < rids.size()) {
+                Rid rid = rids[match_pos_++];
+                std::unique_ptr<RmRecord> inner_rec;
+                try {
+                    inner_rec = inner_fh_->get_record(rid, context_);
+                } catch (RecordNotFoundError &e) {
+                    // 记录在当前事务快照中不可见，跳过
+                    continue;
+                }
+                if (!inner_pred_.eval(inner_rec->data)) continue;
+                if (inner_left_) {
+                    memcpy(joined_->data, inner_rec->data, inner_len_);
+                    memcpy(joined_->data + inner_len_, outer_rec, outer_len);
+                } else {
+                    memcpy(joined_->data, outer_rec, outer_len);
+                    memcpy(joined_->data + outer_len, inner_rec->data, inner_len_);
+                }
+                if (residual_pred_.eval(joined_->data, joined_->data + left_len_)) {
+                    context_->lock_mgr_->lock_shared_on_record(context_->txn_, rid, inner_fh_->GetFd());
+                    return;
+                }
+            }
+            batch_pos_++;
+            match_pos_ = 0;
+        }
+        if (!load_batch()) {
+            isend_ = true;
+            return;
+        }
+    }
+}
+
+std::unique_ptr<RmRecord> IndexNestedLoopJoinExecutor::Next() {
+    if (isend_) return nullptr;
+    return std::make_unique<RmRecord>(*joined_);
+}
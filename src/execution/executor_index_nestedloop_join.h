@@ -0,0 +1,105 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_join.h"
+#include "execution_manager.h"
+#include "execution_predicate.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @brief 索引嵌套循环连接算子
+ * 内层是带索引的基表：用外层元组的连接键（以及内层扫描条件中的等值常量）拼出索引key的前缀，
+ * 直接在内层表的索引上查找匹配的Rid再回表，不必扫描整个内层表。
+ * 外层元组按批读取：前缀覆盖全部索引字段时，一批key排序后用get_values顺序探测B+树（相邻的key大多落在同一个叶子上）；
+ * 只覆盖部分索引字段时对每个外层元组做一次范围扫描。
+ * 回表得到的记录还要检查内层扫描条件和不作为探测键的连接条件
+ */
+class IndexNestedLoopJoinExecutor : public AbstractExecutor {
+   private:
+    static constexpr size_t BATCH_SIZE = 256;   // 每批外层元组的数量
+
+    // 索引key前缀中的一个字段：来自外层元组的连接键，或者内层扫描条件中的等值常量
+    struct ProbePart {
+        bool from_outer;
+        ColMeta outer_col;                      // 外层元组中的字段
+        const char *value;                      // 常量，指向inner_conds_中条件的值
+        int len;
+    };
+
+    std::unique_ptr<AbstractExecutor> outer_;
+    SmManager *sm_manager_;
+    std::string inner_tab_name_;
+    TabMeta inner_tab_;
+    RmFileHandle *inner_fh_;
+    IxIndexHandle *ih_;
+    IndexMeta index_meta_;
+    std::vector<Condition> inner_conds_;        // 内层表上的扫描条件
+    PredicateProgram inner_pred_;               // inner_conds_编译后的形式
+    std::vector<ColMeta> inner_cols_;
+    size_t inner_len_;
+    bool inner_left_;                           // 内层表是计划的左输入，输出元组中内层在前
+
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件
+    std::vector<JoinResidualCond> residual_;    // 在拼接后的元组上检查的连接条件
+    PredicateProgram residual_pred_;            // residual_编译后的形式
+    size_t left_len_;                           // 拼接后元组中左输入的长度
+    std::vector<ProbePart> probe_parts_;        // 按索引字段顺序排列的key前缀
+    int prefix_len_ = 0;                        // key前缀的字节数
+    bool full_key_ = false;                     // 前缀覆盖了全部索引字段
+    std::vector<ColType> key_types_;            // 索引key各字段的类型和长度，用于排序一批探测key
+    std::vector<int> key_lens_;
+
+    std::vector<char> outer_buf_;               // 当前批的外层元组
+    size_t batch_count_ = 0;
+    std::vector<char> key_buf_;                 // 当前批每个外层元组的探测key
+    std::vector<std::vector<Rid>> matches_;     // 每个外层元组在索引中找到的Rid
+    size_t batch_pos_ = 0;                      // 当前外层元组在批中的下标
+    size_t match_pos_ = 0;                      // 当前外层元组下一个待检查的Rid
+
+    std::unique_ptr<RmRecord> joined_;
+    bool isend_ = true;
+
+    bool load_batch();
+
+    void probe_batch();
+
+    void probe_range(const char *key, std::vector<Rid> *rids);
+
+    void advance();
+
+   public:
+    IndexNestedLoopJoinExecutor(SmManager *sm_manager, std::unique_ptr<AbstractExecutor> outer,
+                                std::string inner_tab_name, std::vector<Condition> inner_conds,
+                                std::vector<std::string> index_col_names, std::vector<Condition> conds,
+                                bool inner_left, Context *context);
+
+    void beginTuple() override;
+
+    void nextTuple() override;
+
+    std::unique_ptr<RmRecord> Next() override;
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "IndexNestedLoopJoinExecutor"; }
+
+    bool is_end() const override { return isend_; }
+
+    Rid &rid() override { return _abstract_rid; }
+};
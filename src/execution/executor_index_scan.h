@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_predicate.h"
+#include "execution_scan_projection.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
@@ -25,21 +27,33 @@ class IndexScanExecutor : public AbstractExecutor {
     RmFileHandle *fh_;                          // 表的数据文件句柄
     std::vector<ColMeta> cols_;                 // 需要读取的字段
     size_t len_;                                // 选取出来的一条记录的长度
+    ScanProjection proj_;                       // 非index-only模式下只输出上层需要的字段
     std::vector<Condition> fed_conds_;          // 扫描条件，和conds_字段相同
+    PredicateProgram pred_;                     // conds_编译后的形式，检查从索引读出的每个元组（投影之前）
     std::vector<Condition> index_conds_;
     bool is_con_closed_;
     Condition con_closed_;
     std::vector<std::string> index_col_names_;  // index scan涉及到的索引包含的字段
     IndexMeta index_meta_;                      // index scan涉及到的索引元数据
+    bool index_only_;                           // 索引覆盖了所有引用列时，直接由叶子结点的key构造元组
+    std::unique_ptr<RmRecord> index_rec_;       // index-only模式下当前元组，布局与索引key一致
+    bool reverse_;                              // 是否沿叶子链表反向扫描（ORDER BY ... DESC）
+    bool point_lookup_ = false;                 // 唯一索引的所有字段都是等值条件，最多一条记录，直接用get_value点查询
+    bool point_end_ = true;                     // 点查询模式下是否已经输出完毕
 
     Rid rid_;
-    std::unique_ptr<RecScan> scan_;
+    std::unique_ptr<IxScan> scan_;
 
     SmManager *sm_manager_;
 
    public:
+    /**
+     * @param proj_cols 需要输出的字段名，为空时输出所有字段；index-only模式下不使用
+     * @param emit_rid 是否在输出元组末尾附加Rid，供最终投影回表读取其余字段
+     */
     IndexScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, std::vector<std::string> index_col_names,
-                      Context *context) {
+                      Context *context, bool index_only = false, bool reverse = false,
+                      const std::vector<std::string> &proj_cols = {}, bool emit_rid = false) {
         sm_manager_ = sm_manager;
         context_ = context;
         tab_name_ = std::move(tab_name);
@@ -48,9 +62,19 @@ class IndexScanExecutor : public AbstractExecutor {
         index_col_names_ = index_col_names;
         index_meta_ = *(tab_.get_index_meta(index_col_names_));
         fh_ = sm_manager_->fhs_.at(tab_name_).get();
-        cols_ = tab_.cols;
-        len_ = cols_.back().offset + cols_.back().len;
-        is_con_closed_ = false;
+        index_only_ = index_only;
+        reverse_ = reverse;
+        if (index_only_) {
+            // 输出元组只包含索引列，按索引key的布局重新计算偏移，key可以直接作为元组数据
+            int offset = 0;
+            for (auto col : index_meta_.cols) {
+                col.offset = offset;
+                offset += col.len;
+                cols_.push_back(col);
+            }
+            len_ = index_meta_.col_tot_len;
+            index_rec_ = std::make_unique<RmRecord>(static_cast<int>(len_));
+        }
         std::map<CompOp, CompOp> swap_op = {
                 {OP_EQ, OP_EQ}, {OP_NE, OP_NE}, {OP_LT, OP_GT}, {OP_GT, OP_LT}, {OP_LE, OP_GE}, {OP_GE, OP_LE},
         };
@@ -63,7 +87,14 @@ class IndexScanExecutor : public AbstractExecutor {
                 cond.op = swap_op.at(cond.op);
             }
         }
+        if (!index_only_) {
+            proj_ = ScanProjection(tab_.cols, proj_cols, emit_rid, conds_);
+            cols_ = proj_.cols();
+            len_ = proj_.len();
+        }
+        is_con_closed_ = false;
         fed_conds_ = conds_;
+        pred_ = PredicateProgram(index_only_ ? cols_ : tab_.cols, conds_);
 
         // 按照索引列的顺序处理条件
         std::vector<Condition> eq_conds;
@@ -116,6 +147,11 @@ class IndexScanExecutor : public AbstractExecutor {
             }
             break;
         }
+
+        point_lookup_ = index_meta_.unique && index_conds_.size() == index_meta_.cols.size();
+        for (auto &cond : index_conds_) {
+            if (cond.op != OP_EQ) point_lookup_ = false;
+        }
     }
 
 
@@ -123,8 +159,19 @@ class IndexScanExecutor : public AbstractExecutor {
     void beginTuple() override {
         context_->lock_mgr_->lock_IS_on_table(context_->txn_,fh_->GetFd());
         IxIndexHandle* ix_handle = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_,index_col_names_)).get();
+        if (index_conds_.empty()) {
+            // 没有可用于定界的条件（仅为了利用索引序），直接扫描整个叶子链表
+            scan_ = std::make_unique<IxScan>(ix_handle, ix_handle->leaf_begin(), ix_handle->leaf_end(),
+                                             sm_manager_->get_bpm(), reverse_);
+            seek_first();
+            return;
+        }
         char lower_bound[index_meta_.col_tot_len],upper_bound[index_meta_.col_tot_len];
         set_bound(lower_bound,upper_bound);
+        if (point_lookup_) {
+            begin_point_lookup(ix_handle, lower_bound);
+            return;
+        }
         int offset = 0,res = 0;
         for (auto & col : index_meta_.cols){
             res = ix_compare(lower_bound + offset, upper_bound + offset, col.type, col.len);
@@ -135,35 +182,49 @@ class IndexScanExecutor : public AbstractExecutor {
         if(res > 0){
             auto lower = ix_handle->leaf_end();
             auto upper = ix_handle->leaf_end();
-            scan_ = std::make_unique<IxScan>(ix_handle, lower, upper, sm_manager_->get_bpm());
+            scan_ = std::make_unique<IxScan>(ix_handle, lower, upper, sm_manager_->get_bpm(), reverse_);
         }
         else{
             auto lower = ix_handle->lower_bound(lower_bound);
             auto upper = ix_handle->upper_bound(upper_bound);
-            scan_ = std::make_unique<IxScan>(ix_handle, lower, upper, sm_manager_->get_bpm());
+            scan_ = std::make_unique<IxScan>(ix_handle, lower, upper, sm_manager_->get_bpm(), reverse_);
         }
-        while(!scan_->is_end()){
-            rid_ = scan_->rid();
-            try {
-                auto record = fh_->get_record(rid_,context_);
-                if(check_cons(conds_,record.get(),cols_)){
-                    context_->lock_mgr_->lock_shared_on_record(context_->txn_, rid_, fh_->GetFd());
-                    break;
+        seek_first();
+    }
+
+    // 点查询：get_value可以命中索引的点查询缓存，不必建立IxScan
+    void begin_point_lookup(IxIndexHandle *ix_handle, const char *key) {
+        std::vector<Rid> rids;
+        point_end_ = !ix_handle->get_value(key, &rids, context_->txn_);
+        if (point_end_) return;
+        rid_ = rids[0];
+        try {
+            if (index_only_) {
+                memcpy(index_rec_->data, key, len_);
+                if (!is_page_all_visible(rid_.page_no)) {
+                    auto record = fh_->get_record(rid_, context_);
+                    for (size_t i = 0; i < cols_.size(); ++i) {
+                        memcpy(index_rec_->data + cols_[i].offset, record->data + index_meta_.cols[i].offset, cols_[i].len);
+                    }
                 }
-            } catch (RecordNotFoundError &e) {
-                // 记录在当前事务快照中不可见，跳过
+                point_end_ = !pred_.eval(index_rec_->data);
+            } else {
+                auto record = fh_->get_record(rid_, context_);
+                point_end_ = !pred_.eval(record->data);
             }
-            scan_->next();
+        } catch (RecordNotFoundError &e) {
+            point_end_ = true;
+        }
+        if (!point_end_) {
+            context_->lock_mgr_->lock_shared_on_record(context_->txn_, rid_, fh_->GetFd());
         }
     }
 
-    void nextTuple() override {
-        scan_->next();
+    // 从scan_当前位置开始，找到第一条可见且满足条件的记录
+    void seek_first() {
         while(!scan_->is_end()){
-            rid_ = scan_->rid();
             try {
-                auto record = fh_->get_record(rid_,context_);
-                if(check_cons(conds_,record.get(),cols_)){
+                if(load_tuple()){
                     context_->lock_mgr_->lock_shared_on_record(context_->txn_, rid_, fh_->GetFd());
                     break;
                 }
@@ -174,8 +235,19 @@ class IndexScanExecutor : public AbstractExecutor {
         }
     }
 
+    void nextTuple() override {
+        if (point_lookup_) {
+            point_end_ = true;
+            return;
+        }
+        scan_->next();
+        seek_first();
+    }
+
     std::unique_ptr<RmRecord> Next() override {
-        return scan_->is_end()? nullptr:fh_->get_record(rid(),context_);
+        if (is_end()) return nullptr;
+        if (index_only_) return std::make_unique<RmRecord>(*index_rec_);
+        return proj_.apply(fh_->get_record(rid(), context_), rid_);
     }
 
     Rid &rid() override { return rid_; }
@@ -195,6 +267,7 @@ class IndexScanExecutor : public AbstractExecutor {
     }
 
     bool is_end() const override {
+        if (point_lookup_) return point_end_;
         return scan_->is_end();
     }
 
@@ -204,7 +277,7 @@ class IndexScanExecutor : public AbstractExecutor {
 
     void set_limit(const std::string& col_name,char* bound,int offset,int col_len,bool max_or_min = false){
         int int_max = max_or_min? -2147483648 : 2147483647;
-        float float_max = max_or_min? 1.175494E-38:3.402823E38;
+        float float_max = max_or_min? -3.402823E38:3.402823E38;
         char* datetime_max = const_cast<char *>(max_or_min ? "0000-01-01 00:00:00" : "9999-12-31 23:59:59");
         if (tab_.get_col(col_name)->type == TYPE_INT)
             memcpy(bound + offset,&int_max,col_len);
@@ -255,6 +328,34 @@ class IndexScanExecutor : public AbstractExecutor {
         }
     }
 
+    /**
+     * @brief 读取scan_当前位置的元组并检查条件
+     * index-only模式下先用叶子结点的key构造元组，只有堆页面不是all visible时才回表取可见版本
+     * @return 元组是否满足所有条件；不可见时由get_record抛出RecordNotFoundError
+     */
+    bool load_tuple() {
+        if (!index_only_) {
+            rid_ = scan_->rid();
+            auto record = fh_->get_record(rid_, context_);
+            return pred_.eval(record->data);
+        }
+        rid_ = scan_->entry(index_rec_->data);
+        if (!is_page_all_visible(rid_.page_no)) {
+            auto record = fh_->get_record(rid_, context_);
+            for (size_t i = 0; i < cols_.size(); ++i) {
+                memcpy(index_rec_->data + cols_[i].offset, record->data + index_meta_.cols[i].offset, cols_[i].len);
+            }
+        }
+        return pred_.eval(index_rec_->data);
+    }
+
+    bool is_page_all_visible(int page_no) {
+        if (context_ == nullptr || context_->txn_ == nullptr) {
+            return true;
+        }
+        return MVCCManager::get_instance().is_page_all_visible(fh_->GetFd(), page_no);
+    }
+
     bool get_condition(Condition last_neq_cond, std::vector<Condition> &other_conditions){
         auto op = last_neq_cond.op;
         if (op == OP_LE || op == OP_LT){ // <= || <
@@ -275,39 +376,4 @@ class IndexScanExecutor : public AbstractExecutor {
         return false;
     }
 
-    bool check_con (const Condition &cond, const RmRecord *record ,const std::vector<ColMeta> &cols_meta){
-        auto lhs_col = get_col(cols_meta,cond.lhs_col);
-        char *lhs_data = record->data + lhs_col->offset;
-        char *rhs_data;
-        ColType rhs_type;
-        if(cond.is_rhs_val){
-            rhs_type = cond.rhs_val.type;
-            rhs_data = cond.rhs_val.raw->data;
-        }else{
-            auto rhs_col = get_col(cols_meta, cond.rhs_col);
-            rhs_type = rhs_col->type;
-            rhs_data = record->data + rhs_col->offset;
-        }
-        char lhs_copy[lhs_col->len];
-        char rhs_copy[lhs_col->len];
-        memcpy(lhs_copy,lhs_data,lhs_col->len);
-        memcpy(rhs_copy,rhs_data,lhs_col->len);
-        int cmp = ix_compare(lhs_copy,rhs_copy,rhs_type,lhs_col->len);
-        if (cond.op == OP_EQ) return cmp == 0;
-        else if (cond.op == OP_NE) return cmp != 0;
-        else if (cond.op == OP_LT) return cmp < 0;
-        else if (cond.op == OP_LE) return cmp <= 0;
-        else if (cond.op == OP_GT) return cmp > 0;
-        else if (cond.op == OP_GE) return cmp >= 0;
-        else throw RMDBError("unexpected operation!");
-    }
-
-    bool check_cons(const std::vector<Condition> &conds, const RmRecord *record,const std::vector<ColMeta> &cols_meta){
-        for(auto &cond : conds){
-            if(!check_con(cond,record,cols_meta)){
-                return false;
-            }
-        }
-        return true;
-    }
 };
\ No newline at end of file
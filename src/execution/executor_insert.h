@@ -57,20 +57,20 @@ class InsertExecutor : public AbstractExecutor {
             memcpy(rec.data + col.offset, val.raw->data, col.len);
         }
 
-        // 唯一索引预检查
+        // 唯一索引预检查，非唯一索引允许重复的key
         for(auto & index : tab_.indexes) {
+            if (!index.unique) continue;
             auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
 
-            char* key = new char[index.col_tot_len];
+            char key[index.col_tot_len];
             int offset = 0;
             for(size_t j = 0; j < index.col_num; ++j) {
                 memcpy(key + offset, rec.data + index.cols[j].offset, index.cols[j].len);
                 offset += index.cols[j].len;
             }
 
-            auto leaf_node = ih->find_leaf_page(key,Operation::FIND,context_->txn_).first;
-            int idx = leaf_node->lower_bound(key);
-            if(!(idx == leaf_node->get_size() || ix_compare(leaf_node->get_key(idx),key,leaf_node->file_hdr->col_types_,leaf_node->file_hdr->col_lens_)!=0))
+            std::vector<Rid> rids;
+            if(ih->get_value(key, &rids, context_->txn_))
                 throw RMDBError("insert key not unique! --InsertExecutor::Next()");
         }
 
@@ -100,7 +100,7 @@ class InsertExecutor : public AbstractExecutor {
         for(size_t i = 0; i < tab_.indexes.size(); ++i) {
             auto& index = tab_.indexes[i];
             auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
-            char* key = new char[index.col_tot_len];
+            char key[index.col_tot_len];
             int offset = 0;
             for(size_t j = 0; j < index.col_num; ++j) {
                 memcpy(key + offset, rec.data + index.cols[j].offset, index.cols[j].len);
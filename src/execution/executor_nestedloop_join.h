@@ -11,13 +11,25 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "execution_defs.h"
+#include "execution_join.h"
 #include "execution_manager.h"
+#include "execution_predicate.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
+/**
+ * @brief 块嵌套循环连接
+ * 每次把不超过内存预算的一块左元组读入缓冲区，右输入对每一块只扫描一遍，
+ * 每个右元组与块内所有左元组逐一检查连接条件，右输入的扫描次数从左元组数降为块数。
+ * 上层只需要少量结果时（LIMIT下推）第一块只读入limit_hint个左元组，之后每块翻倍直到内存预算，
+ * 前几个结果不必等读完一整块左输入。输出顺序为：块内按右元组、同一右元组按左元组的顺序
+ */
 class NestedLoopJoinExecutor : public AbstractExecutor
 {
+public:
+    static constexpr size_t DEFAULT_BLOCK_MEM = 4 << 20;   // 默认每块左元组的内存预算（字节）
+
 private:
     std::unique_ptr<AbstractExecutor> left_;  // 左儿子节点（需要join的表）
     std::unique_ptr<AbstractExecutor> right_; // 右儿子节点（需要join的表）
@@ -25,13 +37,87 @@ private:
     std::vector<ColMeta> cols_;               // join后获得的记录的字段
 
     std::vector<Condition> fed_conds_; // join条件
+    std::vector<JoinResidualCond> conds_;     // join条件，字段偏移为拼接后元组中的偏移
+    PredicateProgram pred_;                   // conds_编译后的形式
     bool isend;
 
+    std::vector<char> block_;                 // 当前块的左元组
+    size_t block_cap_;                        // 每块最多容纳的左元组数
+    size_t first_block_cap_;                  // 第一块最多容纳的左元组数
+    size_t next_block_cap_ = 0;               // 下一块最多容纳的左元组数
+    size_t block_size_ = 0;                   // 当前块中的左元组数
+    size_t block_pos_ = 0;                    // 当前右元组下一个待检查的块内左元组
+    std::unique_ptr<RmRecord> right_rec_;     // 当前右元组
+    bool right_seen_ = false;                 // 右输入是否读到过元组
+    std::unique_ptr<RmRecord> joined_;
+
+    const char *block_tuple(size_t i) const { return block_.data() + i * left_->tupleLen(); }
 
+    // 读入下一块左元组，左输入已经读完时返回false
+    bool load_block()
+    {
+        size_t left_len = left_->tupleLen();
+        block_.clear();
+        block_size_ = 0;
+        block_pos_ = 0;
+        for (; block_size_ < next_block_cap_ && !left_->is_end(); left_->nextTuple())
+        {
+            auto rec = left_->Next();
+            if (rec == nullptr)
+                continue;
+            block_.insert(block_.end(), rec->data, rec->data + left_len);
+            block_size_++;
+        }
+        next_block_cap_ = std::min(next_block_cap_ * 2, block_cap_);
+        return block_size_ > 0;
+    }
+
+    // 找到下一对满足连接条件的元组，写入joined_
+    void advance()
+    {
+        size_t left_len = left_->tupleLen();
+        while (true)
+        {
+            if (right_rec_ != nullptr)
+            {
+                while (block_pos_ < block_size_)
+                {
+                    const char *left_rec = block_tuple(block_pos_++);
+                    if (pred_.eval(left_rec, right_rec_->data))
+                    {
+                        memcpy(joined_->data, left_rec, left_len);
+                        memcpy(joined_->data + left_len, right_rec_->data, right_->tupleLen());
+                        return;
+                    }
+                }
+                right_rec_ = nullptr;
+                right_->nextTuple();
+            }
+            while (right_rec_ == nullptr && !right_->is_end())
+            {
+                right_rec_ = right_->Next();
+                if (right_rec_ == nullptr)
+                    right_->nextTuple();
+            }
+            if (right_rec_ != nullptr)
+            {
+                right_seen_ = true;
+                block_pos_ = 0;
+                continue;
+            }
+            // 右输入为空时后面的块也不会有结果
+            if (!right_seen_ || !load_block())
+            {
+                isend = true;
+                return;
+            }
+            right_->beginTuple();
+        }
+    }
 
 public:
     NestedLoopJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
-                           std::vector<Condition> conds)
+                           std::vector<Condition> conds, size_t limit_hint = 0, size_t block_mem = DEFAULT_BLOCK_MEM)
     {
         left_ = std::move(left);
         right_ = std::move(right);
@@ -51,135 +137,52 @@ public:
         cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
         isend = false;
         fed_conds_ = std::move(conds);
-    }
 
+        // 条件两侧的列可以以任意顺序出现在左右输入中，连接键也作为普通条件检查
+        std::vector<JoinKeyCol> keys;
+        split_join_conds(left_->cols(), right_->cols(), left_->tupleLen(), fed_conds_, &keys, &conds_);
+        for (auto &key : keys)
+        {
+            ColMeta rhs = key.right;
+            rhs.offset += left_->tupleLen();
+            conds_.push_back(JoinResidualCond{key.left, rhs, OP_EQ});
+        }
+        pred_ = PredicateProgram(conds_, left_->tupleLen());
+        block_cap_ = std::max<size_t>(block_mem / left_->tupleLen(), 1);
+        first_block_cap_ = limit_hint > 0 ? std::min(limit_hint, block_cap_) : block_cap_;
+        joined_ = std::make_unique<RmRecord>(len_);
+    }
 
-        //2t
     void beginTuple() override
     {
         left_->beginTuple();
+        right_rec_ = nullptr;
+        isend = false;
+        next_block_cap_ = first_block_cap_;
+        if (!load_block())
+        {
+            isend = true;
+            return;
+        }
+        right_seen_ = false;
         right_->beginTuple();
+        advance();
     }
 
     void nextTuple() override
     {
-        // 需要一直往后找，直到符合条件的，或直到left和right都is_end
-        bool found_pair = false;
-        if (!right_->is_end())
-            right_->nextTuple();
-        while (!left_->is_end())
-        {
-            auto left_rec = left_->Next();
-            while (!right_->is_end() && !found_pair)
-            {
-                auto right_rec = right_->Next();
-                // check conds
-                if (check_conds(left_rec.get(), right_rec.get()))
-                {
-                    found_pair = true;
-                    return;
-                }
-                right_->nextTuple();
-            }
-            if (found_pair)
-            {
-                break;
-            }
-            right_->beginTuple();
-            left_->nextTuple();
-        }
-        isend = true;
-        return;
+        if (isend)
+            return;
+        advance();
     }
 
     std::unique_ptr<RmRecord> Next() override
     {
-        // 处理连接操作
-        assert(!isend);
-
-        // 获取左右表记录
-        auto left_rec = left_->Next();
-        auto right_rec = right_->Next();
-
-        // 调试输出 - 检查记录长度
-        if (static_cast<size_t>(left_rec->size) != static_cast<size_t>(left_->tupleLen()) || static_cast<size_t>(right_rec->size) != static_cast<size_t>(right_->tupleLen()))
-        {
-            throw InternalError("NestedLoopJoinExecutor::Next Error: left_rec size=" + std::to_string(left_rec->size) +
-                                ", left tupleLen=" + std::to_string(left_->tupleLen()) + "; right_rec size=" +
-                                std::to_string(right_rec->size) + ", right tupleLen=" +
-                                std::to_string(right_->tupleLen()));
-        }
-
-        // 调试：检查cols_向量初始化（示例，根据实际代码调整）
-        if (cols_.empty())
-        {
-            throw InternalError("NestedLoopJoinExecutor::Next Error: cols_ vector is empty");
-        }
-        for (size_t i = 0; i < cols_.size(); ++i)
-        {
-            // 由于 ColMeta 没有 GetOffset 和 GetLen 成员，推测使用 offset 和 len 成员替代
-            if (cols_[i].offset < 0 || cols_[i].len <= 0)
-            {
-                throw InternalError("NestedLoopJoinExecutor::Next Error: cols_ index=" + std::to_string(i) + " offset=" + std::to_string(cols_[i].offset) + " len=" + std::to_string(cols_[i].len));
-            }
-        }
-        // 创建新记录并合并数据
-        auto new_rec = std::make_unique<RmRecord>(len_);
-        memcpy(new_rec->data, left_rec->data, left_rec->size);
-        memcpy(new_rec->data + left_rec->size, right_rec->data, right_rec->size);
-
-        // 检查合并后的记录
-        if (static_cast<size_t>(new_rec->size) != static_cast<size_t>(len_))
-        {
-            throw InternalError(
-                "NestedLoopJoinExecutor::Next Error: merged record size=" + std::to_string(new_rec->size) +
-                ", expected=" + std::to_string(len_));
-        }
-
-        return new_rec;
+        if (isend)
+            return nullptr;
+        return std::make_unique<RmRecord>(*joined_);
     }
 
-    bool check_conds(RmRecord *left_rec, RmRecord *right_rec)
-    {
-        int len = fed_conds_.size();
-        if (!len)
-        {
-            return true;
-        }
-        bool ret = check_cond(left_rec, right_rec, fed_conds_[0]);
-        for (int i = 1; i < len; i++)
-        {
-            ret &= check_cond(left_rec, right_rec, fed_conds_[i]);
-            if (!ret)
-            {
-                return false;
-            }
-        }
-        return ret;
-    }
-
-    bool check_cond(RmRecord *left_rec, RmRecord *right_rec, Condition cond_) {
-        auto left_col_it = left_->get_col(left_->cols(), cond_.lhs_col);
-        auto right_col_it = right_->get_col(right_->cols(), cond_.rhs_col);
-        char *left_val = left_rec->data + left_col_it->offset;
-        char *right_val = right_rec->data + right_col_it->offset;
-        assert(left_col_it->type == right_col_it->type);
-        int cmp = ix_compare(left_val, right_val, right_col_it->type, right_col_it->len);
-        
-        switch (cond_.op) {
-            case OP_EQ: return cmp == 0;
-            case OP_NE: return cmp != 0;
-            case OP_LT: return cmp == -1;
-            case OP_GT: return cmp == 1;
-            case OP_LE: return cmp != 1;
-            case OP_GE: return cmp != -1;
-            default: throw InternalError("NestedLoopJoinExecutor::check_cond Error: unsupported operator");
-        }
-    }
-
-
-
-
     size_t tupleLen() const { return len_; };
     const std::vector<ColMeta> &cols() const
     {
@@ -193,4 +196,4 @@ public:
     Rid &rid() override { return _abstract_rid; }
 
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,60 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "executor_parallel_seq_scan.h"
+
+ParallelSeqScanExecutor::ParallelSeqScanExecutor(SmManager *sm_manager, std::string tab_name,
+                                                 std::vector<Condition> conds, Context *context,
+                                                 const std::vector<std::string> &proj_cols, bool emit_rid)
+    : tab_name_(std::move(tab_name)), fed_conds_(std::move(conds)) {
+    TabMeta &tab = sm_manager->db_.get_table(tab_name_);
+    fh_ = sm_manager->fhs_.at(tab_name_).get();
+    proj_ = ScanProjection(tab.cols, proj_cols, emit_rid, fed_conds_);
+    cols_ = proj_.cols();
+    len_ = proj_.len();
+    context_ = context;
+    preds_ = make_batch_predicates(proj_.read_cols(), fed_conds_);
+}
+
+void ParallelSeqScanExecutor::reset() {
+    num_morsels_ = 0;
+    // 扫描开始时的页数之后追加的页面不在当前事务的快照中
+    cursor_ = std::make_unique<MorselCursor>(RM_FIRST_RECORD_PAGE, fh_->get_file_hdr().num_pages);
+}
+
+void ParallelSeqScanExecutor::scan_worker(const std::function<bool(std::unique_ptr<RecordBatch>)> &sink) {
+    int num_slots = fh_->get_file_hdr().num_records_per_page;
+    auto batch = std::make_unique<RecordBatch>(proj_.read_cols());
+    std::vector<Rid> rids;
+    std::vector<Rid> *rids_out = proj_.emit_rid() ? &rids : nullptr;
+    // 批满或者扫描结束时过滤并交给sink
+    auto flush = [&]() {
+        filter_batch(batch.get(), preds_);
+        bool ok = batch->num_selected() == 0 || sink(proj_.apply(std::move(batch), rids));
+        batch = std::make_unique<RecordBatch>(proj_.read_cols());
+        rids.clear();
+        return ok;
+    };
+    int begin, end;
+    while (cursor_->claim(&begin, &end)) {
+        num_morsels_++;
+        for (int page = begin; page < end; page++) {
+            for (int slot = 0; slot < num_slots;) {
+                SeqScanExecutor::read_page(fh_, page, &slot, batch.get(), context_, rids_out);
+                if (batch->full() && !flush()) return;
+            }
+        }
+    }
+    if (batch->size() > 0) flush();
+}
+
+std::string ParallelSeqScanExecutor::analyze_info() const {
+    return "Morsels: " + std::to_string(num_morsels_.load());
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "execution_defs.h"
+#include "execution_parallel.h"
+#include "executor_abstract.h"
+#include "executor_seq_scan.h"
+#include "system/sm.h"
+
+/**
+ * @brief 并行顺序扫描
+ * 本身不启动线程，由上方的GatherExecutor在各工作线程中调用scan_worker：每个线程从共享的MorselCursor领取一段页面，
+ * 用SeqScanExecutor::read_page按当前事务的快照读取可见记录，在本线程内对整批求值过滤条件，把非空的批交给调用方。
+ * 输出顺序不确定，只用于查询，不提供rid()；延迟物化需要的Rid作为字段附加在输出元组中
+ */
+class ParallelSeqScanExecutor : public AbstractExecutor {
+   private:
+    std::string tab_name_;
+    std::vector<Condition> fed_conds_;
+    RmFileHandle *fh_;
+    std::vector<ColMeta> cols_;
+    size_t len_;
+    ScanProjection proj_;                       // 只输出上层需要的字段，cols_和len_取自其中
+    std::vector<BatchPredicate> preds_;         // fed_conds_解析为proj_.read_cols()中的下标，各工作线程共享（只读）
+
+    std::unique_ptr<MorselCursor> cursor_;
+    std::atomic<size_t> num_morsels_{0};         // 已领取的morsel数，EXPLAIN ANALYZE统计
+
+   public:
+    ParallelSeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds,
+                            Context *context, const std::vector<std::string> &proj_cols = {}, bool emit_rid = false);
+
+    // 开始新一轮扫描，在启动工作线程之前调用
+    void reset();
+
+    /**
+     * @brief 在工作线程中调用：反复领取morsel并读取、过滤，把非空的批交给sink
+     * sink返回false（消费者不再需要结果）或者所有morsel都被领取后返回，批可以跨越多个morsel
+     */
+    void scan_worker(const std::function<bool(std::unique_ptr<RecordBatch>)> &sink);
+
+    // 让正在运行的scan_worker领取完当前morsel后尽快返回
+    void cancel() {
+        if (cursor_ != nullptr) cursor_->cancel();
+    }
+
+    void beginTuple() override { throw InternalError("Parallel seq scan must run under a gather"); }
+
+    void nextTuple() override { throw InternalError("Parallel seq scan must run under a gather"); }
+
+    std::unique_ptr<RmRecord> Next() override { throw InternalError("Parallel seq scan must run under a gather"); }
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "ParallelSeqScanExecutor"; }
+
+    Rid &rid() override { return _abstract_rid; }
+
+    std::string analyze_info() const override;
+};
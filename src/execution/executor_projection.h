@@ -10,31 +10,74 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <algorithm>
+#include <functional>
+
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_scan_projection.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
 
 class ProjectionExecutor : public AbstractExecutor {
 private:
+    // 延迟物化的表：输入元组中只有它的Rid，投影时回表读取只在select列表中出现的字段
+    struct LateTable {
+        RmFileHandle *fh;
+        size_t rid_idx;                             // LATE_RID_COL字段在输入中的下标
+    };
+
+    static constexpr size_t NOT_LATE = static_cast<size_t>(-1);
+
     std::unique_ptr<AbstractExecutor> prev_;        // 投影节点的儿子节点
     std::vector<ColMeta> cols_;                     // 需要投影的字段
     size_t len_;                                    // 字段总长度
-    std::vector<size_t> sel_idxs_;
+    std::vector<size_t> sel_idxs_;                  // 输入中的字段下标，延迟物化的字段为其在表中的下标
+    std::vector<size_t> late_tabs_;                 // 每个字段所属的late_tables_下标，NOT_LATE表示字段在输入中
+    std::vector<LateTable> late_tables_;
+    std::vector<std::vector<ColMeta>> late_tab_cols_;   // 延迟物化的表的所有字段
 
     Rid rid_;
 
 public:
-    ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols) {
+    /**
+     * @param late_tabs 延迟物化的表，sel_cols中这些表不在输入里的字段按输入元组中的Rid回表读取
+     */
+    ProjectionExecutor(std::unique_ptr<AbstractExecutor> prev, const std::vector<TabCol> &sel_cols,
+                       SmManager *sm_manager = nullptr, const std::vector<std::string> &late_tabs = {},
+                       Context *context = nullptr) {
         prev_ = std::move(prev);
+        context_ = context;
 
         size_t curr_offset = 0;
         auto &prev_cols = prev_->cols();
         for (auto &sel_col: sel_cols) {
-            auto pos = get_col(prev_cols, sel_col);
-            sel_idxs_.push_back(pos - prev_cols.begin());
-            auto col = *pos;
+            auto late = std::find(late_tabs.begin(), late_tabs.end(), sel_col.tab_name);
+            bool in_prev = std::any_of(prev_cols.begin(), prev_cols.end(), [&](const ColMeta &col) {
+                return (sel_col.tab_name.empty() || col.tab_name == sel_col.tab_name) && col.name == sel_col.col_name;
+            });
+            ColMeta col;
+            if (in_prev || late == late_tabs.end()) {
+                auto pos = get_col(prev_cols, sel_col);
+                sel_idxs_.push_back(pos - prev_cols.begin());
+                late_tabs_.push_back(NOT_LATE);
+                col = *pos;
+            } else {
+                size_t idx = late - late_tabs.begin();
+                if (late_tables_.empty()) {
+                    for (auto &tab_name : late_tabs) {
+                        auto rid_pos = get_col(prev_cols, {.tab_name = tab_name, .col_name = LATE_RID_COL});
+                        late_tables_.push_back({sm_manager->fhs_.at(tab_name).get(),
+                                                static_cast<size_t>(rid_pos - prev_cols.begin())});
+                        late_tab_cols_.push_back(sm_manager->db_.get_table(tab_name).cols);
+                    }
+                }
+                auto pos = get_col(late_tab_cols_[idx], sel_col);
+                sel_idxs_.push_back(pos - late_tab_cols_[idx].begin());
+                late_tabs_.push_back(idx);
+                col = *pos;
+            }
             col.offset = curr_offset;
             curr_offset += col.len;
             cols_.push_back(col);
@@ -42,6 +85,17 @@ public:
         len_ = curr_offset;
     }
 
+    // 回表读取各延迟物化的表中当前元组对应的记录，rid_of(i)返回输入中第i个字段的数据
+    std::vector<std::unique_ptr<RmRecord>> fetch_late(const std::function<const char *(size_t rid_idx)> &rid_of) {
+        std::vector<std::unique_ptr<RmRecord>> recs;
+        for (auto &late : late_tables_) {
+            Rid rid;
+            memcpy(&rid, rid_of(late.rid_idx), sizeof(Rid));
+            recs.push_back(late.fh->get_record(rid, context_));
+        }
+        return recs;
+    }
+
     //2t
     void beginTuple() override {
         prev_->beginTuple();
@@ -65,12 +119,20 @@ public:
         }
 
         auto result = std::make_unique<RmRecord>(static_cast<int>(len_));
-
+        std::vector<std::unique_ptr<RmRecord>> late_recs;
+        if (!late_tables_.empty()) {
+            late_recs = fetch_late([&](size_t idx) { return prev_record->data + prev_->cols()[idx].offset; });
+        }
 
         for (size_t i = 0; i < cols().size(); ++i) {
             size_t src_idx = sel_idxs_[i];
-            const auto &src_col = prev_->cols()[src_idx];
             const auto &dst_col = cols()[i];
+            if (late_tabs_[i] != NOT_LATE) {
+                const auto &src_col = late_tab_cols_[late_tabs_[i]][src_idx];
+                memcpy(result->data + dst_col.offset, late_recs[late_tabs_[i]]->data + src_col.offset, dst_col.len);
+                continue;
+            }
+            const auto &src_col = prev_->cols()[src_idx];
 
 
             memcpy(result->data + dst_col.offset,
@@ -82,6 +144,47 @@ public:
     }
 
 
+    // 投影只重新排列列向量：每个输入列第一次被选中时直接移交列向量，重复选中的列才需要拷贝；
+    // 延迟物化的字段只对有效行回表读取
+    std::unique_ptr<RecordBatch> NextBatch() override {
+        auto in = prev_->NextBatch();
+        if (in == nullptr) {
+            return nullptr;
+        }
+        auto out = std::make_unique<RecordBatch>(cols_, false);
+        if (!late_tables_.empty()) {
+            for (size_t i = 0; i < cols_.size(); ++i) {
+                if (late_tabs_[i] != NOT_LATE) out->column_buffer(i).resize(RecordBatch::CAPACITY * cols_[i].len);
+            }
+            for (size_t k = 0; k < in->num_selected(); ++k) {
+                size_t row = in->selected(k);
+                auto late_recs = fetch_late([&](size_t idx) { return in->value(idx, row); });
+                for (size_t i = 0; i < cols_.size(); ++i) {
+                    if (late_tabs_[i] == NOT_LATE) continue;
+                    const auto &src_col = late_tab_cols_[late_tabs_[i]][sel_idxs_[i]];
+                    memcpy(out->column(i) + row * cols_[i].len, late_recs[late_tabs_[i]]->data + src_col.offset,
+                           cols_[i].len);
+                }
+            }
+        }
+        std::vector<size_t> moved_to(prev_->cols().size(), NOT_LATE);     // 输入列已经移交给的输出列
+        for (size_t i = 0; i < cols_.size(); ++i) {
+            if (late_tabs_[i] != NOT_LATE) continue;
+            size_t src_idx = sel_idxs_[i];
+            if (moved_to[src_idx] != NOT_LATE) {
+                out->column_buffer(i) = out->column_buffer(moved_to[src_idx]);
+            } else {
+                out->column_buffer(i) = std::move(in->column_buffer(src_idx));
+                moved_to[src_idx] = i;
+            }
+        }
+        out->set_size(in->size());
+        if (in->has_selection()) {
+            out->set_selection(in->selection());
+        }
+        return out;
+    }
+
     size_t tupleLen() const override {
         return len_;
     }
@@ -101,8 +204,9 @@ public:
         return prev_->is_end();
     }
 
+    // 上层的排序键按投影输出的布局解析：输入中可能有未选中的列和延迟物化表的Rid，偏移与输出不同
     ColMeta get_col_offset(const TabCol &target) override {
-        return prev_->get_col_offset(target);
+        return *get_col(cols_, target);
     }
 
 
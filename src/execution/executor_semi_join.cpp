@@ -1,23 +1,96 @@
 #include "executor_semi_join.h"
 
+SemiJoinExecutor::SemiJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                                   std::vector<Condition> conds, bool anti)
+{
+    left_ = std::move(left);
+    right_ = std::move(right);
+
+    if (left_->tupleLen() == 0 || right_->tupleLen() == 0)
+    {
+        throw InternalError("SemiJoinExecutor::Constructor Error: left tupleLen=" + std::to_string(left_->tupleLen()) + ", right tupleLen=" + std::to_string(right_->tupleLen()));
+    }
+
+    len_ = left_->tupleLen();
+    cols_ = left_->cols();
+    right_len_ = right_->tupleLen();
+
+    left_end_ = false;
+    anti_ = anti;
+    fed_conds_ = std::move(conds);
+
+    std::vector<JoinKeyCol> keys;
+    split_join_conds(left_->cols(), right_->cols(), left_->tupleLen(), fed_conds_, &keys, &residual_);
+    residual_pred_ = PredicateProgram(residual_, left_->tupleLen());
+    for (auto &key : keys) {
+        left_key_cols_.push_back(key.left);
+        right_key_cols_.push_back(key.right);
+    }
+}
+
+/**
+ * @brief 读取右输入的全部元组，有连接键时建立哈希表
+ * 没有剩余条件时，连接键与已插入元组相同的右元组不再链入哈希表
+ */
+void SemiJoinExecutor::build() {
+    for (right_->beginTuple(); !right_->is_end(); right_->nextTuple()) {
+        auto rec = right_->Next();
+        if (rec == nullptr) continue;
+        arena_.insert(arena_.end(), rec->data, rec->data + right_len_);
+        num_rows_++;
+    }
+    built_ = true;
+    if (left_key_cols_.empty()) return;
+
+    size_t num_buckets = 1;
+    while (num_buckets < num_rows_ * 2) num_buckets <<= 1;
+    bucket_mask_ = num_buckets - 1;
+    buckets_.assign(num_buckets, NIL);
+    next_.assign(num_rows_, NIL);
+    hashes_.resize(num_rows_);
+    for (size_t i = 0; i < num_rows_; i++) {
+        hashes_[i] = hash_join_key(right_tuple(i), right_key_cols_);
+        uint32_t &head = buckets_[hashes_[i] & bucket_mask_];
+        bool duplicate = false;
+        if (residual_.empty()) {
+            for (uint32_t idx = head; idx != NIL && !duplicate; idx = next_[idx]) {
+                duplicate = hashes_[idx] == hashes_[i] &&
+                            compare_join_key(right_tuple(idx), right_key_cols_, right_tuple(i), right_key_cols_) == 0;
+            }
+        }
+        if (duplicate) continue;
+        next_[i] = head;
+        head = static_cast<uint32_t>(i);
+    }
+}
+
 void SemiJoinExecutor::beginTuple() {
+    // 右输入不依赖左元组，重复执行时复用已经读入的右元组
+    if (!built_) build();
     left_->beginTuple();
-    left_end_ = left_->is_end();
-
-    while (!left_end_ && !findMatchForCurrentLeft()) {
-        left_->nextTuple();
-        left_end_ = left_->is_end();
+    if (num_rows_ == 0 && !anti_) {
+        left_end_ = true;
+        return;
     }
+    seek();
 }
 
 void SemiJoinExecutor::nextTuple() {
+    if (left_end_) return;
     left_->nextTuple();
-    left_end_ = left_->is_end();
+    seek();
+}
 
-    while (!left_end_ && !findMatchForCurrentLeft()) {
+// 从左输入当前位置开始找到第一个需要输出的元组
+void SemiJoinExecutor::seek() {
+    while (!left_->is_end()) {
+        if (findMatchForCurrentLeft() != anti_) {
+            left_end_ = false;
+            return;
+        }
         left_->nextTuple();
-        left_end_ = left_->is_end();
     }
+    left_end_ = true;
 }
 
 std::unique_ptr<RmRecord> SemiJoinExecutor::Next() {
@@ -25,104 +98,36 @@ std::unique_ptr<RmRecord> SemiJoinExecutor::Next() {
         return nullptr;
     }
 
-    return left_->Next();
+    return std::make_unique<RmRecord>(*left_rec_);
 }
 
+// 读取当前左元组，返回右输入中是否存在匹配的元组；左元组为空时返回anti_，使其被跳过
 bool SemiJoinExecutor::findMatchForCurrentLeft() {
-    if (left_->is_end()) {
-        return false;
+    left_rec_ = left_->Next();
+    if (!left_rec_) {
+        return anti_;
     }
+    const char *left_data = left_rec_->data;
 
-    auto left_rec = left_->Next();
-    if (!left_rec) {
+    if (left_key_cols_.empty()) {
+        for (size_t i = 0; i < num_rows_; i++) {
+            if (residual_pred_.eval(left_data, right_tuple(i))) return true;
+        }
         return false;
     }
-
-    right_->beginTuple();
-    
-    while (!right_->is_end()) {
-        auto right_rec = right_->Next();
-        if (right_rec && check_conds(left_rec.get(), right_rec.get())) {
+    if (num_rows_ == 0) return false;
+    uint64_t hash = hash_join_key(left_data, left_key_cols_);
+    for (uint32_t idx = buckets_[hash & bucket_mask_]; idx != NIL; idx = next_[idx]) {
+        if (hashes_[idx] != hash) continue;
+        const char *right_data = right_tuple(idx);
+        if (compare_join_key(left_data, left_key_cols_, right_data, right_key_cols_) == 0 &&
+            residual_pred_.eval(left_data, right_data)) {
             return true;
         }
-        right_->nextTuple();
     }
-    
     return false;
 }
 
-bool SemiJoinExecutor::check_conds(RmRecord *left_rec, RmRecord *right_rec) {
-    for (const auto &cond : fed_conds_) {
-        if (!check_cond(left_rec, right_rec, cond)) {
-            return false;
-        }
-    }
-    return true;
-}
-
-bool SemiJoinExecutor::check_cond(RmRecord *left_rec, RmRecord *right_rec, const Condition &cond) {
-    auto left_cols = left_->cols();
-    auto right_cols = right_->cols();
-    
-    auto left_col_it = left_->get_col(left_cols, cond.lhs_col);
-    auto right_col_it = right_->get_col(right_cols, cond.rhs_col);
-    
-    char *left_data = left_rec->data + left_col_it->offset;
-    char *right_data = right_rec->data + right_col_it->offset;
-    
-    return evaluate_compare(left_data, right_data, left_col_it->type, right_col_it->type, left_col_it->len, right_col_it->len, cond.op);
-}
-
-bool SemiJoinExecutor::evaluate_compare(char *left_data, char *right_data, ColType left_type, ColType right_type, int left_len, int right_len, CompOp op) {
-    assert(left_type == right_type);
-    
-    int cmp_result;
-    switch (left_type) {
-        case TYPE_INT: {
-            int left_val = *(int*)left_data;
-            int right_val = *(int*)right_data;
-            cmp_result = (left_val < right_val) ? -1 : (left_val > right_val) ? 1 : 0;
-            break;
-        }
-        case TYPE_FLOAT: {
-            float left_val = *(float*)left_data;
-            float right_val = *(float*)right_data;
-            cmp_result = (left_val < right_val) ? -1 : (left_val > right_val) ? 1 : 0;
-            break;
-        }
-        case TYPE_STRING: {
-            cmp_result = memcmp(left_data, right_data, std::min(left_len, right_len));
-            if (cmp_result == 0 && left_len != right_len) {
-                cmp_result = (left_len < right_len) ? -1 : 1;
-            }
-            break;
-        }
-        default:
-            throw InternalError("Unsupported column type for comparison");
-    }
-    
-    switch (op) {
-        case OP_EQ: return cmp_result == 0;
-        case OP_NE: return cmp_result != 0;
-        case OP_LT: return cmp_result < 0;
-        case OP_GT: return cmp_result > 0;
-        case OP_LE: return cmp_result <= 0;
-        case OP_GE: return cmp_result >= 0;
-        default:
-            throw InternalError("Unsupported comparison operator");
-    }
-}
-
-ColMeta *SemiJoinExecutor::get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target) {
-    auto pos = std::find_if(rec_cols.begin(), rec_cols.end(), [&](const ColMeta &col) {
-        return col.tab_name == target.tab_name && col.name == target.col_name;
-    });
-    if (pos == rec_cols.end()) {
-        throw ColumnNotFoundError(target.tab_name + "." + target.col_name);
-    }
-    return const_cast<ColMeta*>(&(*pos));
-}
-
 Rid &SemiJoinExecutor::rid() {
     return left_->rid();
 }
@@ -140,5 +145,5 @@ size_t SemiJoinExecutor::tupleLen() const {
 }
 
 std::string SemiJoinExecutor::getType() {
-    return "SemiJoinExecutor";
-}
\ No newline at end of file
+    return anti_ ? "AntiJoinExecutor" : "SemiJoinExecutor";
+}
@@ -1,55 +1,68 @@
 #pragma once
 
 #include "execution_defs.h"
+#include "execution_join.h"
 #include "execution_manager.h"
+#include "execution_predicate.h"
 #include "executor_abstract.h"
 #include "../index/ix.h"
 #include "../system/sm.h"
-#include <unordered_set>
 
+/**
+ * @brief semi join / anti join
+ * 右输入只读取一次：有等值连接键时按连接键建立哈希表，每个左元组探测一次；没有连接键时把右元组缓存下来逐一比较。
+ * semi join输出在右输入中有匹配的左元组，anti join输出没有匹配的左元组（NOT IN / NOT EXISTS）。
+ * 系统中没有NULL值，NOT IN与NOT EXISTS语义相同，右输入为空时anti join输出全部左元组。
+ * 没有剩余条件时连接键相同的右元组只保留一个，哈希表即连接键的集合
+ */
 class SemiJoinExecutor : public AbstractExecutor
 {
 private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
     std::unique_ptr<AbstractExecutor> left_;
     std::unique_ptr<AbstractExecutor> right_;
     size_t len_;
     std::vector<ColMeta> cols_;
 
     std::vector<Condition> fed_conds_;
+    bool anti_;                                 // anti join：输出没有匹配的左元组
     bool left_end_;
-    
+    std::unique_ptr<RmRecord> left_rec_;        // 当前输出的左元组
+
+    std::vector<ColMeta> left_key_cols_;
+    std::vector<ColMeta> right_key_cols_;
+    std::vector<JoinResidualCond> residual_;    // 不作为连接键的条件
+    PredicateProgram residual_pred_;            // residual_编译后的形式
+
+    std::vector<char> arena_;                   // 右输入的全部元组
+    size_t right_len_;
+    size_t num_rows_ = 0;
+    std::vector<uint64_t> hashes_;              // 每个右元组连接键的哈希值
+    std::vector<uint32_t> next_;                // 同一个桶中下一个元组的下标
+    std::vector<uint32_t> buckets_;             // 每个桶中第一个元组的下标
+    uint64_t bucket_mask_ = 0;
+    bool built_ = false;
+
+    const char *right_tuple(size_t i) const { return arena_.data() + i * right_len_; }
+
+    void build();
+
+    void seek();
+
 public:
     SemiJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
-                     std::vector<Condition> conds)
-    {
-        left_ = std::move(left);
-        right_ = std::move(right);
-
-        if (left_->tupleLen() == 0 || right_->tupleLen() == 0)
-        {
-            throw InternalError("SemiJoinExecutor::Constructor Error: left tupleLen=" + std::to_string(left_->tupleLen()) + ", right tupleLen=" + std::to_string(right_->tupleLen()));
-        }
-
-        len_ = left_->tupleLen();
-        cols_ = left_->cols();
-        
-        left_end_ = false;
-        fed_conds_ = std::move(conds);
-    }
+                     std::vector<Condition> conds, bool anti = false);
 
     void beginTuple() override;
     void nextTuple() override;
     std::unique_ptr<RmRecord> Next() override;
-    
+
     bool findMatchForCurrentLeft();
-    bool check_conds(RmRecord *left_rec, RmRecord *right_rec);
-    bool check_cond(RmRecord *left_rec, RmRecord *right_rec, const Condition &cond);
-    bool evaluate_compare(char *left_data, char *right_data, ColType left_type, ColType right_type, int left_len, int right_len, CompOp op);
-    ColMeta *get_col(const std::vector<ColMeta> &rec_cols, const TabCol &target);
-    
+
     size_t tupleLen() const override;
     const std::vector<ColMeta> &cols() const override;
     std::string getType() override;
     bool is_end() const override;
     Rid &rid() override;
-};
\ No newline at end of file
+};
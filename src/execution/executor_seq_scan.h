@@ -12,6 +12,8 @@ See the Mulan PSL v2 for more details. */
 
 #include "execution_defs.h"
 #include "execution_manager.h"
+#include "execution_predicate.h"
+#include "execution_scan_projection.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
 #include "system/sm.h"
@@ -25,6 +27,7 @@ private:
     RmFileHandle *fh_;                 // 表的数据文件句柄
     std::vector<ColMeta> cols_;        // scan后生成的记录的字段
     size_t len_;                       // scan后生成的每条记录的长度
+    ScanProjection proj_;              // 只输出上层需要的字段，cols_和len_取自其中
     std::vector<Condition> fed_conds_; // 同conds_，两个字段相同
 
     Rid rid_;
@@ -33,93 +36,93 @@ private:
 
     SmManager *sm_manager_;
 
-public:
-    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context)
-    {
-        sm_manager_ = sm_manager;
-        tab_name_ = std::move(tab_name);
-        conds_ = std::move(conds);
-        TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
-        fh_ = sm_manager_->fhs_.at(tab_name_).get();
-        cols_ = tab.cols;
-        len_ = cols_.back().offset + cols_.back().len;
-
-        context_ = context;
-
-        fed_conds_ = conds_;
-    }
+    PredicateProgram pred_;             // fed_conds_编译后的形式，在完整记录上求值，供元组接口使用
+    std::vector<BatchPredicate> preds_; // fed_conds_解析为proj_.read_cols()中的下标，供NextBatch使用
+    bool batch_started_ = false;        // beginTuple之后是否已经调用过NextBatch
+    Rid batch_rid_;                     // NextBatch下一个待读取的槽位
 
-
-    //2t
-    // 检查所有条件是否满足
-    bool check_cons(const std::vector<Condition> &conds, const RmRecord *record, const std::vector<ColMeta> &cols_meta)
+    // 页面上没有版本链时可以直接读取槽位中的数据
+    static bool is_page_all_visible(RmFileHandle *fh, int page_no, Context *context)
     {
-        for (const auto &cond : conds)
+        if (context == nullptr || context->txn_ == nullptr)
         {
-            if (!check_con(cond, record, cols_meta))
-                return false;
+            return true;
         }
-        return true;
+        return MVCCManager::get_instance().is_page_all_visible(fh->GetFd(), page_no);
     }
 
-    // 检查单个条件是否满足
-    bool check_con(const Condition &cond, const RmRecord *record, const std::vector<ColMeta> &cols_meta)
+public:
+    /**
+     * @brief 从page_no页的第*slot_no个槽位开始，把当前事务可见的记录追加到batch，直到页尾或batch已满
+     * 页面只pin一次，页面上没有版本链时直接从槽位拷贝数据，否则逐条通过get_record读取可见版本。
+     * 只读取共享的页面和版本链，可以由多个线程同时调用
+     * @param rids 不为空时追加每一行的Rid，供延迟物化使用
+     */
+    static void read_page(RmFileHandle *fh, int page_no, int *slot_no, RecordBatch *batch, Context *context,
+                          std::vector<Rid> *rids = nullptr)
     {
-        auto left_col = get_col(cols_meta, cond.lhs_col);
-        char *left_data = record->data + left_col->offset;
-        char *right_data;
-        ColType data_type;
-
-        if (cond.is_rhs_val)
+        int num_slots = fh->get_file_hdr().num_records_per_page;
+        RmPageHandle page_handle = fh->fetch_page_handle(page_no);
+        bool all_visible = is_page_all_visible(fh, page_no, context);
+        for (; *slot_no < num_slots && !batch->full(); (*slot_no)++)
         {
-            right_data = cond.rhs_val.raw->data;
-            data_type = cond.rhs_val.type;
-        }
-        else
-        {
-            auto right_col = get_col(cols_meta, cond.rhs_col);
-            right_data = record->data + right_col->offset;
-            data_type = right_col->type;
+            if (!Bitmap::is_set(page_handle.bitmap, *slot_no))
+            {
+                continue;
+            }
+            if (all_visible)
+            {
+                batch->append_row(page_handle.get_slot(*slot_no));
+                if (rids != nullptr) rids->push_back(Rid{page_no, *slot_no});
+                continue;
+            }
+            try
+            {
+                auto rec = fh->get_record(Rid{page_no, *slot_no}, context);
+                batch->append_row(rec->data);
+                if (rids != nullptr) rids->push_back(Rid{page_no, *slot_no});
+            }
+            catch (const RecordNotFoundError &)
+            {
+                // MVCC: 记录在当前事务快照中不可见，跳过
+            }
         }
+        fh->unpin_page_handle(page_handle);
+    }
 
-        char left_copy[left_col->len];
-        char right_copy[left_col->len];
-        memcpy(left_copy, left_data, left_col->len);
-        memcpy(right_copy, right_data, left_col->len);
+    /**
+     * @param proj_cols 需要输出的字段名，为空时输出所有字段
+     * @param emit_rid 是否在输出元组末尾附加Rid，供最终投影回表读取其余字段
+     */
+    SeqScanExecutor(SmManager *sm_manager, std::string tab_name, std::vector<Condition> conds, Context *context,
+                    const std::vector<std::string> &proj_cols = {}, bool emit_rid = false)
+    {
+        sm_manager_ = sm_manager;
+        tab_name_ = std::move(tab_name);
+        conds_ = std::move(conds);
+        TabMeta &tab = sm_manager_->db_.get_table(tab_name_);
+        fh_ = sm_manager_->fhs_.at(tab_name_).get();
 
-        if (left_col->type != data_type)
-        {
-            throw IncompatibleTypeError(coltype2str(left_col->type), coltype2str(data_type));
-        }
+        context_ = context;
 
-        int cmp = ix_compare(left_copy, right_copy, data_type, left_col->len);
-        switch (cond.op)
-        {
-        case OP_EQ:
-            return cmp == 0;
-        case OP_NE:
-            return cmp != 0;
-        case OP_LT:
-            return cmp < 0;
-        case OP_GT:
-            return cmp > 0;
-        case OP_LE:
-            return cmp <= 0;
-        case OP_GE:
-            return cmp >= 0;
-        default:
-            throw InternalError("未知操作符");
-        }
+        fed_conds_ = conds_;
+        proj_ = ScanProjection(tab.cols, proj_cols, emit_rid, fed_conds_);
+        cols_ = proj_.cols();
+        len_ = proj_.len();
+        pred_ = PredicateProgram(tab.cols, fed_conds_);
+        preds_ = make_batch_predicates(proj_.read_cols(), fed_conds_);
     }
 
+
     void beginTuple() override
     {
+        batch_started_ = false;
         scan_ = std::make_unique<RmScan>(fh_);
         while (!scan_->is_end())
         {
             try {
                 auto rec = fh_->get_record(scan_->rid(), context_);
-                if (check_cons(fed_conds_, rec.get(), cols_))
+                if (pred_.eval(rec->data))
                 {
                     rid_ = scan_->rid();
                     break;
@@ -138,7 +141,7 @@ public:
         {
             try {
                 auto rec = fh_->get_record(scan_->rid(), context_);
-                if (check_cons(fed_conds_, rec.get(), cols_))
+                if (pred_.eval(rec->data))
                 {
                     rid_ = scan_->rid();
                     break;
@@ -152,7 +155,39 @@ public:
 
     std::unique_ptr<RmRecord> Next() override
     {
-        return fh_->get_record(rid_, context_);
+        return proj_.apply(fh_->get_record(rid_, context_), rid_);
+    }
+
+    /**
+     * @brief 按页批量读取，从beginTuple定位到的元组开始
+     * 每个页面通过read_page读取，过滤条件在整批上求值，结果体现在选择向量中；过滤之后只保留输出字段
+     */
+    std::unique_ptr<RecordBatch> NextBatch() override
+    {
+        if (!batch_started_)
+        {
+            batch_started_ = true;
+            batch_rid_ = scan_->rid();
+        }
+        RmFileHdr file_hdr = fh_->get_file_hdr();
+        if (batch_rid_.page_no >= file_hdr.num_pages)
+        {
+            return nullptr;
+        }
+        auto batch = std::make_unique<RecordBatch>(proj_.read_cols());
+        std::vector<Rid> rids;
+        while (!batch->full() && batch_rid_.page_no < file_hdr.num_pages)
+        {
+            read_page(fh_, batch_rid_.page_no, &batch_rid_.slot_no, batch.get(), context_,
+                      proj_.emit_rid() ? &rids : nullptr);
+            if (batch_rid_.slot_no >= file_hdr.num_records_per_page)
+            {
+                batch_rid_.page_no++;
+                batch_rid_.slot_no = 0;
+            }
+        }
+        filter_batch(batch.get(), preds_);
+        return proj_.apply(std::move(batch), rids);
     }
 
     size_t tupleLen() const override
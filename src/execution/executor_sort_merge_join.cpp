@@ -0,0 +1,151 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "executor_sort_merge_join.h"
+
+void SortMergeJoinExecutor::SortedInput::begin() {
+    child_->beginTuple();
+    if (presorted_) {
+        load_child();
+        return;
+    }
+    sorter_ = std::make_unique<ExternalSorter>(child_->tupleLen(), key_cols_, std::vector<bool>());
+    for (; !child_->is_end(); child_->nextTuple()) {
+        auto rec = child_->Next();
+        if (rec != nullptr) sorter_->add(rec->data);
+    }
+    sorter_->finish();
+    cur_ = sorter_->current();
+}
+
+void SortMergeJoinExecutor::SortedInput::load_child() {
+    cur_ = nullptr;
+    while (!child_->is_end()) {
+        rec_ = child_->Next();
+        if (rec_ != nullptr) {
+            cur_ = rec_->data;
+            return;
+        }
+        child_->nextTuple();
+    }
+}
+
+void SortMergeJoinExecutor::SortedInput::advance() {
+    if (presorted_) {
+        child_->nextTuple();
+        load_child();
+    } else {
+        sorter_->next();
+        cur_ = sorter_->current();
+    }
+}
+
+SortMergeJoinExecutor::SortMergeJoinExecutor(std::unique_ptr<AbstractExecutor> left,
+                                             std::unique_ptr<AbstractExecutor> right, std::vector<Condition> conds,
+                                             bool left_sorted, bool right_sorted) {
+    left_ = std::move(left);
+    right_ = std::move(right);
+    if (left_->tupleLen() == 0 || right_->tupleLen() == 0) {
+        throw InternalError("SortMergeJoinExecutor::Constructor Error: left tupleLen=" +
+                            std::to_string(left_->tupleLen()) + ", right tupleLen=" +
+                            std::to_string(right_->tupleLen()));
+    }
+    len_ = left_->tupleLen() + right_->tupleLen();
+    cols_ = left_->cols();
+    auto right_cols = right_->cols();
+    for (auto &col : right_cols) {
+        col.offset += left_->tupleLen();
+    }
+    cols_.insert(cols_.end(), right_cols.begin(), right_cols.end());
+    fed_conds_ = std::move(conds);
+
+    std::vector<JoinKeyCol> keys;
+    split_join_conds(left_->cols(), right_->cols(), left_->tupleLen(), fed_conds_, &keys, &residual_);
+    residual_pred_ = PredicateProgram(residual_, left_->tupleLen());
+    if (keys.empty()) {
+        throw InternalError("SortMergeJoinExecutor::Constructor Error: no equality join condition");
+    }
+    for (auto &key : keys) {
+        left_key_cols_.push_back(key.left);
+        right_key_cols_.push_back(key.right);
+    }
+    left_input_ = std::make_unique<SortedInput>(left_.get(), left_sorted, left_key_cols_);
+    right_input_ = std::make_unique<SortedInput>(right_.get(), right_sorted, right_key_cols_);
+    joined_ = std::make_unique<RmRecord>(len_);
+}
+
+void SortMergeJoinExecutor::beginTuple() {
+    left_input_->begin();
+    right_input_->begin();
+    group_.clear();
+    group_size_ = 0;
+    group_pos_ = 0;
+    in_group_ = false;
+    isend_ = false;
+    advance();
+}
+
+void SortMergeJoinExecutor::nextTuple() {
+    if (isend_) return;
+    advance();
+}
+
+/**
+ * @brief 找到下一对满足所有条件的元组，写入joined_
+ * 当前左元组与group_连接完之后，下一个左元组的连接键仍相同时重新遍历group_，否则丢弃group_继续合并
+ */
+void SortMergeJoinExecutor::advance() {
+    size_t left_len = left_->tupleLen();
+    size_t right_len = right_->tupleLen();
+    while (true) {
+        if (in_group_) {
+            const char *left_rec = left_input_->current();
+            while (group_pos_ < group_size_) {
+                const char *right_rec = group_tuple(group_pos_++);
+                memcpy(joined_->data, left_rec, left_len);
+                memcpy(joined_->data + left_len, right_rec, right_len);
+                if (residual_pred_.eval(joined_->data, joined_->data + left_->tupleLen())) return;
+            }
+            left_input_->advance();
+            group_pos_ = 0;
+            in_group_ = left_input_->valid() &&
+                        compare_join_key(left_input_->current(), left_key_cols_, group_tuple(0), right_key_cols_) == 0;
+            continue;
+        }
+        if (!left_input_->valid() || !right_input_->valid()) {
+            isend_ = true;
+            return;
+        }
+        int cmp = compare_join_key(left_input_->current(), left_key_cols_, right_input_->current(), right_key_cols_);
+        if (cmp < 0) {
+            left_input_->advance();
+        } else if (cmp > 0) {
+            right_input_->advance();
+        } else {
+            // 缓存右输入中连接键相同的一组元组
+            group_.assign(right_input_->current(), right_input_->current() + right_len);
+            group_size_ = 1;
+            right_input_->advance();
+            while (right_input_->valid() &&
+                   compare_join_key(right_input_->current(), right_key_cols_, group_tuple(0), right_key_cols_) == 0) {
+                group_.insert(group_.end(), right_input_->current(), right_input_->current() + right_len);
+                group_size_++;
+                right_input_->advance();
+            }
+            group_pos_ = 0;
+            in_group_ = true;
+        }
+    }
+}
+
+std::unique_ptr<RmRecord> SortMergeJoinExecutor::Next() {
+    if (isend_) return nullptr;
+    return std::make_unique<RmRecord>(*joined_);
+}
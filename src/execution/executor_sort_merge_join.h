@@ -0,0 +1,99 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include "execution_defs.h"
+#include "execution_external_sort.h"
+#include "execution_join.h"
+#include "execution_manager.h"
+#include "execution_predicate.h"
+#include "executor_abstract.h"
+#include "index/ix.h"
+#include "system/sm.h"
+
+/**
+ * @brief 等值连接的排序合并连接算子
+ * 已经按连接键有序的输入（按连接键顺序扫描的IndexScanExecutor，由planner判定）直接按流读取，
+ * 其余输入先用ExternalSorter排序（超过内存预算时写出到临时文件）。
+ * 合并时把右输入中连接键相同的一组元组缓存下来，左输入中连接键相同的每个元组都与这一组逐一连接
+ */
+class SortMergeJoinExecutor : public AbstractExecutor {
+   private:
+    // 按连接键有序的输入：直接读取子算子，或读取排好序的ExternalSorter
+    class SortedInput {
+       public:
+        SortedInput(AbstractExecutor *child, bool presorted, std::vector<ColMeta> key_cols)
+            : child_(child), presorted_(presorted), key_cols_(std::move(key_cols)) {}
+
+        void begin();
+
+        bool valid() const { return cur_ != nullptr; }
+
+        const char *current() const { return cur_; }
+
+        void advance();
+
+       private:
+        AbstractExecutor *child_;
+        bool presorted_;
+        std::vector<ColMeta> key_cols_;
+        std::unique_ptr<ExternalSorter> sorter_;
+        std::unique_ptr<RmRecord> rec_;
+        const char *cur_ = nullptr;
+
+        void load_child();
+    };
+
+    std::unique_ptr<AbstractExecutor> left_;
+    std::unique_ptr<AbstractExecutor> right_;
+    size_t len_;                                // join后获得的每条记录的长度
+    std::vector<ColMeta> cols_;                 // join后获得的记录的字段
+    std::vector<Condition> fed_conds_;          // join条件
+
+    std::vector<ColMeta> left_key_cols_;
+    std::vector<ColMeta> right_key_cols_;
+    std::vector<JoinResidualCond> residual_;    // 不作为连接键的条件
+    PredicateProgram residual_pred_;            // residual_编译后的形式
+    std::unique_ptr<SortedInput> left_input_;
+    std::unique_ptr<SortedInput> right_input_;
+
+    std::vector<char> group_;                   // 右输入中连接键相同的一组元组
+    size_t group_size_ = 0;
+    size_t group_pos_ = 0;                      // 当前左元组下一个待连接的组内元组
+    bool in_group_ = false;                     // 当前左元组与group_的连接键相同
+
+    std::unique_ptr<RmRecord> joined_;
+    bool isend_ = true;
+
+    void advance();
+
+    const char *group_tuple(size_t i) const { return group_.data() + i * right_->tupleLen(); }
+
+   public:
+    SortMergeJoinExecutor(std::unique_ptr<AbstractExecutor> left, std::unique_ptr<AbstractExecutor> right,
+                          std::vector<Condition> conds, bool left_sorted, bool right_sorted);
+
+    void beginTuple() override;
+
+    void nextTuple() override;
+
+    std::unique_ptr<RmRecord> Next() override;
+
+    size_t tupleLen() const override { return len_; }
+
+    const std::vector<ColMeta> &cols() const override { return cols_; }
+
+    std::string getType() override { return "SortMergeJoinExecutor"; }
+
+    bool is_end() const override { return isend_; }
+
+    Rid &rid() override { return _abstract_rid; }
+};
@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #pragma once
 
 #include "execution_defs.h"
+#include "execution_expr.h"
 #include "execution_manager.h"
 #include "executor_abstract.h"
 #include "index/ix.h"
@@ -26,6 +27,8 @@ private:
     std::vector<Rid> rids_;
     std::string tab_name_;
     std::vector<SetClause> set_clauses_;
+    std::vector<ColMeta> set_cols_;             // 每个set子句的目标字段
+    std::vector<ExprProgram> set_exprs_;        // 表达式赋值编译后的字节码，与set_clauses_一一对应
     SmManager *sm_manager_;
 
 public:
@@ -42,10 +45,16 @@ public:
     }
 
     std::unique_ptr<RmRecord> Next() override {
-        // 类型检查与转换（支持表达式）
+        // 类型检查与转换，表达式编译为字节码
+        set_cols_.clear();
+        set_exprs_.clear();
         for (auto &set_clause: set_clauses_) {
             auto lhs_col = tab_.get_col(set_clause.lhs.col_name);
-            if (!set_clause.is_expr_) {
+            set_cols_.push_back(*lhs_col);
+            if (set_clause.is_expr_) {
+                set_exprs_.emplace_back(set_clause.rhs_expr_.get(), tab_.cols, *lhs_col);
+            } else {
+                set_exprs_.emplace_back();
                 // 简单赋值的类型检查
                 if (lhs_col->type == TYPE_FLOAT && set_clause.rhs.type == TYPE_INT) {
                     set_clause.rhs.type = TYPE_FLOAT;
@@ -67,13 +76,13 @@ public:
             auto rec = fh_->get_record(rid, context_);
             old_rec = *rec;
             // 生成新记录（支持表达式求值）
-            for (auto &set: set_clauses_) {
-                auto col = tab_.get_col(set.lhs.col_name);
+            for (size_t i = 0; i < set_clauses_.size(); i++) {
+                auto &set = set_clauses_[i];
+                auto col = &set_cols_[i];
                 if (set.is_expr_) {
-                    // 表达式赋值：支持如 score = score + 5.5
-                    Value expr_result = evaluate_expr(set.rhs_expr_.get(), rec.get(), tab_.cols);
-                    expr_result.init_raw(col->len);
-                    memcpy(rec->data + col->offset, expr_result.raw->data, col->len);
+                    // 表达式赋值：支持如 score = score + 5.5，直接写回记录
+                    // 表达式读取更新前的元组，同一语句中前面的set子句不影响后面的表达式
+                    set_exprs_[i].eval(old_rec.data, rec->data + col->offset);
                 } else if (!set.is_add) {
                     // 简单赋值
                     memcpy(rec->data + col->offset, set.rhs.raw->data, col->len);
@@ -108,8 +117,9 @@ public:
                 }
             }
 
-            // 唯一索引预检查
+            // 唯一索引预检查，非唯一索引允许重复的key
             for(auto & index : tab_.indexes) {
+                if (!index.unique) continue;
                 auto ih = sm_manager_->ihs_.at(sm_manager_->get_ix_manager()->get_index_name(tab_name_, index.cols)).get();
                 char* old_key = new char[index.col_tot_len];
                 char* new_key = new char[index.col_tot_len];
@@ -120,9 +130,8 @@ public:
                     offset += index.cols[j].len;
                 }
                 if(memcmp(old_key, new_key, index.col_tot_len) != 0) {
-                    auto leaf_node = ih->find_leaf_page(new_key,Operation::FIND,context_->txn_).first;
-                    int idx = leaf_node->lower_bound(new_key);
-                    if(!(idx == leaf_node->get_size() || ix_compare(leaf_node->get_key(idx),new_key,leaf_node->file_hdr->col_types_,leaf_node->file_hdr->col_lens_)!=0))
+                    std::vector<Rid> dup_rids;
+                    if(ih->get_value(new_key, &dup_rids, context_->txn_))
                         throw RMDBError("insert key not unique! --UpdateExecutor::Next()");
                 }
                 delete[] old_key;
@@ -139,7 +148,7 @@ public:
                     offset += index.cols[j].len;
                 }
                 if(memcmp(old_key, new_key, index.col_tot_len) != 0) {
-                    ih->delete_entry(old_key, context_->txn_);
+                    ih->delete_entry(old_key, rid, context_->txn_);
                     ih->insert_entry(new_key, rid, context_->txn_);
                 }
             }
@@ -0,0 +1,456 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#include "ix_art_cache.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+IxArtCache::IxArtCache(const std::vector<ColType> &col_types, const std::vector<int> &col_lens)
+    : col_types_(col_types), col_lens_(col_lens), key_len_(0) {
+    for (int len : col_lens_) key_len_ += len;
+}
+
+IxArtCache::~IxArtCache() { clear(); }
+
+void IxArtCache::set_budget(size_t budget) {
+    if (budget < budget_ || budget == 0) clear();
+    budget_ = budget;
+}
+
+void IxArtCache::clear() {
+    destroy(root_);
+    root_ = nullptr;
+    memory_ = 0;
+    num_keys_ = 0;
+}
+
+/**
+ * @brief 把索引key转换为可以逐字节比较的格式
+ * 整数翻转符号位后按大端序存放；浮点数先把-0规范为+0，负数翻转所有bit，非负数只翻转符号位；字符串保持原样
+ */
+void IxArtCache::normalize(const char *key, uint8_t *out) const {
+    int offset = 0;
+    for (size_t i = 0; i < col_types_.size(); i++) {
+        const char *src = key + offset;
+        uint8_t *dst = out + offset;
+        switch (col_types_[i]) {
+            case TYPE_INT: {
+                uint32_t v;
+                memcpy(&v, src, sizeof(v));
+                v ^= 0x80000000u;
+                for (int b = 0; b < 4; b++) dst[b] = static_cast<uint8_t>(v >> (24 - 8 * b));
+                break;
+            }
+            case TYPE_FLOAT: {
+                float f;
+                memcpy(&f, src, sizeof(f));
+                if (f == 0.0f) f = 0.0f;
+                uint32_t v;
+                memcpy(&v, &f, sizeof(v));
+                v = (v & 0x80000000u) ? ~v : (v | 0x80000000u);
+                for (int b = 0; b < 4; b++) dst[b] = static_cast<uint8_t>(v >> (24 - 8 * b));
+                break;
+            }
+            default:
+                memcpy(dst, src, col_lens_[i]);
+                break;
+        }
+        offset += col_lens_[i];
+    }
+}
+
+bool IxArtCache::leaf_matches(const Leaf *leaf, const uint8_t *key) const {
+    return memcmp(leaf_key(leaf), key, key_len_) == 0;
+}
+
+size_t IxArtCache::node_size(NodeType type) {
+    switch (type) {
+        case NODE4: return sizeof(Node4);
+        case NODE16: return sizeof(Node16);
+        case NODE48: return sizeof(Node48);
+        case NODE256: return sizeof(Node256);
+        default: return sizeof(Leaf);
+    }
+}
+
+IxArtCache::Leaf *IxArtCache::new_leaf(const uint8_t *key, const Rid &rid) {
+    Leaf *leaf = static_cast<Leaf *>(malloc(sizeof(Leaf) + key_len_));
+    leaf->type = LEAF;
+    leaf->rid = rid;
+    memcpy(leaf + 1, key, key_len_);
+    memory_ += sizeof(Leaf) + key_len_;
+    return leaf;
+}
+
+IxArtCache::Inner *IxArtCache::new_inner(NodeType type) {
+    size_t size = node_size(type);
+    Inner *node = static_cast<Inner *>(calloc(1, size));
+    node->type = type;
+    memory_ += size;
+    return node;
+}
+
+void IxArtCache::free_node(Node *node) {
+    memory_ -= node->type == LEAF ? sizeof(Leaf) + key_len_ : node_size(node->type);
+    free(node);
+}
+
+void IxArtCache::destroy(Node *node) {
+    if (node == nullptr) return;
+    if (node->type != LEAF) {
+        for_each_child(static_cast<Inner *>(node), [this](uint8_t, Node *child) { destroy(child); });
+    }
+    free(node);
+}
+
+IxArtCache::Node **IxArtCache::find_child(Inner *node, uint8_t byte) {
+    switch (node->type) {
+        case NODE4: {
+            Node4 *n = static_cast<Node4 *>(node);
+            for (int i = 0; i < n->num_children; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return nullptr;
+        }
+        case NODE16: {
+            Node16 *n = static_cast<Node16 *>(node);
+            for (int i = 0; i < n->num_children; i++) {
+                if (n->keys[i] == byte) return &n->children[i];
+            }
+            return nullptr;
+        }
+        case NODE48: {
+            Node48 *n = static_cast<Node48 *>(node);
+            int idx = n->child_index[byte];
+            return idx == 0 ? nullptr : &n->children[idx - 1];
+        }
+        case NODE256: {
+            Node256 *n = static_cast<Node256 *>(node);
+            return n->children[byte] == nullptr ? nullptr : &n->children[byte];
+        }
+        default:
+            return nullptr;
+    }
+}
+
+template <typename Func>
+void IxArtCache::for_each_child(Inner *node, Func func) {
+    switch (node->type) {
+        case NODE4: {
+            Node4 *n = static_cast<Node4 *>(node);
+            for (int i = 0; i < n->num_children; i++) func(n->keys[i], n->children[i]);
+            break;
+        }
+        case NODE16: {
+            Node16 *n = static_cast<Node16 *>(node);
+            for (int i = 0; i < n->num_children; i++) func(n->keys[i], n->children[i]);
+            break;
+        }
+        case NODE48: {
+            Node48 *n = static_cast<Node48 *>(node);
+            for (int b = 0; b < 256; b++) {
+                if (n->child_index[b] != 0) func(static_cast<uint8_t>(b), n->children[n->child_index[b] - 1]);
+            }
+            break;
+        }
+        case NODE256: {
+            Node256 *n = static_cast<Node256 *>(node);
+            for (int b = 0; b < 256; b++) {
+                if (n->children[b] != nullptr) func(static_cast<uint8_t>(b), n->children[b]);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 把node的孩子搬到一个新类型的结点中，释放node并返回新结点
+ */
+IxArtCache::Inner *IxArtCache::change_type(Inner *node, NodeType type) {
+    Inner *fresh = new_inner(type);
+    fresh->prefix_len = node->prefix_len;
+    memcpy(fresh->prefix, node->prefix, MAX_PREFIX_LEN);
+    for_each_child(node, [fresh](uint8_t byte, Node *child) {
+        switch (fresh->type) {
+            case NODE4: {
+                Node4 *n = static_cast<Node4 *>(fresh);
+                n->keys[n->num_children] = byte;
+                n->children[n->num_children] = child;
+                break;
+            }
+            case NODE16: {
+                Node16 *n = static_cast<Node16 *>(fresh);
+                n->keys[n->num_children] = byte;
+                n->children[n->num_children] = child;
+                break;
+            }
+            case NODE48: {
+                Node48 *n = static_cast<Node48 *>(fresh);
+                n->children[n->num_children] = child;
+                n->child_index[byte] = static_cast<uint8_t>(n->num_children + 1);
+                break;
+            }
+            default: {
+                static_cast<Node256 *>(fresh)->children[byte] = child;
+                break;
+            }
+        }
+        fresh->num_children++;
+    });
+    free_node(node);
+    return fresh;
+}
+
+/**
+ * @brief 在node中加入byte对应的孩子，node已满时先换成更大的结点类型，ref为父结点中指向node的指针
+ */
+void IxArtCache::add_child(Node *&ref, Inner *node, uint8_t byte, Node *child) {
+    static const int capacity[] = {4, 16, 48, 256};
+    if (node->num_children == capacity[node->type]) {
+        node = change_type(node, static_cast<NodeType>(node->type + 1));
+        ref = node;
+    }
+    switch (node->type) {
+        case NODE4: {
+            Node4 *n = static_cast<Node4 *>(node);
+            n->keys[n->num_children] = byte;
+            n->children[n->num_children] = child;
+            break;
+        }
+        case NODE16: {
+            Node16 *n = static_cast<Node16 *>(node);
+            n->keys[n->num_children] = byte;
+            n->children[n->num_children] = child;
+            break;
+        }
+        case NODE48: {
+            Node48 *n = static_cast<Node48 *>(node);
+            int slot = 0;
+            while (n->children[slot] != nullptr) slot++;
+            n->children[slot] = child;
+            n->child_index[byte] = static_cast<uint8_t>(slot + 1);
+            break;
+        }
+        default: {
+            static_cast<Node256 *>(node)->children[byte] = child;
+            break;
+        }
+    }
+    node->num_children++;
+}
+
+/**
+ * @brief 删除node中byte对应的孩子（孩子本身已由调用者释放），孩子过少时换成更小的结点类型，
+ * Node4只剩一个孩子时把node并入孩子的压缩路径；depth为node在key中的起始位置
+ */
+void IxArtCache::remove_child(Node *&ref, Inner *node, uint8_t byte, int depth) {
+    switch (node->type) {
+        case NODE4:
+        case NODE16: {
+            uint8_t *keys = node->type == NODE4 ? static_cast<Node4 *>(node)->keys : static_cast<Node16 *>(node)->keys;
+            Node **children =
+                node->type == NODE4 ? static_cast<Node4 *>(node)->children : static_cast<Node16 *>(node)->children;
+            int i = 0;
+            while (keys[i] != byte) i++;
+            int last = node->num_children - 1;
+            keys[i] = keys[last];
+            children[i] = children[last];
+            children[last] = nullptr;
+            break;
+        }
+        case NODE48: {
+            Node48 *n = static_cast<Node48 *>(node);
+            n->children[n->child_index[byte] - 1] = nullptr;
+            n->child_index[byte] = 0;
+            break;
+        }
+        default: {
+            static_cast<Node256 *>(node)->children[byte] = nullptr;
+            break;
+        }
+    }
+    node->num_children--;
+
+    if (node->type == NODE256 && node->num_children <= 37) {
+        ref = change_type(node, NODE48);
+    } else if (node->type == NODE48 && node->num_children <= 12) {
+        ref = change_type(node, NODE16);
+    } else if (node->type == NODE16 && node->num_children <= 3) {
+        ref = change_type(node, NODE4);
+    } else if (node->type == NODE4 && node->num_children == 1) {
+        Node4 *n = static_cast<Node4 *>(node);
+        Node *child = n->children[0];
+        if (child->type != LEAF) {
+            // 孩子的压缩路径 = node的压缩路径 + 孩子对应的字节 + 孩子原来的压缩路径
+            Inner *inner = static_cast<Inner *>(child);
+            const uint8_t *full = leaf_key(any_leaf(child)) + depth;
+            uint32_t prefix_len = node->prefix_len + 1 + inner->prefix_len;
+            memcpy(inner->prefix, full, std::min(prefix_len, MAX_PREFIX_LEN));
+            inner->prefix_len = prefix_len;
+        }
+        ref = child;
+        free_node(node);
+    }
+}
+
+const IxArtCache::Leaf *IxArtCache::any_leaf(const Node *node) {
+    while (node->type != LEAF) {
+        const Node *next = nullptr;
+        for_each_child(const_cast<Inner *>(static_cast<const Inner *>(node)), [&next](uint8_t, Node *child) {
+            if (next == nullptr) next = child;
+        });
+        node = next;
+    }
+    return static_cast<const Leaf *>(node);
+}
+
+/**
+ * @brief 返回key从depth开始与node压缩路径相同的字节数，超过MAX_PREFIX_LEN的部分到任意一个叶子中比较
+ */
+uint32_t IxArtCache::prefix_mismatch(const Inner *node, const uint8_t *key, int depth) const {
+    uint32_t stored = std::min(node->prefix_len, MAX_PREFIX_LEN);
+    uint32_t i = 0;
+    for (; i < stored; i++) {
+        if (node->prefix[i] != key[depth + i]) return i;
+    }
+    if (node->prefix_len > MAX_PREFIX_LEN) {
+        const uint8_t *full = leaf_key(any_leaf(node));
+        for (; i < node->prefix_len; i++) {
+            if (full[depth + i] != key[depth + i]) return i;
+        }
+    }
+    return i;
+}
+
+bool IxArtCache::lookup(const char *key, Rid *rid) const {
+    if (root_ == nullptr) return false;
+    uint8_t norm[IX_MAX_COL_LEN];
+    normalize(key, norm);
+    Node *node = root_;
+    int depth = 0;
+    while (node->type != LEAF) {
+        Inner *inner = static_cast<Inner *>(node);
+        // 查找时只比较保存下来的压缩路径，其余部分跳过，最后在叶子中比较完整的key
+        uint32_t stored = std::min(inner->prefix_len, MAX_PREFIX_LEN);
+        if (memcmp(inner->prefix, norm + depth, stored) != 0) return false;
+        depth += inner->prefix_len;
+        Node **child = find_child(inner, norm[depth]);
+        if (child == nullptr) return false;
+        node = *child;
+        depth++;
+    }
+    const Leaf *leaf = static_cast<const Leaf *>(node);
+    if (!leaf_matches(leaf, norm)) return false;
+    *rid = leaf->rid;
+    return true;
+}
+
+void IxArtCache::insert(const char *key, const Rid &rid) {
+    if (budget_ == 0) return;
+    // 新key最多增加一个叶子和一个Node256的空间，超过预算时先清空缓存
+    if (memory_ + sizeof(Leaf) + key_len_ + sizeof(Node256) > budget_) clear();
+    uint8_t norm[IX_MAX_COL_LEN];
+    normalize(key, norm);
+    insert(root_, norm, rid, 0);
+}
+
+void IxArtCache::insert(Node *&ref, const uint8_t *key, const Rid &rid, int depth) {
+    if (ref == nullptr) {
+        ref = new_leaf(key, rid);
+        num_keys_++;
+        return;
+    }
+    if (ref->type == LEAF) {
+        Leaf *leaf = static_cast<Leaf *>(ref);
+        const uint8_t *other = leaf_key(leaf);
+        if (memcmp(other, key, key_len_) == 0) {
+            leaf->rid = rid;
+            return;
+        }
+        // 在两个key第一个不同的字节处分叉
+        int split = depth;
+        while (other[split] == key[split]) split++;
+        Inner *node = new_inner(NODE4);
+        node->prefix_len = split - depth;
+        memcpy(node->prefix, key + depth, std::min(node->prefix_len, MAX_PREFIX_LEN));
+        Node *old = ref;
+        ref = node;
+        add_child(ref, node, other[split], old);
+        add_child(ref, node, key[split], new_leaf(key, rid));
+        num_keys_++;
+        return;
+    }
+
+    Inner *node = static_cast<Inner *>(ref);
+    if (node->prefix_len > 0) {
+        uint32_t same = prefix_mismatch(node, key, depth);
+        if (same < node->prefix_len) {
+            // 压缩路径在same处分叉，新建Node4，原结点保留分叉字节之后的压缩路径
+            const uint8_t *full = leaf_key(any_leaf(node));
+            Inner *parent = new_inner(NODE4);
+            parent->prefix_len = same;
+            memcpy(parent->prefix, key + depth, std::min(same, MAX_PREFIX_LEN));
+            uint8_t old_byte = full[depth + same];
+            node->prefix_len -= same + 1;
+            memcpy(node->prefix, full + depth + same + 1, std::min(node->prefix_len, MAX_PREFIX_LEN));
+            ref = parent;
+            add_child(ref, parent, old_byte, node);
+            add_child(ref, parent, key[depth + same], new_leaf(key, rid));
+            num_keys_++;
+            return;
+        }
+        depth += node->prefix_len;
+    }
+    Node **child = find_child(node, key[depth]);
+    if (child != nullptr) {
+        insert(*child, key, rid, depth + 1);
+        return;
+    }
+    add_child(ref, node, key[depth], new_leaf(key, rid));
+    num_keys_++;
+}
+
+void IxArtCache::erase(const char *key) {
+    if (root_ == nullptr) return;
+    uint8_t norm[IX_MAX_COL_LEN];
+    normalize(key, norm);
+    erase(root_, norm, 0);
+}
+
+void IxArtCache::erase(Node *&ref, const uint8_t *key, int depth) {
+    if (ref->type == LEAF) {
+        // 只有根结点是叶子时才会走到这里
+        if (leaf_matches(static_cast<Leaf *>(ref), key)) {
+            free_node(ref);
+            ref = nullptr;
+            num_keys_--;
+        }
+        return;
+    }
+    Inner *node = static_cast<Inner *>(ref);
+    uint32_t stored = std::min(node->prefix_len, MAX_PREFIX_LEN);
+    if (memcmp(node->prefix, key + depth, stored) != 0) return;
+    int child_depth = depth + node->prefix_len;
+    Node **child = find_child(node, key[child_depth]);
+    if (child == nullptr) return;
+    if ((*child)->type == LEAF) {
+        Leaf *leaf = static_cast<Leaf *>(*child);
+        if (!leaf_matches(leaf, key)) return;
+        free_node(leaf);
+        num_keys_--;
+        remove_child(ref, node, key[child_depth], depth);
+        return;
+    }
+    erase(*child, key, child_depth + 1);
+}
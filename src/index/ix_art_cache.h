@@ -0,0 +1,135 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ix_defs.h"
+
+/**
+ * @brief 唯一索引的 key -> Rid 内存缓存，用ART（adaptive radix tree）组织，只存在于内存中
+ * 点查询命中缓存时不需要访问缓冲池；B+树仍然是唯一的数据来源，缓存在查找B+树之后按需填充，
+ * 删除key时由IxIndexHandle同步删除缓存项
+ * key先转换为可以逐字节比较的格式（整数、浮点数转为大端序并调整符号位），同一个缓存中所有key等长，
+ * 因此任何key都不是另一个key的前缀，叶子只会出现在key第一次与其他key分叉的位置
+ * 内存使用超过预算时清空整个缓存，之后按需重新填充；预算为0时缓存关闭
+ */
+class IxArtCache {
+   public:
+    IxArtCache(const std::vector<ColType> &col_types, const std::vector<int> &col_lens);
+
+    ~IxArtCache();
+
+    IxArtCache(const IxArtCache &) = delete;
+    IxArtCache &operator=(const IxArtCache &) = delete;
+
+    // 设置内存预算（字节），缩小预算或设为0时清空缓存
+    void set_budget(size_t budget);
+
+    size_t budget() const { return budget_; }
+
+    size_t memory_usage() const { return memory_; }
+
+    size_t size() const { return num_keys_; }
+
+    bool lookup(const char *key, Rid *rid) const;
+
+    // 插入或更新key对应的rid
+    void insert(const char *key, const Rid &rid);
+
+    void erase(const char *key);
+
+    void clear();
+
+   private:
+    enum NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256, LEAF };
+
+    static constexpr uint32_t MAX_PREFIX_LEN = 8;   // 结点中保存的压缩路径的最大长度，更长的部分到叶子中比较
+
+    struct Node {
+        NodeType type;
+    };
+
+    // 叶子之后紧跟key_len_字节的规范化key
+    struct Leaf : Node {
+        Rid rid;
+    };
+
+    struct Inner : Node {
+        uint16_t num_children;
+        uint32_t prefix_len;                    // 压缩路径的完整长度
+        uint8_t prefix[MAX_PREFIX_LEN];         // 压缩路径的前MAX_PREFIX_LEN个字节
+    };
+
+    struct Node4 : Inner {
+        uint8_t keys[4];
+        Node *children[4];
+    };
+
+    struct Node16 : Inner {
+        uint8_t keys[16];
+        Node *children[16];
+    };
+
+    struct Node48 : Inner {
+        uint8_t child_index[256];               // 0表示没有孩子，否则为children中的下标+1
+        Node *children[48];
+    };
+
+    struct Node256 : Inner {
+        Node *children[256];
+    };
+
+    std::vector<ColType> col_types_;
+    std::vector<int> col_lens_;
+    int key_len_;
+    Node *root_ = nullptr;
+    size_t budget_ = 0;
+    size_t memory_ = 0;
+    size_t num_keys_ = 0;
+
+    void normalize(const char *key, uint8_t *out) const;
+
+    static const uint8_t *leaf_key(const Leaf *leaf) { return reinterpret_cast<const uint8_t *>(leaf + 1); }
+
+    bool leaf_matches(const Leaf *leaf, const uint8_t *key) const;
+
+    Leaf *new_leaf(const uint8_t *key, const Rid &rid);
+
+    Inner *new_inner(NodeType type);
+
+    void free_node(Node *node);
+
+    void destroy(Node *node);
+
+    static size_t node_size(NodeType type);
+
+    static Node **find_child(Inner *node, uint8_t byte);
+
+    template <typename Func>
+    static void for_each_child(Inner *node, Func func);
+
+    void add_child(Node *&ref, Inner *node, uint8_t byte, Node *child);
+
+    void remove_child(Node *&ref, Inner *node, uint8_t byte, int depth);
+
+    Inner *change_type(Inner *node, NodeType type);
+
+    static const Leaf *any_leaf(const Node *node);
+
+    uint32_t prefix_mismatch(const Inner *node, const uint8_t *key, int depth) const;
+
+    void insert(Node *&ref, const uint8_t *key, const Rid &rid, int depth);
+
+    void erase(Node *&ref, const uint8_t *key, int depth);
+};
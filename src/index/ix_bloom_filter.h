@@ -0,0 +1,89 @@
+/* Copyright (c) 2023 Renmin University of China
+RMDB is licensed under Mulan PSL v2.
+You can use this software according to the terms and conditions of the Mulan PSL v2.
+You may obtain a copy of Mulan PSL v2 at:
+        http://license.coscl.org.cn/MulanPSL2
+THIS SOFTWARE IS PROVIDED ON AN "AS IS" BASIS, WITHOUT WARRANTIES OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO NON-INFRINGEMENT,
+MERCHANTABILITY OR FIT FOR A PARTICULAR PURPOSE.
+See the Mulan PSL v2 for more details. */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 索引key的Bloom filter，只存在于内存中
+ * may_contain返回false时key一定不在索引中，返回true时key可能存在（需要再查B+树）
+ * Bloom filter不支持删除，删除key后过滤器中仍保留其bit，由IxIndexHandle在删除过多时重建
+ */
+class IxBloomFilter {
+   public:
+    static constexpr int BITS_PER_KEY = 10;     // 每个key占用的bit数，误判率约1%
+    static constexpr int NUM_HASHES = 7;        // 哈希函数个数，约为BITS_PER_KEY * ln2
+    static constexpr size_t MIN_CAPACITY = 1024;
+
+   private:
+    std::vector<uint64_t> bits_;
+    size_t num_bits_ = 0;
+    size_t capacity_ = 0;       // 设计容量（key的数量），超过后误判率上升，需要扩容重建
+    size_t num_keys_ = 0;       // 加入过的key的数量（包括之后被删除的key）
+
+   public:
+    IxBloomFilter() { reset(MIN_CAPACITY); }
+
+    // 清空过滤器，并按capacity个key重新分配bit数组
+    void reset(size_t capacity) {
+        capacity_ = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+        num_bits_ = capacity_ * BITS_PER_KEY;
+        bits_.assign((num_bits_ + 63) / 64, 0);
+        num_keys_ = 0;
+    }
+
+    void add(const char *key, int len) {
+        uint64_t h1 = hash(key, len);
+        uint64_t h2 = mix(h1) | 1;
+        for (int i = 0; i < NUM_HASHES; i++) {
+            size_t bit = (h1 + i * h2) % num_bits_;
+            bits_[bit >> 6] |= 1ULL << (bit & 63);
+        }
+        num_keys_++;
+    }
+
+    bool may_contain(const char *key, int len) const {
+        uint64_t h1 = hash(key, len);
+        uint64_t h2 = mix(h1) | 1;
+        for (int i = 0; i < NUM_HASHES; i++) {
+            size_t bit = (h1 + i * h2) % num_bits_;
+            if ((bits_[bit >> 6] & (1ULL << (bit & 63))) == 0) return false;
+        }
+        return true;
+    }
+
+    size_t capacity() const { return capacity_; }
+
+    size_t num_keys() const { return num_keys_; }
+
+   private:
+    // FNV-1a
+    static uint64_t hash(const char *key, int len) {
+        uint64_t h = 14695981039346656037ULL;
+        for (int i = 0; i < len; i++) {
+            h ^= static_cast<unsigned char>(key[i]);
+            h *= 1099511628211ULL;
+        }
+        return mix(h);
+    }
+
+    // murmur3 finalizer，打散FNV结果的低位
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb93fe53a3f5bULL;
+        h ^= h >> 33;
+        return h;
+    }
+};
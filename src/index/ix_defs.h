@@ -13,6 +13,7 @@ See the Mulan PSL v2 for more details. */
 #include <vector>
 
 #include "defs.h"
+#include "errors.h"
 #include "storage/buffer_pool_manager.h"
 
 constexpr int IX_NO_PAGE = -1;
@@ -21,6 +22,10 @@ constexpr int IX_LEAF_HEADER_PAGE = 1;
 constexpr int IX_INIT_ROOT_PAGE = 2;
 constexpr int IX_INIT_NUM_PAGES = 3;
 constexpr int IX_MAX_COL_LEN = 512;
+constexpr int IX_MAX_KEY_LEN = IX_MAX_COL_LEN + sizeof(Rid);  // 非唯一索引的key还包含Rid
+// 文件头以magic和格式版本开头，结点或文件头的布局改变时增加版本号
+constexpr int IX_FILE_MAGIC = 0x46584952;   // "RIXF"
+constexpr int IX_FILE_VERSION = 3;          // 2: 结点key前缀压缩、非唯一索引；3: 统计信息
 
 class IxFileHdr {
 public: 
@@ -31,32 +36,57 @@ public:
     std::vector<ColType> col_types_;    // 字段的类型
     std::vector<int> col_lens_;         // 字段的长度
     int col_tot_len_;                   // 索引包含的字段的总长度
-    int btree_order_;                   // # children per page 每个结点最多可插入的键值对数量
-    int keys_size_;                     // keys_size = (btree_order + 1) * col_tot_len
+    int btree_order_;                   // key不可压缩时每个结点最多可插入的键值对数量（结点实际按字节容量管理）
+    int keys_size_;                     // keys_size = (btree_order + 1) * key_len
     // first_leaf初始化之后没有进行修改，只不过是在测试文件中遍历叶子结点的时候用了
     page_id_t first_leaf_;              // 首叶节点对应的页号，在上层IxManager的open函数进行初始化，初始化为root page_no
     page_id_t last_leaf_;               // 尾叶节点对应的页号
     int tot_len_;                       // 记录结构体的整体长度
+    // 非唯一索引在B+树中存储的key为 索引字段 + Rid，Rid作为tiebreaker保证树内key仍然唯一
+    bool unique_;                       // 是否为唯一索引
+    // 以下统计信息在插入、删除、分裂、合并时增量维护，供优化器估算代价；SHOW INDEX STATS会用精确值校正
+    int num_keys_;                      // 索引中键值对的数量
+    int num_leaf_pages_;                // 叶子结点的数量
+    int num_internal_pages_;            // 内部结点的数量
+    int height_;                        // 树高，只有一个叶子结点（根结点）时为1
+    int version_;                       // 文件格式版本，见IX_FILE_VERSION
 
     IxFileHdr() {
         tot_len_ = col_num_ = 0;
+        unique_ = true;
+        num_keys_ = num_leaf_pages_ = num_internal_pages_ = height_ = 0;
+        version_ = IX_FILE_VERSION;
     }
 
     IxFileHdr(page_id_t first_free_page_no, int num_pages, page_id_t root_page, int col_num,
-                int col_tot_len, int btree_order, int keys_size, page_id_t first_leaf, page_id_t last_leaf)
+                int col_tot_len, int btree_order, int keys_size, page_id_t first_leaf, page_id_t last_leaf,
+                bool unique = true)
                 : first_free_page_no_(first_free_page_no), num_pages_(num_pages), root_page_(root_page), col_num_(col_num),
-                col_tot_len_(col_tot_len), btree_order_(btree_order), keys_size_(keys_size), first_leaf_(first_leaf), last_leaf_(last_leaf) {
+                col_tot_len_(col_tot_len), btree_order_(btree_order), keys_size_(keys_size), first_leaf_(first_leaf), last_leaf_(last_leaf),
+                unique_(unique), num_keys_(0), num_leaf_pages_(1), num_internal_pages_(0), height_(1),
+                version_(IX_FILE_VERSION) {
                     tot_len_ = 0;
                 } 
 
+    // B+树结点中每个key槽的长度，非唯一索引在索引字段后附加Rid
+    int key_len() const { return unique_ ? col_tot_len_ : col_tot_len_ + static_cast<int>(sizeof(Rid)); }
+
     void update_tot_len() {
         tot_len_ = 0;
         tot_len_ += sizeof(page_id_t) * 4 + sizeof(int) * 6;
         tot_len_ += sizeof(ColType) * col_num_ + sizeof(int) * col_num_;
+        tot_len_ += sizeof(bool);
+        tot_len_ += sizeof(int) * 4;
+        tot_len_ += sizeof(int) * 2;
     }
 
     void serialize(char* dest) {
         int offset = 0;
+        int magic = IX_FILE_MAGIC;
+        memcpy(dest + offset, &magic, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &version_, sizeof(int));
+        offset += sizeof(int);
         memcpy(dest + offset, &tot_len_, sizeof(int));
         offset += sizeof(int);
         memcpy(dest + offset, &first_free_page_no_, sizeof(page_id_t));
@@ -85,11 +115,35 @@ public:
         offset += sizeof(page_id_t);
         memcpy(dest + offset, &last_leaf_, sizeof(page_id_t));
         offset += sizeof(page_id_t);
+        memcpy(dest + offset, &unique_, sizeof(bool));
+        offset += sizeof(bool);
+        memcpy(dest + offset, &num_keys_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &num_leaf_pages_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &num_internal_pages_, sizeof(int));
+        offset += sizeof(int);
+        memcpy(dest + offset, &height_, sizeof(int));
+        offset += sizeof(int);
         assert(offset == tot_len_);
     }
 
+    /**
+     * @brief 从文件头页面读取文件头
+     * @throws IndexFormatError 文件不是当前版本的格式（包括加入版本号之前的文件），需要按表中的记录重建
+     */
     void deserialize(char* src) {
         int offset = 0;
+        int magic = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        version_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        if (magic != IX_FILE_MAGIC) {
+            throw IndexFormatError(0);
+        }
+        if (version_ != IX_FILE_VERSION) {
+            throw IndexFormatError(version_);
+        }
         tot_len_ = *reinterpret_cast<const int*>(src + offset);
         offset += sizeof(int);
         first_free_page_no_ = *reinterpret_cast<const page_id_t*>(src + offset);
@@ -123,10 +177,33 @@ public:
         offset += sizeof(page_id_t);
         last_leaf_ = *reinterpret_cast<const page_id_t*>(src + offset);
         offset += sizeof(page_id_t);
-        assert(offset == tot_len_);
+        unique_ = *reinterpret_cast<const bool*>(src + offset);
+        offset += sizeof(bool);
+        num_keys_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        num_leaf_pages_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        num_internal_pages_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        height_ = *reinterpret_cast<const int*>(src + offset);
+        offset += sizeof(int);
+        if (offset != tot_len_) {
+            throw IndexFormatError(version_);
+        }
     }
 };
 
+/* SHOW INDEX STATS的结果，由IxIndexHandle::collect_stats()遍历整棵B+树得到 */
+struct IxIndexStats {
+    int height = 0;                 // 树高，只有一个叶子结点时为1
+    int leaf_pages = 0;             // 叶子结点的数量
+    int internal_pages = 0;         // 内部结点的数量
+    int free_pages = 0;             // 文件中已分配但不属于B+树的页面（合并时释放的结点）
+    double fill_factor = 0;         // 结点中键值对占用的字节数与结点容量之比的平均值
+    int num_keys = 0;               // 键值对的数量
+    int num_distinct = 0;           // 第一个索引字段不同取值的数量
+};
+
 class IxPageHdr {
 public:
     page_id_t next_free_page_no;    // unused
@@ -135,6 +212,8 @@ public:
     bool is_leaf;                   // 是否为叶节点
     page_id_t prev_leaf;            // previous leaf node's page_no, effective only when is_leaf is true
     page_id_t next_leaf;            // next leaf node's page_no, effective only when is_leaf is true
+    int prefix_len;                 // 结点内所有key的公共前缀长度，公共前缀只在页面中存储一份
+    int data_start;                 // 页面尾部key区的起始偏移，key区从页尾向前增长（空结点为PAGE_SIZE）
 };
 
 class Iid {
@@ -12,6 +12,226 @@ See the Mulan PSL v2 for more details. */
 
 #include "ix_scan.h"
 
+#include <climits>
+
+// 非唯一索引按索引字段查找时，用最小/最大的Rid补齐key，从而定位到该索引字段所有项的起止位置
+static const Rid IX_MIN_RID = {.page_no = INT_MIN, .slot_no = INT_MIN};
+static const Rid IX_MAX_RID = {.page_no = INT_MAX, .slot_no = INT_MAX};
+
+// key中最后一个非0字节之后的部分（CHAR字段末尾补的0、被截断的分隔key）不需要存储
+static int significant_len(const char *key, int len) {
+    while (len > 0 && key[len - 1] == 0) len--;
+    return len;
+}
+
+/**
+ * @brief 计算entries中[begin,end)的键值对编码到一个结点中需要的字节数（不含页头）
+ *
+ * @param stored_len 每个key需要编码的长度
+ * @param[out] prefix_len 这些key的公共前缀长度
+ */
+static int encoded_size(const IxNodeEntries &entries, int begin, int end, int stored_len, int *prefix_len) {
+    int prefix = begin < end ? stored_len : 0;
+    for (int i = begin + 1; i < end && prefix > 0; i++) {
+        const char *first = entries.key(begin);
+        const char *key = entries.key(i);
+        int j = 0;
+        while (j < prefix && first[j] == key[j]) j++;
+        prefix = j;
+    }
+    int size = ((prefix + 3) & ~3) + (end - begin) * static_cast<int>(sizeof(IxSlot));
+    for (int i = begin; i < end; i++) {
+        size += std::max(significant_len(entries.key(i), stored_len) - prefix, 0);
+    }
+    *prefix_len = prefix;
+    return size;
+}
+
+static bool fits_in_node(const IxNodeEntries &entries, int begin, int end, int stored_len) {
+    int prefix_len;
+    return encoded_size(entries, begin, end, stored_len, &prefix_len) <= IxNodeHandle::NODE_CAPACITY;
+}
+
+/**
+ * @brief 按编码后的字节数把entries分成大致相等的两半，返回右半部分的起始位置，范围为[1,n-1]
+ */
+static int balanced_cut(const IxNodeEntries &entries, int stored_len) {
+    int n = entries.size();
+    int prefix_len;
+    int total = encoded_size(entries, 0, n, stored_len, &prefix_len);
+    int sum = 0;
+    int cut = 1;
+    for (; cut < n - 1; cut++) {
+        sum += static_cast<int>(sizeof(IxSlot)) +
+               std::max(significant_len(entries.key(cut - 1), stored_len) - prefix_len, 0);
+        if (sum * 2 >= total) break;
+    }
+    return cut;
+}
+
+void IxNodeHandle::init(bool is_leaf, page_id_t parent) {
+    page_hdr->next_free_page_no = IX_NO_PAGE;
+    page_hdr->parent = parent;
+    page_hdr->num_key = 0;
+    page_hdr->is_leaf = is_leaf;
+    page_hdr->prev_leaf = IX_NO_PAGE;
+    page_hdr->next_leaf = IX_NO_PAGE;
+    page_hdr->prefix_len = 0;
+    page_hdr->data_start = PAGE_SIZE;
+}
+
+void IxNodeHandle::get_key(int key_idx, char *key) const {
+    int stored = stored_len();
+    int prefix = page_hdr->prefix_len;
+    const IxSlot *slot = get_slot(key_idx);
+    memcpy(key, get_prefix(), prefix);
+    memcpy(key + prefix, page->get_data() + slot->offset, slot->len);
+    memset(key + prefix + slot->len, 0, stored - prefix - slot->len);
+    if (stored < file_hdr->key_len()) {
+        memcpy(key + stored, &slot->rid, sizeof(Rid));
+    }
+}
+
+/**
+ * @brief 用结点的公共前缀与target比较，完全位于前缀中的字段对结点中所有key的比较结果相同
+ * 字符串字段按字节比较，跨越前缀末尾时前缀部分也可以先比较；数值字段跨越前缀末尾时留给逐个key比较
+ */
+IxNodeHandle::PrefixMatch IxNodeHandle::match_prefix(const char *target) const {
+    int prefix = page_hdr->prefix_len;
+    const char *prefix_data = get_prefix();
+    int offset = 0;
+    for (size_t col = 0; col < file_hdr->col_types_.size(); col++) {
+        ColType type = file_hdr->col_types_[col];
+        int len = file_hdr->col_lens_[col];
+        if (offset + len <= prefix) {
+            int res = ix_compare(prefix_data + offset, target + offset, type, len);
+            if (res != 0) return {res, static_cast<int>(col), offset, offset};
+            offset += len;
+            continue;
+        }
+        if (type == TYPE_STRING && offset < prefix) {
+            int res = memcmp(prefix_data + offset, target + offset, prefix - offset);
+            return {res, static_cast<int>(col), offset, prefix};
+        }
+        return {0, static_cast<int>(col), offset, offset};
+    }
+    return {0, static_cast<int>(file_hdr->col_types_.size()), offset, offset};
+}
+
+int IxNodeHandle::compare_key(int key_idx, const char *target, const PrefixMatch &match) const {
+    if (match.res != 0) return match.res;
+    int prefix = page_hdr->prefix_len;
+    const IxSlot *slot = get_slot(key_idx);
+    // key的[prefix, suffix_end)存储在suffix中，suffix_end到stored_len()之间是省略的0
+    const char *suffix = page->get_data() + slot->offset;
+    int suffix_end = prefix + slot->len;
+    int stored = stored_len();
+    auto key_byte = [&](int i) -> char {
+        if (i < prefix) return get_prefix()[i];
+        if (i < suffix_end) return suffix[i - prefix];
+        if (i < stored) return 0;
+        return reinterpret_cast<const char *>(&slot->rid)[i - stored];
+    };
+
+    int col_offset = match.col_offset;
+    int offset = match.offset;
+    for (size_t col = match.col; col < file_hdr->col_types_.size(); col++) {
+        ColType type = file_hdr->col_types_[col];
+        int col_end = col_offset + file_hdr->col_lens_[col];
+        if (type == TYPE_STRING) {
+            // 字符串字段从offset开始（不在前缀中）：先比较存储的后缀，再比较省略的0
+            int n = std::min(col_end, suffix_end) - offset;
+            if (n > 0) {
+                int res = memcmp(suffix + (offset - prefix), target + offset, n);
+                if (res != 0) return res;
+                offset += n;
+            }
+            for (; offset < col_end; offset++) {
+                if (target[offset] != 0) return -1;
+            }
+        } else {
+            char value[sizeof(double)];
+            for (int i = col_offset; i < col_end; i++) {
+                value[i - col_offset] = key_byte(i);
+            }
+            int res = ix_compare(value, target + col_offset, type, col_end - col_offset);
+            if (res != 0) return res;
+        }
+        col_offset = offset = col_end;
+    }
+    if (file_hdr->unique_) return 0;
+
+    // 索引字段相同，比较非唯一索引附加的Rid
+    Rid rid, target_rid;
+    for (int i = 0; i < static_cast<int>(sizeof(Rid)); i++) {
+        reinterpret_cast<char *>(&rid)[i] = key_byte(file_hdr->col_tot_len_ + i);
+    }
+    memcpy(&target_rid, target + file_hdr->col_tot_len_, sizeof(Rid));
+    if (rid.page_no != target_rid.page_no) return rid.page_no < target_rid.page_no ? -1 : 1;
+    if (rid.slot_no != target_rid.slot_no) return rid.slot_no < target_rid.slot_no ? -1 : 1;
+    return 0;
+}
+
+int IxNodeHandle::suffix_len(const char *key) const {
+    int prefix = page_hdr->prefix_len;
+    if (memcmp(key, get_prefix(), prefix) != 0) return -1;
+    return std::max(significant_len(key, stored_len()) - prefix, 0);
+}
+
+bool IxNodeHandle::set_key(int key_idx, const char *key) {
+    int len = suffix_len(key);
+    IxSlot *slot = get_slot(key_idx);
+    if (len >= 0 && (len <= slot->len || len <= free_bytes())) {
+        if (len > slot->len) {
+            page_hdr->data_start -= len;
+            slot->offset = static_cast<uint16_t>(page_hdr->data_start);
+        }
+        memcpy(page->get_data() + slot->offset, key + page_hdr->prefix_len, len);
+        slot->len = static_cast<uint16_t>(len);
+        return true;
+    }
+    IxNodeEntries entries(file_hdr->key_len());
+    load(&entries);
+    memcpy(entries.key(key_idx), key, file_hdr->key_len());
+    return store(entries, 0, entries.size());
+}
+
+int IxNodeHandle::used_bytes() const {
+    int size = ((page_hdr->prefix_len + 3) & ~3) + page_hdr->num_key * static_cast<int>(sizeof(IxSlot));
+    for (int i = 0; i < page_hdr->num_key; i++) {
+        size += get_slot(i)->len;
+    }
+    return size;
+}
+
+void IxNodeHandle::load(IxNodeEntries *entries) const {
+    int old_size = entries->size();
+    entries->keys.resize((old_size + page_hdr->num_key) * entries->key_len);
+    entries->rids.resize(old_size + page_hdr->num_key);
+    for (int i = 0; i < page_hdr->num_key; i++) {
+        get_key(i, entries->key(old_size + i));
+        entries->rids[old_size + i] = *get_rid(i);
+    }
+}
+
+bool IxNodeHandle::store(const IxNodeEntries &entries, int begin, int end) {
+    int stored = stored_len();
+    int prefix;
+    if (encoded_size(entries, begin, end, stored, &prefix) > NODE_CAPACITY) return false;
+    page_hdr->num_key = end - begin;
+    page_hdr->prefix_len = prefix;
+    page_hdr->data_start = PAGE_SIZE;
+    if (begin < end) memcpy(get_prefix(), entries.key(begin), prefix);
+    for (int i = begin; i < end; i++) {
+        int len = std::max(significant_len(entries.key(i), stored) - prefix, 0);
+        page_hdr->data_start -= len;
+        memcpy(page->get_data() + page_hdr->data_start, entries.key(i) + prefix, len);
+        *get_slot(i - begin) = IxSlot{entries.rids[i], static_cast<uint16_t>(page_hdr->data_start),
+                                      static_cast<uint16_t>(len)};
+    }
+    return true;
+}
+
 /**
  * @brief 在当前node中查找第一个>=target的key_idx
  *
@@ -22,15 +242,15 @@ int IxNodeHandle::lower_bound(const char *target) const {
     // Todo:
     // 查找当前节点中第一个大于等于target的key，并返回key的位置给上层
     // 提示: 可以采用多种查找方式，如顺序遍历、二分查找等；使用ix_compare()函数进行比较
+    PrefixMatch match = match_prefix(target);
     int left = 0,right = page_hdr->num_key - 1;
     while (left <= right) {// 查询右边界
         int mid = left + (right - left) / 2;
-        int res = ix_compare(get_key(mid),target,file_hdr->col_types_,file_hdr->col_lens_);
+        int res = compare_key(mid,target,match);
         if(res < 0) left = mid + 1;
         else right = mid - 1;
     }
-    if(get_key(right) == target) return right; //说明target存在,right指向target
-    return left; //target不存在,left为第一个大于target的key
+    return left; //left为第一个大于等于target的key
 }
 
 /**
@@ -43,10 +263,11 @@ int IxNodeHandle::upper_bound(const char *target) const {
     // Todo:
     // 查找当前节点中第一个大于target的key，并返回key的位置给上层
     // 提示: 可以采用多种查找方式：顺序遍历、二分查找等；使用ix_compare()函数进行比较
+    PrefixMatch match = match_prefix(target);
     int left = 0,right = page_hdr->num_key - 1;
     while (left <= right) {
         int mid = left + (right - left) / 2;
-        int res = ix_compare(get_key(mid),target,file_hdr->col_types_,file_hdr->col_lens_);
+        int res = compare_key(mid,target,match);
         if(res <= 0) left = mid + 1;
         else right = mid - 1;
     }
@@ -67,10 +288,11 @@ bool IxNodeHandle::leaf_lookup(const char *key, Rid **value) {
     // 2. 判断目标key是否存在
     // 3. 如果存在，获取key对应的Rid，并赋值给传出参数value
     // 提示：可以调用lower_bound()和get_rid()函数。
+    PrefixMatch match = match_prefix(key);
     int left = 0,right = get_size() - 1;
     while (left <= right) {
         int mid = left + (right - left) / 2;
-        int res = ix_compare(get_key(mid),key,file_hdr->col_types_,file_hdr->col_lens_);
+        int res = compare_key(mid,key,match);
         if(res < 0) left = mid + 1;
         else if (res > 0) right = mid - 1;
         else {
@@ -91,78 +313,62 @@ page_id_t IxNodeHandle::internal_lookup(const char *key) {
     // 1. 查找当前非叶子节点中目标key所在孩子节点（子树）的位置
     // 2. 获取该孩子节点（子树）所在页面的编号
     // 3. 返回页面编号
-    auto idx = upper_bound(key);
-    return get_rid(std::max(idx - 1, 0))->page_no;
+    // 第0个key不参与比较，视为负无穷：最左路径上的结点中第0个key不一定是子树中key的下界
+    PrefixMatch match = match_prefix(key);
+    int left = 1,right = get_size() - 1;
+    while (left <= right) {
+        int mid = left + (right - left) / 2;
+        int res = compare_key(mid,key,match);
+        if(res <= 0) left = mid + 1;
+        else right = mid - 1;
+    }
+    return get_rid(left - 1)->page_no;
 }
 
 /**
- * @brief 在指定位置插入n个连续的键值对
- * 将key的前n位插入到原来keys中的pos位置；将rid的前n位插入到原来rids中的pos位置
+ * @brief 在指定位置插入单个键值对
+ * key与结点的公共前缀匹配且空闲空间足够时直接追加到key区，否则解码整个结点后重新编码（同时回收删除留下的空洞）
  *
  * @param pos 要插入键值对的位置
- * @param (key, rid) 连续键值对的起始地址，也就是第一个键值对，可以通过(key, rid)来获取n个键值对
- * @param n 键值对数量
- * @note [0,pos)           [pos,num_key)
- *                            key_slot
- *                            /      \
- *                           /        \
- *       [0,pos)     [pos,pos+n)   [pos+n,num_key+n)
- *                      key           key_slot
- */
-void IxNodeHandle::insert_pairs(int pos, const char *key, const Rid *rid, int n) {
-    // Todo:
-    // 1. 判断pos的合法性
-    // 2. 通过key获取n个连续键值对的key值，并把n个key值插入到pos位置
-    // 3. 通过rid获取n个连续键值对的rid值，并把n个rid值插入到pos位置
-    // 4. 更新当前节点的键数量
-    if(pos<0 || pos > get_size()) return;
-    memmove(get_key(pos + n),get_key(pos),(get_size() - pos) * file_hdr->col_tot_len_);
-    memmove(get_rid(pos + n) ,get_rid(pos),(get_size() - pos) * sizeof(Rid));
-    memcpy(get_key(pos),key,n * file_hdr->col_tot_len_);
-    memcpy(get_rid(pos),rid,n * sizeof(Rid));
-    set_size(page_hdr->num_key + n);
-}
-
-/**
- * @brief 用于在结点中插入单个键值对。
- * 函数返回插入后的键值对数量
- *
- * @param (key, value) 要插入的键值对
- * @return int 键值对数量
+ * @param (key, rid) 要插入的键值对
+ * @return 结点放不下时返回false，此时结点不变，需要由上层拆分
  */
-int IxNodeHandle::insert(const char *key, const Rid &value) {
-    // Todo:
-    // 1. 查找要插入的键值对应该插入到当前节点的哪个位置
-    // 2. 如果key重复则不插入
-    // 3. 如果key不重复则插入键值对
-    // 4. 返回完成插入操作之后的键值对数量
-    int idx = lower_bound(key);
-    //如果要插入的值不存在
-    if (idx == get_size() || ix_compare(get_key(idx),key,file_hdr->col_types_,file_hdr->col_lens_)!=0)
-        insert_pair(idx,key,value);
-    else throw RMDBError("Duplicate entry for unique key");
-    return get_size();
+bool IxNodeHandle::insert_pair(int pos, const char *key, const Rid &rid) {
+    assert(pos >= 0 && pos <= get_size());
+    int len = suffix_len(key);
+    if (len >= 0 && free_bytes() >= static_cast<int>(sizeof(IxSlot)) + len) {
+        page_hdr->data_start -= len;
+        memcpy(page->get_data() + page_hdr->data_start, key + page_hdr->prefix_len, len);
+        IxSlot *slot = get_slot(pos);
+        memmove(slot + 1, slot, (get_size() - pos) * sizeof(IxSlot));
+        *slot = IxSlot{rid, static_cast<uint16_t>(page_hdr->data_start), static_cast<uint16_t>(len)};
+        set_size(get_size() + 1);
+        return true;
+    }
+    IxNodeEntries entries(file_hdr->key_len());
+    load(&entries);
+    entries.insert(pos, key, rid);
+    return store(entries, 0, entries.size());
 }
 
 /**
  * @brief 用于在结点中的指定位置删除单个键值对
+ * key区中被删除的后缀留下空洞，在下一次重新编码结点时回收
  *
  * @param pos 要删除键值对的位置
  */
 void IxNodeHandle::erase_pair(int pos) {
-    // Todo:
-    // 1. 删除该位置的key
-    // 2. 删除该位置的rid
-    // 3. 更新结点的键值对数量
     if (pos < 0 || pos >= get_size()) return ;
-    if (pos == get_size() - 1){ //删除的是最后一个元素
-        memset(get_key(pos),0,file_hdr->col_tot_len_);
-        memset(get_rid(pos),0,sizeof (Rid));
-    }else{
-        memmove(get_key(pos),get_key(pos + 1),(get_size() - pos - 1) * file_hdr->col_tot_len_);
-        memmove(get_rid(pos),get_rid(pos + 1),(get_size() - pos - 1) * sizeof (Rid));
+    IxSlot *slot = get_slot(pos);
+    if (slot->offset == page_hdr->data_start) {
+        page_hdr->data_start += slot->len;
     }
+    memmove(slot, slot + 1, (get_size() - pos - 1) * sizeof(IxSlot));
     set_size(get_size() - 1);
+    if (get_size() == 0) {
+        page_hdr->prefix_len = 0;
+        page_hdr->data_start = PAGE_SIZE;
+    }
 }
 
 /**
@@ -177,7 +383,7 @@ int IxNodeHandle::remove(const char *key) {
     // 2. 如果要删除的键值对存在，删除键值对
     // 3. 返回完成删除操作后的键值对数量
     int idx = lower_bound(key);
-    if (idx != get_size() && ix_compare(get_key(idx),key,file_hdr->col_types_,file_hdr->col_lens_) == 0)
+    if (idx != get_size() && compare_key(idx,key) == 0)
         erase_pair(idx);
     return get_size();
 }
@@ -190,11 +396,28 @@ IxIndexHandle::IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffe
     memset(buf, 0, PAGE_SIZE);
     disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, buf, PAGE_SIZE);
     file_hdr_ = new IxFileHdr();
-    file_hdr_->deserialize(buf);
+    try {
+        file_hdr_->deserialize(buf);
+    } catch (IndexFormatError &e) {
+        delete file_hdr_;
+        delete[] buf;
+        throw;
+    }
+    delete[] buf;
 
     // disk_manager管理的fd对应的文件中，设置从file_hdr_->num_pages开始分配page_no
     int now_page_no = disk_manager_->get_fd2pageno(fd);
     disk_manager_->set_fd2pageno(fd, now_page_no + 1);
+
+    rebuild_bloom_filter();
+    if (file_hdr_->unique_) {
+        art_cache_ = std::make_unique<IxArtCache>(file_hdr_->col_types_, file_hdr_->col_lens_);
+    }
+}
+
+void IxIndexHandle::set_cache_budget(size_t budget) {
+    std::scoped_lock<std::mutex> lock{root_latch_};
+    if (art_cache_ != nullptr) art_cache_->set_budget(budget);
 }
 
 /**
@@ -235,57 +458,211 @@ bool IxIndexHandle::get_value(const char *key, std::vector<Rid> *result, Transac
     // 3. 把rid存入result参数中
     // 提示：使用完buffer_pool提供的page之后，记得unpin page；记得处理并发的上锁
     std::scoped_lock<std::mutex> lock{root_latch_};
-    IxNodeHandle* leaf = find_leaf_page(key,Operation::FIND,transaction).first;
-    Rid* rid = nullptr;
-    bool exist = leaf->leaf_lookup(key,&rid);
-    if (exist) result->push_back(*rid);
+    // 大部分唯一性检查和点查询的key都不存在，Bloom filter判定不存在时不必下降B+树
+    if (!bloom_may_contain(key)) return false;
+    if (file_hdr_->unique_) {
+        // 缓存命中时不访问缓冲池；未命中时查B+树，并把找到的key放入缓存
+        Rid cached;
+        if (art_cache_->lookup(key, &cached)) {
+            result->push_back(cached);
+            return true;
+        }
+        IxNodeHandle* leaf = find_leaf_page(key,Operation::FIND,transaction).first;
+        Rid* rid = nullptr;
+        bool exist = leaf->leaf_lookup(key,&rid);
+        if (exist) {
+            result->push_back(*rid);
+            art_cache_->insert(key, *rid);
+        }
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+        return exist;
+    }
+    // 非唯一索引：从(key, 最小Rid)开始沿叶子链表收集所有索引字段等于key的rid
+    char buf[IX_MAX_KEY_LEN];
+    const char *tree_key = make_tree_key(key, IX_MIN_RID, buf);
+    IxNodeHandle* leaf = find_leaf_page(tree_key,Operation::FIND,transaction).first;
+    int idx = leaf->lower_bound(tree_key);
+    bool exist = false;
+    char leaf_key[IX_MAX_KEY_LEN];
+    while (true) {
+        if (idx == leaf->get_size()) {
+            bool is_last = leaf->get_page_no() == file_hdr_->last_leaf_;
+            page_id_t next_page_no = leaf->get_next_leaf();
+            buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+            if (is_last) return exist;
+            leaf = fetch_node(next_page_no);
+            idx = 0;
+            continue;
+        }
+        leaf->get_key(idx, leaf_key);
+        if (ix_compare(leaf_key, key, file_hdr_->col_types_, file_hdr_->col_lens_) != 0) break;
+        result->push_back(*leaf->get_rid(idx));
+        exist = true;
+        idx++;
+    }
     buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
     return exist;
 }
 
 /**
- * @brief  将传入的一个node拆分(Split)成两个结点，在node的右边生成一个新结点new node
+ * @brief 批量查找一组升序排列的key，用于index nested loop join、IN列表等需要大量探测索引的场景
+ * 排好序的key大多落在同一个或相邻的叶子中：下一个key仍在当前叶子范围内时直接复用当前叶子，
+ * 只有超出当前叶子时才从根结点重新下降；每进入一个叶子就预取它的后继叶子
+ *
+ * @param keys 按索引字段升序排列的key，每个key的长度为col_tot_len
+ * @param[out] results results[i]存放keys[i]对应的所有rid，key不存在时为空
+ * @param transaction 事务指针
+ * @return int 存在于索引中的key的数量
+ */
+int IxIndexHandle::get_values(const std::vector<const char *> &keys, std::vector<std::vector<Rid>> *results,
+                              Transaction *transaction) {
+    std::scoped_lock<std::mutex> lock{root_latch_};
+    results->assign(keys.size(), std::vector<Rid>());
+    int found = 0;
+    char buf[IX_MAX_KEY_LEN];
+    char leaf_key[IX_MAX_KEY_LEN];
+    IxNodeHandle *leaf = nullptr;
+    for (size_t i = 0; i < keys.size(); i++) {
+        // 重复的key直接复用上一个结果（收集上一个key时当前叶子可能已经越过了这些项）
+        if (i > 0 && ix_compare(keys[i], keys[i - 1], file_hdr_->col_types_, file_hdr_->col_lens_) == 0) {
+            (*results)[i] = (*results)[i - 1];
+            if (!(*results)[i].empty()) found++;
+            continue;
+        }
+        // 跳过一定不存在的key不会改变当前叶子，仍可继续复用
+        if (!bloom_may_contain(keys[i])) continue;
+        Rid cached;
+        if (art_cache_ != nullptr && art_cache_->lookup(keys[i], &cached)) {
+            (*results)[i].push_back(cached);
+            found++;
+            continue;
+        }
+        const char *tree_key = make_tree_key(keys[i], IX_MIN_RID, buf);
+        int idx = 0;
+        if (leaf != nullptr) {
+            // 当前叶子之前的项都小于上一个key，因此只要下一个key的下界落在当前叶子内就可以复用
+            idx = leaf->lower_bound(tree_key);
+            if (idx == leaf->get_size()) {
+                buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+                leaf = nullptr;
+            }
+        }
+        if (leaf == nullptr) {
+            leaf = find_leaf_page(tree_key, Operation::FIND, transaction).first;
+            prefetch_next_leaf(leaf);
+            idx = leaf->lower_bound(tree_key);
+        }
+        // 非唯一索引中相同的key可能跨越多个叶子
+        auto &result = (*results)[i];
+        while (true) {
+            if (idx == leaf->get_size()) {
+                if (leaf->get_page_no() == file_hdr_->last_leaf_) break;
+                page_id_t next_page_no = leaf->get_next_leaf();
+                buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+                leaf = fetch_node(next_page_no);
+                prefetch_next_leaf(leaf);
+                idx = 0;
+                continue;
+            }
+            leaf->get_key(idx, leaf_key);
+            if (ix_compare(leaf_key, keys[i], file_hdr_->col_types_, file_hdr_->col_lens_) != 0) break;
+            result.push_back(*leaf->get_rid(idx));
+            if (file_hdr_->unique_) {
+                art_cache_->insert(keys[i], result.back());
+                break;
+            }
+            idx++;
+        }
+        if (!result.empty()) found++;
+    }
+    if (leaf != nullptr) {
+        buffer_pool_manager_->unpin_page(leaf->get_page_id(), false);
+    }
+    return found;
+}
+
+/**
+ * @brief 将放不下的结点拆分(Split)：把entries中的键值对重新编码，分配到node和在node右边新建的结点中，
+ * 并把新结点的分隔key插入父结点
+ * 优先选取使两边字节数接近的拆分点；key之间差异很大导致公共前缀很短时两个结点可能放不下，
+ * 此时按顺序尽量填满每个结点，可能产生多个新结点
+ *
  * @param node 需要拆分的结点
- * @return 拆分得到的new_node
- * @note need to unpin the new node outside
- * 注意：本函数执行完毕后，原node和new node都需要在函数外面进行unpin
+ * @param entries node中原有的键值对加上新插入的键值对
+ * @note node需要在函数外面进行unpin，新结点在函数内部unpin
  */
-IxNodeHandle *IxIndexHandle::split(IxNodeHandle *node) {
+void IxIndexHandle::split(IxNodeHandle *node, const IxNodeEntries &entries, Transaction *transaction) {
     // Todo:
     // 1. 将原结点的键值对平均分配，右半部分分裂为新的右兄弟结点
     //    需要初始化新节点的page_hdr内容
     // 2. 如果新的右兄弟结点是叶子结点，更新新旧节点的prev_leaf和next_leaf指针
     //    为新节点分配键值对，更新旧节点的键值对数记录
     // 3. 如果新的右兄弟结点不是叶子结点，更新该结点的所有孩子结点的父节点信息(使用IxIndexHandle::maintain_child())
-    auto node_new = create_node();
-    node_new->page_hdr->next_free_page_no = node->page_hdr->next_free_page_no;
-    node->page_hdr->next_free_page_no = node_new->get_page_no();
-    node_new->set_parent_page_no(node->get_parent_page_no());
-    node_new->page_hdr->is_leaf = node->page_hdr->is_leaf;
-    int mid = node->get_size()/2;
-    int num_new = node->get_size() - mid;
-    node_new->insert_pairs(0,node->get_key(mid),node->get_rid(mid),num_new);
-    node->set_size(mid);
-    if (node_new->is_leaf_page()){
-        node_new->set_next_leaf(node->get_next_leaf());
-        auto origin_next_node = fetch_node(node_new->get_next_leaf());
-        origin_next_node->set_prev_leaf(node_new->get_page_no());
-        node_new->set_prev_leaf(node->get_page_no());
-        node->set_next_leaf(node_new->get_page_no());
-        buffer_pool_manager_->unpin_page(origin_next_node->get_page_id(),true);
-    }else{
-        for (int i = 0;i < node_new->get_size();i++){
-            maintain_child(node_new,i);
+    static const int MAX_CUT_PROBES = 16;
+    int n = entries.size();
+    int stored_len = node->stored_len();
+    std::vector<int> cuts{0};
+    int mid = balanced_cut(entries, stored_len);
+    for (int i = 0; i < MAX_CUT_PROBES && cuts.size() == 1; i++) {
+        int cut = i % 2 == 0 ? mid + i / 2 : mid - (i + 1) / 2;
+        if (cut < 1 || cut > n - 1) continue;
+        if (fits_in_node(entries, 0, cut, stored_len) && fits_in_node(entries, cut, n, stored_len)) {
+            cuts.push_back(cut);
+        }
+    }
+    if (cuts.size() == 1) {
+        for (int begin = 0, end = 1; end < n; end++) {
+            if (!fits_in_node(entries, begin, end + 1, stored_len)) {
+                cuts.push_back(end);
+                begin = end;
+            }
+        }
+    }
+    cuts.push_back(n);
+
+    bool stored = node->store(entries, cuts[0], cuts[1]);
+    assert(stored);
+    IxNodeHandle *prev = node;
+    for (size_t i = 1; i + 1 < cuts.size(); i++) {
+        IxNodeHandle *node_new = create_node();
+        node_new->init(prev->is_leaf_page(), prev->get_parent_page_no());
+        if (node_new->is_leaf_page()) {
+            file_hdr_->num_leaf_pages_++;
+        } else {
+            file_hdr_->num_internal_pages_++;
+        }
+        stored = node_new->store(entries, cuts[i], cuts[i + 1]);
+        assert(stored);
+        char separator[IX_MAX_KEY_LEN];
+        if (node_new->is_leaf_page()) {
+            node_new->set_next_leaf(prev->get_next_leaf());
+            auto origin_next_node = fetch_node(node_new->get_next_leaf());
+            origin_next_node->set_prev_leaf(node_new->get_page_no());
+            node_new->set_prev_leaf(prev->get_page_no());
+            prev->set_next_leaf(node_new->get_page_no());
+            buffer_pool_manager_->unpin_page(origin_next_node->get_page_id(), true);
+            if (file_hdr_->last_leaf_ == prev->get_page_no()) {
+                file_hdr_->last_leaf_ = node_new->get_page_no();
+            }
+            make_separator(entries.key(cuts[i] - 1), entries.key(cuts[i]), separator);
+        } else {
+            for (int j = 0; j < node_new->get_size(); j++) {
+                maintain_child(node_new, j);
+            }
+            memcpy(separator, entries.key(cuts[i]), file_hdr_->key_len());
         }
+        insert_into_parent(prev, separator, node_new, transaction);
+        if (prev != node) buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
+        prev = node_new;
     }
-    return node_new;
+    if (prev != node) buffer_pool_manager_->unpin_page(prev->get_page_id(), true);
 }
 
 /**
  * @brief Insert key & value pair into internal page after split
  * 拆分(Split)后，向上找到old_node的父结点
- * 将new_node的第一个key插入到父结点，其位置在 父结点指向old_node的孩子指针 之后
- * 如果插入后>=maxsize，则必须继续拆分父结点，然后在其父结点的父结点再插入，即需要递归
+ * 将new_node的分隔key插入到父结点，其位置在 父结点指向old_node的孩子指针 之后
+ * 如果父结点放不下，则必须继续拆分父结点，然后在其父结点的父结点再插入，即需要递归
  * 直到找到的old_node为根结点时，结束递归（此时将会新建一个根R，关键字为key，old_node和new_node为其孩子）
  *
  * @param (old_node, new_node) 原结点为old_node，old_node被分裂之后产生了新的右兄弟结点new_node
@@ -305,27 +682,88 @@ void IxIndexHandle::insert_into_parent(IxNodeHandle *old_node, const char *key,
     if (!old_node->is_root_page()){
         auto parent = fetch_node(old_node->get_parent_page_no());
         int old_index = parent->find_child(old_node);
-        parent->insert_pair(old_index + 1,key,{new_node->get_page_no(),-1});
-        if (parent->get_size() >= parent->get_max_size()){
-            auto new_parent = split(parent);
-            insert_into_parent(parent,new_parent->get_key(0),new_parent,transaction);
-        }
+        insert_into_node(parent, old_index + 1, key, {new_node->get_page_no(), -1}, transaction);
+        buffer_pool_manager_->unpin_page(parent->get_page_id(), true);
     } else{
         auto root_new = create_node();
+        root_new->init(false, INVALID_PAGE_ID);
         update_root_page_no(root_new->get_page_no());
-        root_new->page_hdr->is_leaf = false;
-        root_new->set_size(0);
-        root_new->page_hdr->next_free_page_no = INVALID_PAGE_ID;
-        root_new->set_parent_page_no(INVALID_PAGE_ID);
-        root_new->set_next_leaf(INVALID_PAGE_ID);
-        root_new->set_prev_leaf(INVALID_PAGE_ID);
-        root_new->insert_pair(0,old_node->get_key(0),{old_node->get_page_no(),-1});
+        file_hdr_->num_internal_pages_++;
+        file_hdr_->height_++;
+        char first_key[IX_MAX_KEY_LEN];
+        old_node->get_key(0, first_key);
+        root_new->insert_pair(0,first_key,{old_node->get_page_no(),-1});
         root_new->insert_pair(1,key,{new_node->get_page_no(),-1});
         new_node->set_parent_page_no(root_new->get_page_no());
         old_node->set_parent_page_no(root_new->get_page_no());
+        buffer_pool_manager_->unpin_page(root_new->get_page_id(), true);
     }
 }
 
+/**
+ * @brief 在node的pos位置插入键值对，node放不下时拆分node
+ * @note node需要在函数外面进行unpin
+ */
+void IxIndexHandle::insert_into_node(IxNodeHandle *node, int pos, const char *key, const Rid &rid,
+                                     Transaction *transaction) {
+    if (node->insert_pair(pos, key, rid)) return;
+    IxNodeEntries entries(file_hdr_->key_len());
+    node->load(&entries);
+    entries.insert(pos, key, rid);
+    split(node, entries, transaction);
+}
+
+/**
+ * @brief 替换parent中第child_idx个孩子的分隔key，新key放不下时拆分parent
+ * @note parent需要在函数外面进行unpin
+ */
+void IxIndexHandle::update_separator(IxNodeHandle *parent, int child_idx, const char *key,
+                                     Transaction *transaction) {
+    if (parent->set_key(child_idx, key)) return;
+    IxNodeEntries entries(file_hdr_->key_len());
+    parent->load(&entries);
+    memcpy(entries.key(child_idx), key, file_hdr_->key_len());
+    split(parent, entries, transaction);
+}
+
+/**
+ * @brief 为相邻的两个叶子结点生成父结点中的分隔key（后缀截断）
+ * 分隔key只需满足 left < separator <= right，因此从right中去掉区分两者用不到的部分：
+ * 第一个不同的字段如果是字符串，只保留到第一个不同的字节；之后的字符串字段和非唯一索引附加的Rid置0，
+ * 置0的部分位于key末尾时不占用内部结点的空间
+ *
+ * @param left 左边叶子的最后一个key
+ * @param right 右边叶子的第一个key
+ * @param[out] separator 长度为file_hdr_->key_len()
+ */
+void IxIndexHandle::make_separator(const char *left, const char *right, char *separator) const {
+    memcpy(separator, right, file_hdr_->key_len());
+    size_t col = 0;
+    int offset = 0;
+    for (; col < file_hdr_->col_types_.size(); col++) {
+        if (ix_compare(left + offset, right + offset, file_hdr_->col_types_[col], file_hdr_->col_lens_[col]) != 0) {
+            break;
+        }
+        offset += file_hdr_->col_lens_[col];
+    }
+    // 索引字段完全相同（非唯一索引中由Rid区分），不能截断
+    if (col == file_hdr_->col_types_.size()) return;
+    int col_len = file_hdr_->col_lens_[col];
+    if (file_hdr_->col_types_[col] == TYPE_STRING) {
+        int diff = 0;
+        while (left[offset + diff] == right[offset + diff]) diff++;
+        memset(separator + offset + diff + 1, 0, col_len - diff - 1);
+    }
+    offset += col_len;
+    for (col++; col < file_hdr_->col_types_.size(); col++) {
+        if (file_hdr_->col_types_[col] == TYPE_STRING) {
+            memset(separator + offset, 0, file_hdr_->col_lens_[col]);
+        }
+        offset += file_hdr_->col_lens_[col];
+    }
+    memset(separator + file_hdr_->col_tot_len_, 0, file_hdr_->key_len() - file_hdr_->col_tot_len_);
+}
+
 /**
  * @brief 将指定键值对插入到B+树中
  * @param (key, value) 要插入的键值对
@@ -339,47 +777,51 @@ page_id_t IxIndexHandle::insert_entry(const char *key, const Rid &value, Transac
     // 3. 如果结点已满，分裂结点，并把新结点的相关信息插入父节点
     // 提示：记得unpin page；若当前叶子节点是最右叶子节点，则需要更新file_hdr_.last_leaf；记得处理并发的上锁
     std::scoped_lock<std::mutex> latch{root_latch_};
-    auto leaf_node = find_leaf_page(key, Operation::INSERT, transaction).first;
-    auto origin_num = leaf_node->get_size();
-    auto new_num = leaf_node->insert(key, value);
-    //是否插入成功
-    bool if_success = origin_num != new_num;
-    if (if_success && leaf_node->get_size() == leaf_node->get_max_size()) {
-        auto new_node = split(leaf_node);
-        if (file_hdr_->last_leaf_ == leaf_node->get_page_no()) {
-            file_hdr_->last_leaf_ = new_node->get_page_no();
-        }
-        insert_into_parent(leaf_node, new_node->get_key(0), new_node, transaction);
-        buffer_pool_manager_->unpin_page(new_node->get_page_id(), true);
+    char buf[IX_MAX_KEY_LEN];
+    const char *tree_key = make_tree_key(key, value, buf);
+    auto leaf_node = find_leaf_page(tree_key, Operation::INSERT, transaction).first;
+    int idx = leaf_node->lower_bound(tree_key);
+    if (idx < leaf_node->get_size() && leaf_node->compare_key(idx, tree_key) == 0) {
+        buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
+        throw RMDBError("Duplicate entry for unique key");
     }
-    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), if_success);
+    // 叶子放不下时在insert_into_node中拆分，last_leaf的维护在split中完成
+    insert_into_node(leaf_node, idx, tree_key, value, transaction);
+    buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), true);
+    file_hdr_->num_keys_++;
+    bloom_add(key);
     return leaf_node->get_page_no();
 }
 
 /**
  * @brief 用于删除B+树中含有指定key的键值对
  * @param key 要删除的key值
+ * @param value key对应的rid，非唯一索引用它定位同一key下的具体索引项
  * @param transaction 事务指针
+ * @return 键值对是否存在并被删除
  */
-bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
+bool IxIndexHandle::delete_entry(const char *key, const Rid &value, Transaction *transaction) {
     // Todo:
     // 1. 获取该键值对所在的叶子结点
     // 2. 在该叶子结点中删除键值对
     // 3. 如果删除成功需要调用CoalesceOrRedistribute来进行合并或重分配操作，并根据函数返回结果判断是否有结点需要删除
     // 4. 如果需要并发，并且需要删除叶子结点，则需要在事务的delete_page_set中添加删除结点的对应页面；记得处理并发的上锁
     std::scoped_lock latch(root_latch_);
-    auto leaf_node = find_leaf_page(key,Operation::DELETE,transaction).first;
-    leaf_node->remove(key);
-    auto is_need_delete = coalesce_or_redistribute(leaf_node,transaction);
-    if (is_need_delete){
-        release_node_handle(*leaf_node);
-        auto parent = fetch_node(leaf_node->get_parent_page_no()) ;
-        parent->erase_pair(parent->find_child(leaf_node));
-        buffer_pool_manager_->unpin_page(parent->get_page_id(), true);
+    char buf[IX_MAX_KEY_LEN];
+    const char *tree_key = make_tree_key(key, value, buf);
+    auto leaf_node = find_leaf_page(tree_key,Operation::DELETE,transaction).first;
+    int origin_num = leaf_node->get_size();
+    if (leaf_node->remove(tree_key) == origin_num) {
+        buffer_pool_manager_->unpin_page(leaf_node->get_page_id(), false);
+        return false;
     }
+    // 合并时被删除的结点以及父结点的调整都在coalesce_or_redistribute内部完成
+    coalesce_or_redistribute(leaf_node,transaction);
     buffer_pool_manager_->unpin_page(leaf_node->get_page_id(),true);
+    file_hdr_->num_keys_--;
+    bloom_remove();
+    if (art_cache_ != nullptr) art_cache_->erase(key);
     //todo:事务
-    buffer_pool_manager_->flush_all_pages(fd_);
     return true;
 }
 
@@ -390,9 +832,9 @@ bool IxIndexHandle::delete_entry(const char *key, Transaction *transaction) {
  * @param transaction 事务指针
  * @param root_is_latched 传出参数：根节点是否上锁，用于并发操作
  * @return 是否需要删除结点
- * @note User needs to first find the sibling of input page.
- * If sibling's size + input page's size >= 2 * page's minsize, then redistribute.
- * Otherwise, merge(Coalesce).
+ * @note 结点按字节容量管理：键值对占用的字节数不足结点容量的一半时需要调整，
+ * 和兄弟结点的键值对能放进一个结点时合并(Coalesce)，否则重新分配(Redistribute)
+ * 分隔key是孩子结点中key的下界，删除key之后仍然有效，因此不需要更新父结点
  */
 bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *transaction, bool *root_is_latched)
 {
@@ -402,17 +844,20 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
     //    1.2 如果不是根节点，并且不需要执行合并或重分配操作，则直接返回false，否则执行2
     // 2. 获取node结点的父亲结点
     // 3. 寻找node结点的兄弟结点（优先选取前驱结点）
-    // 4. 如果node结点和兄弟结点的键值对数量之和，能够支撑两个B+树结点（即node.size+neighbor.size >=
-    // NodeMinSize*2)，则只需要重新分配键值对（调用Redistribute函数）
+    // 4. 如果node结点和兄弟结点的键值对放不进一个结点，则只需要重新分配键值对（调用Redistribute函数）
     // 5. 如果不满足上述条件，则需要合并两个结点，将右边的结点合并到左边的结点（调用Coalesce函数）
     if (node->is_root_page()) {
         return adjust_root(node);
-    } else if (node->get_size() >= node->get_min_size()) {
-        maintain_parent(node);
+    } else if (node->used_bytes() * 2 >= IxNodeHandle::NODE_CAPACITY) {
         return false;
     }
 
     auto parent_node = fetch_node(node->get_parent_page_no());
+    if (parent_node->get_size() == 1) {
+        // 没有兄弟结点可以合并
+        buffer_pool_manager_->unpin_page(parent_node->get_page_id(), false);
+        return false;
+    }
     int children_idx = parent_node->find_child(node);
     IxNodeHandle * brother_node;
     if (children_idx != 0){
@@ -420,15 +865,21 @@ bool IxIndexHandle::coalesce_or_redistribute(IxNodeHandle *node, Transaction *tr
     } else{
         brother_node = fetch_node(parent_node->value_at(children_idx + 1));
     }
-    if (node->get_size() + brother_node->get_size() >= node->get_min_size() * 2) {
-        redistribute(brother_node, node, parent_node, children_idx);
+    IxNodeEntries entries(file_hdr_->key_len());
+    (children_idx != 0 ? brother_node : node)->load(&entries);
+    (children_idx != 0 ? node : brother_node)->load(&entries);
+    if (!fits_in_node(entries, 0, entries.size(), node->stored_len())) {
+        redistribute(brother_node, node, parent_node, children_idx, transaction);
         buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
         buffer_pool_manager_->unpin_page(brother_node->get_page_id(), true);
         return false;
     }
+    // coalesce可能交换两个指针，unpin前先记下两个结点的page id
+    PageId parent_page_id = parent_node->get_page_id();
+    PageId brother_page_id = brother_node->get_page_id();
     coalesce(&brother_node, &node, &parent_node, children_idx, transaction, root_is_latched);
-    buffer_pool_manager_->unpin_page(parent_node->get_page_id(), true);
-    buffer_pool_manager_->unpin_page(brother_node->get_page_id(), true);
+    buffer_pool_manager_->unpin_page(parent_page_id, true);
+    buffer_pool_manager_->unpin_page(brother_page_id, true);
     return true;
 }
 
@@ -448,19 +899,16 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
         auto new_root = fetch_node(file_hdr_->root_page_);
         new_root->set_parent_page_no(INVALID_PAGE_ID);
         buffer_pool_manager_->unpin_page(new_root->get_page_id(),true);
-        return true;
-    } else if (old_root_node->is_leaf_page() && old_root_node->get_size() == 0){ // 叶
         release_node_handle(*old_root_node);
-        update_root_page_no(2);
+        file_hdr_->height_--;
         return true;
     }
+    // 根结点为叶子时即使被删空也继续作为根（同时也是唯一的叶子）保留，不需要操作
     return false;
 }
 
 /**
- * @brief 重新分配node和兄弟结点neighbor_node的键值对
- * Redistribute key & value pairs from one page to its sibling page. If index == 0, move sibling page's first key
- * & value pair into end of input "node", otherwise move sibling page's last key & value pair into head of input "node".
+ * @brief 重新分配node和兄弟结点neighbor_node的键值对，使两个结点占用的字节数大致相等
  *
  * @param neighbor_node sibling page of input "node"
  * @param node input from method coalesceOrRedistribute()
@@ -469,28 +917,44 @@ bool IxIndexHandle::adjust_root(IxNodeHandle *old_root_node) {
  * @note node是之前刚被删除过一个key的结点
  * index=0，则neighbor是node后继结点，表示：node(left)      neighbor(right)
  * index>0，则neighbor是node前驱结点，表示：neighbor(left)  node(right)
- * 注意更新parent结点的相关kv对
+ * 注意更新parent中右结点的分隔key，新的分隔key可能更长，因此parent也可能需要拆分
  */
-void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index) {
+void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index,
+                                 Transaction *transaction) {
     // Todo:
     // 1. 通过index判断neighbor_node是否为node的前驱结点
-    // 2. 从neighbor_node中移动一个键值对到node结点中
+    // 2. 在两个结点之间移动键值对
     // 3. 更新父节点中的相关信息，并且修改移动键值对对应孩子结点的父结点信息（maintain_child函数）
     // 注意：neighbor_node的位置不同，需要移动的键值对不同，需要分类讨论
-    auto nbr_idx = parent->find_child(neighbor_node);
-    auto nbr_size = neighbor_node->get_size();
-    if (nbr_idx == index - 1) { //nbr 在 node 前
-        node->insert_pair(0,neighbor_node->get_key(nbr_size-1),*(neighbor_node->get_rid(nbr_size-1)));
-        neighbor_node->erase_pair(nbr_size-1);
-        maintain_child(node,0);
-        maintain_parent(node);
-    } else{ //node 在 nbr 前
-        node->insert_pair(node->get_size(),neighbor_node->get_key(0),*(neighbor_node->get_rid(0)));
-        neighbor_node->erase_pair(0);
-        maintain_child(node,node->get_size());
-        maintain_parent(neighbor_node);
+    IxNodeHandle *left = index > 0 ? neighbor_node : node;
+    IxNodeHandle *right = index > 0 ? node : neighbor_node;
+    IxNodeEntries entries(file_hdr_->key_len());
+    left->load(&entries);
+    int left_size = entries.size();
+    right->load(&entries);
+    int n = entries.size();
+    int stored_len = node->stored_len();
+    // 原来的划分一定放得下，按字节均分放不下时保持原来的划分
+    int cut = balanced_cut(entries, stored_len);
+    if (!fits_in_node(entries, 0, cut, stored_len) || !fits_in_node(entries, cut, n, stored_len)) {
+        cut = left_size;
     }
-
+    left->store(entries, 0, cut);
+    right->store(entries, cut, n);
+    for (int i = std::min(cut, left_size); i < std::max(cut, left_size); i++) {
+        if (i < cut) {
+            maintain_child(left, i);
+        } else {
+            maintain_child(right, i - cut);
+        }
+    }
+    char separator[IX_MAX_KEY_LEN];
+    if (right->is_leaf_page()) {
+        make_separator(entries.key(cut - 1), entries.key(cut), separator);
+    } else {
+        memcpy(separator, entries.key(cut), file_hdr_->key_len());
+    }
+    update_separator(parent, parent->find_child(right), separator, transaction);
 }
 
 /**
@@ -507,32 +971,6 @@ void IxIndexHandle::redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node
  * @return true means parent node should be deleted, false means no deletion happend
  * @note Assume that *neighbor_node is the left sibling of *node (neighbor -> node)
  */
-//bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node, IxNodeHandle **parent, int index,
-//                             Transaction *transaction, bool *root_is_latched) {
-//    // Todo:
-//    // 1. 用index判断neighbor_node是否为node的前驱结点，若不是则交换两个结点，让neighbor_node作为左结点，node作为右结点
-//    // 2. 把node结点的键值对移动到neighbor_node中，并更新node结点孩子结点的父节点信息（调用maintain_child函数）
-//    // 3. 释放和删除node结点，并删除parent中node结点的信息，返回parent是否需要被删除
-//    // 提示：如果是叶子结点且为最右叶子结点，需要更新file_hdr_.last_leaf
-//    auto par_node = *parent,bro_node = *neighbor_node,now_node = *node;
-//    auto bro_idx = par_node->find_child(bro_node);
-//    if (bro_idx != index - 1){
-//        std::swap(node,neighbor_node);
-//        index++;
-//    }
-//    if (now_node->is_leaf_page() && now_node->get_page_no() == file_hdr_->last_leaf_){
-//        file_hdr_->last_leaf_ = bro_node->get_page_no();
-//    }
-//    auto bro_size = bro_node->get_size(),now_size = now_node->get_size();
-//    bro_node->insert_pairs(bro_size,now_node->get_key(0),now_node->get_rid(0),now_size);
-//    for (int i =0;i<now_size;i++){
-//        maintain_child(bro_node,i+bro_size);
-//    }
-//    if (now_node->is_leaf_page()) erase_leaf(now_node);
-//    release_node_handle(*now_node);
-//    par_node->erase_pair(index);
-//    return coalesce_or_redistribute(par_node,transaction,root_is_latched);
-//}
 bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node, IxNodeHandle **parent, int index, Transaction *transaction,bool *root_is_latched){
     // Todo:
     // 1. 用index判断neighbor_node是否为node的前驱结点，若不是则交换两个结点，让neighbor_node作为左结点，node作为右结点
@@ -546,15 +984,19 @@ bool IxIndexHandle::coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node,
     if ((*node)->is_leaf_page() && (*node)->get_page_no() == file_hdr_->last_leaf_) {
         file_hdr_->last_leaf_ = (*neighbor_node)->get_page_no();
     }
-    auto insert_idx = (*neighbor_node)->get_size();
-    (*neighbor_node)->insert_pairs(insert_idx, (*node)->get_key(0), (*node)->get_rid(0), (*node)->get_size());
-    for (int i = 0; i < (*node)->get_size(); i++) {
-        maintain_child(*neighbor_node, i + insert_idx);
+    IxNodeEntries entries(file_hdr_->key_len());
+    (*neighbor_node)->load(&entries);
+    int insert_idx = entries.size();
+    (*node)->load(&entries);
+    bool stored = (*neighbor_node)->store(entries, 0, entries.size());
+    assert(stored);
+    for (int i = insert_idx; i < entries.size(); i++) {
+        maintain_child(*neighbor_node, i);
     }
     if ((*node)->is_leaf_page()) erase_leaf(*node);
     release_node_handle(**node);
     (*parent)->erase_pair(index);
-    return coalesce_or_redistribute(*parent, transaction);
+    return coalesce_or_redistribute(*parent, transaction, root_is_latched);
 }
 
 
@@ -576,6 +1018,220 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
     return *node->get_rid(iid.slot_no);
 }
 
+/**
+ * @brief 同时读出iid对应索引槽中的key和rid，只pin一次叶子结点
+ * 用于index-only scan直接从叶子结点构造元组
+ *
+ * @param iid
+ * @param[out] key 长度至少为file_hdr_->col_tot_len_
+ * @return Rid
+ */
+Rid IxIndexHandle::get_entry(const Iid &iid, char *key) const {
+    IxNodeHandle *node = fetch_node(iid.page_no);
+    if (iid.slot_no >= node->get_size()) {
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+        throw IndexEntryNotFoundError();
+    }
+    char node_key[IX_MAX_KEY_LEN];
+    node->get_key(iid.slot_no, node_key);
+    memcpy(key, node_key, file_hdr_->col_tot_len_);  // 只拷贝索引字段，不含附加的Rid
+    Rid rid = *node->get_rid(iid.slot_no);
+    buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    return rid;
+}
+
+/**
+ * @brief 返回叶子链表中iid的前一个位置，用于反向遍历
+ * 第一个叶子的slot 0之前没有元素，返回{first_leaf, -1}作为反向遍历的结束位置
+ *
+ * @param iid 可以是leaf_end()或lower_bound()/upper_bound()返回的任意位置
+ * @return Iid
+ */
+Iid IxIndexHandle::prev_iid(const Iid &iid) const {
+    if (iid.slot_no > 0) {
+        return Iid{iid.page_no, iid.slot_no - 1};
+    }
+    IxNodeHandle *node = fetch_node(iid.page_no);
+    page_id_t prev_page_no = node->get_prev_leaf();
+    buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    if (prev_page_no == IX_LEAF_HEADER_PAGE) {
+        return Iid{iid.page_no, -1};
+    }
+    IxNodeHandle *prev = fetch_node(prev_page_no);
+    Iid ret{prev_page_no, prev->get_size() - 1};
+    buffer_pool_manager_->unpin_page(prev->get_page_id(), false);
+    return ret;
+}
+
+/**
+ * @brief 预取leaf的后继叶子，最后一个叶子的后继是leaf header，不需要预取
+ */
+void IxIndexHandle::prefetch_next_leaf(IxNodeHandle *leaf) const {
+    if (leaf->get_page_no() == file_hdr_->last_leaf_) return;
+    buffer_pool_manager_->prefetch_page(PageId{fd_, leaf->get_next_leaf()});
+}
+
+/**
+ * @brief 把key转换为Bloom filter哈希的形式
+ * Bloom filter对key的字节计算哈希，ix_compare认为相等的key必须有相同的字节：浮点字段的-0.0统一为+0.0
+ */
+void IxIndexHandle::bloom_key(const char *key, char *out) const {
+    memcpy(out, key, file_hdr_->col_tot_len_);
+    int offset = 0;
+    for (size_t i = 0; i < file_hdr_->col_types_.size(); i++) {
+        if (file_hdr_->col_types_[i] == TYPE_FLOAT) {
+            float f;
+            memcpy(&f, out + offset, sizeof(f));
+            if (f == 0.0f) {
+                f = 0.0f;
+                memcpy(out + offset, &f, sizeof(f));
+            }
+        }
+        offset += file_hdr_->col_lens_[i];
+    }
+}
+
+/**
+ * @brief 插入key后更新Bloom filter，key数量超过设计容量时扩容重建以保持误判率
+ * @note 需要在持有root_latch_时调用，key已经插入B+树
+ */
+void IxIndexHandle::bloom_add(const char *key) {
+    if (bloom_.num_keys() >= bloom_.capacity()) {
+        rebuild_bloom_filter();
+        return;
+    }
+    char norm[IX_MAX_KEY_LEN];
+    bloom_key(key, norm);
+    bloom_.add(norm, file_hdr_->col_tot_len_);
+}
+
+/**
+ * @brief 删除key后维护Bloom filter
+ * Bloom filter无法删除bit，已删除的key会一直被判定为可能存在；
+ * 删除的key超过过滤器中key数量的一半时重建，避免误判率随删除不断升高
+ * @note 需要在持有root_latch_时调用，key已经从B+树中删除
+ */
+void IxIndexHandle::bloom_remove() {
+    bloom_deleted_++;
+    if (bloom_deleted_ * 2 > bloom_.num_keys()) {
+        rebuild_bloom_filter();
+    }
+}
+
+/**
+ * @brief 遍历所有叶子结点，用当前索引中的key重建Bloom filter，设计容量为当前key数量的两倍
+ */
+void IxIndexHandle::rebuild_bloom_filter() {
+    // 第一遍统计key的数量以确定过滤器大小，第二遍加入key
+    size_t num_keys = 0;
+    char key[IX_MAX_KEY_LEN];
+    char norm[IX_MAX_KEY_LEN];
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) bloom_.reset(num_keys * 2);
+        page_id_t page_no = file_hdr_->first_leaf_;
+        while (true) {
+            bool resident;
+            IxNodeHandle *leaf = fetch_scan_node(page_no, &resident);
+            if (pass == 0) {
+                num_keys += leaf->get_size();
+            } else {
+                for (int i = 0; i < leaf->get_size(); i++) {
+                    leaf->get_key(i, key);
+                    bloom_key(key, norm);
+                    bloom_.add(norm, file_hdr_->col_tot_len_);
+                }
+            }
+            page_id_t next_page_no = leaf->get_next_leaf();
+            release_scan_node(leaf, resident);
+            if (page_no == file_hdr_->last_leaf_) break;
+            page_no = next_page_no;
+        }
+    }
+    bloom_deleted_ = 0;
+}
+
+/**
+ * @brief 遍历整棵B+树收集统计信息，同时用精确值校正file_hdr_中增量维护的统计信息
+ * 内部结点从根结点开始按层遍历，叶子结点沿叶子链表遍历
+ */
+IxIndexStats IxIndexHandle::collect_stats() {
+    std::scoped_lock lock{root_latch_};
+    IxIndexStats stats;
+    double fill_sum = 0;
+    // 1. 按层遍历内部结点，遇到叶子结点所在的层时停止
+    std::vector<page_id_t> level{file_hdr_->root_page_};
+    stats.height = 1;
+    while (true) {
+        std::vector<page_id_t> next_level;
+        bool reach_leaf = false;
+        for (page_id_t page_no : level) {
+            bool resident;
+            IxNodeHandle *node = fetch_scan_node(page_no, &resident);
+            if (node->is_leaf_page()) {
+                reach_leaf = true;
+                release_scan_node(node, resident);
+                break;
+            }
+            stats.internal_pages++;
+            fill_sum += static_cast<double>(node->used_bytes()) / IxNodeHandle::NODE_CAPACITY;
+            for (int i = 0; i < node->get_size(); i++) {
+                next_level.push_back(node->value_at(i));
+            }
+            release_scan_node(node, resident);
+        }
+        if (reach_leaf) break;
+        level.swap(next_level);
+        stats.height++;
+    }
+    // 2. 沿叶子链表遍历叶子结点，叶子中的key有序，第一个索引字段的不同取值相邻
+    char key[IX_MAX_KEY_LEN];
+    char prev_key[IX_MAX_KEY_LEN];
+    page_id_t page_no = file_hdr_->first_leaf_;
+    while (true) {
+        bool resident;
+        IxNodeHandle *leaf = fetch_scan_node(page_no, &resident);
+        stats.leaf_pages++;
+        fill_sum += static_cast<double>(leaf->used_bytes()) / IxNodeHandle::NODE_CAPACITY;
+        for (int i = 0; i < leaf->get_size(); i++) {
+            leaf->get_key(i, key);
+            if (stats.num_keys == 0 ||
+                ix_compare(key, prev_key, file_hdr_->col_types_[0], file_hdr_->col_lens_[0]) != 0) {
+                stats.num_distinct++;
+            }
+            memcpy(prev_key, key, file_hdr_->col_lens_[0]);
+            stats.num_keys++;
+        }
+        page_id_t next_page_no = leaf->get_next_leaf();
+        release_scan_node(leaf, resident);
+        if (page_no == file_hdr_->last_leaf_) break;
+        page_no = next_page_no;
+    }
+    stats.fill_factor = fill_sum / (stats.leaf_pages + stats.internal_pages);
+    // 3. 文件中已分配的页面除去两个头部页面和B+树结点之外都是空闲页面
+    int allocated_pages = disk_manager_->get_fd2pageno(fd_);
+    stats.free_pages = std::max(allocated_pages - IX_INIT_ROOT_PAGE - stats.leaf_pages - stats.internal_pages, 0);
+
+    file_hdr_->num_keys_ = stats.num_keys;
+    file_hdr_->num_leaf_pages_ = stats.leaf_pages;
+    file_hdr_->num_internal_pages_ = stats.internal_pages;
+    file_hdr_->height_ = stats.height;
+    return stats;
+}
+
+IxNodeHandle *IxIndexHandle::fetch_scan_node(int page_no, bool *resident) const {
+    *resident = buffer_pool_manager_->is_page_resident(PageId{fd_, page_no});
+    return fetch_node(page_no);
+}
+
+void IxIndexHandle::release_scan_node(IxNodeHandle *node, bool resident) const {
+    if (resident) {
+        buffer_pool_manager_->unpin_page(node->get_page_id(), false);
+    } else {
+        buffer_pool_manager_->unpin_page_cold(node->get_page_id(), false);
+    }
+    delete node;
+}
+
 /**
  * @brief FindLeafPage + lower_bound
  *
@@ -586,8 +1242,10 @@ Rid IxIndexHandle::get_rid(const Iid &iid) const {
  */
 Iid IxIndexHandle::lower_bound(const char *key) {
     std::scoped_lock lock{root_latch_};
-    auto tar_node = find_leaf_page(key,Operation::FIND, nullptr).first;
-    auto tar_idx = tar_node->lower_bound(key);
+    char buf[IX_MAX_KEY_LEN];
+    const char *tree_key = make_tree_key(key, IX_MIN_RID, buf);
+    auto tar_node = find_leaf_page(tree_key,Operation::FIND, nullptr).first;
+    auto tar_idx = tar_node->lower_bound(tree_key);
     if (tar_idx == tar_node->get_size()){
         if (tar_node->get_page_no() == file_hdr_->last_leaf_){
             buffer_pool_manager_->unpin_page(tar_node->get_page_id(), false);
@@ -610,8 +1268,10 @@ Iid IxIndexHandle::lower_bound(const char *key) {
  */
 Iid IxIndexHandle::upper_bound(const char *key) {
     std::scoped_lock lock{root_latch_};
-    auto tar_node = find_leaf_page(key,Operation::FIND, nullptr).first;
-    auto tar_idx = tar_node->upper_bound(key);
+    char buf[IX_MAX_KEY_LEN];
+    const char *tree_key = make_tree_key(key, IX_MAX_RID, buf);
+    auto tar_node = find_leaf_page(tree_key,Operation::FIND, nullptr).first;
+    auto tar_idx = tar_node->upper_bound(tree_key);
     if (tar_idx >= tar_node->get_size()){ //节点外
         if (tar_node->get_page_no() == file_hdr_->last_leaf_){
             buffer_pool_manager_->unpin_page(tar_node->get_page_id(), false);
@@ -685,30 +1345,6 @@ IxNodeHandle *IxIndexHandle::create_node() {
     return node;
 }
 
-/**
- * @brief 从node开始更新其父节点的第一个key，一直向上更新直到根节点
- *
- * @param node
- */
-void IxIndexHandle::maintain_parent(IxNodeHandle *node) {
-    IxNodeHandle *curr = node;
-    while (curr->get_parent_page_no() != IX_NO_PAGE) {
-        // Load its parent
-        IxNodeHandle *parent = fetch_node(curr->get_parent_page_no());
-        int rank = parent->find_child(curr);
-        char *parent_key = parent->get_key(rank);
-        char *child_first_key = curr->get_key(0);
-        if (memcmp(parent_key, child_first_key, file_hdr_->col_tot_len_) == 0) {
-            assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
-            break;
-        }
-        memcpy(parent_key, child_first_key, file_hdr_->col_tot_len_);  // 修改了parent node
-        curr = parent;
-
-        assert(buffer_pool_manager_->unpin_page(parent->get_page_id(), true));
-    }
-}
-
 /**
  * @brief 要删除leaf之前调用此函数，更新leaf前驱结点的next指针和后继结点的prev指针
  *
@@ -727,12 +1363,17 @@ void IxIndexHandle::erase_leaf(IxNodeHandle *leaf) {
 }
 
 /**
- * @brief 删除node时，更新file_hdr_.num_pages
+ * @brief 删除node时，更新file_hdr_.num_pages以及结点数量的统计信息
  *
  * @param node
  */
 void IxIndexHandle::release_node_handle(IxNodeHandle &node) {
     file_hdr_->num_pages_--;
+    if (node.is_leaf_page()) {
+        file_hdr_->num_leaf_pages_--;
+    } else {
+        file_hdr_->num_internal_pages_--;
+    }
 }
 
 /**
@@ -10,6 +10,10 @@ See the Mulan PSL v2 for more details. */
 
 #pragma once
 
+#include <memory>
+
+#include "ix_art_cache.h"
+#include "ix_bloom_filter.h"
 #include "ix_defs.h"
 #include "transaction/transaction.h"
 
@@ -46,39 +50,74 @@ inline int ix_compare(const char* a, const char* b, const std::vector<ColType>&
     return 0;
 }
 
-/* 管理B+树中的每个节点 */
+// 比较B+树中存储的key，非唯一索引在索引字段相等时继续比较附加在其后的Rid
+inline int ix_compare(const char *a, const char *b, const IxFileHdr *file_hdr) {
+    int res = ix_compare(a, b, file_hdr->col_types_, file_hdr->col_lens_);
+    if (res != 0 || file_hdr->unique_) return res;
+    Rid ra, rb;
+    memcpy(&ra, a + file_hdr->col_tot_len_, sizeof(Rid));
+    memcpy(&rb, b + file_hdr->col_tot_len_, sizeof(Rid));
+    if (ra.page_no != rb.page_no) return ra.page_no < rb.page_no ? -1 : 1;
+    if (ra.slot_no != rb.slot_no) return ra.slot_no < rb.slot_no ? -1 : 1;
+    return 0;
+}
+
+/* 结点中每个键值对在槽目录中的表示，key去掉公共前缀后的部分（后缀）存放在页面尾部的key区 */
+struct IxSlot {
+    Rid rid;
+    uint16_t offset;    // key后缀在页面中的偏移
+    uint16_t len;       // key后缀的长度
+};
+
+/* 解码后的一组键值对，结点放不下时在这里完成插入，再重新编码分配到各个结点中 */
+struct IxNodeEntries {
+    int key_len;                // 每个key的完整长度，即file_hdr->key_len()
+    std::vector<char> keys;
+    std::vector<Rid> rids;
+
+    explicit IxNodeEntries(int key_len_) : key_len(key_len_) {}
+
+    int size() const { return static_cast<int>(rids.size()); }
+
+    const char *key(int i) const { return keys.data() + i * key_len; }
+
+    char *key(int i) { return keys.data() + i * key_len; }
+
+    void insert(int pos, const char *key, const Rid &rid) {
+        keys.insert(keys.begin() + pos * key_len, key, key + key_len);
+        rids.insert(rids.begin() + pos, rid);
+    }
+
+    void push_back(const char *key, const Rid &rid) { insert(size(), key, rid); }
+};
+
+/* 管理B+树中的每个节点
+ * 页面布局：| IxPageHdr | 公共前缀 | 槽目录IxSlot[num_key] -> ... 空闲空间 ... <- key区 |
+ * 结点内所有key的公共前缀只存一份，每个key只存储前缀之后到最后一个非0字节为止的部分（CHAR字段末尾补的0不存储），
+ * 读取时用前缀和0补齐还原出完整的key；非唯一索引的叶子结点不存储key末尾附加的Rid，读取时由槽中的rid还原
+ */
 class IxNodeHandle {
     friend class IxIndexHandle;
     friend class IxScan;
-    friend class InsertExecutor;
-    friend class UpdateExecutor;
 
    private:
     const IxFileHdr *file_hdr;      // 节点所在文件的头部信息
     Page *page;                     // 存储节点的页面
     IxPageHdr *page_hdr;            // page->data的第一部分，指针指向首地址，长度为sizeof(IxPageHdr)
-    char *keys;                     // page->data的第二部分，指针指向首地址，长度为file_hdr->keys_size，每个key的长度为file_hdr->col_len
-    Rid *rids;                      // page->data的第三部分，指针指向首地址
 
    public:
+    static constexpr int NODE_CAPACITY = PAGE_SIZE - static_cast<int>(sizeof(IxPageHdr));   // 结点可用于存储键值对的字节数
+
     IxNodeHandle() = default;
 
     IxNodeHandle(const IxFileHdr *file_hdr_, Page *page_) : file_hdr(file_hdr_), page(page_) {
         page_hdr = reinterpret_cast<IxPageHdr *>(page->get_data());
-        keys = page->get_data() + sizeof(IxPageHdr);
-        rids = reinterpret_cast<Rid *>(keys + file_hdr->keys_size_);
     }
 
     int get_size() { return page_hdr->num_key; }
 
     void set_size(int size) { page_hdr->num_key = size; }
 
-    int get_max_size() { return file_hdr->btree_order_ + 1; }
-
-    int get_min_size() { return get_max_size() / 2; }
-
-    int key_at(int i) { return *(int *)get_key(i); }
-
     /* 得到第i个孩子结点的page_no */
     page_id_t value_at(int i) { return get_rid(i)->page_no; }
 
@@ -102,33 +141,60 @@ class IxNodeHandle {
 
     void set_parent_page_no(page_id_t parent) { page_hdr->parent = parent; }
 
-    char *get_key(int key_idx) const { return keys + key_idx * file_hdr->col_tot_len_; }
+    // 初始化新分配结点的page_hdr
+    void init(bool is_leaf, page_id_t parent);
+
+    // 还原第key_idx个key，key的缓冲区长度至少为file_hdr->key_len()
+    void get_key(int key_idx, char *key) const;
+
+    Rid *get_rid(int rid_idx) const { return &get_slot(rid_idx)->rid; }
+
+    void set_rid(int rid_idx, const Rid &rid) { get_slot(rid_idx)->rid = rid; }
+
+    // 替换第key_idx个key，结点放不下时返回false且结点不变
+    bool set_key(int key_idx, const char *key);
 
-    Rid *get_rid(int rid_idx) const { return &rids[rid_idx]; }
+    // target与结点公共前缀比较的结果，在结点中查找时只计算一次
+    struct PrefixMatch {
+        int res;            // 不为0时target与前缀中的字段已经不同，结点中所有key与target的比较结果都是res
+        int col;            // 逐个key比较时从第col个字段开始
+        int col_offset;     // 第col个字段在key中的偏移
+        int offset;         // 从key的第offset个字节开始比较，之前的字节都与target相同
+    };
 
-    void set_key(int key_idx, const char *key) { memcpy(keys + key_idx * file_hdr->col_tot_len_, key, file_hdr->col_tot_len_); }
+    PrefixMatch match_prefix(const char *target) const;
 
-    void set_rid(int rid_idx, const Rid &rid) { rids[rid_idx] = rid; }
+    // 比较第key_idx个key和target，返回值同ix_compare；match为match_prefix(target)的结果，只比较前缀之后的部分
+    int compare_key(int key_idx, const char *target, const PrefixMatch &match) const;
+
+    int compare_key(int key_idx, const char *target) const {
+        return compare_key(key_idx, target, match_prefix(target));
+    }
 
     int lower_bound(const char *target) const;
 
     int upper_bound(const char *target) const;
 
-    void insert_pairs(int pos, const char *key, const Rid *rid, int n);
-
     page_id_t internal_lookup(const char *key);
 
     bool leaf_lookup(const char *key, Rid **value);
 
-    int insert(const char *key, const Rid &value);
-
-    // 用于在结点中的指定位置插入单个键值对
-    void insert_pair(int pos, const char *key, const Rid &rid) { insert_pairs(pos, key, &rid, 1); }
+    // 在结点中的指定位置插入单个键值对，结点放不下时返回false且结点不变
+    bool insert_pair(int pos, const char *key, const Rid &rid);
 
     void erase_pair(int pos);
 
     int remove(const char *key);
 
+    // 结点中键值对实际占用的字节数（不含页头和被删除key留下的空洞）
+    int used_bytes() const;
+
+    // 解码结点中的所有键值对，追加到entries末尾
+    void load(IxNodeEntries *entries) const;
+
+    // 用entries中[begin,end)的键值对重新编码整个结点，放不下时返回false且结点不变
+    bool store(const IxNodeEntries &entries, int begin, int end);
+
     /**
      * @brief used in internal node to remove the last key in root node, and return the last child
      *
@@ -157,6 +223,28 @@ class IxNodeHandle {
         assert(rid_idx < page_hdr->num_key);
         return rid_idx;
     }
+
+   private:
+    // 结点中每个key需要编码的长度，非唯一索引的叶子结点不编码key末尾附加的Rid
+    int stored_len() const {
+        return page_hdr->is_leaf && !file_hdr->unique_ ? file_hdr->col_tot_len_ : file_hdr->key_len();
+    }
+
+    char *get_prefix() const { return page->get_data() + sizeof(IxPageHdr); }
+
+    IxSlot *get_slot(int slot_idx) const {
+        int prefix_size = (page_hdr->prefix_len + 3) & ~3;
+        return reinterpret_cast<IxSlot *>(get_prefix() + prefix_size) + slot_idx;
+    }
+
+    // 槽目录末尾到key区之间连续的空闲字节数
+    int free_bytes() const {
+        return page_hdr->data_start - static_cast<int>(reinterpret_cast<char *>(get_slot(page_hdr->num_key)) -
+                                                        page->get_data());
+    }
+
+    // key与结点的公共前缀匹配时返回key需要存储的后缀长度，否则返回-1
+    int suffix_len(const char *key) const;
 };
 
 /* B+树 */
@@ -170,31 +258,45 @@ class IxIndexHandle {
     int fd_;                                    // 存储B+树的文件
     IxFileHdr* file_hdr_;                       // 存了root_page，但其初始化为2（第0页存FILE_HDR_PAGE，第1页存LEAF_HEADER_PAGE）
     std::mutex root_latch_;
+    IxBloomFilter bloom_;                       // 索引字段的Bloom filter，打开索引时由叶子结点构建
+    size_t bloom_deleted_ = 0;                  // 上次重建Bloom filter之后删除的key数量
+    std::unique_ptr<IxArtCache> art_cache_;     // 唯一索引的点查询缓存，预算为0时关闭（非唯一索引为空）
 
    public:
     IxIndexHandle(DiskManager *disk_manager, BufferPoolManager *buffer_pool_manager, int fd);
 
+    // 以下公开接口中的key均为索引字段拼接而成的key（长度为col_tot_len），
+    // 非唯一索引附加Rid的工作由IxIndexHandle内部完成
+    bool is_unique() const { return file_hdr_->unique_; }
+
+    // 设置点查询缓存的内存预算（字节），0表示关闭；非唯一索引没有缓存，忽略该设置
+    void set_cache_budget(size_t budget);
+
     // for search
     bool get_value(const char *key, std::vector<Rid> *result, Transaction *transaction);
 
+    int get_values(const std::vector<const char *> &keys, std::vector<std::vector<Rid>> *results,
+                   Transaction *transaction);
+
     std::pair<IxNodeHandle *, bool> find_leaf_page(const char *key, Operation operation, Transaction *transaction,
                                                  bool find_first = false);
 
     // for insert
     page_id_t insert_entry(const char *key, const Rid &value, Transaction *transaction);
 
-    IxNodeHandle *split(IxNodeHandle *node);
+    void split(IxNodeHandle *node, const IxNodeEntries &entries, Transaction *transaction);
 
     void insert_into_parent(IxNodeHandle *old_node, const char *key, IxNodeHandle *new_node, Transaction *transaction);
 
     // for delete
-    bool delete_entry(const char *key, Transaction *transaction);
+    bool delete_entry(const char *key, const Rid &value, Transaction *transaction);
 
     bool coalesce_or_redistribute(IxNodeHandle *node, Transaction *transaction = nullptr,
                                 bool *root_is_latched = nullptr);
     bool adjust_root(IxNodeHandle *old_root_node);
 
-    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index);
+    void redistribute(IxNodeHandle *neighbor_node, IxNodeHandle *node, IxNodeHandle *parent, int index,
+                      Transaction *transaction);
 
     bool coalesce(IxNodeHandle **neighbor_node, IxNodeHandle **node, IxNodeHandle **parent, int index,
                   Transaction *transaction, bool *root_is_latched);
@@ -207,6 +309,14 @@ class IxIndexHandle {
 
     Iid leaf_begin() const;
 
+    // for statistics
+    IxIndexStats collect_stats();
+
+    // 增量维护的统计信息，不需要遍历B+树，供优化器使用
+    int get_num_keys() const { return file_hdr_->num_keys_; }
+
+    int get_height() const { return file_hdr_->height_; }
+
     int get_pages_num(){
         return file_hdr_->num_pages_;
     }
@@ -220,13 +330,25 @@ class IxIndexHandle {
 
     bool is_empty() const { return file_hdr_->root_page_ == IX_NO_PAGE; }
 
+    // 构造B+树中实际存储的key，非唯一索引在索引字段后附加rid，唯一索引直接返回key
+    const char *make_tree_key(const char *key, const Rid &rid, char *buf) const {
+        if (file_hdr_->unique_) return key;
+        memcpy(buf, key, file_hdr_->col_tot_len_);
+        memcpy(buf + file_hdr_->col_tot_len_, &rid, sizeof(Rid));
+        return buf;
+    }
+
     // for get/create node
     IxNodeHandle *fetch_node(int page_no) const;
 
     IxNodeHandle *create_node();
 
     // for maintain data structure
-    void maintain_parent(IxNodeHandle *node);
+    void insert_into_node(IxNodeHandle *node, int pos, const char *key, const Rid &rid, Transaction *transaction);
+
+    void update_separator(IxNodeHandle *parent, int child_idx, const char *key, Transaction *transaction);
+
+    void make_separator(const char *left, const char *right, char *separator) const;
 
     void erase_leaf(IxNodeHandle *leaf);
 
@@ -236,4 +358,33 @@ class IxIndexHandle {
 
     // for index test
     Rid get_rid(const Iid &iid) const;
+
+    // for index-only scan
+    Rid get_entry(const Iid &iid, char *key) const;
+
+    // for backward scan
+    Iid prev_iid(const Iid &iid) const;
+
+    // for batch probe
+    void prefetch_next_leaf(IxNodeHandle *leaf) const;
+
+    // 只访问一次的整树遍历（统计信息、重建Bloom filter）使用，遍历前不在缓冲池中的页面用完后优先被淘汰
+    IxNodeHandle *fetch_scan_node(int page_no, bool *resident) const;
+
+    void release_scan_node(IxNodeHandle *node, bool resident) const;
+
+    // for bloom filter
+    void bloom_key(const char *key, char *out) const;
+
+    bool bloom_may_contain(const char *key) const {
+        char norm[IX_MAX_KEY_LEN];
+        bloom_key(key, norm);
+        return bloom_.may_contain(norm, file_hdr_->col_tot_len_);
+    }
+
+    void bloom_add(const char *key);
+
+    void bloom_remove();
+
+    void rebuild_bloom_filter();
 };
\ No newline at end of file
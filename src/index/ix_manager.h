@@ -54,7 +54,8 @@ class IxManager {
         return disk_manager_->is_file(ix_name);
     }
 
-    void create_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
+    // unique为false时创建非唯一索引，B+树中的key附加Rid，允许索引字段重复
+    void create_index(const std::string &filename, const std::vector<ColMeta>& index_cols, bool unique = true) {
         std::string ix_name = get_index_name(filename, index_cols);
         // Create index file
         disk_manager_->create_file(ix_name);
@@ -73,15 +74,17 @@ class IxManager {
         if (col_tot_len > IX_MAX_COL_LEN) {
             throw InvalidColLengthError(col_tot_len);
         }
+        // 非唯一索引的key槽中还要存放作为tiebreaker的Rid
+        int key_len = unique ? col_tot_len : col_tot_len + static_cast<int>(sizeof(Rid));
         // 根据 |page_hdr| + (|attr| + |rid|) * (n + 1) <= PAGE_SIZE 求得n的最大值btree_order
-        // 即 n <= btree_order，那么btree_order就是每个结点最多可插入的键值对数量（实际还多留了一个空位，但其不可插入）
-        int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (col_tot_len + sizeof(Rid)) - 1);
+        // 结点实际按字节容量管理（key经过前缀压缩和截断），btree_order只是key不可压缩时的最小扇出
+        int btree_order = static_cast<int>((PAGE_SIZE - sizeof(IxPageHdr)) / (key_len + sizeof(Rid)) - 1);
         assert(btree_order > 2);
 
         // Create file header and write to file
         IxFileHdr* fhdr = new IxFileHdr(IX_NO_PAGE, IX_INIT_NUM_PAGES, IX_INIT_ROOT_PAGE,
-                                col_num, col_tot_len, btree_order, (btree_order + 1) * col_tot_len,
-                                IX_INIT_ROOT_PAGE, IX_INIT_ROOT_PAGE);
+                                col_num, col_tot_len, btree_order, (btree_order + 1) * key_len,
+                                IX_INIT_ROOT_PAGE, IX_INIT_ROOT_PAGE, unique);
         for(int i = 0; i < col_num; ++i) {
             fhdr->col_types_.push_back(index_cols[i].type);
             fhdr->col_lens_.push_back(index_cols[i].len);
@@ -107,6 +110,8 @@ class IxManager {
                 .is_leaf = true,
                 .prev_leaf = IX_INIT_ROOT_PAGE,
                 .next_leaf = IX_INIT_ROOT_PAGE,
+                .prefix_len = 0,
+                .data_start = PAGE_SIZE,
             };
             disk_manager_->write_page(fd, IX_LEAF_HEADER_PAGE, page_buf, PAGE_SIZE);
         }
@@ -122,6 +127,8 @@ class IxManager {
                 .is_leaf = true,
                 .prev_leaf = IX_LEAF_HEADER_PAGE,
                 .next_leaf = IX_LEAF_HEADER_PAGE,
+                .prefix_len = 0,
+                .data_start = PAGE_SIZE,
             };
             // Must write PAGE_SIZE here in case of future fetch_node()
             disk_manager_->write_page(fd, IX_INIT_ROOT_PAGE, page_buf, PAGE_SIZE);
@@ -144,16 +151,13 @@ class IxManager {
     }
 
     // 注意这里打开文件，创建并返回了index file handle的指针
+    // 文件格式不是当前版本时关闭文件并抛出IndexFormatError
     std::unique_ptr<IxIndexHandle> open_index(const std::string &filename, const std::vector<ColMeta>& index_cols) {
-        std::string ix_name = get_index_name(filename, index_cols);
-        int fd = disk_manager_->open_file(ix_name);
-        return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+        return open_index_file(get_index_name(filename, index_cols));
     }
 
     std::unique_ptr<IxIndexHandle> open_index(const std::string &filename, const std::vector<std::string>& index_cols) {
-        std::string ix_name = get_index_name(filename, index_cols);
-        int fd = disk_manager_->open_file(ix_name);
-        return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+        return open_index_file(get_index_name(filename, index_cols));
     }
 
     void close_index(const IxIndexHandle *ih) {
@@ -164,4 +168,15 @@ class IxManager {
         buffer_pool_manager_->flush_all_pages(ih->fd_);
         disk_manager_->close_file(ih->fd_);
     }
+
+   private:
+    std::unique_ptr<IxIndexHandle> open_index_file(const std::string &ix_name) {
+        int fd = disk_manager_->open_file(ix_name);
+        try {
+            return std::make_unique<IxIndexHandle>(disk_manager_, buffer_pool_manager_, fd);
+        } catch (IndexFormatError &e) {
+            disk_manager_->close_file(fd);
+            throw;
+        }
+    }
 };
\ No newline at end of file
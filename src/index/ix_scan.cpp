@@ -16,6 +16,10 @@ See the Mulan PSL v2 for more details. */
  */
 void IxScan::next() {
     assert(!is_end());
+    if (reverse_) {
+        iid_ = ih_->prev_iid(iid_);
+        return;
+    }
     IxNodeHandle *node = ih_->fetch_node(iid_.page_no);
     assert(node->is_leaf_page());
     assert(iid_.slot_no < node->get_size());
@@ -32,4 +36,8 @@ void IxScan::next() {
 
 Rid IxScan::rid() const {
     return ih_->get_rid(iid_);
-}
\ No newline at end of file
+}
+
+Rid IxScan::entry(char *key) const {
+    return ih_->get_entry(iid_, key);
+}
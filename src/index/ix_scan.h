@@ -18,15 +18,22 @@ See the Mulan PSL v2 for more details. */
 // 用于遍历叶子结点
 // 用于直接遍历叶子结点，而不用findleafpage来得到叶子结点
 // TODO：对page遍历时，要加上读锁
+// reverse为true时沿prev_leaf反向遍历[lower,upper)，用于ORDER BY ... DESC
 class IxScan : public RecScan {
     const IxIndexHandle *ih_;
-    Iid iid_;  // 初始为lower（用于遍历的指针）
-    Iid end_;  // 初始为upper
+    Iid iid_;  // 初始为lower（用于遍历的指针），反向遍历时初始为upper的前一个位置
+    Iid end_;  // 初始为upper，反向遍历时为lower的前一个位置
     BufferPoolManager *bpm_;
+    bool reverse_;
 
    public:
-    IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm)
-        : ih_(ih), iid_(lower), end_(upper), bpm_(bpm) {}
+    IxScan(const IxIndexHandle *ih, const Iid &lower, const Iid &upper, BufferPoolManager *bpm, bool reverse = false)
+        : ih_(ih), iid_(lower), end_(upper), bpm_(bpm), reverse_(reverse) {
+        if (reverse_) {
+            iid_ = ih_->prev_iid(upper);
+            end_ = ih_->prev_iid(lower);
+        }
+    }
 
     void next() override;
 
@@ -34,5 +41,8 @@ class IxScan : public RecScan {
 
     Rid rid() const override;
 
+    // 读出当前索引槽的key（拷贝到key中）并返回rid
+    Rid entry(char *key) const;
+
     const Iid &iid() const { return iid_; }
 };
\ No newline at end of file
@@ -45,6 +45,9 @@ class Optimizer {
         else if (auto x = std::dynamic_pointer_cast<ast::ShowIndex>(query->parse)){
             //show index;
             return std::make_shared<OtherPlan>(T_ShowIndex, x->tab_name);
+        } else if (auto x = std::dynamic_pointer_cast<ast::ShowIndexStats>(query->parse)) {
+            // show index stats table;
+            return std::make_shared<OtherPlan>(T_ShowIndexStats, x->tab_name);
         }
 
 
@@ -66,7 +69,7 @@ class Optimizer {
             return std::make_shared<OtherPlan>(T_Transaction_rollback, std::string());
         } else if (auto x = std::dynamic_pointer_cast<ast::SetStmt>(query->parse)) {
             // Set Knob Plan
-            return std::make_shared<SetKnobPlan>(x->set_knob_type_, x->bool_val_);
+            return std::make_shared<SetKnobPlan>(x->set_knob_type_, x->bool_val_, x->int_val_);
         } else {
             return planner_->do_planner(query, context);
         }
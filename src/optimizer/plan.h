@@ -27,6 +27,7 @@ typedef enum PlanTag{
     T_CreateTable,
     T_DropTable,
     T_ShowIndex,
+    T_ShowIndexStats,
     T_CreateIndex,
     T_DropIndex,
     T_SetKnob,
@@ -43,8 +44,14 @@ typedef enum PlanTag{
     T_IndexScan,
     T_NestLoop,
     T_SemiJoin,     // semi join
+    T_AntiJoin,     // anti join
     T_SortMerge,    // sort merge join
+    T_HashJoin,     // hash join
+    T_IndexNestLoop,    // index nested loop join
     T_Sort,
+    T_Limit,
+    T_TopN,         // ORDER BY ... LIMIT
+    T_Gather,       // 并行区域的边界
     T_Projection,
     T_Aggregate,
     T_Explain
@@ -55,6 +62,8 @@ class Plan
 {
 public:
     PlanTag tag;
+    // LIMIT下推：上层预计只读取该节点的前这么多个元组，0表示读完全部元组。经过连接传给流式读取的一侧时只是估计值
+    size_t limit_hint_ = 0;
     virtual ~Plan() = default;
 };
 
@@ -71,7 +80,10 @@ class ScanPlan : public Plan
             len_ = cols_.back().offset + cols_.back().len;
             fed_conds_ = conds_;
             index_col_names_ = index_col_names;
-        
+            index_only_ = false;
+            reverse_ = false;
+            parallel_workers_ = 0;
+            emit_rid_ = false;
         }
         ~ScanPlan(){}
         // 以下变量同ScanExecutor中的变量
@@ -81,7 +93,11 @@ class ScanPlan : public Plan
         size_t len_;                               
         std::vector<Condition> fed_conds_;
         std::vector<std::string> index_col_names_;
-    
+        bool index_only_;                           // 索引覆盖查询引用的所有列，不需要回表
+        bool reverse_;                              // 反向扫描索引，按索引列降序输出
+        int parallel_workers_;                      // 顺序扫描的并行工作线程数，0表示不并行
+        std::vector<std::string> proj_cols_;        // 扫描需要输出的字段，为空时输出所有字段
+        bool emit_rid_;                             // 在输出元组末尾附加Rid，由最终投影回表读取其余字段（延迟物化）
 };
 
 class JoinPlan : public Plan
@@ -94,6 +110,10 @@ class JoinPlan : public Plan
             right_ = std::move(right);
             conds_ = std::move(conds);
             type = INNER_JOIN;
+            build_left_ = false;
+            left_sorted_ = false;
+            right_sorted_ = false;
+            inner_left_ = false;
         }
         ~JoinPlan(){}
         // 左节点
@@ -104,6 +124,13 @@ class JoinPlan : public Plan
         std::vector<Condition> conds_;
         // future TODO: 后续可以支持的连接类型
         JoinType type;
+        // hash join在左输入上建哈希表（左输入估计更小），否则在右输入上建
+        bool build_left_;
+        // sort merge join的左/右输入已经按连接键有序（按索引顺序扫描），不需要再排序
+        bool left_sorted_;
+        bool right_sorted_;
+        // index nested loop join的内层（ScanPlan，按其index_col_names_探测）是左输入，否则是右输入
+        bool inner_left_;
 };
 
 class ProjectionPlan : public Plan
@@ -118,6 +145,7 @@ class ProjectionPlan : public Plan
         ~ProjectionPlan(){}
         std::shared_ptr<Plan> subplan_;
         std::vector<TabCol> sel_cols_;
+        std::vector<std::string> late_tabs_;        // 延迟物化的表，其只在select列表中出现的字段按Rid回表读取
         
 };
 
@@ -140,18 +168,57 @@ class SortPlan : public Plan
 class LimitPlan : public Plan
 {
     public:
-        LimitPlan(std::shared_ptr<Plan> subplan, int limit_count)
+        LimitPlan(std::shared_ptr<Plan> subplan, int limit_count, int offset = 0)
         {
-            Plan::tag = T_Projection; // 使用现有的tag或添加新的T_Limit
+            Plan::tag = T_Limit;
             subplan_ = std::move(subplan);
             limit_count_ = limit_count;
+            offset_ = offset;
         }
         ~LimitPlan(){}
         std::shared_ptr<Plan> subplan_;
         int limit_count_;
+        int offset_;
         
 };
 
+// SortPlan + LimitPlan合并而成，只保留排在最前面的offset + limit个元组
+class TopNPlan : public Plan
+{
+    public:
+        TopNPlan(std::shared_ptr<Plan> subplan, std::vector<TabCol> sel_cols, std::vector<bool> is_desc_list,
+                 int limit_count, int offset)
+        {
+            Plan::tag = T_TopN;
+            subplan_ = std::move(subplan);
+            sel_cols_ = std::move(sel_cols);
+            is_desc_list_ = std::move(is_desc_list);
+            limit_count_ = limit_count;
+            offset_ = offset;
+        }
+        ~TopNPlan(){}
+        std::shared_ptr<Plan> subplan_;
+        std::vector<TabCol> sel_cols_;
+        std::vector<bool> is_desc_list_;
+        int limit_count_;
+        int offset_;
+};
+
+// 汇合下方并行顺序扫描（parallel_workers_ > 0）的各工作线程的输出；并行聚合、并行哈希连接直接在工作线程中消费它的输入
+class GatherPlan : public Plan
+{
+    public:
+        GatherPlan(std::shared_ptr<Plan> subplan, int num_workers)
+        {
+            Plan::tag = T_Gather;
+            subplan_ = std::move(subplan);
+            num_workers_ = num_workers;
+        }
+        ~GatherPlan(){}
+        std::shared_ptr<Plan> subplan_;
+        int num_workers_;
+};
+
 // dml语句，包括insert; delete; update; select语句　
 class DMLPlan : public Plan
 {
@@ -190,6 +257,7 @@ class DDLPlan : public Plan
         std::string tab_name_;
         std::vector<std::string> tab_col_names_;
         std::vector<ColDef> cols_;
+        bool unique_ = true;    // create index时是否为唯一索引
 };
 
 // help; show tables; desc tables; begin; abort; commit; rollback语句对应的plan
@@ -214,8 +282,13 @@ class SetKnobPlan : public Plan
             set_knob_type_ = knob_type;
             bool_value_ = bool_value;
         }
+        SetKnobPlan(ast::SetKnobType knob_type, bool bool_value, int int_value)
+            : SetKnobPlan(knob_type, bool_value) {
+            int_value_ = int_value;
+        }
     ast::SetKnobType set_knob_type_;
     bool bool_value_;
+    int int_value_ = 0;
 };
 
 class plannerInfo{
@@ -261,10 +334,12 @@ public:
 class ExplainPlan : public Plan {
 public:
     std::shared_ptr<Plan> subplan_;
+    bool analyze_;      // EXPLAIN ANALYZE
     
-    ExplainPlan(std::shared_ptr<Plan> subplan) {
+    ExplainPlan(std::shared_ptr<Plan> subplan, bool analyze = false) {
         tag = T_Explain;
         subplan_ = std::move(subplan);
+        analyze_ = analyze;
     }
     ~ExplainPlan(){}
 };
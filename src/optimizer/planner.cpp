@@ -75,13 +75,10 @@ bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_c
         if(can_use_index && !matched_cols.empty()) {
             for (const auto& index_col:index.cols){
                 index_col_names.push_back(index_col.name);
-                for (auto cond:curr_conds){
-                    if (cond.lhs_col.col_name == index_col.name){
-                        ret_conds.push_back(cond);
-                    }
-                }
-
             }
+            // IndexScanExecutor会自行从中挑选可用于确定扫描范围的条件，
+            // 其余条件（包括非索引列上的条件）仍需在扫描时逐条检查，因此全部传入
+            ret_conds = curr_conds;
             return true;
         }
     }
@@ -89,6 +86,501 @@ bool Planner::get_index_cols(std::string tab_name, std::vector<Condition> curr_c
     return false;
 }
 
+/**
+ * @brief 遍历查询引用的所有列
+ * 引用列包括select列表、where条件、join条件、group by、having和order by中的列，
+ * in_select表示该列来自select列表；列的表名可能为空，聚合别名、COUNT(*)等也会出现，由调用方过滤
+ */
+void Planner::for_each_referenced_col(
+    std::shared_ptr<Query> query,
+    const std::function<void(const std::string &tab_name, const std::string &col_name, bool in_select)> &visit) {
+    auto visit_expr = [&](const std::shared_ptr<ast::Expr> &expr) {
+        if (auto col = std::dynamic_pointer_cast<ast::Col>(expr)) visit(col->tab_name, col->col_name, false);
+    };
+
+    for (auto &col : query->cols) {
+        visit(col.tab_name, col.col_name, true);
+    }
+    for (auto &cond : query->conds) {
+        visit(cond.lhs_col.tab_name, cond.lhs_col.col_name, false);
+        if (!cond.is_rhs_val) visit(cond.rhs_col.tab_name, cond.rhs_col.col_name, false);
+    }
+
+    auto x = std::dynamic_pointer_cast<ast::SelectStmt>(query->parse);
+    if (!x) return;
+    for (auto &join_expr : x->jointree) {
+        for (auto &cond : join_expr->conds) {
+            visit_expr(cond->lhs);
+            visit_expr(cond->rhs);
+        }
+    }
+    if (x->group_by_clause) {
+        for (auto &col : x->group_by_clause->group_by_cols) {
+            visit(col->tab_name, col->col_name, false);
+        }
+    }
+    if (x->having_clause) {
+        for (auto &cond : x->having_clause->conds) {
+            visit_expr(cond->lhs);
+            visit_expr(cond->rhs);
+        }
+    }
+    if (x->order) {
+        for (auto &item : x->order->order_items) {
+            visit(item->col->tab_name, item->col->col_name, false);
+        }
+    }
+}
+
+/**
+ * @brief 判断scan使用的索引是否覆盖了查询在该表上引用的所有列
+ * 没有表名的列按列名在该表中查找，找不到的（如聚合别名、COUNT(*)）不计入
+ */
+bool Planner::is_index_covering(std::shared_ptr<Query> query, const ScanPlan &scan) {
+    if (!std::dynamic_pointer_cast<ast::SelectStmt>(query->parse)) return false;
+    TabMeta &tab = sm_manager_->db_.get_table(scan.tab_name_);
+    bool covering = true;
+    for_each_referenced_col(query, [&](const std::string &tab_name, const std::string &col_name, bool) {
+        if (col_name.empty() || col_name == "*") return;
+        if (!tab_name.empty() && tab_name != scan.tab_name_) return;
+        if (tab_name.empty() && !tab.is_col(col_name)) return;
+        if (std::find(scan.index_col_names_.begin(), scan.index_col_names_.end(), col_name) ==
+            scan.index_col_names_.end()) {
+            covering = false;
+        }
+    });
+    return covering;
+}
+
+void Planner::set_index_only_scans(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        if (x->tag == T_IndexScan) {
+            x->index_only_ = is_index_covering(query, *x);
+        }
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        // index nested loop join的内层需要回表取完整记录
+        if (x->tag != T_IndexNestLoop || !x->inner_left_) set_index_only_scans(query, x->left_);
+        if (x->tag != T_IndexNestLoop || x->inner_left_) set_index_only_scans(query, x->right_);
+    }
+}
+
+/**
+ * @brief 把query->scan_cols交给各个扫描，扫描只输出上层需要的列
+ * 表中延迟物化的列合计不少于LATE_MATERIALIZE_MIN_WIDTH字节时，扫描不输出这些列而是附加Rid，
+ * 连接和排序只携带较窄的元组，最终投影只为留下来的元组回表读取
+ */
+void Planner::push_down_projections(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan) {
+    // 最终投影在Sort、TopN和Limit的下面
+    std::shared_ptr<ProjectionPlan> projection;
+    while (plan != nullptr && projection == nullptr) {
+        if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+            projection = x;
+        } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+            plan = x->subplan_;
+        } else if (auto x = std::dynamic_pointer_cast<TopNPlan>(plan)) {
+            plan = x->subplan_;
+        } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+            plan = x->subplan_;
+        } else {
+            plan = nullptr;
+        }
+    }
+    if (projection == nullptr || query->scan_cols.empty()) return;
+    projection->late_tabs_.clear();
+    set_scan_projections(query, projection, projection->subplan_);
+}
+
+void Planner::set_scan_projections(std::shared_ptr<Query> query, std::shared_ptr<ProjectionPlan> projection,
+                                   std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        // index-only扫描已经只输出索引列
+        if (x->tag == T_IndexScan && x->index_only_) return;
+        auto scan_cols = query->scan_cols.find(x->tab_name_);
+        if (scan_cols == query->scan_cols.end()) return;
+        TabMeta &tab = sm_manager_->db_.get_table(x->tab_name_);
+        std::set<std::string> late;
+        auto late_cols = query->late_cols.find(x->tab_name_);
+        if (late_cols != query->late_cols.end()) {
+            int width = 0;
+            for (auto &col_name : late_cols->second) {
+                width += tab.get_col(col_name)->len;
+            }
+            if (width >= LATE_MATERIALIZE_MIN_WIDTH) late = late_cols->second;
+        }
+        x->proj_cols_.clear();
+        for (auto &col : tab.cols) {
+            if (scan_cols->second.count(col.name) != 0 && late.count(col.name) == 0) x->proj_cols_.push_back(col.name);
+        }
+        if (x->proj_cols_.empty()) {
+            // 不需要任何列（如COUNT(*)）时保留最窄的一列，输出元组不能为空
+            auto narrowest = std::min_element(tab.cols.begin(), tab.cols.end(),
+                                              [](const ColMeta &a, const ColMeta &b) { return a.len < b.len; });
+            x->proj_cols_.push_back(narrowest->name);
+        }
+        x->emit_rid_ = !late.empty();
+        if (x->emit_rid_) {
+            projection->late_tabs_.push_back(x->tab_name_);
+        } else if (x->proj_cols_.size() == tab.cols.size()) {
+            x->proj_cols_.clear();
+        }
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        // index nested loop join的内层不执行扫描，直接输出完整记录；
+        // semi/anti join只输出左输入的列，右输入的Rid传不到最终投影，不能延迟物化
+        bool filter_join = x->tag == T_SemiJoin || x->tag == T_AntiJoin;
+        if (x->tag != T_IndexNestLoop || !x->inner_left_) set_scan_projections(query, projection, x->left_);
+        if ((x->tag != T_IndexNestLoop || x->inner_left_) && !filter_join) {
+            set_scan_projections(query, projection, x->right_);
+        }
+    } else if (auto x = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+        set_scan_projections(query, projection, x->prev_);
+    } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+        set_scan_projections(query, projection, x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+        set_scan_projections(query, projection, x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<TopNPlan>(plan)) {
+        set_scan_projections(query, projection, x->subplan_);
+    }
+}
+
+/**
+ * @brief LIMIT下推
+ * 投影逐个转换元组，原样下传；连接只下传给流式读取的一侧：嵌套循环连接的外层（左输入）、哈希连接的probe侧、
+ * 已经有序的归并连接输入、index nested loop join的外层和semi/anti join的左输入，这一侧实际读取的元组数
+ * 取决于连接的选择率，只是估计。排序、Top-N和聚合要读完全部输入，不再下传
+ */
+void Planner::push_down_limits(std::shared_ptr<Plan> plan, size_t hint) {
+    if (plan == nullptr || hint == 0) return;
+    plan->limit_hint_ = hint;
+    if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+        push_down_limits(x->subplan_, std::min(hint, static_cast<size_t>(x->offset_) + x->limit_count_));
+    } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+        push_down_limits(x->subplan_, hint);
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        bool stream_left = true;
+        bool stream_right = false;
+        if (x->tag == T_HashJoin) {
+            stream_left = !x->build_left_;
+            stream_right = x->build_left_;
+        } else if (x->tag == T_SortMerge) {
+            stream_left = x->left_sorted_;
+            stream_right = x->right_sorted_;
+        } else if (x->tag == T_IndexNestLoop) {
+            stream_left = !x->inner_left_;
+            stream_right = x->inner_left_;
+        }
+        if (stream_left) push_down_limits(x->left_, hint);
+        if (stream_right) push_down_limits(x->right_, hint);
+    }
+}
+
+/**
+ * @brief 为顺序扫描选择并行工作线程数
+ * 表达到PARALLEL_SCAN_MIN_PAGES页时使用2个工作线程，页数每增加到3倍多用1个，不超过max_parallel_workers；
+ * 并行扫描的上方加入GatherPlan。上层只需要的元组（limit_hint_）不到PARALLEL_SCAN_MIN_PAGES页时不并行，
+ * 工作线程会预先读取多个morsel，而串行扫描取够元组就停止。index nested loop join的内层不执行扫描，不需要处理
+ */
+std::shared_ptr<Plan> Planner::choose_parallel_scans(std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        if (x->tag != T_SeqScan || max_parallel_workers < 2) return plan;
+        auto file_hdr = sm_manager_->fhs_.at(x->tab_name_)->get_file_hdr();
+        int num_pages = file_hdr.num_pages;
+        if (num_pages < PARALLEL_SCAN_MIN_PAGES) return plan;
+        if (x->limit_hint_ > 0 &&
+            x->limit_hint_ < static_cast<size_t>(PARALLEL_SCAN_MIN_PAGES) * file_hdr.num_records_per_page) {
+            return plan;
+        }
+        int workers = 2;
+        for (long threshold = PARALLEL_SCAN_MIN_PAGES * 3L; num_pages >= threshold; threshold *= 3) {
+            workers++;
+        }
+        x->parallel_workers_ = std::min(workers, max_parallel_workers);
+        return std::make_shared<GatherPlan>(x, x->parallel_workers_);
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        if (x->tag != T_IndexNestLoop || !x->inner_left_) x->left_ = choose_parallel_scans(x->left_);
+        if (x->tag != T_IndexNestLoop || x->inner_left_) x->right_ = choose_parallel_scans(x->right_);
+    } else if (auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)) {
+        x->subplan_ = choose_parallel_scans(x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
+        x->subplan_ = choose_parallel_scans(x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
+        x->subplan_ = choose_parallel_scans(x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<TopNPlan>(plan)) {
+        x->subplan_ = choose_parallel_scans(x->subplan_);
+    } else if (auto x = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
+        x->prev_ = choose_parallel_scans(x->prev_);
+    }
+    return plan;
+}
+
+/**
+ * @brief 估计表中的元组数量
+ * 有索引时使用索引头部增量维护的键值对数量（每条记录在每个索引中恰好有一项），否则按页数粗略估计
+ */
+int Planner::estimate_table_rows(const std::string &tab_name) {
+    try {
+        auto &tab = sm_manager_->db_.get_table(tab_name);
+        if (!tab.indexes.empty()) {
+            auto ix_name = sm_manager_->get_ix_manager()->get_index_name(tab_name, tab.indexes[0].cols);
+            return sm_manager_->ihs_.at(ix_name)->get_num_keys();
+        }
+        auto fh = sm_manager_->fhs_.find(tab_name);
+        if (fh != sm_manager_->fhs_.end()) {
+            return fh->second->get_file_hdr().num_pages * 100;  // 简单估算，假设每页平均100条记录
+        }
+    } catch (...) {
+    }
+    return 1000;
+}
+
+/**
+ * @brief 估计计划输出的元组数量
+ * 扫描条件中等值条件的选择率按1/10、范围条件按1/3估计；等值连接按较大一侧估计，没有连接条件时为笛卡尔积
+ */
+double Planner::estimate_plan_rows(std::shared_ptr<Plan> plan) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        double rows = estimate_table_rows(x->tab_name_);
+        for (auto &cond : x->conds_) {
+            if (!cond.is_rhs_val) continue;
+            rows /= cond.op == OP_EQ ? 10 : (cond.op == OP_NE ? 1 : 3);
+        }
+        return std::max(rows, 1.0);
+    }
+    if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        double left = estimate_plan_rows(x->left_);
+        double right = estimate_plan_rows(x->right_);
+        if (x->tag == T_SemiJoin || x->tag == T_AntiJoin) return left;
+        return x->conds_.empty() ? left * right : std::max(left, right);
+    }
+    return 1000;
+}
+
+static void collect_plan_tables(std::shared_ptr<Plan> plan, std::set<std::string> &tables) {
+    if (auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
+        tables.insert(x->tab_name_);
+    } else if (auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
+        collect_plan_tables(x->left_, tables);
+        collect_plan_tables(x->right_, tables);
+    }
+}
+
+/**
+ * @brief 判断按index_cols顺序扫描scan时，输出是否按order_cols有序
+ * 排序列需要按顺序出现在索引中，中间被等值条件固定的索引列可以跳过
+ */
+static bool index_provides_order(const ScanPlan &scan, const std::vector<std::string> &index_cols,
+                                 const std::vector<std::string> &order_cols) {
+    size_t j = 0;
+    for (size_t i = 0; i < index_cols.size() && j < order_cols.size(); ++i) {
+        if (index_cols[i] == order_cols[j]) {
+            ++j;
+            continue;
+        }
+        bool fixed = std::any_of(scan.conds_.begin(), scan.conds_.end(), [&](const Condition &cond) {
+            return cond.op == OP_EQ && cond.is_rhs_val && cond.lhs_col.col_name == index_cols[i];
+        });
+        if (!fixed) return false;
+    }
+    return j == order_cols.size();
+}
+
+/**
+ * @brief 计划能否按key_cols升序输出：按连接键顺序的索引扫描，或者表上有能提供该顺序的索引的顺序扫描
+ * apply为true时把这样的顺序扫描改为（全范围的）索引扫描
+ */
+bool Planner::provide_join_order(std::shared_ptr<Plan> plan, const std::vector<TabCol> &key_cols, bool apply) {
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(plan);
+    if (!scan || scan->reverse_) return false;
+    std::vector<std::string> names;
+    for (auto &col : key_cols) {
+        if (col.tab_name != scan->tab_name_) return false;
+        names.push_back(col.col_name);
+    }
+    if (scan->tag == T_IndexScan) return index_provides_order(*scan, scan->index_col_names_, names);
+    TabMeta &tab = sm_manager_->db_.get_table(scan->tab_name_);
+    for (auto &index : tab.indexes) {
+        std::vector<std::string> index_cols;
+        for (auto &col : index.cols) {
+            index_cols.push_back(col.name);
+        }
+        if (!index_provides_order(*scan, index_cols, names)) continue;
+        if (apply) {
+            scan->tag = T_IndexScan;
+            scan->index_col_names_ = index_cols;
+        }
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 尝试把连接改为index nested loop join
+ * 内层候选是基表扫描，把连接键作为内层列上的等值条件与内层扫描条件一起交给get_index_cols选择索引；
+ * 索引的前缀字段需要由连接键或等值常量确定，且至少包含一个连接键。
+ * 每个外层元组的探测代价按INDEX_PROBE_COST次页面访问估计，总代价低于扫描内层整表时才采用，
+ * 两侧都可以作为内层时选择外层估计较小的一侧
+ */
+bool Planner::choose_index_nestloop(std::shared_ptr<JoinPlan> join, const std::vector<TabCol> &left_keys,
+                                    const std::vector<TabCol> &right_keys) {
+    static constexpr double INDEX_PROBE_COST = 4;
+    std::shared_ptr<ScanPlan> best_inner;
+    std::vector<std::string> best_index_cols;
+    bool best_inner_left = false;
+    double best_outer_rows = 0;
+    for (bool inner_left : {false, true}) {
+        auto inner = std::dynamic_pointer_cast<ScanPlan>(inner_left ? join->left_ : join->right_);
+        if (!inner || inner->reverse_) continue;
+        auto &inner_keys = inner_left ? left_keys : right_keys;
+        auto &outer_keys = inner_left ? right_keys : left_keys;
+        std::vector<Condition> conds = inner->conds_;
+        for (size_t i = 0; i < inner_keys.size(); i++) {
+            Condition cond;
+            cond.lhs_col = outer_keys[i];
+            cond.op = OP_EQ;
+            cond.is_rhs_val = false;
+            cond.rhs_col = inner_keys[i];
+            conds.push_back(cond);
+        }
+        std::vector<Condition> index_conds;
+        std::vector<std::string> index_cols;
+        if (!get_index_cols(inner->tab_name_, conds, index_conds, index_cols)) continue;
+        bool has_key = false;
+        for (auto &col_name : index_cols) {
+            bool is_key = std::any_of(inner_keys.begin(), inner_keys.end(),
+                                      [&](const TabCol &col) { return col.col_name == col_name; });
+            bool fixed = std::any_of(inner->conds_.begin(), inner->conds_.end(), [&](const Condition &cond) {
+                return cond.op == OP_EQ && cond.is_rhs_val && cond.lhs_col.col_name == col_name;
+            });
+            if (!is_key && !fixed) break;
+            has_key |= is_key;
+        }
+        if (!has_key) continue;
+        double outer_rows = estimate_plan_rows(inner_left ? join->right_ : join->left_);
+        if (outer_rows * INDEX_PROBE_COST > estimate_table_rows(inner->tab_name_)) continue;
+        if (best_inner && outer_rows >= best_outer_rows) continue;
+        best_inner = inner;
+        best_index_cols = index_cols;
+        best_inner_left = inner_left;
+        best_outer_rows = outer_rows;
+    }
+    if (!best_inner) return false;
+    best_inner->tag = T_IndexScan;
+    best_inner->index_col_names_ = best_index_cols;
+    best_inner->index_only_ = false;
+    join->tag = T_IndexNestLoop;
+    join->inner_left_ = best_inner_left;
+    return true;
+}
+
+/**
+ * @brief 连接算法选择
+ * 两侧列分属左右输入、类型相同的等值条件可以作为连接键，其余条件由连接算子在键匹配后检查。有连接键时：
+ * 外层很小且内层基表上有以连接键开头的索引时，使用index nested loop join；
+ * 两个输入都能由索引按连接键顺序输出（顺序扫描改为索引扫描），或者只启用了sort merge join时，使用sort merge join，
+ * 有序的输入不再排序；
+ * 否则使用hash join，build侧选择估计元组数较少的输入，两侧相当时在右输入上建表，输出顺序与嵌套循环连接一致
+ */
+void Planner::choose_join_methods(std::shared_ptr<Plan> plan) {
+    auto x = std::dynamic_pointer_cast<JoinPlan>(plan);
+    if (!x) return;
+    choose_join_methods(x->left_);
+    choose_join_methods(x->right_);
+    if (x->tag != T_NestLoop && x->tag != T_SortMerge) return;
+
+    std::set<std::string> left_tables, right_tables;
+    collect_plan_tables(x->left_, left_tables);
+    collect_plan_tables(x->right_, right_tables);
+    // 与split_join_conds相同的顺序收集连接键
+    std::vector<TabCol> left_keys, right_keys;
+    for (auto &cond : x->conds_) {
+        if (cond.op != OP_EQ || cond.is_rhs_val) continue;
+        bool lhs_left = left_tables.count(cond.lhs_col.tab_name) > 0;
+        bool rhs_left = left_tables.count(cond.rhs_col.tab_name) > 0;
+        bool lhs_right = right_tables.count(cond.lhs_col.tab_name) > 0;
+        bool rhs_right = right_tables.count(cond.rhs_col.tab_name) > 0;
+        if (!((lhs_left && rhs_right) || (lhs_right && rhs_left))) continue;
+        auto lhs = sm_manager_->db_.get_table(cond.lhs_col.tab_name).get_col(cond.lhs_col.col_name);
+        auto rhs = sm_manager_->db_.get_table(cond.rhs_col.tab_name).get_col(cond.rhs_col.col_name);
+        if (lhs->type != rhs->type || (lhs->type == TYPE_STRING && lhs->len != rhs->len)) continue;
+        left_keys.push_back(lhs_left ? cond.lhs_col : cond.rhs_col);
+        right_keys.push_back(lhs_left ? cond.rhs_col : cond.lhs_col);
+    }
+    if (left_keys.empty()) {
+        // 没有连接键时sort merge join无法执行，退回嵌套循环连接
+        x->tag = T_NestLoop;
+        return;
+    }
+    bool sort_merge_only = enable_sortmerge_join && !enable_nestedloop_join;
+    if (x->tag != T_SortMerge && !sort_merge_only && choose_index_nestloop(x, left_keys, right_keys)) return;
+    if (provide_join_order(x->left_, left_keys, false) && provide_join_order(x->right_, right_keys, false)) {
+        provide_join_order(x->left_, left_keys, true);
+        provide_join_order(x->right_, right_keys, true);
+        x->tag = T_SortMerge;
+        x->left_sorted_ = true;
+        x->right_sorted_ = true;
+        return;
+    }
+    if (x->tag == T_SortMerge || sort_merge_only) {
+        auto is_index_scan = [](std::shared_ptr<Plan> child) {
+            auto scan = std::dynamic_pointer_cast<ScanPlan>(child);
+            return scan && scan->tag == T_IndexScan;
+        };
+        x->tag = T_SortMerge;
+        x->left_sorted_ = is_index_scan(x->left_) && provide_join_order(x->left_, left_keys, false);
+        x->right_sorted_ = is_index_scan(x->right_) && provide_join_order(x->right_, right_keys, false);
+        return;
+    }
+    x->tag = T_HashJoin;
+    x->build_left_ = estimate_plan_rows(x->left_) < estimate_plan_rows(x->right_);
+}
+
+/**
+ * @brief 判断能否由索引扫描直接产生ORDER BY要求的顺序
+ * 要求只有单表扫描、所有排序方向一致，且排序列按顺序出现在索引中（中间被等值条件固定的索引列可以跳过）。
+ * 降序时反向遍历叶子链表。顺序扫描只在有LIMIT或索引覆盖时才改为索引扫描，否则逐条回表不如排序划算
+ */
+bool Planner::use_index_order(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan,
+                              const std::vector<TabCol> &order_cols, const std::vector<bool> &is_desc_list,
+                              bool has_limit) {
+    auto scan = std::dynamic_pointer_cast<ScanPlan>(plan);
+    if (!scan || order_cols.empty()) return false;
+    for (size_t i = 0; i < order_cols.size(); ++i) {
+        if (order_cols[i].tab_name != scan->tab_name_ || is_desc_list[i] != is_desc_list[0]) return false;
+    }
+
+    std::vector<std::string> order_names;
+    for (auto &col : order_cols) {
+        order_names.push_back(col.col_name);
+    }
+    auto provides_order = [&](const std::vector<std::string> &index_cols) {
+        return index_provides_order(*scan, index_cols, order_names);
+    };
+
+    if (scan->tag == T_IndexScan) {
+        if (!provides_order(scan->index_col_names_)) return false;
+    } else {
+        TabMeta &tab = sm_manager_->db_.get_table(scan->tab_name_);
+        bool found = false;
+        for (auto &index : tab.indexes) {
+            std::vector<std::string> index_cols;
+            for (auto &col : index.cols) {
+                index_cols.push_back(col.name);
+            }
+            if (!provides_order(index_cols)) continue;
+            ScanPlan index_scan = *scan;
+            index_scan.index_col_names_ = index_cols;
+            bool covering = is_index_covering(query, index_scan);
+            if (!has_limit && !covering) continue;
+            scan->tag = T_IndexScan;
+            scan->index_col_names_ = index_cols;
+            scan->index_only_ = covering;
+            found = true;
+            break;
+        }
+        if (!found) return false;
+    }
+    scan->reverse_ = is_desc_list[0];
+    return true;
+}
 
 /**
  * @brief 表算子条件谓词生成
@@ -214,13 +706,15 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
 
     // 物理优化策略
 
-    // 1. 索引选择优化
-    // 在make_one_rel中已经处理了基本的索引选择
-    // 这里可以进一步优化索引使用策略
-
-    // 2. 连接算法选择优化
+    // 1. 连接算法选择优化
     // 根据表大小、内存限制等选择最优的连接算法
-    // 当前支持嵌套循环连接和排序合并连接
+    // 当前支持嵌套循环连接、排序合并连接和哈希连接；sort merge join可能把顺序扫描改为索引扫描，因此先于index-only判定
+    choose_join_methods(plan);
+
+    // 2. 索引选择优化
+    // 在make_one_rel中已经处理了基本的索引选择
+    // 索引覆盖了所有引用列时改为index-only scan，避免回表
+    set_index_only_scans(query, plan);
 
     // 3. 排序优化
     // 如果ORDER BY的列上有索引，可以利用索引避免排序
@@ -228,7 +722,7 @@ std::shared_ptr<Plan> Planner::physical_optimization(std::shared_ptr<Query> quer
     // 排序处理已移至generate_select_plan函数中
 
     // 4. 并行化考虑
-    // TODO: 在未来版本中可以考虑并行执行计划
+    // 排序处理可能把顺序扫描改为索引扫描，并行扫描在generate_select_plan的最后选择
 
     // 5. 内存使用优化
     // TODO: 根据可用内存调整执行策略
@@ -245,7 +739,7 @@ std::shared_ptr<Plan> Planner::make_one_rel(std::shared_ptr<Query> query)
 
     bool has_semi_join = false;
     for (const auto& join_expr : x->jointree) {
-        if (join_expr->type == SEMI_JOIN) {
+        if (join_expr->type == SEMI_JOIN || join_expr->type == ANTI_JOIN) {
             has_semi_join = true;
             break;
         }
@@ -491,6 +985,8 @@ std::shared_ptr<Plan> Planner::make_one_rel_with_jointree(std::shared_ptr<Query>
 
         if (join_expr->type == SEMI_JOIN) {
             result_plan = std::make_shared<JoinPlan>(T_SemiJoin, std::move(left_plan), std::move(right_plan), join_conds);
+        } else if (join_expr->type == ANTI_JOIN) {
+            result_plan = std::make_shared<JoinPlan>(T_AntiJoin, std::move(left_plan), std::move(right_plan), join_conds);
         } else {
             result_plan = std::make_shared<JoinPlan>(T_NestLoop, std::move(left_plan), std::move(right_plan), join_conds);
         }
@@ -604,7 +1100,9 @@ std::shared_ptr<Query> Planner::optimize_redundant_conditions(std::shared_ptr<Qu
 
 /**
  * @brief 投影下推优化
- * 尽早移除不需要的列，减少数据传输
+ * 尽早移除不需要的列，减少数据传输：确定每个表实际被引用的列，记录在query->scan_cols中，
+ * 物理计划生成后由push_down_projections交给扫描；多表连接且没有聚合时，只在select列表中出现的列
+ * 记录在query->late_cols中，可以延迟到最终投影再读取
  */
 std::shared_ptr<Query> Planner::optimize_projection_pushdown(std::shared_ptr<Query> query, Context *context) {
     if (!query || !query->parse) {
@@ -616,30 +1114,42 @@ std::shared_ptr<Query> Planner::optimize_projection_pushdown(std::shared_ptr<Que
         return query;
     }
 
-    // TODO: 实现投影下推逻辑
-    // 1. 分析SELECT列表中需要的列
-    // 2. 分析WHERE、GROUP BY、ORDER BY中引用的列
-    // 3. 确定每个表实际需要的列集合
-    // 4. 在表扫描阶段就只读取需要的列
-    // 5. 在连接操作中尽早移除不再需要的列
-    if (query->cols.empty() || (query->cols.size() == 1 && query->cols[0].col_name == "*")) {
+    query->scan_cols.clear();
+    query->late_cols.clear();
+    std::map<std::string, std::set<std::string>> needed_cols;      // select列表之外引用的列
+    std::map<std::string, std::set<std::string>> select_cols;
+    bool resolved = true;
+    for_each_referenced_col(query, [&](const std::string &tab_name, const std::string &col_name, bool in_select) {
+        if (col_name.empty() || col_name == "*") return;
+        if (!tab_name.empty() && std::find(query->tables.begin(), query->tables.end(), tab_name) == query->tables.end()) {
+            resolved = false;
+            return;
+        }
+        // 没有表名的列可能属于任意一个有同名列的表，全部保留
+        for (auto &table_name : query->tables) {
+            if (tab_name.empty() ? !sm_manager_->db_.get_table(table_name).is_col(col_name) : tab_name != table_name) {
+                continue;
+            }
+            (in_select ? select_cols : needed_cols)[table_name].insert(col_name);
+        }
+    });
+    // 出现无法归属的列时保守地让所有扫描输出完整记录
+    if (!resolved) {
         return query;
     }
 
-    std::set<std::string> needed_cols;
-
-    for (const auto& col : query->cols) {
-        std::string full_name = col.tab_name.empty() ? col.col_name : col.tab_name + "." + col.col_name;
-        needed_cols.insert(full_name);
+    bool has_aggregation = select_stmt->has_group_by;
+    for (auto &col : select_stmt->cols) {
+        has_aggregation = has_aggregation || col->isAgg;
     }
-
-    for (const auto& cond : query->conds) {
-        std::string lhs_name = cond.lhs_col.tab_name.empty() ? cond.lhs_col.col_name : cond.lhs_col.tab_name + "." + cond.lhs_col.col_name;
-        needed_cols.insert(lhs_name);
-        
-        if (!cond.is_rhs_val) {
-            std::string rhs_name = cond.rhs_col.tab_name.empty() ? cond.rhs_col.col_name : cond.rhs_col.tab_name + "." + cond.rhs_col.col_name;
-            needed_cols.insert(rhs_name);
+    for (auto &table_name : query->tables) {
+        auto &needed = needed_cols[table_name];
+        auto &scan_cols = query->scan_cols[table_name];
+        scan_cols = needed;
+        scan_cols.insert(select_cols[table_name].begin(), select_cols[table_name].end());
+        if (has_aggregation || query->tables.size() < 2) continue;
+        for (auto &col_name : select_cols[table_name]) {
+            if (needed.count(col_name) == 0) query->late_cols[table_name].insert(col_name);
         }
     }
     return query;
@@ -671,17 +1181,7 @@ std::shared_ptr<Query> Planner::optimize_join_reordering(std::shared_ptr<Query>
 
     std::vector<std::pair<std::string, int>> table_cardinalities;
     for (const auto& table_name : query->tables) {
-        try {
-            auto fh = sm_manager_->fhs_.find(table_name);
-            int record_count = 0;
-            if (fh != sm_manager_->fhs_.end()) {
-                auto file_hdr = fh->second->get_file_hdr();
-                record_count = file_hdr.num_pages * 100; // 简单估算，假设每页平均100条记录
-            }
-            table_cardinalities.push_back({table_name, record_count});
-        } catch (...) {
-            table_cardinalities.push_back({table_name, 1000});
-        }
+        table_cardinalities.push_back({table_name, estimate_table_rows(table_name)});
     }
 
     std::sort(table_cardinalities.begin(), table_cardinalities.end(), 
@@ -722,6 +1222,7 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
     // 物理优化阶段 - 生成基础的扫描和连接计划
     auto sel_cols = query->cols;
     std::shared_ptr<Plan> plannerRoot = physical_optimization(query, context);
+    std::shared_ptr<Plan> scan_root = plannerRoot;
 
     // 聚合处理阶段
     bool has_aggregation = false;
@@ -961,6 +1462,7 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
     );
 
     // 处理ORDER BY
+    bool has_topn = false;
     if (select_stmt->has_sort && select_stmt->order) {
         std::vector<TabCol> order_cols;
         std::vector<bool> is_desc_list;
@@ -992,14 +1494,49 @@ std::shared_ptr<Plan> Planner::generate_select_plan(std::shared_ptr<Query> query
             is_desc_list.push_back(order_item->orderby_dir == ast::OrderBy_DESC);
         }
         
-        plannerRoot = std::make_shared<SortPlan>(std::move(plannerRoot), order_cols, is_desc_list);
+        // 索引能提供所需顺序时不再排序，LIMIT取够行数后扫描即停止
+        bool sorted_by_index = !has_aggregation && !select_stmt->has_group_by &&
+                               use_index_order(query, scan_root, order_cols, is_desc_list,
+                                               select_stmt->has_limit && select_stmt->limit_count > 0);
+        if (!sorted_by_index) {
+            // 排序键按投影输出解析；有不在select列表中的排序键时排序放到投影下面，直接对输入元组排序
+            auto projection = std::static_pointer_cast<ProjectionPlan>(plannerRoot);
+            bool keys_projected = std::all_of(order_cols.begin(), order_cols.end(), [&](const TabCol &order_col) {
+                return std::any_of(projection->sel_cols_.begin(), projection->sel_cols_.end(),
+                                   [&](const TabCol &sel_col) {
+                                       return (sel_col.tab_name.empty() || sel_col.tab_name == order_col.tab_name) &&
+                                              sel_col.col_name == order_col.col_name;
+                                   });
+            });
+            std::shared_ptr<Plan> &sort_input = keys_projected ? plannerRoot : projection->subplan_;
+            // 有LIMIT时只需要保留前offset + limit个元组，排序与LIMIT合并为Top-N
+            if (select_stmt->has_limit && select_stmt->limit_count > 0) {
+                has_topn = true;
+                sort_input = std::make_shared<TopNPlan>(std::move(sort_input), order_cols, is_desc_list,
+                                                        select_stmt->limit_count, select_stmt->limit_offset);
+            } else {
+                sort_input = std::make_shared<SortPlan>(std::move(sort_input), order_cols, is_desc_list);
+            }
+        }
     }
 
     // 处理LIMIT
+    if (select_stmt->has_limit && select_stmt->limit_count > 0 && !has_topn) {
+        plannerRoot = std::make_shared<LimitPlan>(std::move(plannerRoot), select_stmt->limit_count,
+                                                  select_stmt->limit_offset);
+    }
+
+    // 扫描只输出需要的列，只在select列表中出现的宽列延迟到最终投影读取
+    push_down_projections(query, plannerRoot);
+
+    // LIMIT只需要前几个元组时，流式读取的算子取够就停止，不预先读取
     if (select_stmt->has_limit && select_stmt->limit_count > 0) {
-        plannerRoot = std::make_shared<LimitPlan>(std::move(plannerRoot), select_stmt->limit_count);
+        push_down_limits(plannerRoot, static_cast<size_t>(select_stmt->limit_offset) + select_stmt->limit_count);
     }
 
+    // 大表上的顺序扫描由多个工作线程按morsel并行读取
+    plannerRoot = choose_parallel_scans(plannerRoot);
+
     return plannerRoot;
 }
 
@@ -1026,7 +1563,9 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
         plannerRoot = std::make_shared<DDLPlan>(T_DropTable, x->tab_name, std::vector<std::string>(), std::vector<ColDef>());
     } else if (auto x = std::dynamic_pointer_cast<ast::CreateIndex>(query->parse)) {
         // create index;
-        plannerRoot = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        auto ddl_plan = std::make_shared<DDLPlan>(T_CreateIndex, x->tab_name, x->col_names, std::vector<ColDef>());
+        ddl_plan->unique_ = x->unique;
+        plannerRoot = ddl_plan;
     } else if (auto x = std::dynamic_pointer_cast<ast::DropIndex>(query->parse)) {
         // drop index
         plannerRoot = std::make_shared<DDLPlan>(T_DropIndex, x->tab_name, x->col_names, std::vector<ColDef>());
@@ -1091,7 +1630,7 @@ std::shared_ptr<Plan> Planner::do_planner(std::shared_ptr<Query> query, Context
         Analyze analyzer(sm_manager_);
         auto analyzed_query = analyzer.do_analyze(x->select_stmt);
         std::shared_ptr<Plan> optimized_plan = generate_select_plan(std::move(analyzed_query), context);
-        plannerRoot = std::make_shared<ExplainPlan>(optimized_plan);
+        plannerRoot = std::make_shared<ExplainPlan>(optimized_plan, x->analyze);
     } else if (auto x = std::dynamic_pointer_cast<ast::TxnBegin>(query->parse)) {
         // transaction begin
         plannerRoot = std::make_shared<OtherPlan>(T_Transaction_begin, "");
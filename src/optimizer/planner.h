@@ -12,6 +12,7 @@ See the Mulan PSL v2 for more details. */
 
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -32,6 +33,10 @@ class Planner {
 
     bool enable_nestedloop_join = true;
     bool enable_sortmerge_join = false;
+    int max_parallel_workers = 4;                           // 每个并行扫描最多使用的工作线程数，小于2时不并行
+
+    static constexpr int PARALLEL_SCAN_MIN_PAGES = 512;     // 表至少有这么多页时才考虑并行扫描
+    static constexpr int LATE_MATERIALIZE_MIN_WIDTH = 16;   // 表中延迟物化的列至少这么宽才值得在最终投影时回表读取
 
    public:
     Planner(SmManager *sm_manager) : sm_manager_(sm_manager) {}
@@ -42,6 +47,8 @@ class Planner {
     void set_enable_nestedloop_join(bool set_val) { enable_nestedloop_join = set_val; }
     
     void set_enable_sortmerge_join(bool set_val) { enable_sortmerge_join = set_val; }
+
+    void set_max_parallel_workers(int set_val) { max_parallel_workers = set_val; }
     
    private:
     std::shared_ptr<Query> logical_optimization(std::shared_ptr<Query> query, Context *context);
@@ -62,6 +69,40 @@ class Planner {
     // int get_indexNo(std::string tab_name, std::vector<Condition> curr_conds);
     bool get_index_cols(std::string tab_name, std::vector<Condition> curr_conds, std::vector<Condition>& ret_conds, std::vector<std::string>& index_col_names);
 
+    // 查询在select列表、条件、连接、分组和排序中引用的每一列
+    void for_each_referenced_col(
+        std::shared_ptr<Query> query,
+        const std::function<void(const std::string &tab_name, const std::string &col_name, bool in_select)> &visit);
+
+    // 索引覆盖了查询在该表上引用的全部列时，将index scan标记为index-only
+    void set_index_only_scans(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
+    bool is_index_covering(std::shared_ptr<Query> query, const ScanPlan &scan);
+
+    // 投影下推：扫描只输出query->scan_cols中的列，较宽的只在select列表中出现的列延迟到最终投影读取
+    void push_down_projections(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan);
+    void set_scan_projections(std::shared_ptr<Query> query, std::shared_ptr<ProjectionPlan> projection,
+                              std::shared_ptr<Plan> plan);
+
+    // 连接算法选择：含有可哈希的等值连接条件的嵌套循环连接改为hash join，在估计较小的一侧建哈希表
+    void choose_join_methods(std::shared_ptr<Plan> plan);
+    bool provide_join_order(std::shared_ptr<Plan> plan, const std::vector<TabCol> &key_cols, bool apply);
+    bool choose_index_nestloop(std::shared_ptr<JoinPlan> join, const std::vector<TabCol> &left_keys,
+                               const std::vector<TabCol> &right_keys);
+
+    // LIMIT下推：把上层最多需要的元组数hint记录到plan及其流式读取的子节点的limit_hint_中
+    void push_down_limits(std::shared_ptr<Plan> plan, size_t hint);
+
+    // 足够大的表上的顺序扫描改为并行扫描并在上方加入Gather，工作线程数随表的页数增加；返回替换后的节点
+    std::shared_ptr<Plan> choose_parallel_scans(std::shared_ptr<Plan> plan);
+
+    // 基数估计
+    int estimate_table_rows(const std::string &tab_name);
+    double estimate_plan_rows(std::shared_ptr<Plan> plan);
+
+    // ORDER BY列是索引的前缀时改用（反向）索引扫描提供顺序，返回是否可以省去排序
+    bool use_index_order(std::shared_ptr<Query> query, std::shared_ptr<Plan> plan, const std::vector<TabCol> &order_cols,
+                         const std::vector<bool> &is_desc_list, bool has_limit);
+
     ColType interp_sv_type(ast::SvType sv_type) {
         std::map<ast::SvType, ColType> m = {
             {ast::SV_TYPE_INT, TYPE_INT}, {ast::SV_TYPE_FLOAT, TYPE_FLOAT}, {ast::SV_TYPE_STRING, TYPE_STRING}};
@@ -15,7 +15,7 @@ See the Mulan PSL v2 for more details. */
 #include <map>
 
 enum JoinType {
-    INNER_JOIN, LEFT_JOIN, RIGHT_JOIN, FULL_JOIN, SEMI_JOIN
+    INNER_JOIN, LEFT_JOIN, RIGHT_JOIN, FULL_JOIN, SEMI_JOIN, ANTI_JOIN
 };
 namespace ast {
 
@@ -39,7 +39,7 @@ namespace ast {
     };
 
     enum SetKnobType {
-        EnableNestLoop, EnableSortMerge
+        EnableNestLoop, EnableSortMerge, IndexCacheSize, WorkMem, MaxParallelWorkers
     };
 
 // Base class for tree nodes
@@ -109,9 +109,10 @@ namespace ast {
     struct CreateIndex : public TreeNode {
         std::string tab_name;
         std::vector<std::string> col_names;
+        bool unique;    // CREATE NONUNIQUE INDEX 创建允许重复key的索引
 
-        CreateIndex(std::string tab_name_, std::vector<std::string> col_names_) :
-                tab_name(std::move(tab_name_)), col_names(std::move(col_names_)) {}
+        CreateIndex(std::string tab_name_, std::vector<std::string> col_names_, bool unique_ = true) :
+                tab_name(std::move(tab_name_)), col_names(std::move(col_names_)), unique(unique_) {}
     };
 
     struct DropIndex : public TreeNode {
@@ -129,6 +130,13 @@ namespace ast {
         }
     };
 
+    struct ShowIndexStats : public TreeNode {
+        std::string tab_name;
+
+        ShowIndexStats(std::string tab_name_) : tab_name(std::move(tab_name_)) {
+        }
+    };
+
     struct Expr : public TreeNode {
     };
 
@@ -326,6 +334,7 @@ namespace ast {
         std::shared_ptr<HavingClause> having_clause;
         std::shared_ptr<OrderBy> order;
         int limit_count;
+        int limit_offset{0};
 
         bool has_sort{false};
         bool has_group_by{false};
@@ -359,18 +368,23 @@ namespace ast {
 
     struct ExplainStmt : public TreeNode {
         std::shared_ptr<SelectStmt> select_stmt;
+        bool analyze;   // EXPLAIN ANALYZE：实际执行查询并输出各算子的运行统计
 
-        ExplainStmt(std::shared_ptr<SelectStmt> select_stmt_) :
-                select_stmt(std::move(select_stmt_)) {}
+        ExplainStmt(std::shared_ptr<SelectStmt> select_stmt_, bool analyze_ = false) :
+                select_stmt(std::move(select_stmt_)), analyze(analyze_) {}
     };
 
 // set enable_nestloop
     struct SetStmt : public TreeNode {
         SetKnobType set_knob_type_;
         bool bool_val_;
+        int int_val_ = 0;
 
         SetStmt(SetKnobType &type, bool bool_value) :
                 set_knob_type_(type), bool_val_(bool_value) {}
+
+        SetStmt(SetKnobType type, int int_value) :
+                set_knob_type_(type), bool_val_(false), int_val_(int_value) {}
     };
 
 // Semantic value
@@ -426,6 +440,11 @@ namespace ast {
             std::map<std::string, std::string> table_aliases; // alias -> table_name mapping
         } sv_table_list;
 
+        struct {
+            int count;      // LIMIT的行数，没有LIMIT时为-1
+            int offset;     // 跳过的行数
+        } sv_limit;
+
     };
 
     extern std::shared_ptr<ast::TreeNode> parse_tree;
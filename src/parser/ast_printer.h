@@ -92,6 +92,7 @@ private:
         } else if (auto x = std::dynamic_pointer_cast<CreateIndex>(node)) {
             std::cout << "CREATE_INDEX\n";
             print_val(x->tab_name, offset);
+            print_val(x->unique ? "UNIQUE" : "NONUNIQUE", offset);
             // print_val(x->col_name, offset);
             for(auto col_name: x->col_names)
                 print_val(col_name, offset);
@@ -71,6 +71,7 @@
 
 #include "ast.h"
 #include "yacc.tab.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
@@ -82,7 +83,7 @@ void yyerror(YYLTYPE *locp, const char* s) {
 
 using namespace ast;
 
-#line 86 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 87 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -549,18 +550,18 @@ union yyalloc
 #endif /* !YYCOPY_NEEDED */
 
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  54
+#define YYFINAL  57
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   227
+#define YYLAST   265
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  73
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  38
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  111
+#define YYNRULES  118
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  217
+#define YYNSTATES  247
 
 /* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   315
@@ -615,18 +616,18 @@ static const yytype_int8 yytranslate[] =
 /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_int16 yyrline[] =
 {
-       0,    86,    86,    91,    96,   101,   109,   110,   111,   112,
-     113,   117,   121,   125,   129,   133,   140,   147,   154,   158,
-     162,   166,   170,   174,   181,   185,   189,   193,   200,   210,
-     214,   221,   225,   232,   239,   243,   247,   254,   258,   265,
-     269,   273,   277,   284,   288,   295,   297,   304,   308,   315,
-     317,   324,   329,   336,   337,   344,   348,   355,   359,   363,
-     367,   371,   375,   379,   383,   387,   391,   399,   403,   407,
-     411,   415,   423,   427,   434,   438,   442,   446,   450,   454,
-     461,   465,   469,   473,   477,   481,   485,   489,   496,   500,
-     507,   511,   518,   522,   529,   535,   542,   550,   561,   565,
-     569,   573,   580,   587,   588,   589,   593,   597,   601,   602,
-     605,   607
+       0,    87,    87,    92,    97,   102,   110,   111,   112,   113,
+     114,   118,   122,   126,   130,   134,   141,   148,   152,   171,
+     175,   179,   183,   187,   198,   202,   206,   220,   224,   228,
+     232,   240,   248,   266,   270,   277,   281,   288,   295,   299,
+     303,   310,   314,   321,   325,   329,   333,   340,   344,   351,
+     353,   360,   364,   371,   373,   380,   385,   392,   393,   400,
+     404,   411,   415,   419,   423,   427,   431,   435,   439,   443,
+     447,   455,   459,   463,   467,   471,   479,   483,   490,   494,
+     498,   502,   506,   510,   517,   521,   525,   529,   533,   537,
+     541,   545,   552,   556,   563,   567,   574,   578,   585,   591,
+     598,   606,   614,   632,   636,   640,   644,   651,   658,   659,
+     660,   664,   669,   681,   687,   691,   692,   695,   697
 };
 #endif
 
@@ -669,12 +670,12 @@ yysymbol_name (yysymbol_kind_t yysymbol)
 }
 #endif
 
-#define YYPACT_NINF (-113)
+#define YYPACT_NINF (-185)
 
 #define yypact_value_is_default(Yyn) \
   ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF (-111)
+#define YYTABLE_NINF (-118)
 
 #define yytable_value_is_error(Yyn) \
   0
@@ -683,28 +684,31 @@ yysymbol_name (yysymbol_kind_t yysymbol)
    STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
-      86,     2,     9,     3,    -6,    -1,   -40,   -40,     8,    92,
-    -113,  -113,  -113,  -113,  -113,  -113,    14,  -113,    32,   -16,
-    -113,  -113,  -113,  -113,  -113,  -113,    43,   -40,   -40,  -113,
-     -40,   -40,   -40,   -40,  -113,  -113,    36,  -113,  -113,    -3,
-    -113,  -113,  -113,  -113,  -113,  -113,    17,  -113,    29,    -8,
-      77,    24,    47,    92,  -113,  -113,   -40,    39,    45,  -113,
-      50,    99,   112,    95,    96,   -29,   115,   -40,    95,    95,
-     146,  -113,    95,    95,    95,   101,   133,  -113,  -113,   -15,
-    -113,   104,  -113,   105,   106,   110,  -113,    23,  -113,   121,
-    -113,   -40,   -34,  -113,    59,    57,  -113,    70,    41,   133,
-    -113,  -113,  -113,  -113,   133,  -113,  -113,   152,    58,    90,
-      95,  -113,   133,   134,    95,   135,   -40,   157,   -40,   144,
-      95,    23,  -113,    95,  -113,   122,  -113,  -113,  -113,    95,
-    -113,    81,  -113,  -113,  -113,    -4,   133,  -113,  -113,  -113,
-    -113,  -113,  -113,   133,   133,   133,   133,   133,   133,  -113,
-    -113,    27,    95,   131,    95,   170,   -40,  -113,   185,   148,
-    -113,   144,  -113,   142,  -113,  -113,    41,  -113,  -113,    27,
-     108,   108,  -113,  -113,    27,  -113,   154,  -113,   133,   174,
-     115,   133,   192,   148,   141,  -113,    95,  -113,   133,   145,
-    -113,  -113,   182,   194,   193,   192,  -113,  -113,  -113,   115,
-     133,   115,   151,  -113,   193,  -113,  -113,   143,   147,  -113,
-    -113,  -113,  -113,  -113,  -113,   115,  -113
+     123,     9,     4,    54,    60,    75,    38,    38,   -20,    34,
+    -185,  -185,  -185,  -185,  -185,  -185,   -17,  -185,   103,    40,
+    -185,  -185,  -185,  -185,  -185,  -185,    -6,    38,    38,  -185,
+      98,    38,    38,    38,    38,  -185,  -185,   107,  -185,  -185,
+      67,    77,  -185,  -185,  -185,  -185,  -185,  -185,    84,  -185,
+      70,    72,   134,    96,   136,    34,   158,  -185,  -185,    38,
+      38,   125,   127,    38,  -185,   135,   182,   175,   141,   142,
+     139,    17,   128,    38,   141,   141,   192,    34,  -185,  -185,
+     141,   141,   143,   141,   150,   172,  -185,  -185,   -11,  -185,
+     152,  -185,  -185,   151,   137,   157,  -185,    -8,  -185,   155,
+    -185,    38,   196,   -35,  -185,    87,    23,  -185,   141,    47,
+      57,   172,  -185,  -185,  -185,  -185,   172,  -185,  -185,   198,
+      51,   140,   141,  -185,   172,   174,   141,   176,    38,   199,
+     201,    38,   183,   141,    -8,    38,  -185,   141,  -185,   171,
+    -185,  -185,  -185,   141,    71,  -185,   101,  -185,  -185,  -185,
+      28,   172,  -185,  -185,  -185,  -185,  -185,  -185,   172,   172,
+     172,   172,   172,   172,  -185,  -185,   118,   141,   173,   141,
+     209,    38,    38,  -185,   225,   188,  -185,   183,    -8,  -185,
+     184,  -185,  -185,  -185,    57,  -185,  -185,   118,   126,   126,
+    -185,  -185,   118,  -185,   191,  -185,   172,   214,   216,   128,
+     172,   232,   188,   183,   181,  -185,   141,  -185,   172,   172,
+     185,  -185,  -185,   222,   234,   233,   232,   188,  -185,  -185,
+    -185,  -185,   128,   172,   128,   193,  -185,   233,   232,  -185,
+    -185,   160,   187,  -185,   -44,  -185,   233,  -185,  -185,  -185,
+     128,   195,   197,  -185,  -185,  -185,  -185
 };
 
 /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
@@ -715,43 +719,46 @@ static const yytype_int8 yydefact[] =
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        4,     3,    11,    12,    13,    14,     0,     5,     0,     0,
        9,     6,    10,     7,     8,    16,     0,     0,     0,    15,
-       0,     0,     0,     0,   110,    20,     0,   108,   109,     0,
-      92,    71,    67,    68,    70,    69,   111,    72,     0,    93,
-       0,     0,    58,     0,     1,     2,     0,     0,     0,    19,
-       0,     0,    53,     0,     0,     0,     0,     0,     0,     0,
-       0,    23,     0,     0,     0,     0,     0,    25,   111,    53,
-      88,     0,    17,     0,     0,     0,    73,    53,    94,    57,
-      63,     0,     0,    29,     0,     0,    31,     0,     0,     0,
-      41,    39,    40,    42,     0,    80,    55,    54,    81,     0,
-       0,    26,     0,    61,     0,    59,     0,     0,     0,    45,
-       0,    53,    18,     0,    34,     0,    36,    33,    21,     0,
-      22,     0,    37,    81,    86,     0,     0,    78,    77,    79,
-      74,    75,    76,     0,     0,     0,     0,     0,     0,    89,
-      80,    91,     0,     0,     0,     0,     0,    95,     0,    49,
-      62,    45,    30,     0,    32,    24,     0,    87,    56,    43,
-      82,    83,    84,    85,    44,    66,    60,    64,     0,     0,
-       0,     0,    99,    49,     0,    38,     0,    96,     0,    46,
-      47,    51,    50,     0,   107,    99,    35,    65,    97,     0,
-       0,     0,     0,    27,   107,    48,    52,   105,    98,   100,
-     106,    28,   103,   104,   102,     0,   101
+       0,     0,     0,     0,     0,   117,    21,     0,   115,   116,
+       0,     0,    96,    75,    71,    72,    74,    73,   118,    76,
+       0,    97,     0,     0,    62,     0,     0,     1,     2,     0,
+       0,     0,     0,     0,    20,     0,     0,    57,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    25,    26,
+       0,     0,     0,     0,     0,     0,    28,   118,    57,    92,
+       0,    18,    17,     0,     0,     0,    77,    57,    98,    61,
+      67,     0,     0,     0,    33,     0,     0,    35,     0,     0,
+       0,     0,    45,    43,    44,    46,     0,    84,    59,    58,
+      85,     0,     0,    29,     0,    65,     0,    63,     0,     0,
+       0,     0,    49,     0,    57,     0,    19,     0,    38,     0,
+      40,    37,    22,     0,     0,    24,     0,    41,    85,    90,
+       0,     0,    82,    81,    83,    78,    79,    80,     0,     0,
+       0,     0,     0,     0,    93,    84,    95,     0,     0,     0,
+       0,     0,     0,    99,     0,    53,    66,    49,    57,    34,
+       0,    36,    23,    27,     0,    91,    60,    47,    86,    87,
+      88,    89,    48,    70,    64,    68,     0,     0,     0,     0,
+       0,   104,    53,    49,     0,    42,     0,   100,     0,     0,
+      50,    51,    55,    54,     0,   114,   104,    53,    39,    69,
+     101,   102,     0,     0,     0,     0,    30,   114,   104,    52,
+      56,   110,   103,   105,   111,    31,   114,   108,   109,   107,
+       0,     0,     0,    32,   106,   112,   113
 };
 
 /* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
-    -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,  -113,   149,
-      94,  -113,  -113,   -91,  -112,    54,  -113,    35,  -113,   -76,
-    -113,    -9,  -113,  -113,   111,   -66,  -113,   109,   168,   136,
-      30,  -113,     7,  -113,    20,  -113,    -5,   -55
+    -185,  -185,  -185,  -185,  -185,  -185,  -185,  -185,  -185,   -82,
+     116,  -185,  -185,  -106,  -143,  -166,  -185,  -115,  -185,   -83,
+    -185,    -9,  -185,  -185,   144,   -10,  -185,   138,   -38,   -86,
+    -184,  -185,    18,  -185,  -137,  -185,    -4,   -33
 };
 
 /* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_uint8 yydefgoto[] =
 {
-       0,    18,    19,    20,    21,    22,    23,    24,    92,    95,
-      93,   127,   131,   105,   106,   159,   189,   182,   192,    77,
-     107,   133,    48,    49,   143,   109,    79,    80,    50,    87,
-     194,   208,   209,   214,   203,    39,    51,    52
+       0,    18,    19,    20,    21,    22,    23,    24,   103,   106,
+     104,   141,   146,   117,   118,   175,   210,   201,   213,    86,
+     119,   148,    50,    51,   158,   121,    88,    89,    52,    97,
+     215,   232,   233,   239,   226,    41,    53,    54
 };
 
 /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
@@ -759,56 +766,64 @@ static const yytype_uint8 yydefgoto[] =
    number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-      47,    35,    36,   111,    32,    76,    25,   132,    81,    30,
-      85,   119,    33,    89,    90,    27,    83,    94,    96,    96,
-      34,   150,    57,    58,   168,    59,    60,    61,    62,    26,
-      31,    46,    54,   134,   122,   123,    28,    53,   135,   144,
-     145,   146,   147,    76,    47,   161,   151,    37,    38,    55,
-      29,    71,   116,   117,   110,    81,    56,    86,    63,   153,
-      84,    66,    88,    64,   167,   160,   187,   108,    94,   191,
-     144,   145,   146,   147,   164,   185,   198,   169,   170,   171,
-     172,   173,   174,   124,   125,   126,    88,  -110,   206,     1,
-      67,     2,   118,     3,    68,     4,    65,   175,     5,   177,
-      69,     6,   100,   101,   102,   103,    72,     7,     8,     9,
-      75,   155,    73,   157,   137,   138,   139,    74,    10,    11,
-      12,    13,    14,    15,   140,   128,   129,   108,    16,   141,
-     142,   197,    76,   144,   145,   146,   147,    40,   130,   129,
-      41,    42,    43,    44,    45,    17,   137,   138,   139,   165,
-     166,   179,    46,   146,   147,    78,   140,   212,   213,    91,
-      82,   141,   142,    41,    42,    43,    44,    45,    98,   108,
-     112,   190,   108,   113,   120,    46,   114,    99,   115,   108,
-     136,    41,    42,    43,    44,    45,   156,   152,   154,   163,
-     205,   108,   207,    46,   100,   101,   102,   103,   158,   176,
-     104,   178,   180,   181,   184,   188,   207,   186,   193,   196,
-     200,   201,   202,   210,   199,   183,   215,   162,   195,   149,
-     148,    70,   216,    97,   211,   204,     0,   121
+      49,   109,    36,    37,   147,   123,    55,    59,   186,    85,
+      27,   202,    85,    25,   132,   134,   241,    76,   165,    38,
+      39,   128,   129,    61,    62,   242,   144,    64,    65,    66,
+      67,    28,   227,   136,   137,    90,    26,   217,    95,   102,
+      40,    99,   100,    56,   236,    29,    49,   105,   107,   178,
+     107,   177,   130,   207,    60,    78,    79,   212,   122,    82,
+      31,   131,    93,    96,    30,   220,   221,    94,    49,    98,
+      33,   159,   160,   161,   162,   107,   120,    48,   205,    42,
+     230,    32,    43,    44,    45,    46,    47,   216,    34,    90,
+     235,   142,   143,   168,    48,   203,   185,    98,    35,   243,
+     176,   149,   228,    57,   105,    58,   150,   152,   153,   154,
+     181,   138,   139,   140,   166,   145,   143,   155,   112,   113,
+     114,   115,   156,   157,   170,    63,     1,   173,     2,    68,
+       3,    98,     4,    69,   193,     5,   195,    71,     6,   182,
+     143,    72,   120,    70,     7,     8,     9,    73,   187,   188,
+     189,   190,   191,   192,  -117,    10,    11,    12,    13,    14,
+      15,   159,   160,   161,   162,    16,    74,   197,   198,   183,
+     184,   161,   162,   219,   237,   238,    43,    44,    45,    46,
+      47,    77,    17,   159,   160,   161,   162,   120,    48,    75,
+     211,   120,    80,    84,    81,    85,   152,   153,   154,   120,
+     120,    87,    83,    92,    91,   101,   155,   126,   133,   135,
+     108,   156,   157,   229,   120,   231,   111,   110,   124,   125,
+      43,    44,    45,    46,    47,   127,   151,   167,   171,   169,
+     172,   231,    48,   112,   113,   114,   115,   174,   180,   116,
+     196,   194,   199,   200,   206,   208,   204,   209,   214,   218,
+     223,   224,   225,   179,   222,   234,   240,   245,   244,   246,
+     164,     0,     0,     0,     0,   163
 };
 
 static const yytype_int16 yycheck[] =
 {
-       9,     6,     7,    79,    10,    20,     4,    98,    63,     6,
-      65,    87,    13,    68,    69,     6,    45,    72,    73,    74,
-      60,   112,    27,    28,   136,    30,    31,    32,    33,    27,
-      27,    60,     0,    99,    68,    69,    27,    23,   104,    43,
-      44,    45,    46,    20,    53,   121,   112,    39,    40,    65,
-      41,    56,    29,    30,    69,   110,    13,    66,    22,   114,
-      65,    69,    67,    66,    68,   120,   178,    76,   123,   181,
-      43,    44,    45,    46,   129,   166,   188,   143,   144,   145,
-     146,   147,   148,    24,    25,    26,    91,    70,   200,     3,
-      13,     5,    69,     7,    70,     9,    67,   152,    12,   154,
-      53,    15,    61,    62,    63,    64,    67,    21,    22,    23,
-      11,   116,    67,   118,    56,    57,    58,    67,    32,    33,
-      34,    35,    36,    37,    66,    68,    69,   136,    42,    71,
-      72,   186,    20,    43,    44,    45,    46,    45,    68,    69,
-      48,    49,    50,    51,    52,    59,    56,    57,    58,    68,
-      69,   156,    60,    45,    46,    60,    66,    14,    15,    13,
-      64,    71,    72,    48,    49,    50,    51,    52,    67,   178,
-      66,   180,   181,    68,    53,    60,    70,    44,    68,   188,
-      28,    48,    49,    50,    51,    52,    29,    53,    53,    67,
-     199,   200,   201,    60,    61,    62,    63,    64,    54,    68,
-      67,    31,    17,    55,    62,    31,   215,    53,    16,    68,
-      28,    17,    19,    62,    69,   161,    69,   123,   183,   110,
-     109,    53,   215,    74,   204,   195,    -1,    91
+       9,    83,     6,     7,   110,    88,    23,    13,   151,    20,
+       6,   177,    20,     4,    97,   101,    60,    55,   124,    39,
+      40,    29,    30,    27,    28,    69,   108,    31,    32,    33,
+      34,    27,   216,    68,    69,    68,    27,   203,    71,    77,
+      60,    74,    75,    60,   228,    41,    55,    80,    81,   135,
+      83,   134,    60,   196,    60,    59,    60,   200,    69,    63,
+       6,    69,    45,    72,    60,   208,   209,    71,    77,    73,
+      10,    43,    44,    45,    46,   108,    85,    60,   184,    45,
+     223,    27,    48,    49,    50,    51,    52,   202,    13,   122,
+     227,    68,    69,   126,    60,   178,    68,   101,    60,   236,
+     133,   111,   217,     0,   137,    65,   116,    56,    57,    58,
+     143,    24,    25,    26,   124,    68,    69,    66,    61,    62,
+      63,    64,    71,    72,   128,    27,     3,   131,     5,    22,
+       7,   135,     9,    66,   167,    12,   169,    67,    15,    68,
+      69,    69,   151,    66,    21,    22,    23,    13,   158,   159,
+     160,   161,   162,   163,    70,    32,    33,    34,    35,    36,
+      37,    43,    44,    45,    46,    42,    70,   171,   172,    68,
+      69,    45,    46,   206,    14,    15,    48,    49,    50,    51,
+      52,    23,    59,    43,    44,    45,    46,   196,    60,    53,
+     199,   200,    67,    11,    67,    20,    56,    57,    58,   208,
+     209,    60,    67,    64,    62,    13,    66,    70,    53,    13,
+      67,    71,    72,   222,   223,   224,    44,    67,    66,    68,
+      48,    49,    50,    51,    52,    68,    28,    53,    29,    53,
+      29,   240,    60,    61,    62,    63,    64,    54,    67,    67,
+      31,    68,    17,    55,    53,    31,    62,    31,    16,    68,
+      28,    17,    19,   137,    69,    62,    69,    62,   240,    62,
+     122,    -1,    -1,    -1,    -1,   121
 };
 
 /* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
@@ -818,59 +833,62 @@ static const yytype_int8 yystos[] =
        0,     3,     5,     7,     9,    12,    15,    21,    22,    23,
       32,    33,    34,    35,    36,    37,    42,    59,    74,    75,
       76,    77,    78,    79,    80,     4,    27,     6,    27,    41,
-       6,    27,    10,    13,    60,   109,   109,    39,    40,   108,
-      45,    48,    49,    50,    51,    52,    60,    94,    95,    96,
-     101,   109,   110,    23,     0,    65,    13,   109,   109,   109,
-     109,   109,   109,    22,    66,    67,    69,    13,    70,    53,
-     101,   109,    67,    67,    67,    11,    20,    92,    60,    99,
-     100,   110,    64,    45,   109,   110,    94,   102,   109,   110,
-     110,    13,    81,    83,   110,    82,   110,    82,    67,    44,
-      61,    62,    63,    64,    67,    86,    87,    93,    94,    98,
-      69,    92,    66,    68,    70,    68,    29,    30,    69,    92,
-      53,   102,    68,    69,    24,    25,    26,    84,    68,    69,
-      68,    85,    86,    94,    98,    98,    28,    56,    57,    58,
-      66,    71,    72,    97,    43,    44,    45,    46,    97,   100,
-      86,    98,    53,   110,    53,   109,    29,   109,    54,    88,
-     110,    92,    83,    67,   110,    68,    69,    68,    87,    98,
-      98,    98,    98,    98,    98,   110,    68,   110,    31,   109,
-      17,    55,    90,    88,    62,    86,    53,    87,    31,    89,
-      94,    87,    91,    16,   103,    90,    68,   110,    87,    69,
-      28,    17,    19,   107,   103,    94,    87,    94,   104,   105,
-      62,   107,    14,    15,   106,    69,   105
+      60,     6,    27,    10,    13,    60,   109,   109,    39,    40,
+      60,   108,    45,    48,    49,    50,    51,    52,    60,    94,
+      95,    96,   101,   109,   110,    23,    60,     0,    65,    13,
+      60,   109,   109,    27,   109,   109,   109,   109,    22,    66,
+      66,    67,    69,    13,    70,    53,   101,    23,   109,   109,
+      67,    67,   109,    67,    11,    20,    92,    60,    99,   100,
+     110,    62,    64,    45,   109,   110,    94,   102,   109,   110,
+     110,    13,   101,    81,    83,   110,    82,   110,    67,    82,
+      67,    44,    61,    62,    63,    64,    67,    86,    87,    93,
+      94,    98,    69,    92,    66,    68,    70,    68,    29,    30,
+      60,    69,    92,    53,   102,    13,    68,    69,    24,    25,
+      26,    84,    68,    69,    82,    68,    85,    86,    94,    98,
+      98,    28,    56,    57,    58,    66,    71,    72,    97,    43,
+      44,    45,    46,    97,   100,    86,    98,    53,   110,    53,
+     109,    29,    29,   109,    54,    88,   110,    92,   102,    83,
+      67,   110,    68,    68,    69,    68,    87,    98,    98,    98,
+      98,    98,    98,   110,    68,   110,    31,   109,   109,    17,
+      55,    90,    88,    92,    62,    86,    53,    87,    31,    31,
+      89,    94,    87,    91,    16,   103,    90,    88,    68,   110,
+      87,    87,    69,    28,    17,    19,   107,   103,    90,    94,
+      87,    94,   104,   105,    62,   107,   103,    14,    15,   106,
+      69,    60,    69,   107,   105,    62,    62
 };
 
 /* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
        0,    73,    74,    74,    74,    74,    75,    75,    75,    75,
-      75,    76,    76,    76,    76,    76,    77,    78,    79,    79,
-      79,    79,    79,    79,    80,    80,    80,    80,    80,    81,
-      81,    82,    82,    83,    84,    84,    84,    85,    85,    86,
-      86,    86,    86,    87,    87,    88,    88,    89,    89,    90,
-      90,    91,    91,    92,    92,    93,    93,    94,    94,    94,
-      94,    94,    94,    94,    94,    94,    94,    95,    95,    95,
-      95,    95,    96,    96,    97,    97,    97,    97,    97,    97,
-      98,    98,    98,    98,    98,    98,    98,    98,    99,    99,
-     100,   100,   101,   101,   102,   102,   102,   102,   103,   103,
-     104,   104,   105,   106,   106,   106,   107,   107,   108,   108,
-     109,   110
+      75,    76,    76,    76,    76,    76,    77,    78,    78,    79,
+      79,    79,    79,    79,    79,    79,    79,    80,    80,    80,
+      80,    80,    80,    81,    81,    82,    82,    83,    84,    84,
+      84,    85,    85,    86,    86,    86,    86,    87,    87,    88,
+      88,    89,    89,    90,    90,    91,    91,    92,    92,    93,
+      93,    94,    94,    94,    94,    94,    94,    94,    94,    94,
+      94,    95,    95,    95,    95,    95,    96,    96,    97,    97,
+      97,    97,    97,    97,    98,    98,    98,    98,    98,    98,
+      98,    98,    99,    99,   100,   100,   101,   101,   102,   102,
+     102,   102,   102,   103,   103,   104,   104,   105,   106,   106,
+     106,   107,   107,   107,   107,   108,   108,   109,   110
 };
 
 /* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     2,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     2,     2,     4,     6,     3,
-       2,     6,     6,     4,     7,     4,     5,     9,    10,     1,
-       3,     1,     3,     2,     1,     4,     1,     1,     3,     1,
-       1,     1,     1,     3,     3,     0,     3,     1,     3,     0,
-       2,     1,     3,     0,     2,     1,     3,     3,     1,     4,
-       6,     4,     5,     3,     6,     8,     6,     1,     1,     1,
-       1,     1,     1,     3,     1,     1,     1,     1,     1,     1,
-       1,     1,     3,     3,     3,     3,     2,     3,     1,     3,
-       3,     3,     1,     1,     1,     3,     5,     6,     3,     0,
-       1,     3,     2,     1,     1,     0,     2,     0,     1,     1,
-       1,     1
+       1,     1,     1,     1,     1,     2,     2,     4,     4,     6,
+       3,     2,     6,     7,     6,     4,     4,     7,     4,     5,
+       9,    10,    11,     1,     3,     1,     3,     2,     1,     4,
+       1,     1,     3,     1,     1,     1,     1,     3,     3,     0,
+       3,     1,     3,     0,     2,     1,     3,     0,     2,     1,
+       3,     3,     1,     4,     6,     4,     5,     3,     6,     8,
+       6,     1,     1,     1,     1,     1,     1,     3,     1,     1,
+       1,     1,     1,     1,     1,     1,     3,     3,     3,     3,
+       2,     3,     1,     3,     3,     3,     1,     1,     1,     3,
+       5,     6,     6,     3,     0,     1,     3,     2,     1,     1,
+       0,     2,     4,     4,     0,     1,     1,     1,     1
 };
 
 
@@ -1726,728 +1744,799 @@ yyreduce:
   switch (yyn)
     {
   case 2: /* start: stmt ';'  */
-#line 87 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 88 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         parse_tree = (yyvsp[-1].sv_node);
         YYACCEPT;
     }
-#line 1735 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1753 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 3: /* start: HELP  */
-#line 92 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 93 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         parse_tree = std::make_shared<Help>();
         YYACCEPT;
     }
-#line 1744 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1762 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 4: /* start: EXIT  */
-#line 97 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 98 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1753 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1771 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 5: /* start: T_EOF  */
-#line 102 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 103 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         parse_tree = nullptr;
         YYACCEPT;
     }
-#line 1762 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1780 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 11: /* txnStmt: TXN_BEGIN  */
-#line 118 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 119 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnBegin>();
     }
-#line 1770 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1788 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 12: /* txnStmt: TXN_COMMIT  */
-#line 122 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 123 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnCommit>();
     }
-#line 1778 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1796 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 13: /* txnStmt: TXN_ABORT  */
-#line 126 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 127 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnAbort>();
     }
-#line 1786 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1804 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 14: /* txnStmt: TXN_ROLLBACK  */
-#line 130 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 131 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<TxnRollback>();
     }
-#line 1794 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1812 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 15: /* txnStmt: CREATE STATIC_CHECKPOINT  */
-#line 134 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 135 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateCheckpoint>();
     }
-#line 1802 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1820 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 16: /* dbStmt: SHOW TABLES  */
-#line 141 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 142 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowTables>();
     }
-#line 1810 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1828 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
   case 17: /* setStmt: SET set_knob_type '=' VALUE_BOOL  */
-#line 148 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 149 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<SetStmt>((yyvsp[-2].sv_setKnobType), (yyvsp[0].sv_bool));
     }
-#line 1818 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1836 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 18: /* setStmt: SET IDENTIFIER '=' VALUE_INT  */
+#line 153 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // 整数类型的参数不是关键字，按标识符识别（大小写不敏感）
+        std::string knob = (yyvsp[-2].sv_str);
+        std::transform(knob.begin(), knob.end(), knob.begin(), ::tolower);
+        if (knob == "index_cache_size") {
+            (yyval.sv_node) = std::make_shared<SetStmt>(IndexCacheSize, (yyvsp[0].sv_int));
+        } else if (knob == "work_mem") {
+            (yyval.sv_node) = std::make_shared<SetStmt>(WorkMem, (yyvsp[0].sv_int));
+        } else if (knob == "max_parallel_workers") {
+            (yyval.sv_node) = std::make_shared<SetStmt>(MaxParallelWorkers, (yyvsp[0].sv_int));
+        } else {
+            yyerror(&(yylsp[-2]), ("unknown variable " + (yyvsp[-2].sv_str)).c_str());
+            YYERROR;
+        }
+    }
+#line 1856 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 18: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
-#line 155 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 19: /* ddl: CREATE TABLE tbName '(' fieldList ')'  */
+#line 172 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateTable>((yyvsp[-3].sv_str), (yyvsp[-1].sv_fields));
     }
-#line 1826 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1864 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 19: /* ddl: DROP TABLE tbName  */
-#line 159 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 20: /* ddl: DROP TABLE tbName  */
+#line 176 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropTable>((yyvsp[0].sv_str));
     }
-#line 1834 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1872 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 20: /* ddl: DESC_ORDER tbName  */
-#line 163 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 21: /* ddl: DESC_ORDER tbName  */
+#line 180 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DescTable>((yyvsp[0].sv_str));
     }
-#line 1842 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1880 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 21: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
-#line 167 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 22: /* ddl: CREATE INDEX tbName '(' colNameList ')'  */
+#line 184 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1850 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1888 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 22: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
-#line 171 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 23: /* ddl: CREATE IDENTIFIER INDEX tbName '(' colNameList ')'  */
+#line 188 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // UNIQUE/NONUNIQUE不是关键字，按标识符识别（大小写不敏感）
+        std::string index_type = (yyvsp[-5].sv_str);
+        std::transform(index_type.begin(), index_type.end(), index_type.begin(), ::tolower);
+        if (index_type != "unique" && index_type != "nonunique") {
+            yyerror(&(yylsp[-5]), ("unknown index type " + (yyvsp[-5].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_node) = std::make_shared<CreateIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs), index_type == "unique");
+    }
+#line 1903 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 24: /* ddl: DROP INDEX tbName '(' colNameList ')'  */
+#line 199 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DropIndex>((yyvsp[-3].sv_str), (yyvsp[-1].sv_strs));
     }
-#line 1858 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1911 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 23: /* ddl: SHOW INDEX FROM tbName  */
-#line 175 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 25: /* ddl: SHOW INDEX FROM tbName  */
+#line 203 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<ShowIndex>((yyvsp[0].sv_str));
     }
-#line 1866 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1919 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 26: /* ddl: SHOW INDEX IDENTIFIER tbName  */
+#line 207 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // STATS不是关键字，按标识符识别（大小写不敏感）
+        std::string option = (yyvsp[-1].sv_str);
+        std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+        if (option != "stats") {
+            yyerror(&(yylsp[-1]), ("unknown show index option " + (yyvsp[-1].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_node) = std::make_shared<ShowIndexStats>((yyvsp[0].sv_str));
+    }
+#line 1934 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 24: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
-#line 182 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 27: /* dml: INSERT INTO tbName VALUES '(' valueList ')'  */
+#line 221 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<InsertStmt>((yyvsp[-4].sv_str), (yyvsp[-1].sv_vals));
     }
-#line 1874 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1942 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 25: /* dml: DELETE FROM tbName optWhereClause  */
-#line 186 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 28: /* dml: DELETE FROM tbName optWhereClause  */
+#line 225 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<DeleteStmt>((yyvsp[-1].sv_str), (yyvsp[0].sv_conds));
     }
-#line 1882 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1950 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 26: /* dml: UPDATE tbName SET setClauses optWhereClause  */
-#line 190 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 29: /* dml: UPDATE tbName SET setClauses optWhereClause  */
+#line 229 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_node) = std::make_shared<UpdateStmt>((yyvsp[-3].sv_str), (yyvsp[-1].sv_set_clauses), (yyvsp[0].sv_conds));
     }
-#line 1890 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1958 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 27: /* dml: SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause  */
-#line 194 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 30: /* dml: SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause  */
+#line 233 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
-        auto select_stmt = std::make_shared<SelectStmt>((yyvsp[-7].sv_cols), (yyvsp[-5].sv_table_list).tables, (yyvsp[-4].sv_conds), (yyvsp[-3].sv_group_by_Clause), (yyvsp[-2].sv_having_clause), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_int));
+        auto select_stmt = std::make_shared<SelectStmt>((yyvsp[-7].sv_cols), (yyvsp[-5].sv_table_list).tables, (yyvsp[-4].sv_conds), (yyvsp[-3].sv_group_by_Clause), (yyvsp[-2].sv_having_clause), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_limit).count);
+        select_stmt->limit_offset = (yyvsp[0].sv_limit).offset;
         select_stmt->jointree = (yyvsp[-5].sv_table_list).joins;
         select_stmt->table_aliases = (yyvsp[-5].sv_table_list).table_aliases;
         (yyval.sv_node) = select_stmt;
     }
-#line 1901 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1970 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 28: /* dml: EXPLAIN SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause  */
-#line 201 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 31: /* dml: EXPLAIN SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause  */
+#line 241 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
-        auto select_stmt = std::make_shared<SelectStmt>((yyvsp[-7].sv_cols), (yyvsp[-5].sv_table_list).tables, (yyvsp[-4].sv_conds), (yyvsp[-3].sv_group_by_Clause), (yyvsp[-2].sv_having_clause), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_int));
+        auto select_stmt = std::make_shared<SelectStmt>((yyvsp[-7].sv_cols), (yyvsp[-5].sv_table_list).tables, (yyvsp[-4].sv_conds), (yyvsp[-3].sv_group_by_Clause), (yyvsp[-2].sv_having_clause), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_limit).count);
+        select_stmt->limit_offset = (yyvsp[0].sv_limit).offset;
         select_stmt->jointree = (yyvsp[-5].sv_table_list).joins;
         select_stmt->table_aliases = (yyvsp[-5].sv_table_list).table_aliases;
         (yyval.sv_node) = std::make_shared<ExplainStmt>(select_stmt);
     }
-#line 1912 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 1982 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 32: /* dml: EXPLAIN IDENTIFIER SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause  */
+#line 249 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // EXPLAIN ANALYZE：ANALYZE不是关键字，按标识符识别（大小写不敏感）
+        std::string option = (yyvsp[-9].sv_str);
+        std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+        if (option != "analyze") {
+            yyerror(&(yylsp[-9]), ("unknown explain option " + (yyvsp[-9].sv_str)).c_str());
+            YYERROR;
+        }
+        auto select_stmt = std::make_shared<SelectStmt>((yyvsp[-7].sv_cols), (yyvsp[-5].sv_table_list).tables, (yyvsp[-4].sv_conds), (yyvsp[-3].sv_group_by_Clause), (yyvsp[-2].sv_having_clause), (yyvsp[-1].sv_orderby), (yyvsp[0].sv_limit).count);
+        select_stmt->limit_offset = (yyvsp[0].sv_limit).offset;
+        select_stmt->jointree = (yyvsp[-5].sv_table_list).joins;
+        select_stmt->table_aliases = (yyvsp[-5].sv_table_list).table_aliases;
+        (yyval.sv_node) = std::make_shared<ExplainStmt>(select_stmt, true);
+    }
+#line 2001 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 29: /* fieldList: field  */
-#line 211 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 33: /* fieldList: field  */
+#line 267 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_fields) = std::vector<std::shared_ptr<Field>>{(yyvsp[0].sv_field)};
     }
-#line 1920 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2009 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 30: /* fieldList: fieldList ',' field  */
-#line 215 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 34: /* fieldList: fieldList ',' field  */
+#line 271 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_fields).push_back((yyvsp[0].sv_field));
     }
-#line 1928 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2017 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 31: /* colNameList: colName  */
-#line 222 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 35: /* colNameList: colName  */
+#line 278 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_strs) = std::vector<std::string>{(yyvsp[0].sv_str)};
     }
-#line 1936 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2025 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 32: /* colNameList: colNameList ',' colName  */
-#line 226 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 36: /* colNameList: colNameList ',' colName  */
+#line 282 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_strs).push_back((yyvsp[0].sv_str));
     }
-#line 1944 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2033 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 33: /* field: colName type  */
-#line 233 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 37: /* field: colName type  */
+#line 289 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_field) = std::make_shared<ColDef>((yyvsp[-1].sv_str), (yyvsp[0].sv_type_len));
     }
-#line 1952 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2041 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 34: /* type: INT  */
-#line 240 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 38: /* type: INT  */
+#line 296 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_INT, sizeof(int));
     }
-#line 1960 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2049 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 35: /* type: CHAR '(' VALUE_INT ')'  */
-#line 244 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 39: /* type: CHAR '(' VALUE_INT ')'  */
+#line 300 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_STRING, (yyvsp[-1].sv_int));
     }
-#line 1968 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2057 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 36: /* type: FLOAT  */
-#line 248 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 40: /* type: FLOAT  */
+#line 304 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_type_len) = std::make_shared<TypeLen>(SV_TYPE_FLOAT, sizeof(float));
     }
-#line 1976 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2065 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 37: /* valueList: value  */
-#line 255 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 41: /* valueList: value  */
+#line 311 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_vals) = std::vector<std::shared_ptr<Value>>{(yyvsp[0].sv_val)};
     }
-#line 1984 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2073 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 38: /* valueList: valueList ',' value  */
-#line 259 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 42: /* valueList: valueList ',' value  */
+#line 315 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_vals).push_back((yyvsp[0].sv_val));
     }
-#line 1992 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2081 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 39: /* value: VALUE_INT  */
-#line 266 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 43: /* value: VALUE_INT  */
+#line 322 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<IntLit>((yyvsp[0].sv_int));
     }
-#line 2000 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2089 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 40: /* value: VALUE_FLOAT  */
-#line 270 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 44: /* value: VALUE_FLOAT  */
+#line 326 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<FloatLit>((yyvsp[0].sv_float));
     }
-#line 2008 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2097 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 41: /* value: VALUE_STRING  */
-#line 274 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 45: /* value: VALUE_STRING  */
+#line 330 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<StringLit>((yyvsp[0].sv_str));
     }
-#line 2016 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2105 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 42: /* value: VALUE_BOOL  */
-#line 278 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 46: /* value: VALUE_BOOL  */
+#line 334 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_val) = std::make_shared<BoolLit>((yyvsp[0].sv_bool));
     }
-#line 2024 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2113 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 43: /* condition: col op expr  */
-#line 285 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 47: /* condition: col op expr  */
+#line 341 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_col), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 2032 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2121 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 44: /* condition: expr op expr  */
-#line 289 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 48: /* condition: expr op expr  */
+#line 345 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cond) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_expr), (yyvsp[-1].sv_comp_op), (yyvsp[0].sv_expr));
     }
-#line 2040 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2129 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 45: /* optGroupClause: %empty  */
-#line 295 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 49: /* optGroupClause: %empty  */
+#line 351 "/root/db2025-amatilasdb/src/parser/yacc.y"
                   { (yyval.sv_group_by_Clause) = nullptr; }
-#line 2046 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2135 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 46: /* optGroupClause: GROUP BY GroupColList  */
-#line 298 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 50: /* optGroupClause: GROUP BY GroupColList  */
+#line 354 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
        (yyval.sv_group_by_Clause) = std::make_shared<GroupByClause>((yyvsp[0].sv_cols));
     }
-#line 2054 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2143 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 47: /* GroupColList: col  */
-#line 305 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 51: /* GroupColList: col  */
+#line 361 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 2062 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2151 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 48: /* GroupColList: GroupColList ',' col  */
-#line 309 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 52: /* GroupColList: GroupColList ',' col  */
+#line 365 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 2070 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2159 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 49: /* optHavingClause: %empty  */
-#line 315 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 53: /* optHavingClause: %empty  */
+#line 371 "/root/db2025-amatilasdb/src/parser/yacc.y"
                   { (yyval.sv_having_clause) = nullptr; }
-#line 2076 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2165 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 50: /* optHavingClause: HAVING havingConditions  */
-#line 318 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 54: /* optHavingClause: HAVING havingConditions  */
+#line 374 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_having_clause) = std::make_shared<HavingClause>((yyvsp[0].sv_conds));
     }
-#line 2084 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2173 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 51: /* havingConditions: condition  */
-#line 325 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 55: /* havingConditions: condition  */
+#line 381 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 2092 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2181 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 52: /* havingConditions: havingConditions AND condition  */
-#line 330 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 56: /* havingConditions: havingConditions AND condition  */
+#line 386 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 2100 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2189 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 53: /* optWhereClause: %empty  */
-#line 336 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 57: /* optWhereClause: %empty  */
+#line 392 "/root/db2025-amatilasdb/src/parser/yacc.y"
                       { /* ignore*/ }
-#line 2106 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2195 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 54: /* optWhereClause: WHERE whereClause  */
-#line 338 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 58: /* optWhereClause: WHERE whereClause  */
+#line 394 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_conds) = (yyvsp[0].sv_conds);
     }
-#line 2114 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2203 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 55: /* whereClause: condition  */
-#line 345 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 59: /* whereClause: condition  */
+#line 401 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_conds) = std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)};
     }
-#line 2122 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2211 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 56: /* whereClause: whereClause AND condition  */
-#line 349 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 60: /* whereClause: whereClause AND condition  */
+#line 405 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_conds).push_back((yyvsp[0].sv_cond));
     }
-#line 2130 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2219 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 57: /* col: tbName '.' colName  */
-#line 356 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 61: /* col: tbName '.' colName  */
+#line 412 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 2138 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2227 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 58: /* col: colName  */
-#line 360 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 62: /* col: colName  */
+#line 416 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[0].sv_str));
     }
-#line 2146 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2235 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 59: /* col: agg_type '(' colName ')'  */
-#line 364 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 63: /* col: agg_type '(' colName ')'  */
+#line 420 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[-1].sv_str), (yyvsp[-3].sv_agg_type));
     }
-#line 2154 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2243 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 60: /* col: agg_type '(' tbName '.' colName ')'  */
-#line 368 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 64: /* col: agg_type '(' tbName '.' colName ')'  */
+#line 424 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[-1].sv_str), (yyvsp[-5].sv_agg_type));
     }
-#line 2162 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2251 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 61: /* col: agg_type '(' '*' ')'  */
-#line 372 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 65: /* col: agg_type '(' '*' ')'  */
+#line 428 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", "*", (yyvsp[-3].sv_agg_type));
     }
-#line 2170 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2259 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 62: /* col: tbName '.' colName AS colName  */
-#line 376 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 66: /* col: tbName '.' colName AS colName  */
+#line 432 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-4].sv_str), (yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 2178 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2267 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 63: /* col: colName AS colName  */
-#line 380 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 67: /* col: colName AS colName  */
+#line 436 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[-2].sv_str), (yyvsp[0].sv_str));
     }
-#line 2186 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2275 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 64: /* col: agg_type '(' colName ')' AS colName  */
-#line 384 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 68: /* col: agg_type '(' colName ')' AS colName  */
+#line 440 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", (yyvsp[-3].sv_str), (yyvsp[-5].sv_agg_type), (yyvsp[0].sv_str));
     }
-#line 2194 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2283 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 65: /* col: agg_type '(' tbName '.' colName ')' AS colName  */
-#line 388 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 69: /* col: agg_type '(' tbName '.' colName ')' AS colName  */
+#line 444 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>((yyvsp[-5].sv_str), (yyvsp[-3].sv_str), (yyvsp[-7].sv_agg_type), (yyvsp[0].sv_str));
     }
-#line 2202 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2291 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 66: /* col: agg_type '(' '*' ')' AS colName  */
-#line 392 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 70: /* col: agg_type '(' '*' ')' AS colName  */
+#line 448 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_col) = std::make_shared<Col>("", "*", (yyvsp[-5].sv_agg_type), (yyvsp[0].sv_str));
     }
-#line 2210 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2299 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 67: /* agg_type: SUM  */
-#line 400 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 71: /* agg_type: SUM  */
+#line 456 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_agg_type) = AggFuncType::SUM;
     }
-#line 2218 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2307 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 68: /* agg_type: COUNT  */
-#line 404 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 72: /* agg_type: COUNT  */
+#line 460 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_agg_type) = AggFuncType::COUNT;
     }
-#line 2226 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2315 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 69: /* agg_type: MIN  */
-#line 408 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 73: /* agg_type: MIN  */
+#line 464 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_agg_type) = AggFuncType::MIN;
     }
-#line 2234 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2323 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 70: /* agg_type: MAX  */
-#line 412 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 74: /* agg_type: MAX  */
+#line 468 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_agg_type) = AggFuncType::MAX;
     }
-#line 2242 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2331 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 71: /* agg_type: AVG  */
-#line 416 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 75: /* agg_type: AVG  */
+#line 472 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_agg_type) = AggFuncType::AVG;
     }
-#line 2250 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2339 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 72: /* colList: col  */
-#line 424 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 76: /* colList: col  */
+#line 480 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols) = std::vector<std::shared_ptr<Col>>{(yyvsp[0].sv_col)};
     }
-#line 2258 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2347 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 73: /* colList: colList ',' col  */
-#line 428 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 77: /* colList: colList ',' col  */
+#line 484 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols).push_back((yyvsp[0].sv_col));
     }
-#line 2266 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2355 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 74: /* op: '='  */
-#line 435 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 78: /* op: '='  */
+#line 491 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_EQ;
     }
-#line 2274 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2363 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 75: /* op: '<'  */
-#line 439 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 79: /* op: '<'  */
+#line 495 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LT;
     }
-#line 2282 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2371 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 76: /* op: '>'  */
-#line 443 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 80: /* op: '>'  */
+#line 499 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GT;
     }
-#line 2290 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2379 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 77: /* op: NEQ  */
-#line 447 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 81: /* op: NEQ  */
+#line 503 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_NE;
     }
-#line 2298 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2387 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 78: /* op: LEQ  */
-#line 451 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 82: /* op: LEQ  */
+#line 507 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_LE;
     }
-#line 2306 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2395 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 79: /* op: GEQ  */
-#line 455 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 83: /* op: GEQ  */
+#line 511 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_comp_op) = SV_OP_GE;
     }
-#line 2314 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2403 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 80: /* expr: value  */
-#line 462 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 84: /* expr: value  */
+#line 518 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_val));
     }
-#line 2322 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2411 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 81: /* expr: col  */
-#line 466 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 85: /* expr: col  */
+#line 522 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::static_pointer_cast<Expr>((yyvsp[0].sv_col));
     }
-#line 2330 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2419 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 82: /* expr: expr '+' expr  */
-#line 470 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 86: /* expr: expr '+' expr  */
+#line 526 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_expr), SV_OP_ADD, (yyvsp[0].sv_expr));
     }
-#line 2338 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2427 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 83: /* expr: expr '-' expr  */
-#line 474 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 87: /* expr: expr '-' expr  */
+#line 530 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_expr), SV_OP_SUB, (yyvsp[0].sv_expr));
     }
-#line 2346 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2435 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 84: /* expr: expr '*' expr  */
-#line 478 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 88: /* expr: expr '*' expr  */
+#line 534 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_expr), SV_OP_MUL, (yyvsp[0].sv_expr));
     }
-#line 2354 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2443 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 85: /* expr: expr '/' expr  */
-#line 482 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 89: /* expr: expr '/' expr  */
+#line 538 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::make_shared<BinaryExpr>((yyvsp[-2].sv_expr), SV_OP_DIV, (yyvsp[0].sv_expr));
     }
-#line 2362 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2451 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 86: /* expr: '-' expr  */
-#line 486 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 90: /* expr: '-' expr  */
+#line 542 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = std::make_shared<UnaryExpr>(SV_OP_NEG, (yyvsp[0].sv_expr));
     }
-#line 2370 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2459 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 87: /* expr: '(' expr ')'  */
-#line 490 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 91: /* expr: '(' expr ')'  */
+#line 546 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_expr) = (yyvsp[-1].sv_expr);
     }
-#line 2378 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2467 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 88: /* setClauses: setClause  */
-#line 497 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 92: /* setClauses: setClause  */
+#line 553 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses) = std::vector<std::shared_ptr<SetClause>>{(yyvsp[0].sv_set_clause)};
     }
-#line 2386 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2475 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 89: /* setClauses: setClauses ',' setClause  */
-#line 501 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 93: /* setClauses: setClauses ',' setClause  */
+#line 557 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_set_clauses).push_back((yyvsp[0].sv_set_clause));
     }
-#line 2394 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2483 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 90: /* setClause: colName '=' value  */
-#line 508 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 94: /* setClause: colName '=' value  */
+#line 564 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_val));
     }
-#line 2402 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2491 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 91: /* setClause: colName '=' expr  */
-#line 512 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 95: /* setClause: colName '=' expr  */
+#line 568 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_set_clause) = std::make_shared<SetClause>((yyvsp[-2].sv_str), (yyvsp[0].sv_expr));
     }
-#line 2410 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2499 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 92: /* selector: '*'  */
-#line 519 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 96: /* selector: '*'  */
+#line 575 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols) = {};
     }
-#line 2418 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2507 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 93: /* selector: colList  */
-#line 523 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 97: /* selector: colList  */
+#line 579 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_cols) = (yyvsp[0].sv_cols);
     }
-#line 2426 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2515 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 94: /* tableList: tbName  */
-#line 530 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 98: /* tableList: tbName  */
+#line 586 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = std::vector<std::string>{(yyvsp[0].sv_str)};
         (yyval.sv_table_list).joins = std::vector<std::shared_ptr<JoinExpr>>{};
         (yyval.sv_table_list).table_aliases = std::map<std::string, std::string>{};
     }
-#line 2436 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2525 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 95: /* tableList: tableList ',' tbName  */
-#line 536 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 99: /* tableList: tableList ',' tbName  */
+#line 592 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = (yyvsp[-2].sv_table_list).tables;
         (yyval.sv_table_list).tables.push_back((yyvsp[0].sv_str));
         (yyval.sv_table_list).joins = (yyvsp[-2].sv_table_list).joins;
         (yyval.sv_table_list).table_aliases = (yyvsp[-2].sv_table_list).table_aliases;
     }
-#line 2447 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2536 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 96: /* tableList: tableList JOIN tbName ON condition  */
-#line 543 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 100: /* tableList: tableList JOIN tbName ON condition  */
+#line 599 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = (yyvsp[-4].sv_table_list).tables;
         (yyval.sv_table_list).tables.push_back((yyvsp[-2].sv_str));
@@ -2455,11 +2544,11 @@ yyreduce:
         (yyval.sv_table_list).joins.push_back(std::make_shared<JoinExpr>((yyvsp[-4].sv_table_list).tables.back(), (yyvsp[-2].sv_str), std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)}, INNER_JOIN));
         (yyval.sv_table_list).table_aliases = (yyvsp[-4].sv_table_list).table_aliases;
     }
-#line 2459 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2548 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 97: /* tableList: tableList SEMI JOIN tbName ON condition  */
-#line 551 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 101: /* tableList: tableList SEMI JOIN tbName ON condition  */
+#line 607 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_table_list).tables = (yyvsp[-5].sv_table_list).tables;
         (yyval.sv_table_list).tables.push_back((yyvsp[-2].sv_str));
@@ -2467,93 +2556,139 @@ yyreduce:
         (yyval.sv_table_list).joins.push_back(std::make_shared<JoinExpr>((yyvsp[-5].sv_table_list).tables.back(), (yyvsp[-2].sv_str), std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)}, SEMI_JOIN));
         (yyval.sv_table_list).table_aliases = (yyvsp[-5].sv_table_list).table_aliases;
     }
-#line 2471 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2560 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 102: /* tableList: tableList IDENTIFIER JOIN tbName ON condition  */
+#line 615 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // ANTI不是关键字，按标识符识别（大小写不敏感）
+        std::string join_type = (yyvsp[-4].sv_str);
+        std::transform(join_type.begin(), join_type.end(), join_type.begin(), ::tolower);
+        if (join_type != "anti") {
+            yyerror(&(yylsp[-4]), ("unknown join type " + (yyvsp[-4].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_table_list).tables = (yyvsp[-5].sv_table_list).tables;
+        (yyval.sv_table_list).tables.push_back((yyvsp[-2].sv_str));
+        (yyval.sv_table_list).joins = (yyvsp[-5].sv_table_list).joins;
+        (yyval.sv_table_list).joins.push_back(std::make_shared<JoinExpr>((yyvsp[-5].sv_table_list).tables.back(), (yyvsp[-2].sv_str), std::vector<std::shared_ptr<BinaryExpr>>{(yyvsp[0].sv_cond)}, ANTI_JOIN));
+        (yyval.sv_table_list).table_aliases = (yyvsp[-5].sv_table_list).table_aliases;
+    }
+#line 2579 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 98: /* opt_order_clause: ORDER BY order_list  */
-#line 562 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 103: /* opt_order_clause: ORDER BY order_list  */
+#line 633 "/root/db2025-amatilasdb/src/parser/yacc.y"
     { 
         (yyval.sv_orderby) = std::make_shared<OrderBy>((yyvsp[0].sv_orderby_items)); 
     }
-#line 2479 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2587 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 99: /* opt_order_clause: %empty  */
-#line 565 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 104: /* opt_order_clause: %empty  */
+#line 636 "/root/db2025-amatilasdb/src/parser/yacc.y"
                       { (yyval.sv_orderby) = nullptr; }
-#line 2485 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2593 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 100: /* order_list: order_item  */
-#line 570 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 105: /* order_list: order_item  */
+#line 641 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_orderby_items) = std::vector<std::shared_ptr<OrderByItem>>{(yyvsp[0].sv_orderby_item)};
     }
-#line 2493 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2601 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 101: /* order_list: order_list ',' order_item  */
-#line 574 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 106: /* order_list: order_list ',' order_item  */
+#line 645 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
         (yyval.sv_orderby_items).push_back((yyvsp[0].sv_orderby_item));
     }
-#line 2501 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2609 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 102: /* order_item: col opt_asc_desc  */
-#line 581 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 107: /* order_item: col opt_asc_desc  */
+#line 652 "/root/db2025-amatilasdb/src/parser/yacc.y"
     { 
         (yyval.sv_orderby_item) = std::make_shared<OrderByItem>((yyvsp[-1].sv_col), (yyvsp[0].sv_orderby_dir));
     }
-#line 2509 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2617 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 103: /* opt_asc_desc: ASC  */
-#line 587 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 108: /* opt_asc_desc: ASC  */
+#line 658 "/root/db2025-amatilasdb/src/parser/yacc.y"
                  { (yyval.sv_orderby_dir) = OrderBy_ASC;     }
-#line 2515 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2623 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 104: /* opt_asc_desc: DESC_ORDER  */
-#line 588 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 109: /* opt_asc_desc: DESC_ORDER  */
+#line 659 "/root/db2025-amatilasdb/src/parser/yacc.y"
                   { (yyval.sv_orderby_dir) = OrderBy_DESC;    }
-#line 2521 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2629 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 105: /* opt_asc_desc: %empty  */
-#line 589 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 110: /* opt_asc_desc: %empty  */
+#line 660 "/root/db2025-amatilasdb/src/parser/yacc.y"
             { (yyval.sv_orderby_dir) = OrderBy_DEFAULT; }
-#line 2527 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2635 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 111: /* opt_limit_clause: LIMIT VALUE_INT  */
+#line 665 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        (yyval.sv_limit).count = (yyvsp[0].sv_int);
+        (yyval.sv_limit).offset = 0;
+    }
+#line 2644 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+    break;
+
+  case 112: /* opt_limit_clause: LIMIT VALUE_INT IDENTIFIER VALUE_INT  */
+#line 670 "/root/db2025-amatilasdb/src/parser/yacc.y"
+    {
+        // OFFSET不是关键字，按标识符识别（大小写不敏感）
+        std::string word = (yyvsp[-1].sv_str);
+        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+        if (word != "offset") {
+            yyerror(&(yylsp[-1]), ("syntax error near " + (yyvsp[-1].sv_str)).c_str());
+            YYERROR;
+        }
+        (yyval.sv_limit).count = (yyvsp[-2].sv_int);
+        (yyval.sv_limit).offset = (yyvsp[0].sv_int);
+    }
+#line 2660 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 106: /* opt_limit_clause: LIMIT VALUE_INT  */
-#line 594 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 113: /* opt_limit_clause: LIMIT VALUE_INT ',' VALUE_INT  */
+#line 682 "/root/db2025-amatilasdb/src/parser/yacc.y"
     {
-        (yyval.sv_int) = (yyvsp[0].sv_int);
+        // LIMIT offset, count
+        (yyval.sv_limit).count = (yyvsp[0].sv_int);
+        (yyval.sv_limit).offset = (yyvsp[-2].sv_int);
     }
-#line 2535 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2670 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 107: /* opt_limit_clause: %empty  */
-#line 597 "/root/db2025-amatilasdb/src/parser/yacc.y"
-                    { (yyval.sv_int) = -1; }
-#line 2541 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+  case 114: /* opt_limit_clause: %empty  */
+#line 687 "/root/db2025-amatilasdb/src/parser/yacc.y"
+                    { (yyval.sv_limit).count = -1; (yyval.sv_limit).offset = 0; }
+#line 2676 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 108: /* set_knob_type: ENABLE_NESTLOOP  */
-#line 601 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 115: /* set_knob_type: ENABLE_NESTLOOP  */
+#line 691 "/root/db2025-amatilasdb/src/parser/yacc.y"
                     { (yyval.sv_setKnobType) = EnableNestLoop; }
-#line 2547 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2682 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
-  case 109: /* set_knob_type: ENABLE_SORTMERGE  */
-#line 602 "/root/db2025-amatilasdb/src/parser/yacc.y"
+  case 116: /* set_knob_type: ENABLE_SORTMERGE  */
+#line 692 "/root/db2025-amatilasdb/src/parser/yacc.y"
                          { (yyval.sv_setKnobType) = EnableSortMerge; }
-#line 2553 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2688 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
     break;
 
 
-#line 2557 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
+#line 2692 "/root/db2025-amatilasdb/src/parser/yacc.tab.cpp"
 
       default: break;
     }
@@ -2782,5 +2917,5 @@ yyreturnlab:
   return yyresult;
 }
 
-#line 608 "/root/db2025-amatilasdb/src/parser/yacc.y"
+#line 698 "/root/db2025-amatilasdb/src/parser/yacc.y"
 
@@ -1,6 +1,7 @@
 %{
 #include "ast.h"
 #include "yacc.tab.h"
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
@@ -68,7 +69,7 @@ WHERE UPDATE SET SELECT INT CHAR FLOAT INDEX AND JOIN SEMI ON EXIT HELP TXN_BEGI
 %type <sv_orderby_item> order_item
 %type <sv_orderby_items> order_list
 %type <sv_orderby_dir> opt_asc_desc
-%type <sv_int> opt_limit_clause
+%type <sv_limit> opt_limit_clause
 %type <sv_setKnobType> set_knob_type
 
 //AGG
@@ -148,6 +149,22 @@ setStmt:
     {
         $$ = std::make_shared<SetStmt>($2, $4);
     }
+    |   SET IDENTIFIER '=' VALUE_INT
+    {
+        // 整数类型的参数不是关键字，按标识符识别（大小写不敏感）
+        std::string knob = $2;
+        std::transform(knob.begin(), knob.end(), knob.begin(), ::tolower);
+        if (knob == "index_cache_size") {
+            $$ = std::make_shared<SetStmt>(IndexCacheSize, $4);
+        } else if (knob == "work_mem") {
+            $$ = std::make_shared<SetStmt>(WorkMem, $4);
+        } else if (knob == "max_parallel_workers") {
+            $$ = std::make_shared<SetStmt>(MaxParallelWorkers, $4);
+        } else {
+            yyerror(&@2, ("unknown variable " + $2).c_str());
+            YYERROR;
+        }
+    }
     ;
 
 ddl:
@@ -167,6 +184,17 @@ ddl:
     {
         $$ = std::make_shared<CreateIndex>($3, $5);
     }
+    |   CREATE IDENTIFIER INDEX tbName '(' colNameList ')'
+    {
+        // UNIQUE/NONUNIQUE不是关键字，按标识符识别（大小写不敏感）
+        std::string index_type = $2;
+        std::transform(index_type.begin(), index_type.end(), index_type.begin(), ::tolower);
+        if (index_type != "unique" && index_type != "nonunique") {
+            yyerror(&@2, ("unknown index type " + $2).c_str());
+            YYERROR;
+        }
+        $$ = std::make_shared<CreateIndex>($4, $6, index_type == "unique");
+    }
     |   DROP INDEX tbName '(' colNameList ')'
     {
         $$ = std::make_shared<DropIndex>($3, $5);
@@ -175,6 +203,17 @@ ddl:
     {
         $$ = std::make_shared<ShowIndex>($4);
     }
+    |   SHOW INDEX IDENTIFIER tbName
+    {
+        // STATS不是关键字，按标识符识别（大小写不敏感）
+        std::string option = $3;
+        std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+        if (option != "stats") {
+            yyerror(&@3, ("unknown show index option " + $3).c_str());
+            YYERROR;
+        }
+        $$ = std::make_shared<ShowIndexStats>($4);
+    }
     ;
 
 dml:
@@ -192,18 +231,35 @@ dml:
     }
     |   SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause
     {
-        auto select_stmt = std::make_shared<SelectStmt>($2, $4.tables, $5, $6, $7, $8, $9);
+        auto select_stmt = std::make_shared<SelectStmt>($2, $4.tables, $5, $6, $7, $8, $9.count);
+        select_stmt->limit_offset = $9.offset;
         select_stmt->jointree = $4.joins;
         select_stmt->table_aliases = $4.table_aliases;
         $$ = select_stmt;
     }
     |   EXPLAIN SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause
     {
-        auto select_stmt = std::make_shared<SelectStmt>($3, $5.tables, $6, $7, $8, $9, $10);
+        auto select_stmt = std::make_shared<SelectStmt>($3, $5.tables, $6, $7, $8, $9, $10.count);
+        select_stmt->limit_offset = $10.offset;
         select_stmt->jointree = $5.joins;
         select_stmt->table_aliases = $5.table_aliases;
         $$ = std::make_shared<ExplainStmt>(select_stmt);
     }
+    |   EXPLAIN IDENTIFIER SELECT selector FROM tableList optWhereClause optGroupClause optHavingClause opt_order_clause opt_limit_clause
+    {
+        // EXPLAIN ANALYZE：ANALYZE不是关键字，按标识符识别（大小写不敏感）
+        std::string option = $2;
+        std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+        if (option != "analyze") {
+            yyerror(&@2, ("unknown explain option " + $2).c_str());
+            YYERROR;
+        }
+        auto select_stmt = std::make_shared<SelectStmt>($4, $6.tables, $7, $8, $9, $10, $11.count);
+        select_stmt->limit_offset = $11.offset;
+        select_stmt->jointree = $6.joins;
+        select_stmt->table_aliases = $6.table_aliases;
+        $$ = std::make_shared<ExplainStmt>(select_stmt, true);
+    }
     ;
 
 fieldList:
@@ -555,6 +611,21 @@ tableList:
         $$.joins.push_back(std::make_shared<JoinExpr>($1.tables.back(), $4, std::vector<std::shared_ptr<BinaryExpr>>{$6}, SEMI_JOIN));
         $$.table_aliases = $1.table_aliases;
     }
+    |   tableList IDENTIFIER JOIN tbName ON condition
+    {
+        // ANTI不是关键字，按标识符识别（大小写不敏感）
+        std::string join_type = $2;
+        std::transform(join_type.begin(), join_type.end(), join_type.begin(), ::tolower);
+        if (join_type != "anti") {
+            yyerror(&@2, ("unknown join type " + $2).c_str());
+            YYERROR;
+        }
+        $$.tables = $1.tables;
+        $$.tables.push_back($4);
+        $$.joins = $1.joins;
+        $$.joins.push_back(std::make_shared<JoinExpr>($1.tables.back(), $4, std::vector<std::shared_ptr<BinaryExpr>>{$6}, ANTI_JOIN));
+        $$.table_aliases = $1.table_aliases;
+    }
     ;
 
 opt_order_clause:
@@ -592,9 +663,28 @@ opt_asc_desc:
 opt_limit_clause:
     LIMIT VALUE_INT
     {
-        $$ = $2;
+        $$.count = $2;
+        $$.offset = 0;
+    }
+    |   LIMIT VALUE_INT IDENTIFIER VALUE_INT
+    {
+        // OFFSET不是关键字，按标识符识别（大小写不敏感）
+        std::string word = $3;
+        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+        if (word != "offset") {
+            yyerror(&@3, ("syntax error near " + $3).c_str());
+            YYERROR;
+        }
+        $$.count = $2;
+        $$.offset = $4;
+    }
+    |   LIMIT VALUE_INT ',' VALUE_INT
+    {
+        // LIMIT offset, count
+        $$.count = $4;
+        $$.offset = $2;
     }
-    | /* epsilon */ { $$ = -1; }
+    | /* epsilon */ { $$.count = -1; $$.offset = 0; }
     ;    
 
 set_knob_type:
@@ -17,16 +17,23 @@ See the Mulan PSL v2 for more details. */
 #include "optimizer/plan.h"
 #include "execution/executor_abstract.h"
 #include "execution/executor_nestedloop_join.h"
+#include "execution/executor_hash_join.h"
+#include "execution/executor_sort_merge_join.h"
+#include "execution/executor_index_nestedloop_join.h"
 #include "execution/executor_semi_join.h"
 #include "execution/executor_projection.h"
 #include "execution/executor_seq_scan.h"
+#include "execution/executor_gather.h"
+#include "execution/executor_parallel_seq_scan.h"
 #include "execution/executor_index_scan.h"
 #include "execution/executor_update.h"
 #include "execution/executor_insert.h"
 #include "execution/executor_delete.h"
 #include "execution/execution_sort.h"
 #include "execution/execution_limit.h"
+#include "execution/execution_topn.h"
 #include "execution/executor_aggregate.h"
+#include "execution/execution_manager.h"
 #include "common/common.h"
 
 typedef enum portalTag{
@@ -34,7 +41,8 @@ typedef enum portalTag{
     PORTAL_ONE_SELECT,
     PORTAL_DML_WITHOUT_SELECT,
     PORTAL_MULTI_QUERY,
-    PORTAL_CMD_UTILITY
+    PORTAL_CMD_UTILITY,
+    PORTAL_EXPLAIN_ANALYZE
 } portalTag;
 
 
@@ -44,6 +52,7 @@ struct PortalStmt {
     std::vector<TabCol> sel_cols;
     std::unique_ptr<AbstractExecutor> root;
     std::shared_ptr<Plan> plan;
+    PlanExecutorMap execs;      // EXPLAIN ANALYZE中每个计划节点对应的算子
     
     PortalStmt(portalTag tag_, std::vector<TabCol> sel_cols_, std::unique_ptr<AbstractExecutor> root_, std::shared_ptr<Plan> plan_) :
             tag(tag_), sel_cols(std::move(sel_cols_)), root(std::move(root_)), plan(std::move(plan_)) {}
@@ -70,6 +79,12 @@ class Portal
         } else if (auto x = std::dynamic_pointer_cast<DDLPlan>(plan)) {
             return std::make_shared<PortalStmt>(PORTAL_MULTI_QUERY, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(),plan);
         } else if (auto x = std::dynamic_pointer_cast<ExplainPlan>(plan)) {
+            if (x->analyze_) {
+                auto stmt = std::make_shared<PortalStmt>(PORTAL_EXPLAIN_ANALYZE, std::vector<TabCol>(),
+                                                         std::unique_ptr<AbstractExecutor>(), plan);
+                stmt->root = convert_plan_executor(x->subplan_, context, &stmt->execs);
+                return stmt;
+            }
             return std::make_shared<PortalStmt>(PORTAL_CMD_UTILITY, std::vector<TabCol>(), std::unique_ptr<AbstractExecutor>(), plan);
         } else if (auto x = std::dynamic_pointer_cast<DMLPlan>(plan)) {
             switch(x->tag) {
@@ -92,6 +107,9 @@ class Portal
                                 // 可能是 LimitPlan->ProjectionPlan
                                 p = std::dynamic_pointer_cast<ProjectionPlan>(limit_plan->subplan_);
                             }
+                        } else if (auto topn_plan = std::dynamic_pointer_cast<TopNPlan>(x->subplan_)) {
+                            // 可能是 TopNPlan->ProjectionPlan
+                            p = std::dynamic_pointer_cast<ProjectionPlan>(topn_plan->subplan_);
                         } else {
                             // 如果不是 LimitPlan，可能是 SortPlan，尝试获取其子计划
                             auto sort_plan = std::dynamic_pointer_cast<SortPlan>(x->subplan_);
@@ -174,6 +192,11 @@ class Portal
                 ql->run_cmd_utility(portal->plan, txn_id, context);
                 break;
             }
+            case PORTAL_EXPLAIN_ANALYZE:
+            {
+                ql->explain_analyze(portal->plan, std::move(portal->root), portal->execs, context);
+                break;
+            }
             default:
             {
                 throw InternalError("Unexpected field type");
@@ -185,45 +208,81 @@ class Portal
     void drop(){}
 
 
-    std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context)
+    // 将计划树转换为算子树，execs不为空时记录每个计划节点对应的算子
+    std::unique_ptr<AbstractExecutor> convert_plan_executor(std::shared_ptr<Plan> plan, Context *context,
+                                                            PlanExecutorMap *execs = nullptr)
+    {
+        auto executor = create_executor(plan, context, execs);
+        if (execs != nullptr && executor != nullptr) {
+            (*execs)[plan.get()] = executor.get();
+        }
+        return executor;
+    }
+
+    std::unique_ptr<AbstractExecutor> create_executor(std::shared_ptr<Plan> plan, Context *context, PlanExecutorMap *execs)
     {
         if(auto x = std::dynamic_pointer_cast<ProjectionPlan>(plan)){
-            return std::make_unique<ProjectionExecutor>(convert_plan_executor(x->subplan_, context), 
-                                                        x->sel_cols_);
+            return std::make_unique<ProjectionExecutor>(convert_plan_executor(x->subplan_, context, execs), 
+                                                        x->sel_cols_, sm_manager_, x->late_tabs_, context);
         } else if(auto x = std::dynamic_pointer_cast<ScanPlan>(plan)) {
-            if(x->tag == T_SeqScan) {
-                return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context);
+            if(x->tag == T_SeqScan && x->parallel_workers_ > 0) {
+                return std::make_unique<ParallelSeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context,
+                                                                 x->proj_cols_, x->emit_rid_);
+            } else if(x->tag == T_SeqScan) {
+                return std::make_unique<SeqScanExecutor>(sm_manager_, x->tab_name_, x->conds_, context, x->proj_cols_,
+                                                         x->emit_rid_);
             }
             else {
-                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context);
+                return std::make_unique<IndexScanExecutor>(sm_manager_, x->tab_name_, x->conds_, x->index_col_names_, context,
+                                                           x->index_only_, x->reverse_, x->proj_cols_, x->emit_rid_);
             } 
+        } else if(auto x = std::dynamic_pointer_cast<GatherPlan>(plan)) {
+            return std::make_unique<GatherExecutor>(convert_plan_executor(x->subplan_, context, execs),
+                                                    x->num_workers_);
         } else if(auto x = std::dynamic_pointer_cast<JoinPlan>(plan)) {
-            std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context);
-            std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context);
+            if (x->tag == T_IndexNestLoop) {
+                // 内层不生成扫描算子，由连接算子直接探测内层表的索引
+                auto inner = std::dynamic_pointer_cast<ScanPlan>(x->inner_left_ ? x->left_ : x->right_);
+                std::unique_ptr<AbstractExecutor> outer = convert_plan_executor(x->inner_left_ ? x->right_ : x->left_, context, execs);
+                return std::make_unique<IndexNestedLoopJoinExecutor>(sm_manager_, std::move(outer), inner->tab_name_,
+                                                                     inner->conds_, inner->index_col_names_,
+                                                                     x->conds_, x->inner_left_, context);
+            }
+            std::unique_ptr<AbstractExecutor> left = convert_plan_executor(x->left_, context, execs);
+            std::unique_ptr<AbstractExecutor> right = convert_plan_executor(x->right_, context, execs);
             
-            if (x->tag == T_SemiJoin) {
+            if (x->tag == T_SemiJoin || x->tag == T_AntiJoin) {
                 std::unique_ptr<AbstractExecutor> join = std::make_unique<SemiJoinExecutor>(
                                     std::move(left), 
-                                    std::move(right), std::move(x->conds_));
+                                    std::move(right), x->conds_, x->tag == T_AntiJoin);
                 return join;
+            } else if (x->tag == T_HashJoin) {
+                return std::make_unique<HashJoinExecutor>(std::move(left), std::move(right), x->conds_,
+                                                          x->build_left_, x->limit_hint_);
+            } else if (x->tag == T_SortMerge) {
+                return std::make_unique<SortMergeJoinExecutor>(std::move(left), std::move(right), x->conds_,
+                                                               x->left_sorted_, x->right_sorted_);
             } else {
                 std::unique_ptr<AbstractExecutor> join = std::make_unique<NestedLoopJoinExecutor>(
                                     std::move(left), 
-                                    std::move(right), std::move(x->conds_));
+                                    std::move(right), x->conds_, x->limit_hint_);
                 return join;
             }
         } else if(auto x = std::dynamic_pointer_cast<SortPlan>(plan)) {
-            auto subplan_executor = convert_plan_executor(x->subplan_, context);
+            auto subplan_executor = convert_plan_executor(x->subplan_, context, execs);
             return std::make_unique<SortExecutor>(std::move(subplan_executor), 
-                                            x->sel_cols_, x->is_desc_list_);
+                                            x->sel_cols_, x->is_desc_list_, sm_manager_->work_mem());
         } else if(auto x = std::dynamic_pointer_cast<LimitPlan>(plan)) {
-            return std::make_unique<LimitExecutor>(convert_plan_executor(x->subplan_, context), 
-                                            x->limit_count_);
+            return std::make_unique<LimitExecutor>(convert_plan_executor(x->subplan_, context, execs), 
+                                            x->limit_count_, x->offset_);
+        } else if(auto x = std::dynamic_pointer_cast<TopNPlan>(plan)) {
+            return std::make_unique<TopNExecutor>(convert_plan_executor(x->subplan_, context, execs),
+                                            x->sel_cols_, x->is_desc_list_, x->limit_count_, x->offset_);
         } else if(auto x = std::dynamic_pointer_cast<AggregatePlan>(plan)) {
-            return std::make_unique<AggregateExecutor>(convert_plan_executor(x->prev_, context),
+            return std::make_unique<AggregateExecutor>(convert_plan_executor(x->prev_, context, execs),
                                                       x->agg_exprs_, x->group_by_cols_,
                                                       x->having_conds_, x->select_cols_,
-                                                      x->has_group_by_, x->has_having_);
+                                                      x->has_group_by_, x->has_having_, sm_manager_->work_mem());
         }
         return nullptr;
     }
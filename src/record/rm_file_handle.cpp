@@ -25,6 +25,20 @@ void update_file_hdr(DiskManager *disk_manager, int fd,
  */
 std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid &rid,
                                                    Context *context) const {
+  // MVCC: 先取版本链再读槽位。版本链被清理之前链头已经写回槽位，
+  // 反过来先读槽位可能读到旧数据，再发现版本链已经删除
+  bool has_txn = context != nullptr && context->txn_ != nullptr;
+  auto &mvcc_manager = MVCCManager::get_instance();
+  timestamp_t read_ts = has_txn ? context->txn_->get_start_ts() : 0;
+  txn_id_t reader_txn_id = has_txn ? context->txn_->get_transaction_id() : INVALID_TXN_ID;
+  std::unordered_set<txn_id_t> active_txns;
+  std::vector<UndoLog> all_version_logs;
+  if (has_txn) {
+    // 获取活跃事务集合用于可见性判断
+    active_txns = mvcc_manager.get_active_txns();
+    all_version_logs = mvcc_manager.get_undo_logs(rid, fd_, read_ts, reader_txn_id);
+  }
+
   RmPageHandle page_handle = fetch_page_handle(rid.page_no);
 
   if (!Bitmap::is_set(page_handle.bitmap, rid.slot_no)) {
@@ -36,26 +50,13 @@ std::unique_ptr<RmRecord> RmFileHandle::get_record(const Rid &rid,
   auto base_record =
       std::make_unique<RmRecord>(file_hdr_.record_size, slot_data);
 
+  buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+
   // 如果没有事务上下文，直接返回基础记录
-  if (context == nullptr || context->txn_ == nullptr) {
-    buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+  if (!has_txn) {
     return base_record;
   }
 
-  // MVCC版本可见性检查
-  auto &mvcc_manager = MVCCManager::get_instance();
-  timestamp_t read_ts = context->txn_->get_start_ts();
-  txn_id_t reader_txn_id = context->txn_->get_transaction_id();
-
-  // 获取活跃事务集合用于可见性判断
-  auto active_txns = mvcc_manager.get_active_txns();
-  auto all_version_logs =
-      mvcc_manager.get_undo_logs(rid, fd_, read_ts, reader_txn_id);
-
-  // MVCC调试信息已移除
-
-  buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
-
   // 如果没有版本链，返回基础记录
   if (all_version_logs.empty()) {
     return base_record;
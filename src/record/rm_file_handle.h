@@ -85,6 +85,11 @@ class RmFileHandle {
 
     RmPageHandle fetch_page_handle(int page_no) const;
 
+    /* 释放fetch_page_handle对页面的pin，用于在页面上直接批量读取记录 */
+    void unpin_page_handle(const RmPageHandle &page_handle) const {
+        buffer_pool_manager_->unpin_page(page_handle.page->get_page_id(), false);
+    }
+
    private:
     RmPageHandle create_page_handle();
 
@@ -75,6 +75,23 @@ void LRUReplacer::unpin(frame_id_t frame_id) {
     LRUhash_[frame_id] = LRUlist_.begin();
 }
 
+/**
+ * @description: 取消固定一个frame，并把它放在LRUlist_尾部，作为下一个被淘汰的页面
+ * @param {frame_id_t} frame_id 取消固定的frame的id
+ */
+void LRUReplacer::unpin_cold(frame_id_t frame_id) {
+    std::scoped_lock lock{latch_};
+    if (LRUhash_.find(frame_id) != LRUhash_.end()) {
+        return;
+    }
+    if (LRUlist_.size() >= max_size_) {
+        return;
+    }
+
+    LRUlist_.push_back(frame_id);
+    LRUhash_[frame_id] = std::prev(LRUlist_.end());
+}
+
 /**
  * @description: 获取当前replacer中可以被淘汰的页面数量
  */
@@ -37,6 +37,8 @@ class LRUReplacer : public Replacer {
 
     void unpin(frame_id_t frame_id);
 
+    void unpin_cold(frame_id_t frame_id);
+
     size_t Size();
 
    private:
@@ -39,6 +39,13 @@ class Replacer {
      */
     virtual void unpin(frame_id_t frame_id) = 0;
 
+    /**
+     * Unpins a frame and makes it the first candidate for victimization.
+     * Used for pages touched once by a large scan, so that they do not push hot pages out of the pool.
+     * @param frame_id the id of the frame to unpin
+     */
+    virtual void unpin_cold(frame_id_t frame_id) = 0;
+
     /** @return the number of elements in the replacer that can be victimized */
     virtual size_t Size() = 0;
 };
@@ -102,6 +102,21 @@ Page* BufferPoolManager::fetch_page(PageId page_id) {
     return victim_page;
 }
 
+/**
+ * @description: 预取目标页：若目标页不在缓冲池中，提示磁盘异步预读，之后的fetch_page不必等待磁盘I/O
+ * 不占用frame，也不修改pin_count
+ * @param {PageId} page_id 目标page的page_id
+ */
+void BufferPoolManager::prefetch_page(PageId page_id) {
+    {
+        std::scoped_lock lock{latch_};
+        if (page_table_.count(page_id)) {
+            return;
+        }
+    }
+    disk_manager_->prefetch_page(page_id.fd, page_id.page_no);
+}
+
 /**
  * @description: 取消固定pin_count>0的在缓冲池中的page
  * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
@@ -136,6 +151,43 @@ bool BufferPoolManager::unpin_page(PageId page_id, bool is_dirty) {
     return true;
 }
 
+/**
+ * @description: 取消固定目标页，pin_count降为0时让该页成为下一个被淘汰的页面
+ * 用于只会被访问一次的扫描页面（如统计信息收集），扫描再大也不会冲掉缓冲池中的热点页面
+ * @return {bool} 如果目标页的pin_count<=0则返回false，否则返回true
+ * @param {PageId} page_id 目标page的page_id
+ * @param {bool} is_dirty 若目标page应该被标记为dirty则为true，否则为false
+ */
+bool BufferPoolManager::unpin_page_cold(PageId page_id, bool is_dirty) {
+    std::scoped_lock lock{latch_};
+    auto it = page_table_.find(page_id);
+    if (it == page_table_.end()) {
+        return false;
+    }
+    frame_id_t frame_id = it->second;
+    Page* page = &pages_[frame_id];
+    if (page->pin_count_ <= 0) {
+        return false;
+    }
+    page->pin_count_--;
+    if (page->pin_count_ == 0) {
+        replacer_->unpin_cold(frame_id);
+    }
+    if (is_dirty) {
+        page->is_dirty_ = true;
+    }
+    return true;
+}
+
+/**
+ * @description: 目标页当前是否在缓冲池中
+ * @param {PageId} page_id 目标page的page_id
+ */
+bool BufferPoolManager::is_page_resident(PageId page_id) {
+    std::scoped_lock lock{latch_};
+    return page_table_.count(page_id) > 0;
+}
+
 /**
  * @description: 将目标页写回磁盘，不考虑当前页面是否正在被使用
  * @return {bool} 成功则返回true，否则返回false(只有page_table_中没有目标页时)
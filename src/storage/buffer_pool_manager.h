@@ -66,8 +66,14 @@ class BufferPoolManager {
    public: 
     Page* fetch_page(PageId page_id);
 
+    void prefetch_page(PageId page_id);
+
     bool unpin_page(PageId page_id, bool is_dirty);
 
+    bool unpin_page_cold(PageId page_id, bool is_dirty);
+
+    bool is_page_resident(PageId page_id);
+
     bool flush_page(PageId page_id);
 
     Page* new_page(PageId* page_id);
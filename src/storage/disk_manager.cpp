@@ -11,6 +11,7 @@ See the Mulan PSL v2 for more details. */
 #include "storage/disk_manager.h"
 
 #include <assert.h>   // for assert
+#include <fcntl.h>    // for posix_fadvise
 #include <string.h>   // for memset
 #include <sys/stat.h> // for stat
 #include <unistd.h>   // for lseek
@@ -66,6 +67,19 @@ void DiskManager::read_page(int fd, page_id_t page_no, char *offset,
   ssize_t bytes_read = read(fd, offset, num_bytes);
 }
 
+/**
+ * @description: 提示操作系统预读从page_no开始的num_pages个页面，不阻塞调用者
+ * 之后的read_page可以直接命中page cache
+ * @param {int} fd 磁盘文件的文件句柄
+ * @param {page_id_t} page_no 起始页面号
+ * @param {int} num_pages 预读的页面数量
+ */
+void DiskManager::prefetch_page(int fd, page_id_t page_no, int num_pages) {
+  off_t file_offset = static_cast<off_t>(page_no) * PAGE_SIZE;
+  // 预读只是性能提示，失败时忽略即可
+  posix_fadvise(fd, file_offset, static_cast<off_t>(num_pages) * PAGE_SIZE, POSIX_FADV_WILLNEED);
+}
+
 /**
  * @description: 分配一个新的页号
  * @return {page_id_t} 分配的新页号
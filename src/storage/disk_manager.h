@@ -36,6 +36,8 @@ class DiskManager {
 
     void read_page(int fd, page_id_t page_no, char *offset, int num_bytes);
 
+    void prefetch_page(int fd, page_id_t page_no, int num_pages = 1);
+
     page_id_t allocate_page(int fd);
 
     void deallocate_page(page_id_t page_id);
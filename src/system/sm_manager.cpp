@@ -105,16 +105,23 @@ void SmManager::open_db(const std::string &db_name) {
   for (auto &[tab_name, tab_meta] : db_.tabs_) {
     fhs_.emplace(tab_name, rm_manager_->open_file(tab_name));
 
-    for (auto index : tab_meta.indexes) {
-      // TODO:
+    // 索引按表中的记录重建；drop_index/create_index会修改tab_meta.indexes，遍历它的副本
+    auto indexes = tab_meta.indexes;
+    for (auto &index : indexes) {
       auto index_name = ix_manager_->get_index_name(tab_name, index.cols);
-      ihs_.emplace(index_name, ix_manager_->open_index(tab_name, index.cols));
-      drop_index(tab_name, index.cols, nullptr); // 删除索引文件
       std::vector<std::string> cols;
       for (auto &col : index.cols) {
         cols.emplace_back(col.name);
       }
-      create_index(tab_name, cols, nullptr);
+      try {
+        ihs_.emplace(index_name, ix_manager_->open_index(tab_name, index.cols));
+        drop_index(tab_name, index.cols, nullptr); // 删除索引文件
+      } catch (IndexFormatError &e) {
+        // 旧版本格式的索引文件无法打开，直接删除
+        ix_manager_->destroy_index(tab_name, index.cols);
+        tab_meta.indexes.erase(tab_meta.get_index_meta(cols));
+      }
+      create_index(tab_name, cols, nullptr, index.unique);
     }
   }
 }
@@ -136,8 +143,9 @@ void SmManager::close_db() {
   // 元数据信息落盘
   std::ofstream ofs(DB_META_NAME);
   ofs << db_;
-  // 关闭所有文件，close_file里实现落盘
+  // 关闭所有文件，close_file里实现落盘；文件描述符之后会被复用，丢弃其上的版本链
   for (auto it = fhs_.begin(); it != fhs_.end(); it++) {
+    MVCCManager::get_instance().discard_version_chains(it->second->GetFd());
     rm_manager_->close_file(it->second.get());
   }
   for (auto it = ihs_.begin(); it != ihs_.end(); it++) {
@@ -260,6 +268,7 @@ void SmManager::drop_table(const std::string &tab_name, Context *context) {
     drop_index(tab_name, index.cols, context);
   }
   // 删除表文件
+  MVCCManager::get_instance().discard_version_chains(table_hdr_ptr->GetFd());
   rm_manager_->close_file(table_hdr_ptr);
   rm_manager_->destroy_file(tab_name);
 
@@ -279,7 +288,7 @@ void SmManager::show_indexes(const std::string &tab_name, Context *context) {
   printer.print_separator(context);
   for (auto &index : tab.indexes) {
     // for output.txt content
-    std::string tmp = "| " + tab_name + " | unique | (" + index.cols[0].name;
+    std::string tmp = "| " + tab_name + (index.unique ? " | unique | (" : " | nonunique | (") + index.cols[0].name;
     for (size_t i = 1; i < index.cols.size(); i++) {
       tmp += "," + index.cols[i].name;
     }
@@ -292,6 +301,59 @@ void SmManager::show_indexes(const std::string &tab_name, Context *context) {
   outfile.close();
 }
 
+/**
+ * @description: 设置索引点查询缓存的内存预算
+ * @param {size_t} bytes 每个索引的缓存预算（字节），0表示关闭缓存
+ */
+void SmManager::set_index_cache_size(size_t bytes) {
+  index_cache_size_ = bytes;
+  for (auto &[index_name, index] : ihs_) {
+    index->set_cache_budget(bytes);
+  }
+}
+
+// show index stats
+void SmManager::show_index_stats(const std::string &tab_name, Context *context) {
+  auto &tab = db_.get_table(tab_name);
+
+  std::vector<std::string> captions = {"index",          "height",      "leaf_pages",
+                                       "internal_pages", "fill_factor", "free_pages",
+                                       "keys",           "distinct"};
+  std::fstream outfile;
+  outfile.open("output.txt", std::ios::out | std::ios::app);
+  RecordPrinter printer(captions.size());
+  printer.print_separator(context);
+  printer.print_record(captions, context);
+  printer.print_separator(context);
+  outfile << "|";
+  for (auto &caption : captions) {
+    outfile << " " << caption << " |";
+  }
+  outfile << "\n";
+  for (auto &index : tab.indexes) {
+    std::string ix_name = ix_manager_->get_index_name(tab_name, index.cols);
+    IxIndexStats stats = ihs_.at(ix_name)->collect_stats();
+    char fill_factor[16];
+    snprintf(fill_factor, sizeof(fill_factor), "%.2f", stats.fill_factor);
+    std::vector<std::string> row = {ix_name,
+                                    std::to_string(stats.height),
+                                    std::to_string(stats.leaf_pages),
+                                    std::to_string(stats.internal_pages),
+                                    fill_factor,
+                                    std::to_string(stats.free_pages),
+                                    std::to_string(stats.num_keys),
+                                    std::to_string(stats.num_distinct)};
+    printer.print_record(row, context);
+    outfile << "|";
+    for (auto &field : row) {
+      outfile << " " << field << " |";
+    }
+    outfile << "\n";
+  }
+  printer.print_separator(context);
+  outfile.close();
+}
+
 /**
  * @description: 创建索引
  * @param {string&} tab_name 表的名称
@@ -300,7 +362,7 @@ void SmManager::show_indexes(const std::string &tab_name, Context *context) {
  */
 void SmManager::create_index(const std::string &tab_name,
                              const std::vector<std::string> &col_names,
-                             Context *context) {
+                             Context *context, bool unique) {
   TabMeta &tab_meta = db_.get_table(tab_name);
   if (context != nullptr)
     context->lock_mgr_->lock_shared_on_table(context->txn_,
@@ -321,7 +383,7 @@ void SmManager::create_index(const std::string &tab_name,
   std::vector<ColMeta> index_cols;
   for (const std::string &col_name : col_names)
     index_cols.emplace_back(*tab_meta.get_col(col_name));
-  ix_manager_->create_index(tab_name, index_cols);
+  ix_manager_->create_index(tab_name, index_cols, unique);
   std::unique_ptr<IxIndexHandle> index =
       ix_manager_->open_index(tab_name, index_cols);
   int col_tot_len = 0;
@@ -331,7 +393,13 @@ void SmManager::create_index(const std::string &tab_name,
   RmFileHandle *table = fhs_.at(tab_name).get();
   RmScan rows(table);
   for (; !rows.is_end(); rows.next()) {
-    std::unique_ptr<RmRecord> row = table->get_record(rows.rid(), context);
+    std::unique_ptr<RmRecord> row;
+    try {
+      row = table->get_record(rows.rid(), context);
+    } catch (const RecordNotFoundError &) {
+      // 已被删除（对当前事务不可见）的记录不建立索引项
+      continue;
+    }
     if (rows.rid().slot_no < 0 && rows.rid().page_no == 0)
       break;
     int offset = 0;
@@ -350,7 +418,8 @@ void SmManager::create_index(const std::string &tab_name,
     }
   }
   tab_meta.indexes.emplace_back(IndexMeta{
-      tab_name, col_tot_len, static_cast<int>(index_cols.size()), index_cols});
+      tab_name, col_tot_len, static_cast<int>(index_cols.size()), index_cols, unique});
+  index->set_cache_budget(index_cache_size_);
   ihs_.emplace(ix_manager_->get_index_name(tab_name, col_names),
                std::move(index));
   flush_meta();
@@ -460,8 +529,9 @@ void SmManager::redo_index(const std::string &tab_name,
       ix_manager_->destroy_index(tab_name, col_names);
     }
 
-    // 创建新的索引文件
-    ix_manager_->create_index(tab_name, index_cols);
+    // 创建新的索引文件，保持原索引的唯一性
+    bool unique = const_cast<TabMeta&>(table_meta).get_index_meta(col_names)->unique;
+    ix_manager_->create_index(tab_name, index_cols, unique);
 
     // 打开索引文件
     std::unique_ptr<IxIndexHandle> index =
@@ -495,6 +565,7 @@ void SmManager::redo_index(const std::string &tab_name,
     }
 
     // 将索引句柄加入到索引句柄映射中
+    index->set_cache_budget(index_cache_size_);
     ihs_.emplace(index_name, std::move(index));
 
     printf("    Successfully rebuilt index: %s\n", index_name.c_str());
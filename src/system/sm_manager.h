@@ -35,6 +35,8 @@ class SmManager {
     BufferPoolManager* buffer_pool_manager_;
     RmManager* rm_manager_;
     IxManager* ix_manager_;
+    size_t index_cache_size_ = 0;   // 每个唯一索引点查询缓存的内存预算（字节），0表示关闭
+    size_t work_mem_ = 16 << 20;    // 排序、聚合等算子各自的内存预算（字节），超出后写入临时文件
 
    public:
     SmManager(DiskManager* disk_manager, BufferPoolManager* buffer_pool_manager, RmManager* rm_manager,
@@ -77,11 +79,22 @@ class SmManager {
 
     void show_indexes(const std::string &tab_name, Context *context);
 
-    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
+    void show_index_stats(const std::string &tab_name, Context *context);
+
+    void create_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context,
+                      bool unique = true);
 
     void drop_index(const std::string& tab_name, const std::vector<std::string>& col_names, Context* context);
     
     void drop_index(const std::string& tab_name, const std::vector<ColMeta>& col_names, Context* context);
+
+    // 设置索引点查询缓存的内存预算，作用于当前打开的所有索引以及之后创建的索引
+    void set_index_cache_size(size_t bytes);
+
+    // 设置排序、聚合等算子的内存预算，只影响之后开始执行的查询
+    void set_work_mem(size_t bytes) { work_mem_ = bytes; }
+
+    size_t work_mem() const { return work_mem_; }
     
     // 获取索引文件名
     std::string get_ix_file_name(const std::string& tab_name, const std::vector<ColMeta>& cols);
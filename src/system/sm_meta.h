@@ -19,6 +19,10 @@ See the Mulan PSL v2 for more details. */
 #include "errors.h"
 #include "sm_defs.h"
 
+/* 元数据文件格式版本，写在db.meta开头。没有版本行的是版本0：索引元数据中没有unique，全部为唯一索引 */
+static const std::string DB_META_MAGIC = "#rmdb_meta";
+constexpr int DB_META_VERSION = 1;
+
 /* 字段元数据 */
 struct ColMeta {
     std::string tab_name;   // 字段所属表名称
@@ -45,22 +49,31 @@ struct IndexMeta {
     int col_tot_len;                // 索引字段长度总和
     int col_num;                    // 索引字段数量
     std::vector<ColMeta> cols;      // 索引包含的字段
+    bool unique = true;             // 是否为唯一索引，非唯一索引允许索引字段重复
 
     friend std::ostream &operator<<(std::ostream &os, const IndexMeta &index) {
-        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num;
+        os << index.tab_name << " " << index.col_tot_len << " " << index.col_num << " " << index.unique;
         for(auto& col: index.cols) {
             os << "\n" << col;
         }
         return os;
     }
 
-    friend std::istream &operator>>(std::istream &is, IndexMeta &index) {
-        is >> index.tab_name >> index.col_tot_len >> index.col_num;
-        for(int i = 0; i < index.col_num; ++i) {
+    // 按version对应的格式读取
+    void read(std::istream &is, int version) {
+        is >> tab_name >> col_tot_len >> col_num;
+        if (version >= 1) {
+            is >> unique;
+        }
+        for(int i = 0; i < col_num; ++i) {
             ColMeta col;
             is >> col;
-            index.cols.push_back(col);
+            cols.push_back(col);
         }
+    }
+
+    friend std::istream &operator>>(std::istream &is, IndexMeta &index) {
+        index.read(is, DB_META_VERSION);
         return is;
     }
 };
@@ -136,20 +149,25 @@ struct TabMeta {
         return os;
     }
 
-    friend std::istream &operator>>(std::istream &is, TabMeta &tab) {
+    // 按version对应的格式读取
+    void read(std::istream &is, int version) {
         size_t n;
-        is >> tab.name >> n;
+        is >> name >> n;
         for (size_t i = 0; i < n; i++) {
             ColMeta col;
             is >> col;
-            tab.cols.push_back(col);
+            cols.push_back(col);
         }
         is >> n;
         for(size_t i = 0; i < n; ++i) {
             IndexMeta index;
-            is >> index;
-            tab.indexes.push_back(index);
+            index.read(is, version);
+            indexes.push_back(index);
         }
+    }
+
+    friend std::istream &operator>>(std::istream &is, TabMeta &tab) {
+        tab.read(is, DB_META_VERSION);
         return is;
     }
 };
@@ -185,7 +203,7 @@ class DbMeta {
 
     // 重载操作符 <<
     friend std::ostream &operator<<(std::ostream &os, const DbMeta &db_meta) {
-        os << db_meta.name_ << '\n' << db_meta.tabs_.size() << '\n';
+        os << DB_META_MAGIC << ' ' << DB_META_VERSION << '\n' << db_meta.name_ << '\n' << db_meta.tabs_.size() << '\n';
         for (auto &entry : db_meta.tabs_) {
             os << entry.second << '\n';
         }
@@ -193,11 +211,20 @@ class DbMeta {
     }
 
     friend std::istream &operator>>(std::istream &is, DbMeta &db_meta) {
+        // 旧格式没有版本行，第一项就是数据库名称
+        int version = 0;
+        is >> db_meta.name_;
+        if (db_meta.name_ == DB_META_MAGIC) {
+            is >> version >> db_meta.name_;
+            if (version > DB_META_VERSION) {
+                throw InternalError("Unsupported db.meta version " + std::to_string(version));
+            }
+        }
         size_t n;
-        is >> db_meta.name_ >> n;
+        is >> n;
         for (size_t i = 0; i < n; i++) {
             TabMeta tab;
-            is >> tab;
+            tab.read(is, version);
             db_meta.tabs_[tab.name] = tab;
         }
         return is;
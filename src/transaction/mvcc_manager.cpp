@@ -36,10 +36,33 @@ void MVCCManager::add_version(const Rid &rid, int fd,
 
   // 如果该记录的版本链不存在，则创建新的版本链
   if (version_chains_.find(version_key) == version_chains_.end()) {
-    version_chains_[version_key] = std::make_shared<VersionChain>();
+    create_version_chain(version_key, rid, fd);
   }
 
   version_chains_[version_key]->insert_version(undo_log);
+  txn_chains_[undo_log->txn_id_].insert(version_key);
+}
+
+void MVCCManager::create_version_chain(int64_t version_key, const Rid &rid,
+                                       int fd) {
+  version_chains_[version_key] = std::make_shared<VersionChain>();
+  // 页面上出现了版本链，清除该页面的all visible标记
+  page_chain_cnt_[page_to_key(fd, rid.page_no)]++;
+}
+
+void MVCCManager::release_page_chain(int64_t version_key) {
+  int fd = static_cast<int>(version_key >> 48);
+  int page_no = static_cast<int>((version_key >> 16) & 0xFFFFFFFF);
+  auto cnt = page_chain_cnt_.find(page_to_key(fd, page_no));
+  if (cnt != page_chain_cnt_.end() && --cnt->second == 0) {
+    page_chain_cnt_.erase(cnt);
+  }
+}
+
+bool MVCCManager::is_page_all_visible(int fd, int page_no) {
+  std::lock_guard<std::mutex> lock(manager_latch_);
+  auto it = page_chain_cnt_.find(page_to_key(fd, page_no));
+  return it == page_chain_cnt_.end() || it->second == 0;
 }
 
 timestamp_t MVCCManager::get_next_timestamp() { return next_ts_.fetch_add(1); }
@@ -52,9 +75,18 @@ void MVCCManager::update_last_committed_ts(timestamp_t ts) {
 void MVCCManager::assign_commit_timestamp(txn_id_t txn_id,
                                           timestamp_t commit_ts) {
   std::lock_guard<std::mutex> lock(manager_latch_);
+  auto txn_it = txn_chains_.find(txn_id);
+  if (txn_it == txn_chains_.end()) {
+    return;
+  }
 
-  // 更新所有属于该事务的版本的时间戳，
-  for (auto &[version_key, chain] : version_chains_) {
+  // 更新该事务写过的版本链上属于它的版本的时间戳，链头是它的版本时等待清理
+  for (int64_t version_key : txn_it->second) {
+    auto it = version_chains_.find(version_key);
+    if (it == version_chains_.end()) {
+      continue;
+    }
+    auto &chain = it->second;
     std::lock_guard<std::mutex> chain_lock(chain->chain_latch_);
     auto version_node = chain->head_;
     while (version_node != nullptr) {
@@ -63,7 +95,11 @@ void MVCCManager::assign_commit_timestamp(txn_id_t txn_id,
       }
       version_node = version_node->prev_version_;
     }
+    if (chain->head_ != nullptr && chain->head_->txn_id_ == txn_id) {
+      purge_queue_.emplace(commit_ts, version_key);
+    }
   }
+  txn_chains_.erase(txn_it);
 }
 
 std::shared_ptr<VersionChain> MVCCManager::get_version_chain(const Rid &rid,
@@ -72,7 +108,7 @@ std::shared_ptr<VersionChain> MVCCManager::get_version_chain(const Rid &rid,
   int64_t version_key = rid_to_key(rid, fd);
 
   if (version_chains_.find(version_key) == version_chains_.end()) {
-    version_chains_[version_key] = std::make_shared<VersionChain>();
+    create_version_chain(version_key, rid, fd);
   }
 
   return version_chains_[version_key];
@@ -135,26 +171,117 @@ MVCCManager::get_inserted_rids(txn_id_t txn_id) {
 
 void MVCCManager::rollback_transaction(txn_id_t txn_id) {
   std::lock_guard<std::mutex> lock(manager_latch_);
+  auto txn_it = txn_chains_.find(txn_id);
+  if (txn_it == txn_chains_.end()) {
+    return;
+  }
 
-  // 移除所有属于该事务的版本
-  for (auto &[version_key, chain] : version_chains_) {
-    std::lock_guard<std::mutex> chain_lock(chain->chain_latch_);
-
-    // 处理头节点
-    while (chain->head_ != nullptr && chain->head_->txn_id_ == txn_id) {
-      chain->head_ = chain->head_->prev_version_;
+  // 移除该事务写过的版本链上属于它的所有版本
+  for (int64_t version_key : txn_it->second) {
+    auto it = version_chains_.find(version_key);
+    if (it == version_chains_.end()) {
+      continue;
     }
+    auto &chain = it->second;
+    bool chain_empty;
+    timestamp_t head_ts = 0;
+    {
+      std::lock_guard<std::mutex> chain_lock(chain->chain_latch_);
+
+      // 处理头节点
+      while (chain->head_ != nullptr && chain->head_->txn_id_ == txn_id) {
+        chain->head_ = chain->head_->prev_version_;
+      }
 
-    // 处理中间节点
-    if (chain->head_ != nullptr) {
-      auto version_node = chain->head_;
-      while (version_node->prev_version_ != nullptr) {
-        if (version_node->prev_version_->txn_id_ == txn_id) {
-          version_node->prev_version_ = version_node->prev_version_->prev_version_;
-        } else {
-          version_node = version_node->prev_version_;
+      // 处理中间节点
+      if (chain->head_ != nullptr) {
+        auto version_node = chain->head_;
+        while (version_node->prev_version_ != nullptr) {
+          if (version_node->prev_version_->txn_id_ == txn_id) {
+            version_node->prev_version_ = version_node->prev_version_->prev_version_;
+          } else {
+            version_node = version_node->prev_version_;
+          }
         }
       }
+      chain_empty = chain->head_ == nullptr;
+      if (!chain_empty) {
+        head_ts = chain->head_->ts_;
+      }
+    }
+
+    // 版本全部回滚后删除空链，页面上没有其他版本链时恢复all visible
+    if (chain_empty) {
+      release_page_chain(version_key);
+      version_chains_.erase(it);
+    } else if (head_ts != 0) {
+      // 链头重新变成已提交的版本，它原来的清理项可能已经因为链头未提交被跳过
+      purge_queue_.emplace(head_ts, version_key);
+    }
+  }
+  txn_chains_.erase(txn_it);
+}
+
+void MVCCManager::purge_version_chains(timestamp_t watermark,
+                                       const std::function<void(int fd, const UndoLog &head)> &apply) {
+  std::vector<std::pair<int64_t, std::shared_ptr<UndoLog>>> purgeable;
+  {
+    std::lock_guard<std::mutex> lock(manager_latch_);
+    std::unordered_set<int64_t> seen;
+    while (!purge_queue_.empty() && purge_queue_.top().first <= watermark) {
+      int64_t version_key = purge_queue_.top().second;
+      purge_queue_.pop();
+      auto it = version_chains_.find(version_key);
+      if (it == version_chains_.end() || !seen.insert(version_key).second) {
+        continue;
+      }
+      std::shared_ptr<UndoLog> head;
+      {
+        std::lock_guard<std::mutex> chain_lock(it->second->chain_latch_);
+        head = it->second->head_;
+      }
+      // 链头未提交或者提交得更晚时，由它提交（或回滚）时加入的项负责清理
+      if (head == nullptr || head->ts_ == 0 || head->ts_ > watermark || active_txns_.count(head->txn_id_)) {
+        continue;
+      }
+      purgeable.emplace_back(version_key, head);
+    }
+  }
+  if (purgeable.empty()) {
+    return;
+  }
+
+  // 写回堆上要读写页面和日志，不持有manager_latch_；写回之前链还在，读者沿链读到的也是链头版本
+  for (auto &[version_key, head] : purgeable) {
+    apply(static_cast<int>(version_key >> 48), *head);
+  }
+
+  std::lock_guard<std::mutex> lock(manager_latch_);
+  for (auto &[version_key, head] : purgeable) {
+    auto it = version_chains_.find(version_key);
+    if (it == version_chains_.end()) {
+      continue;
+    }
+    {
+      // 写回期间有新版本加到链头时保留整条链，新版本提交或回滚时会再次加入队列
+      std::lock_guard<std::mutex> chain_lock(it->second->chain_latch_);
+      if (it->second->head_ != head) {
+        continue;
+      }
+    }
+    release_page_chain(version_key);
+    version_chains_.erase(it);
+  }
+}
+
+void MVCCManager::discard_version_chains(int fd) {
+  std::lock_guard<std::mutex> lock(manager_latch_);
+  for (auto it = version_chains_.begin(); it != version_chains_.end();) {
+    if (static_cast<int>(it->first >> 48) == fd) {
+      release_page_chain(it->first);
+      it = version_chains_.erase(it);
+    } else {
+      ++it;
     }
   }
 }
@@ -240,118 +367,3 @@ auto ReconstructTuple(const TabMeta *schema, const RmRecord &base_tuple,
 
   return reconstructed_tuple;
 }
-
-
-
-// 表达式计算实现-
-Value evaluate_expr(const ExprNode *expr, const RmRecord *record,
-                    const std::vector<ColMeta> &cols) {
-  // 检查表达式是否为空
-  if (expr == nullptr) {
-    throw std::runtime_error("Null expression node encountered");
-  }
-
-  switch (expr->op_) {
-  case EXPR_CONST:
-    return expr->val_;
-
-  case EXPR_COL: {
-    // 列表达式从记录中提取指定列的值
-    for (size_t col_index = 0; col_index < cols.size(); ++col_index) {
-      if (cols[col_index].name == expr->col_.col_name) {
-        // 从记录中提取值
-        char *field_data = record->data + cols[col_index].offset;
-        Value column_value;
-
-        // 根据列的数据类型进行相应的值提取
-        switch (cols[col_index].type) {
-        case TYPE_INT:
-          column_value.set_int(*(int *)field_data);
-          break;
-        case TYPE_FLOAT:
-          column_value.set_float(*(float *)field_data);
-          break;
-        case TYPE_STRING:
-          column_value.set_str(std::string(field_data, cols[col_index].len));
-          // 移除字符串尾部的空字符，确保字符串格式正确
-          column_value.str_val.erase(column_value.str_val.find('\0'));
-          break;
-        default:
-          throw std::runtime_error("Unsupported data type for column");
-        }
-        return column_value;
-      }
-    }
-    throw std::runtime_error(expr->col_.col_name + "' does not exist");
-  }
-
-  case EXPR_ADD:
-  case EXPR_SUB:
-  case EXPR_MUL:
-  case EXPR_DIV: {
-    Value left_operand = evaluate_expr(expr->left_.get(), record, cols);
-    Value right_operand = evaluate_expr(expr->right_.get(), record, cols);
-
-    // 类型转换和计算
-    if (left_operand.type == TYPE_INT && right_operand.type == TYPE_INT) {
-      // 两个操作数都是整数类型
-      int calculation_result;
-      switch (expr->op_) {
-      case EXPR_ADD:
-        calculation_result = left_operand.int_val + right_operand.int_val;
-        break;
-      case EXPR_SUB:
-        calculation_result = left_operand.int_val - right_operand.int_val;
-        break;
-      case EXPR_MUL:
-        calculation_result = left_operand.int_val * right_operand.int_val;
-        break;
-      case EXPR_DIV:
-        if (right_operand.int_val == 0)
-          throw std::runtime_error("Arithmetic : division by zero");
-        calculation_result = left_operand.int_val / right_operand.int_val;
-        break;
-      default:
-        throw std::runtime_error("Unsupported arithmetic operator");
-      }
-      Value result_value;
-      result_value.set_int(calculation_result);
-      return result_value;
-    } else {
-      // 转换为浮点数计算
-      float left_float = (left_operand.type == TYPE_INT) ? static_cast<float>(left_operand.int_val)
-                                             : left_operand.float_val;
-      float right_float = (right_operand.type == TYPE_INT)
-                          ? static_cast<float>(right_operand.int_val)
-                          : right_operand.float_val;
-
-      float float_calculation_result;
-      switch (expr->op_) {
-      case EXPR_ADD:
-        float_calculation_result = left_float + right_float;
-        break;
-      case EXPR_SUB:
-        float_calculation_result = left_float - right_float;
-        break;
-      case EXPR_MUL:
-        float_calculation_result = left_float * right_float;
-        break;
-      case EXPR_DIV:
-        // 检查错误
-        if (right_float == 0.0f)
-          throw std::runtime_error("Arithmetic: division by zero");
-        float_calculation_result = left_float / right_float;
-        break;
-      default:
-        throw std::runtime_error("Unsupported arithmetic operator");
-      }
-      Value result_value;
-      result_value.set_float(float_calculation_result);
-      return result_value;
-    }
-  }
-
-  default:
-    throw std::runtime_error("Unsupported expression type");
-  }
-}
\ No newline at end of file
@@ -141,6 +141,8 @@ void TransactionManager::commit(Transaction *txn, LogManager *log_manager) {
     std::unique_lock<std::mutex> lock(latch_);
     running_txns_.erase(txn->get_transaction_id());
     lock.unlock();
+
+    PurgeVersions(log_manager);
     
     // 定期进行垃圾回收
     if (commit_ts % 100 == 0) {
@@ -204,7 +206,7 @@ void TransactionManager::abort(Transaction *txn, LogManager *log_manager) {
                         memcpy(key + offset, insert_record->data + index.cols[j].offset, index.cols[j].len);
                         offset += index.cols[j].len;
                     }
-                    index_handle->delete_entry(key, txn);
+                    index_handle->delete_entry(key, rid, txn);
                     delete[] key;
                 }
                 // 删除记录
@@ -251,7 +253,7 @@ void TransactionManager::abort(Transaction *txn, LogManager *log_manager) {
                         memcpy(current_key + offset, update_current_record->data + index.cols[j].offset, index.cols[j].len);
                         offset += index.cols[j].len;
                     }
-                    index_handle->delete_entry(current_key, txn);
+                    index_handle->delete_entry(current_key, rid, txn);
                     delete[] current_key;
                     
                     // 插入原始记录的索引项
@@ -307,6 +309,8 @@ void TransactionManager::abort(Transaction *txn, LogManager *log_manager) {
     std::unique_lock<std::mutex> lock(latch_);
     running_txns_.erase(txn->get_transaction_id());
     lock.unlock();
+
+    PurgeVersions(log_manager);
     
     // 定期进行垃圾回收
     timestamp_t current_ts = mvcc_manager.get_next_timestamp();
@@ -421,6 +425,54 @@ timestamp_t TransactionManager::GetWatermark() {
     return watermark_.GetWatermark();
 }
 
+/**
+ * @description: 版本链清理。链头已提交且提交时间戳不大于水印时，所有活跃事务都读到链头版本，
+ * 以链头事务的名义记录UPDATE/DELETE日志后把它写回表堆（更新写入新值，删除释放槽位，插入时已经写入），再删除版本链。
+ * 这些日志属于已提交的事务，恢复时与原来的操作一样幂等地重做
+ * @param {LogManager*} log_manager 日志管理器指针
+ */
+void TransactionManager::PurgeVersions(LogManager *log_manager) {
+    if (sm_manager_ == nullptr) {
+        return;
+    }
+    // 只在确实有链头需要写回时建立文件描述符到表的映射
+    std::unordered_map<int, std::pair<std::string, RmFileHandle *>> tables;
+    MVCCManager::get_instance().purge_version_chains(GetWatermark(), [&](int fd, const UndoLog &head) {
+        if (head.type_ == WType::INSERT_TUPLE) {
+            return;
+        }
+        if (tables.empty()) {
+            for (auto &[tab_name, fh] : sm_manager_->fhs_) {
+                tables[fh->GetFd()] = {tab_name, fh.get()};
+            }
+        }
+        auto it = tables.find(fd);
+        if (it == tables.end()) {
+            return;     // 表已经删除
+        }
+        auto &[tab_name, fh] = it->second;
+        Rid rid = head.rid_;
+        try {
+            auto old_value = fh->get_record(rid, nullptr);
+            if (head.type_ == WType::UPDATE_TUPLE) {
+                if (log_manager != nullptr) {
+                    UpdateLogRecord update_log(head.txn_id_, *old_value, *head.value_, rid, tab_name, INVALID_LSN);
+                    log_manager->add_log_to_buffer(&update_log);
+                }
+                fh->update_record(rid, head.value_->data, nullptr);
+            } else if (head.type_ == WType::DELETE_TUPLE) {
+                if (log_manager != nullptr) {
+                    DeleteLogRecord delete_log(head.txn_id_, *old_value, rid, tab_name, INVALID_LSN);
+                    log_manager->add_log_to_buffer(&delete_log);
+                }
+                fh->delete_record(rid, nullptr);
+            }
+        } catch (RecordNotFoundError &) {
+            // 槽位已经被释放
+        }
+    });
+}
+
 /**
  * @description: 垃圾回收
  */
@@ -166,6 +166,10 @@ public:
       page_version_info_;
 
 private:
+  /** @brief 把已提交且不再被任何快照需要的链头版本写回表堆并记录日志，删除对应的版本链，页面因此可以重新成为all visible。
+   * 在事务提交或回滚、水印前移之后调用 */
+  void PurgeVersions(LogManager *log_manager);
+
   ConcurrencyMode
       concurrency_mode_; // 事务使用的并发控制算法，目前只需要考虑2PL
   std::atomic<txn_id_t> next_txn_id_{0};       // 用于分发事务ID
@@ -23,16 +23,29 @@ See the Mulan PSL v2 for more details. */
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <memory>
 #include <random>
 #include <set>
+#include <sstream>
 #include <string>
 #include <thread>  // NOLINT
+#include <tuple>
 #include <unordered_map>
 #include <vector>
 
+#include "analyze/analyze.h"
+#include "execution/execution_expr.h"
+#include "execution/execution_simd.h"
 #include "gtest/gtest.h"
+#include "index/ix.h"
+#include "optimizer/optimizer.h"
+#include "portal.h"
 #include "replacer/lru_replacer.h"
 #include "storage/disk_manager.h"
 
@@ -234,6 +247,41 @@ TEST(LRUReplacerTest, SampleTest) {
     std::cout<<"LRUReplacerTest end"<<std::endl;
 }
 
+// unpin_cold把frame放在LRU链表尾部，作为下一个被淘汰的frame；已经在链表中的frame位置不变
+TEST(LRUReplacerTest, UnpinColdOrder) {
+    LRUReplacer lru_replacer(5);
+    lru_replacer.unpin(1);
+    lru_replacer.unpin(2);
+    lru_replacer.unpin_cold(3);
+    lru_replacer.unpin(4);
+    lru_replacer.unpin_cold(5);
+    // 已经可以淘汰的frame再次unpin/unpin_cold不改变位置，超出容量的frame被忽略
+    lru_replacer.unpin_cold(1);
+    lru_replacer.unpin(5);
+    lru_replacer.unpin_cold(6);
+    EXPECT_EQ(5, lru_replacer.Size());
+
+    // 最后一次unpin_cold的frame最先被淘汰，其后是更早unpin_cold的frame，最后按LRU顺序
+    int value;
+    std::vector<int> victims;
+    while (lru_replacer.victim(&value)) {
+        victims.push_back(value);
+    }
+    EXPECT_EQ(victims, (std::vector<int>{5, 3, 1, 2, 4}));
+    EXPECT_EQ(0, lru_replacer.Size());
+    EXPECT_FALSE(lru_replacer.victim(&value));
+
+    // pin之后再unpin_cold，frame移到淘汰位置
+    lru_replacer.unpin(7);
+    lru_replacer.unpin(8);
+    lru_replacer.pin(8);
+    lru_replacer.unpin_cold(8);
+    lru_replacer.victim(&value);
+    EXPECT_EQ(8, value);
+    lru_replacer.victim(&value);
+    EXPECT_EQ(7, value);
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME，记录其文件描述符fd */
@@ -334,6 +382,44 @@ TEST_F(BufferPoolManagerTest, SampleTest) {
     bpm->flush_all_pages(fd);
 }
 
+// unpin_page_cold释放的页面先于其他未固定的页面被淘汰
+TEST_F(BufferPoolManagerTest, UnpinPageCold) {
+    const size_t buffer_pool_size = 3;
+    auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager_.get());
+    int fd = fd_;
+    PageId page_id = {.fd = fd, .page_no = INVALID_PAGE_ID};
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+        Page *page = bpm->new_page(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->get_data(), PAGE_SIZE, "page %zu", i);
+    }
+    // 页面1被固定两次，两次都释放之后才能被淘汰
+    ASSERT_NE(nullptr, bpm->fetch_page(PageId{fd, 1}));
+    EXPECT_TRUE(bpm->unpin_page(PageId{fd, 0}, true));
+    EXPECT_TRUE(bpm->unpin_page_cold(PageId{fd, 1}, true));
+    EXPECT_TRUE(bpm->unpin_page(PageId{fd, 2}, true));
+    EXPECT_EQ(1, bpm->pages_[bpm->page_table_.at(PageId{fd, 1})].pin_count_);
+    EXPECT_TRUE(bpm->unpin_page_cold(PageId{fd, 1}, false));
+    EXPECT_FALSE(bpm->unpin_page_cold(PageId{fd, 1}, false));
+    EXPECT_FALSE(bpm->unpin_page_cold(PageId{fd, 100}, false));
+
+    // 页面1最后才释放，但它是冷页面，最先被淘汰；之后按LRU顺序淘汰页面0
+    ASSERT_NE(nullptr, bpm->new_page(&page_id));
+    EXPECT_FALSE(bpm->is_page_resident(PageId{fd, 1}));
+    EXPECT_TRUE(bpm->is_page_resident(PageId{fd, 0}));
+    EXPECT_TRUE(bpm->is_page_resident(PageId{fd, 2}));
+    ASSERT_NE(nullptr, bpm->new_page(&page_id));
+    EXPECT_FALSE(bpm->is_page_resident(PageId{fd, 0}));
+    EXPECT_TRUE(bpm->is_page_resident(PageId{fd, 2}));
+
+    // 被淘汰的脏页已经写回，可以重新读入
+    Page *page1 = bpm->fetch_page(PageId{fd, 1});
+    ASSERT_NE(nullptr, page1);
+    EXPECT_STREQ("page 1", page1->get_data());
+    EXPECT_FALSE(bpm->is_page_resident(PageId{fd, 2}));
+    bpm->flush_all_pages(fd);
+}
+
 /** 注意：每个测试点只测试了单个文件！
  * 对于每个测试点，先创建和进入目录TEST_DB_NAME
  * 然后在此目录下创建和打开文件TEST_FILE_NAME_CCUR，记录其文件描述符fd */
@@ -673,3 +759,2040 @@ TEST(RecordManagerTest, SimpleTest) {
     rm_manager->close_file(file_handle.get());
     rm_manager->destroy_file(filename);
 }
+
+/** 端到端测试：在临时数据库中逐条执行SQL，每条语句作为一个单独的事务，
+ * 按客户端看到的表格解析查询结果 */
+class SqlTest : public ::testing::Test {
+   public:
+    static constexpr size_t SQL_TEST_POOL_SIZE = 8192;
+    const std::string TEST_SQL_DB_NAME = "SqlTest_db";
+
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> bpm_;
+    std::unique_ptr<RmManager> rm_manager_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<SmManager> sm_manager_;
+    std::unique_ptr<LockManager> lock_manager_;
+    std::unique_ptr<TransactionManager> txn_manager_;
+    std::unique_ptr<Planner> planner_;
+    std::unique_ptr<Optimizer> optimizer_;
+    std::unique_ptr<QlManager> ql_manager_;
+    std::unique_ptr<LogManager> log_manager_;
+    std::unique_ptr<Portal> portal_;
+    std::unique_ptr<Analyze> analyze_;
+
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        init_managers();
+        if (sm_manager_->is_dir(TEST_SQL_DB_NAME)) {
+            sm_manager_->drop_db(TEST_SQL_DB_NAME);
+        }
+        sm_manager_->create_db(TEST_SQL_DB_NAME);
+        sm_manager_->open_db(TEST_SQL_DB_NAME);
+    }
+
+    void TearDown() override {
+        sm_manager_->close_db();
+        sm_manager_->drop_db(TEST_SQL_DB_NAME);
+    }
+
+    // 关闭数据库，在数据库目录下执行modify（如改写文件），再用新的缓冲池重新打开数据库
+    void reopen_db(const std::function<void()> &modify) {
+        sm_manager_->close_db();
+        if (chdir(TEST_SQL_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        modify();
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+        init_managers();
+        sm_manager_->open_db(TEST_SQL_DB_NAME);
+    }
+
+    void init_managers() {
+        disk_manager_ = std::make_unique<DiskManager>();
+        bpm_ = std::make_unique<BufferPoolManager>(SQL_TEST_POOL_SIZE, disk_manager_.get());
+        rm_manager_ = std::make_unique<RmManager>(disk_manager_.get(), bpm_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), bpm_.get());
+        sm_manager_ = std::make_unique<SmManager>(disk_manager_.get(), bpm_.get(), rm_manager_.get(), ix_manager_.get());
+        lock_manager_ = std::make_unique<LockManager>();
+        txn_manager_ = std::make_unique<TransactionManager>(lock_manager_.get(), sm_manager_.get());
+        planner_ = std::make_unique<Planner>(sm_manager_.get());
+        optimizer_ = std::make_unique<Optimizer>(sm_manager_.get(), planner_.get());
+        ql_manager_ = std::make_unique<QlManager>(sm_manager_.get(), txn_manager_.get(), planner_.get(), bpm_.get());
+        log_manager_ = std::make_unique<LogManager>(disk_manager_.get());
+        portal_ = std::make_unique<Portal>(sm_manager_.get());
+        analyze_ = std::make_unique<Analyze>(sm_manager_.get());
+    }
+
+    // 执行一条SQL，返回发给客户端的内容，出错时返回错误信息
+    std::string exec(const std::string &sql) {
+        char data_send[BUFFER_LENGTH];
+        memset(data_send, 0, BUFFER_LENGTH);
+        int offset = 0;
+        Context context(lock_manager_.get(), log_manager_.get(), nullptr, data_send, &offset);
+        context.txn_ = txn_manager_->begin(nullptr, log_manager_.get());
+        txn_id_t txn_id = context.txn_->get_transaction_id();
+        std::string result;
+        YY_BUFFER_STATE buf = yy_scan_string(sql.c_str());
+        if (yyparse() != 0) {
+            result = "Parser Error";
+        } else {
+            try {
+                auto query = analyze_->do_analyze(ast::parse_tree);
+                auto plan = optimizer_->plan_query(query, &context);
+                auto portal_stmt = portal_->start(plan, &context);
+                portal_->run(portal_stmt, ql_manager_.get(), &txn_id, &context);
+                result = std::string(data_send, offset);
+            } catch (RMDBError &e) {
+                result = e.what();
+            }
+        }
+        yy_delete_buffer(buf);
+        txn_manager_->commit(context.txn_, log_manager_.get());
+        return result;
+    }
+
+    // 执行多条SQL，每条都必须成功
+    void exec_all(const std::vector<std::string> &sqls) {
+        for (auto &sql : sqls) {
+            std::string result = exec(sql);
+            ASSERT_EQ(result.find("Error"), std::string::npos) << sql << ": " << result;
+        }
+    }
+
+    // 执行查询，返回结果中除表头以外的各行
+    std::vector<std::vector<std::string>> query(const std::string &sql) {
+        std::vector<std::vector<std::string>> rows;
+        std::istringstream output(exec(sql));
+        bool header = true;
+        for (std::string line; std::getline(output, line);) {
+            if (line.empty() || line[0] != '|') continue;
+            std::vector<std::string> row;
+            std::istringstream cells(line.substr(1));
+            for (std::string cell; std::getline(cells, cell, '|');) {
+                size_t begin = cell.find_first_not_of(' ');
+                size_t end = cell.find_last_not_of(' ');
+                row.push_back(begin == std::string::npos ? "" : cell.substr(begin, end - begin + 1));
+            }
+            if (!header) rows.push_back(std::move(row));
+            header = false;
+        }
+        return rows;
+    }
+
+    // 查询结果中第col列的各行
+    std::vector<std::string> column(const std::string &sql, size_t col) {
+        std::vector<std::string> values;
+        for (auto &row : query(sql)) {
+            values.push_back(row.at(col));
+        }
+        return values;
+    }
+
+    // 向tab插入多行，每一项是values括号中的内容
+    void insert_rows(const std::string &tab, const std::vector<std::string> &rows) {
+        for (auto &row : rows) {
+            exec_all({"insert into " + tab + " values (" + row + ");"});
+        }
+    }
+
+    // 绕过SQL直接向tab追加rows条记录，fill(i, buf)填写第i条，用于构造达到并行扫描阈值的大表；表上不能有索引
+    void bulk_load(const std::string &tab, int rows, const std::function<void(int, char *)> &fill) {
+        auto &fh = sm_manager_->fhs_.at(tab);
+        std::vector<char> buf(fh->get_file_hdr().record_size);
+        for (int i = 0; i < rows; i++) {
+            memset(buf.data(), 0, buf.size());
+            fill(i, buf.data());
+            fh->insert_record(buf.data(), nullptr);
+        }
+    }
+
+    // EXPLAIN ANALYZE输出中"name: N"的值，没有时返回-1
+    static long analyze_stat(const std::string &plan, const std::string &name) {
+        size_t pos = plan.find(name + ": ");
+        return pos == std::string::npos ? -1 : std::stol(plan.substr(pos + name.size() + 2));
+    }
+
+    // 与输出顺序无关的比较
+    static std::vector<std::vector<std::string>> sorted(std::vector<std::vector<std::string>> rows) {
+        std::sort(rows.begin(), rows.end());
+        return rows;
+    }
+};
+
+// 夹具本身：建表、插入、查询结果的解析，以及出错的语句返回错误信息
+TEST_F(SqlTest, ExecAndParseResults) {
+    exec_all({"create table t (id int, name char(8), v float);"});
+    insert_rows("t", {"1, 'one', 1.5", "2, 'two', -2.0"});
+    EXPECT_EQ(query("select id, name, v from t;"),
+              (std::vector<std::vector<std::string>>{{"1", "one", "1.500000"}, {"2", "two", "-2.000000"}}));
+    EXPECT_EQ(column("select name from t where id = 2;", 0), (std::vector<std::string>{"two"}));
+    EXPECT_TRUE(query("select id from t where id > 2;").empty());
+    EXPECT_NE(exec("select id from missing;").find("Error"), std::string::npos);
+}
+
+// 覆盖索引的查询使用index-only scan，直接由索引中的key构造元组；有版本链的页面回表读取可见版本
+TEST_F(SqlTest, IndexOnlyScan) {
+    exec_all({"create table t (id int, k int, name char(8));", "create index t(k, id);"});
+    std::vector<std::pair<int, int>> rows;      // (k, id)
+    for (int id = 0; id < 30; id++) {
+        rows.push_back({(id * 7) % 10, id});
+        insert_rows("t", {std::to_string(id) + ", " + std::to_string((id * 7) % 10) + ", 'n" + std::to_string(id) + "'"});
+    }
+    std::sort(rows.begin(), rows.end());
+    auto expected = [&](const std::function<bool(int k, int id)> &pred) {
+        std::vector<std::vector<std::string>> result;
+        for (auto &[k, id] : rows) {
+            if (pred(k, id)) result.push_back({std::to_string(k), std::to_string(id)});
+        }
+        return result;
+    };
+
+    std::string plan = exec("explain select k, id from t where k = 3;");
+    EXPECT_NE(plan.find("Index Only Scan on t"), std::string::npos) << plan;
+    plan = exec("explain select name from t where k = 3;");
+    EXPECT_EQ(plan.find("Index Only Scan"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Index Scan on t"), std::string::npos) << plan;
+
+    EXPECT_EQ(query("select k, id from t where k = 3;"), expected([](int k, int) { return k == 3; }));
+    EXPECT_EQ(query("select k, id from t where k >= 8;"), expected([](int k, int) { return k >= 8; }));
+
+    // 删除和修改后页面上有版本链，回表读取当前快照可见的版本
+    exec_all({"delete from t where id = 9;", "update t set name = 'x' where id = 19;"});
+    rows.erase(std::find(rows.begin(), rows.end(), std::make_pair(3, 9)));
+    EXPECT_EQ(query("select k, id from t where k = 3;"), expected([](int k, int) { return k == 3; }));
+    EXPECT_EQ(column("select name from t where k = 3 and id = 19;", 0), (std::vector<std::string>{"x"}));
+}
+
+// 加入unique之前的db.meta没有版本行，索引元数据中也没有unique字段：按旧格式读取，全部是唯一索引
+TEST_F(SqlTest, LoadPreVersionDbMeta) {
+    exec_all({"create table m (id int, name char(8));", "create index m(id);", "create index m(name, id);"});
+    insert_rows("m", {"1, 'a'", "2, 'b'", "3, 'c'"});
+    // 按加入版本号之前的格式生成db.meta
+    auto &tab = sm_manager_->db_.get_table("m");
+    std::ostringstream old_meta;
+    old_meta << TEST_SQL_DB_NAME << '\n' << 1 << '\n' << tab.name << '\n' << tab.cols.size() << '\n';
+    for (auto &col : tab.cols) old_meta << col << '\n';
+    old_meta << tab.indexes.size() << '\n';
+    for (auto &index : tab.indexes) {
+        old_meta << index.tab_name << ' ' << index.col_tot_len << ' ' << index.col_num;
+        for (auto &col : index.cols) old_meta << '\n' << col;
+        old_meta << '\n';
+    }
+    reopen_db([&] { std::ofstream(DB_META_NAME) << old_meta.str() << '\n'; });
+    auto &indexes = sm_manager_->db_.get_table("m").indexes;
+    ASSERT_EQ(indexes.size(), 2u);
+    for (auto &index : indexes) EXPECT_TRUE(index.unique);
+    EXPECT_EQ(indexes[1].cols.size(), 2u);
+    EXPECT_EQ(column("select name from m where id = 2;", 0), (std::vector<std::string>{"b"}));
+    EXPECT_NE(exec("insert into m values (3, 'd');").find("Error"), std::string::npos);
+
+    // 关闭时按新格式写回，再次打开结果不变
+    reopen_db([] {});
+    EXPECT_EQ(column("select id from m where name = 'c';", 0), (std::vector<std::string>{"3"}));
+    EXPECT_NE(exec("insert into m values (1, 'e');").find("Error"), std::string::npos);
+
+    // 比当前版本新的格式无法识别
+    DbMeta newer;
+    std::istringstream is(DB_META_MAGIC + " " + std::to_string(DB_META_VERSION + 1) + "\nx\n0\n");
+    EXPECT_THROW(is >> newer, InternalError);
+}
+
+// Bloom filter按字节哈希，-0.0和+0.0在索引中相等，必须得到相同的哈希
+TEST_F(SqlTest, BloomFilterNegativeZeroKey) {
+    exec_all({"create table f (id int, v float);", "create index f(v);", "insert into f values (1, 0.0);",
+              "insert into f values (2, 1.5);"});
+    EXPECT_EQ(column("select id from f where v = -0.0;", 0), (std::vector<std::string>{"1"}));
+
+    // 唯一性检查在写入记录之前发现冲突，表中不会留下没有索引项的记录
+    EXPECT_NE(exec("insert into f values (3, -0.0);").find("Error"), std::string::npos);
+    EXPECT_EQ(column("select id from f;", 0), (std::vector<std::string>{"1", "2"}));
+    EXPECT_EQ(column("select id from f where v >= -1.0;", 0), (std::vector<std::string>{"1", "2"}));
+
+    // 以-0.0插入的key也能用+0.0查到
+    exec_all({"delete from f where id = 1;", "insert into f values (4, -0.0);"});
+    EXPECT_EQ(column("select id from f where v = 0.0;", 0), (std::vector<std::string>{"4"}));
+    EXPECT_NE(exec("insert into f values (5, 0.0);").find("Error"), std::string::npos);
+}
+
+// SHOW INDEX STATS遍历整棵B+树：树高、叶子结点数、key数与索引的实际结构一致
+TEST_F(SqlTest, ShowIndexStats) {
+    exec_all({"create table s (id int, grp int, name char(160));", "create index s(name);",
+              "create nonunique index s(grp);"});
+    const int ROWS = 1500;
+    for (int i = 0; i < ROWS; i++) {
+        // name的开头各不相同，前缀压缩去不掉后面的填充，叶子结点放不下所有key
+        std::string name = std::to_string(i * 7919 % 10007) + std::string(120, 'x');
+        exec_all({"insert into s values (" + std::to_string(i) + ", " + std::to_string(i % 10) + ", '" + name + "');"});
+    }
+    // 沿叶子链表数出叶子结点的数量
+    auto count_leaves = [&](const std::string &ix_name) {
+        auto &ih = sm_manager_->ihs_.at(ix_name);
+        std::set<int> pages;
+        for (IxScan scan(ih.get(), ih->leaf_begin(), ih->leaf_end(), bpm_.get()); !scan.is_end(); scan.next()) {
+            pages.insert(scan.iid().page_no);
+        }
+        return static_cast<int>(pages.size());
+    };
+    auto check = [&](int keys) {
+        auto rows = query("show index stats s;");
+        ASSERT_EQ(rows.size(), 2u);
+        for (auto &row : rows) {
+            SCOPED_TRACE(row[0]);
+            auto &ih = sm_manager_->ihs_.at(row[0]);
+            // index, height, leaf_pages, internal_pages, fill_factor, free_pages, keys, distinct
+            EXPECT_EQ(std::stoi(row[1]), ih->get_height());
+            EXPECT_EQ(std::stoi(row[2]), count_leaves(row[0]));
+            EXPECT_EQ(std::stoi(row[6]), keys);
+            EXPECT_EQ(std::stoi(row[7]), row[0] == "s_grp.idx" ? 10 : keys);
+        }
+        auto name_row = rows[0][0] == "s_name.idx" ? rows[0] : rows[1];
+        EXPECT_GE(std::stoi(name_row[1]), 2);
+        EXPECT_GT(std::stoi(name_row[2]), 1);
+        EXPECT_GE(std::stoi(name_row[3]), 1);
+    };
+    check(ROWS);
+
+    // 删除一部分记录后统计随之更新
+    exec_all({"delete from s where id >= 500;"});
+    check(500);
+}
+
+// 唯一索引上的等值查询走get_value点查询，打开点查询缓存前后结果一致
+TEST_F(SqlTest, UniqueIndexPointLookup) {
+    exec_all({"create table p (id int, v float, name char(8));", "create index p(id);", "create index p(v);"});
+    for (int i = 0; i < 50; i++) {
+        exec_all({"insert into p values (" + std::to_string(i) + ", " + std::to_string(i) + ".5, 'p" +
+                  std::to_string(i) + "');"});
+    }
+    exec_all({"insert into p values (100, 0.0, 'zero');"});
+    for (int cache_kb : {0, 64}) {
+        SCOPED_TRACE("index_cache_size = " + std::to_string(cache_kb));
+        exec_all({"set index_cache_size = " + std::to_string(cache_kb) + ";"});
+        // 连续两次查询，第二次可以命中缓存
+        for (int round = 0; round < 2; round++) {
+            EXPECT_EQ(column("select name from p where id = 7;", 0), (std::vector<std::string>{"p7"}));
+            EXPECT_EQ(column("select name from p where v = 7.5;", 0), (std::vector<std::string>{"p7"}));
+            EXPECT_EQ(column("select name from p where v = -0.0;", 0), (std::vector<std::string>{"zero"}));
+            EXPECT_TRUE(query("select name from p where id = 77;").empty());
+        }
+    }
+
+    // 修改和删除之后缓存中不能留下旧的Rid
+    exec_all({"update p set id = 77 where id = 7;", "delete from p where id = 8;"});
+    EXPECT_TRUE(query("select name from p where id = 7;").empty());
+    EXPECT_EQ(column("select name from p where id = 77;", 0), (std::vector<std::string>{"p7"}));
+    EXPECT_TRUE(query("select name from p where id = 8;").empty());
+    EXPECT_TRUE(query("select name from p where v = 8.5;").empty());
+    exec_all({"insert into p values (8, -0.5, 'again');"});
+    EXPECT_EQ(column("select name from p where id = 8;", 0), (std::vector<std::string>{"again"}));
+}
+
+// 已提交的版本在没有更早的快照之后写回表堆，页面重新成为all visible；仍有更早的快照时保留版本链
+TEST_F(SqlTest, PurgeCommittedVersions) {
+    exec_all({"create table t (id int, v int);", "create index t(id);"});
+    for (int i = 1; i <= 3; i++) {
+        exec_all({"insert into t values (" + std::to_string(i) + ", " + std::to_string(i * 10) + ");"});
+    }
+    auto &mvcc_manager = MVCCManager::get_instance();
+    RmFileHandle *fh = sm_manager_->fhs_.at("t").get();
+    int fd = fh->GetFd();
+    std::vector<Rid> rids;
+    for (RmScan scan(fh); !scan.is_end(); scan.next()) {
+        rids.push_back(scan.rid());
+    }
+    ASSERT_EQ(rids.size(), 3u);
+    int page_no = rids[0].page_no;
+    EXPECT_TRUE(mvcc_manager.is_page_all_visible(fd, page_no));
+
+    // 更早开始的读事务仍需要旧版本
+    Transaction *reader = txn_manager_->begin(nullptr, log_manager_.get());
+    Context reader_ctx(lock_manager_.get(), log_manager_.get(), reader);
+    exec_all({"update t set v = 200 where id = 2;"});
+    EXPECT_FALSE(mvcc_manager.is_page_all_visible(fd, page_no));
+    int v;
+    memcpy(&v, fh->get_record(rids[1], &reader_ctx)->data + sizeof(int), sizeof(int));
+    EXPECT_EQ(v, 20);
+    EXPECT_EQ(column("select v from t where id = 2;", 0), (std::vector<std::string>{"200"}));
+
+    // 读事务结束后新值写回堆上，版本链删除；写回记录在提交日志之后的UPDATE日志中
+    lsn_t lsn = log_manager_->get_global_lsn();
+    txn_manager_->commit(reader, log_manager_.get());
+    EXPECT_TRUE(mvcc_manager.is_page_all_visible(fd, page_no));
+    EXPECT_EQ(log_manager_->get_global_lsn(), lsn + 2);
+    memcpy(&v, fh->get_record(rids[1], nullptr)->data + sizeof(int), sizeof(int));
+    EXPECT_EQ(v, 200);
+
+    // 没有其他活跃事务时，删除在提交时释放槽位
+    exec_all({"delete from t where id = 3;"});
+    EXPECT_TRUE(mvcc_manager.is_page_all_visible(fd, page_no));
+    EXPECT_THROW(fh->get_record(rids[2], nullptr), RecordNotFoundError);
+    EXPECT_EQ(column("select v from t;", 0), (std::vector<std::string>{"10", "200"}));
+    EXPECT_EQ(column("select id from t where id > 0;", 0), (std::vector<std::string>{"1", "2"}));
+
+    // 回滚后链头重新是已提交的版本，仍会被清理
+    reader = txn_manager_->begin(nullptr, log_manager_.get());
+    exec_all({"update t set v = 100 where id = 1;"});
+    Context writer_ctx(lock_manager_.get(), log_manager_.get(), txn_manager_->begin(nullptr, log_manager_.get()));
+    fh->update_record(rids[0], std::vector<char>(fh->get_file_hdr().record_size, 0).data(), &writer_ctx);
+    txn_manager_->commit(reader, log_manager_.get());
+    EXPECT_FALSE(mvcc_manager.is_page_all_visible(fd, page_no));
+    txn_manager_->abort(writer_ctx.txn_, log_manager_.get());
+    EXPECT_TRUE(mvcc_manager.is_page_all_visible(fd, page_no));
+    memcpy(&v, fh->get_record(rids[0], nullptr)->data + sizeof(int), sizeof(int));
+    EXPECT_EQ(v, 100);
+
+    // 删除表时丢弃表上的版本链
+    exec_all({"create table d (id int);", "insert into d values (1);"});
+    int d_fd = sm_manager_->fhs_.at("d")->GetFd();
+    reader = txn_manager_->begin(nullptr, log_manager_.get());
+    exec_all({"update d set id = 2;"});
+    EXPECT_FALSE(mvcc_manager.is_page_all_visible(d_fd, page_no));
+    exec_all({"drop table d;"});
+    EXPECT_TRUE(mvcc_manager.is_page_all_visible(d_fd, page_no));
+    txn_manager_->commit(reader, log_manager_.get());
+}
+
+// 等值连接使用hash join：重复的连接键、没有匹配的键、键匹配后再检查的其余条件，以及两侧分别作为build侧
+TEST_F(SqlTest, HashJoinResults) {
+    exec_all({"create table a (id int, k int, s char(4), half int);", "create table b (k int, name char(8), k3 int);"});
+    std::vector<std::string> a_rows, b_rows;
+    for (int id = 0; id < 30; id++) {
+        a_rows.push_back(std::to_string(id) + ", " + std::to_string(id % 7) + ", 's" + std::to_string(id % 3) + "', " +
+                         std::to_string(id / 2));
+    }
+    // k = 3重复，k = 10没有匹配，k = 5、6在b中不存在
+    std::vector<int> b_keys = {0, 1, 2, 3, 3, 4, 10};
+    for (size_t i = 0; i < b_keys.size(); i++) {
+        b_rows.push_back(std::to_string(b_keys[i]) + ", 'b" + std::to_string(i) + "', " + std::to_string(b_keys[i] * 3));
+    }
+    insert_rows("a", a_rows);
+    insert_rows("b", b_rows);
+
+    std::vector<std::vector<std::string>> expected, expected_residual, expected_str;
+    for (int id = 0; id < 30; id++) {
+        for (size_t i = 0; i < b_keys.size(); i++) {
+            if (id % 7 != b_keys[i]) continue;
+            std::vector<std::string> row = {std::to_string(id), "b" + std::to_string(i)};
+            expected.push_back(row);
+            if (id / 2 > b_keys[i] * 3) expected_residual.push_back(row);
+        }
+    }
+
+    EXPECT_NE(exec("explain select a.id, b.name from a, b where a.k = b.k;").find("Hash Join"), std::string::npos);
+    EXPECT_EQ(sorted(query("select a.id, b.name from a, b where a.k = b.k;")), sorted(expected));
+    // b较小，换一下顺序后在左输入上建表
+    EXPECT_EQ(sorted(query("select a.id, b.name from b, a where b.k = a.k;")), sorted(expected));
+    EXPECT_EQ(sorted(query("select a.id, b.name from a, b where a.k = b.k and a.half > b.k3;")),
+              sorted(expected_residual));
+
+    // 字符串连接键
+    exec_all({"create table c (s char(4), v int);"});
+    insert_rows("c", {"'s0', 100", "'s2', 200", "'s9', 900"});
+    for (int id = 0; id < 30; id++) {
+        if (id % 3 == 0) expected_str.push_back({std::to_string(id), "100"});
+        if (id % 3 == 2) expected_str.push_back({std::to_string(id), "200"});
+    }
+    EXPECT_EQ(sorted(query("select a.id, c.v from a, c where a.s = c.s;")), sorted(expected_str));
+    EXPECT_TRUE(query("select a.id from a, c where a.s = c.s and c.v > 1000;").empty());
+}
+
+// sort merge join：两侧都有重复键时输出笛卡尔积，两端各有不匹配的键；输入需要排序和已经由索引排好序两种情况
+TEST_F(SqlTest, SortMergeJoinResults) {
+    exec_all({"create table l (k int, name char(8));", "create table r (k int, tag char(8), v int);"});
+    std::vector<int> l_keys = {5, -3, 2, 2, 9, 7, 2, -8, 5, 100};
+    std::vector<int> r_keys = {2, 5, 5, -3, 2, 11, -8, -20, 7, 7, 7};
+    std::vector<std::string> l_rows, r_rows;
+    for (size_t i = 0; i < l_keys.size(); i++) {
+        l_rows.push_back(std::to_string(l_keys[i]) + ", 'l" + std::to_string(i) + "'");
+    }
+    for (size_t i = 0; i < r_keys.size(); i++) {
+        r_rows.push_back(std::to_string(r_keys[i]) + ", 'r" + std::to_string(i) + "', " + std::to_string(i));
+    }
+    insert_rows("l", l_rows);
+    insert_rows("r", r_rows);
+    std::vector<std::vector<std::string>> expected, expected_residual;
+    for (size_t i = 0; i < l_keys.size(); i++) {
+        for (size_t j = 0; j < r_keys.size(); j++) {
+            if (l_keys[i] != r_keys[j]) continue;
+            std::vector<std::string> row = {"l" + std::to_string(i), "r" + std::to_string(j)};
+            expected.push_back(row);
+            if (static_cast<int>(j) > l_keys[i]) expected_residual.push_back(row);
+        }
+    }
+    const std::string sql = "select l.name, r.tag from l, r where l.k = r.k";
+
+    exec_all({"set enable_sortmerge = true;", "set enable_nestloop = false;"});
+    EXPECT_NE(exec("explain " + sql + ";").find("Sort Merge Join"), std::string::npos);
+    EXPECT_EQ(sorted(query(sql + ";")), sorted(expected));
+    EXPECT_EQ(sorted(query(sql + " and r.v > l.k;")), sorted(expected_residual));
+    // 输出按连接键有序
+    std::vector<std::string> keys = column("select l.k, r.tag from l, r where l.k = r.k;", 0);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end(), [](const std::string &a, const std::string &b) {
+        return std::stoi(a) < std::stoi(b);
+    }));
+
+    // 两侧都有连接键上的索引时按索引顺序读取，不再排序
+    exec_all({"set enable_sortmerge = false;", "set enable_nestloop = true;", "create nonunique index l(k);",
+              "create nonunique index r(k);"});
+    std::string plan = exec("explain " + sql + ";");
+    EXPECT_NE(plan.find("Sort Merge Join"), std::string::npos) << plan;
+    EXPECT_EQ(plan.find("-> Sort ("), std::string::npos) << plan;
+    EXPECT_EQ(sorted(query(sql + ";")), sorted(expected));
+}
+
+// index nested loop join：外层很小、内层有以连接键开头的索引。覆盖批量点查询（key覆盖全部索引字段）、
+// 前缀范围扫描、内层扫描条件中的等值常量补全key、内层在左侧，以及键匹配后再检查的其余连接条件
+TEST_F(SqlTest, IndexNestedLoopJoinResults) {
+    const int BIG_ROWS = 600;
+    exec_all({"create table big (id int, k int, v int);", "create table o (id int, fk int, lim int);",
+              "create index big(id);", "create nonunique index big(k, v);"});
+    std::vector<std::string> big_rows;
+    for (int id = 0; id < BIG_ROWS; id++) {
+        big_rows.push_back(std::to_string(id) + ", " + std::to_string(id % 50) + ", " + std::to_string(id % 7));
+    }
+    insert_rows("big", big_rows);
+    // 外层的连接键有重复、负数和内层不存在的值
+    std::vector<std::vector<int>> outer = {{1, 42, 0}, {2, 7, 300}, {3, 42, 500}, {4, -5, 0}, {5, 1000, 0},
+                                           {6, 599, 0}, {7, 0, 100}};
+    for (auto &row : outer) {
+        insert_rows("o", {std::to_string(row[0]) + ", " + std::to_string(row[1]) + ", " + std::to_string(row[2])});
+    }
+    auto expect = [&](const std::function<bool(const std::vector<int> &, int)> &match) {
+        std::vector<std::vector<std::string>> rows;
+        for (auto &o : outer) {
+            for (int id = 0; id < BIG_ROWS; id++) {
+                if (match(o, id)) rows.push_back({std::to_string(o[0]), std::to_string(id)});
+            }
+        }
+        return sorted(rows);
+    };
+
+    // 没有索引的表按每页100行估计，外层加上范围条件（不过滤任何行）使估计的外层行数足够小
+    const std::string point = "select o.id, big.id from o, big where o.fk = big.id and o.id < 100";
+    EXPECT_NE(exec("explain " + point + ";").find("Index Nested Loop Join"), std::string::npos);
+    auto by_id = expect([](const std::vector<int> &o, int id) { return o[1] == id; });
+    EXPECT_EQ(sorted(query(point + ";")), by_id);
+    const std::string inner_left = "select o.id, big.id from big, o where big.id = o.fk and o.id < 100";
+    EXPECT_NE(exec("explain " + inner_left + ";").find("Index Nested Loop Join"), std::string::npos);
+    EXPECT_EQ(sorted(query(inner_left + ";")), by_id);
+    EXPECT_EQ(sorted(query(point + " and big.id > o.lim;")),
+              expect([](const std::vector<int> &o, int id) { return o[1] == id && id > o[2]; }));
+
+    // 只用到(k, v)索引的第一个字段，每个外层元组做一次范围扫描
+    const std::string prefix = "select o.id, big.id from o, big where o.fk = big.k and o.id < 100";
+    EXPECT_NE(exec("explain " + prefix + ";").find("Index Nested Loop Join"), std::string::npos);
+    EXPECT_EQ(sorted(query(prefix + ";")), expect([](const std::vector<int> &o, int id) { return o[1] == id % 50; }));
+    EXPECT_EQ(sorted(query(prefix + " and big.id > o.lim;")),
+              expect([](const std::vector<int> &o, int id) { return o[1] == id % 50 && id > o[2]; }));
+    // 等值常量补全索引的第二个字段
+    EXPECT_NE(exec("explain " + prefix + " and big.v = 3;").find("Index Nested Loop Join"), std::string::npos);
+    EXPECT_EQ(sorted(query(prefix + " and big.v = 3;")),
+              expect([](const std::vector<int> &o, int id) { return o[1] == id % 50 && id % 7 == 3; }));
+}
+
+// 没有等值连接键时使用块嵌套循环连接；直接构造算子并把块限制为几个元组，检查跨越多个块以及第一块按limit缩小时的结果
+TEST_F(SqlTest, BlockNestedLoopJoinResults) {
+    exec_all({"create table a (id int, x int);", "create table b (id int, y int);"});
+    std::vector<int> xs = {5, 1, 9, 3, 3, 7, 0, 8, 2, 6};
+    std::vector<int> ys = {4, 10, 1, 3, 8, 6, 0};
+    for (size_t i = 0; i < xs.size(); i++) {
+        insert_rows("a", {std::to_string(i) + ", " + std::to_string(xs[i])});
+    }
+    for (size_t j = 0; j < ys.size(); j++) {
+        insert_rows("b", {std::to_string(j) + ", " + std::to_string(ys[j])});
+    }
+    std::vector<std::vector<std::string>> expected;
+    for (size_t i = 0; i < xs.size(); i++) {
+        for (size_t j = 0; j < ys.size(); j++) {
+            if (xs[i] < ys[j]) expected.push_back({std::to_string(i), std::to_string(j)});
+        }
+    }
+
+    const std::string sql = "select a.id, b.id from a, b where a.x < b.y";
+    EXPECT_NE(exec("explain " + sql + ";").find("Nested Loop Join"), std::string::npos);
+    EXPECT_EQ(sorted(query(sql + ";")), sorted(expected));
+    // LIMIT缩小第一块：返回的每一行都满足条件且互不相同
+    auto limited = query(sql + " limit 7;");
+    ASSERT_EQ(limited.size(), 7u);
+    for (auto &row : limited) {
+        EXPECT_NE(std::find(expected.begin(), expected.end(), row), expected.end());
+    }
+    EXPECT_EQ(std::set<std::vector<std::string>>(limited.begin(), limited.end()).size(), limited.size());
+
+    Condition cond;
+    cond.lhs_col = {"a", "x"};
+    cond.op = OP_LT;
+    cond.is_rhs_val = false;
+    cond.rhs_col = {"b", "y"};
+    auto run = [&](size_t limit_hint, size_t block_tuples, const std::vector<Condition> &b_conds) {
+        auto left = std::make_unique<SeqScanExecutor>(sm_manager_.get(), "a", std::vector<Condition>{}, nullptr);
+        auto right = std::make_unique<SeqScanExecutor>(sm_manager_.get(), "b", b_conds, nullptr);
+        size_t block_mem = block_tuples * left->tupleLen();
+        NestedLoopJoinExecutor join(std::move(left), std::move(right), {cond}, limit_hint, block_mem);
+        std::vector<std::vector<std::string>> rows;
+        for (join.beginTuple(); !join.is_end(); join.nextTuple()) {
+            auto rec = join.Next();
+            int a_id, b_id;
+            memcpy(&a_id, rec->data + join.get_col(join.cols(), {"a", "id"})->offset, sizeof(int));
+            memcpy(&b_id, rec->data + join.get_col(join.cols(), {"b", "id"})->offset, sizeof(int));
+            rows.push_back({std::to_string(a_id), std::to_string(b_id)});
+        }
+        return rows;
+    };
+    for (size_t block_tuples : {1, 3, 4, 100}) {
+        for (size_t limit_hint : {0, 2}) {
+            SCOPED_TRACE("block " + std::to_string(block_tuples) + ", limit hint " + std::to_string(limit_hint));
+            EXPECT_EQ(sorted(run(limit_hint, block_tuples, {})), sorted(expected));
+        }
+    }
+    // 右输入为空
+    Condition none;
+    none.lhs_col = {"b", "y"};
+    none.op = OP_GT;
+    none.is_rhs_val = true;
+    none.rhs_val.set_int(100);
+    none.rhs_val.init_raw(sizeof(int));
+    EXPECT_TRUE(run(0, 3, {none}).empty());
+}
+
+// semi join和anti join都只输出左表的列，select *只展开左表
+TEST_F(SqlTest, SemiAndAntiJoinSelectStar) {
+    exec_all({"create table u (k int, s char(20));", "create table t (id int, k int, note char(20));"});
+    for (int i = 1; i <= 8; i++) {
+        exec_all({"insert into u values (" + std::to_string(i) + ", 'u" + std::to_string(i) + "');"});
+    }
+    // t中k = 2, 4, 6有匹配，k = 4重复出现
+    exec_all({"insert into t values (10, 2, 'x');", "insert into t values (11, 4, 'y');",
+              "insert into t values (12, 4, 'z');", "insert into t values (13, 6, 'w');",
+              "insert into t values (14, 20, 'v');"});
+
+    auto anti = query("select * from u anti join t on u.k = t.k order by u.k;");
+    ASSERT_EQ(anti.size(), 5u);
+    std::vector<std::string> anti_keys = {"1", "3", "5", "7", "8"};
+    for (size_t i = 0; i < anti.size(); i++) {
+        ASSERT_EQ(anti[i].size(), 2u);
+        EXPECT_EQ(anti[i][0], anti_keys[i]);
+        EXPECT_EQ(anti[i][1], "u" + anti_keys[i]);
+    }
+
+    // 匹配多次的左表元组只输出一次
+    auto semi = query("select * from u semi join t on u.k = t.k order by u.k desc;");
+    ASSERT_EQ(semi.size(), 3u);
+    EXPECT_EQ(semi[0], (std::vector<std::string>{"6", "u6"}));
+    EXPECT_EQ(semi[1], (std::vector<std::string>{"4", "u4"}));
+    EXPECT_EQ(semi[2], (std::vector<std::string>{"2", "u2"}));
+
+    EXPECT_EQ(column("select s from u anti join t on u.k = t.k where u.k > 4 order by s;", 0),
+              (std::vector<std::string>{"u5", "u7", "u8"}));
+    EXPECT_NE(exec("select t.note from u anti join t on u.k = t.k;").find("Anti Join"), std::string::npos);
+
+    // 没有等值条件时逐个比较缓存的右表元组
+    EXPECT_EQ(column("select u.k from u semi join t on u.k > t.k order by u.k;", 0),
+              (std::vector<std::string>{"3", "4", "5", "6", "7", "8"}));
+    EXPECT_EQ(column("select u.k from u anti join t on u.k > t.k order by u.k;", 0),
+              (std::vector<std::string>{"1", "2"}));
+    // 右表为空时anti join返回全部左表元组，semi join没有结果
+    exec_all({"create table e (k int);"});
+    EXPECT_EQ(query("select * from u anti join e on u.k = e.k;").size(), 8u);
+    EXPECT_TRUE(query("select * from u semi join e on u.k = e.k;").empty());
+}
+
+// 同一个扫描分别通过NextBatch和元组接口读完，结果必须一致：
+// 包括有版本链的页面（逐条get_record读取可见版本）、整批都被过滤掉的批，以及重复选中同一列的投影
+TEST_F(SqlTest, BatchMatchesTupleInterface) {
+    exec_all({"create table b (id int, grp int, name char(12));"});
+    const int rows = 2500;
+    for (int id = 0; id < rows; id++) {
+        int grp = id < 5 || id >= 2300 ? 100 : id % 7;
+        insert_rows("b", {std::to_string(id) + ", " + std::to_string(grp) + ", 'n" + std::to_string(id) + "'"});
+    }
+    // 旧快照在修改之前开始，之后修改过的页面上一直有版本链
+    char data_send[BUFFER_LENGTH];
+    int offset = 0;
+    Context old_ctx(lock_manager_.get(), log_manager_.get(), nullptr, data_send, &offset);
+    old_ctx.txn_ = txn_manager_->begin(nullptr, log_manager_.get());
+    exec_all({"update b set name = 'upd' where id >= 100 and id < 200;", "delete from b where id >= 1500 and id < 1600;"});
+    Context new_ctx(lock_manager_.get(), log_manager_.get(), nullptr, data_send, &offset);
+    new_ctx.txn_ = txn_manager_->begin(nullptr, log_manager_.get());
+
+    int fd = sm_manager_->fhs_.at("b")->GetFd();
+    int chained_pages = 0;
+    for (int page_no = 1; page_no < sm_manager_->fhs_.at("b")->get_file_hdr().num_pages; page_no++) {
+        chained_pages += !MVCCManager::get_instance().is_page_all_visible(fd, page_no);
+    }
+    EXPECT_GT(chained_pages, 0);
+
+    auto int_cond = [](const std::string &col, CompOp op, int val) {
+        Condition cond;
+        cond.lhs_col = {"b", col};
+        cond.op = op;
+        cond.is_rhs_val = true;
+        cond.rhs_val.set_int(val);
+        cond.rhs_val.init_raw(sizeof(int));
+        return cond;
+    };
+    auto tuples = [](AbstractExecutor *executor) {
+        std::vector<std::string> result;
+        for (executor->beginTuple(); !executor->is_end(); executor->nextTuple()) {
+            auto rec = executor->Next();
+            result.emplace_back(rec->data, rec->size);
+        }
+        return result;
+    };
+    size_t empty_batches = 0;
+    auto batches = [&](AbstractExecutor *executor) {
+        std::vector<std::string> result;
+        std::string row(executor->tupleLen(), '\0');
+        executor->beginTuple();
+        while (auto batch = executor->NextBatch()) {
+            if (batch->size() > 0 && batch->num_selected() == 0) empty_batches++;
+            for (size_t i = 0; i < batch->num_selected(); i++) {
+                batch->gather_row(batch->selected(i), &row[0]);
+                result.push_back(row);
+            }
+        }
+        return result;
+    };
+    // 每次都新建执行器，两种接口不能混用
+    auto check = [&](Context *ctx, const std::vector<Condition> &conds, const std::vector<TabCol> &sel_cols) {
+        auto make = [&]() -> std::unique_ptr<AbstractExecutor> {
+            auto scan = std::make_unique<SeqScanExecutor>(sm_manager_.get(), "b", conds, ctx);
+            if (sel_cols.empty()) return scan;
+            return std::make_unique<ProjectionExecutor>(std::move(scan), sel_cols);
+        };
+        auto by_tuple = tuples(make().get());
+        auto by_batch = batches(make().get());
+        EXPECT_EQ(by_batch, by_tuple);
+        return by_tuple.size();
+    };
+
+    for (auto *ctx : {&old_ctx, &new_ctx}) {
+        bool old = ctx == &old_ctx;
+        SCOPED_TRACE(old ? "old snapshot" : "new snapshot");
+        EXPECT_EQ(check(ctx, {}, {}), old ? 2500u : 2400u);
+        // 只有开头和结尾的行满足条件，中间的批全部被过滤掉
+        empty_batches = 0;
+        EXPECT_EQ(check(ctx, {int_cond("grp", OP_EQ, 100)}, {}), 205u);
+        EXPECT_GE(empty_batches, 1u);
+        EXPECT_EQ(check(ctx, {int_cond("grp", OP_EQ, 3), int_cond("id", OP_LT, 1700)},
+                        {{"b", "id"}, {"b", "name"}, {"b", "id"}}),
+                  old ? 242u : 227u);
+    }
+    txn_manager_->commit(old_ctx.txn_, log_manager_.get());
+    txn_manager_->commit(new_ctx.txn_, log_manager_.get());
+}
+
+// 外部排序：内存预算很小时写出多个run再归并，结果与内存排序相同。排序键包括负数、浮点数、降序和变长的字符串
+TEST_F(SqlTest, ExternalSortSpill) {
+    struct Row {
+        int id, k;
+        float f;
+        std::string s;
+    };
+    std::vector<Row> rows;
+    exec_all({"create table t (id int, k int, f float, s char(8));"});
+    for (int i = 0; i < 200; i++) {
+        Row row{i, (i * 37) % 23 - 11, static_cast<float>((i * 53) % 41 - 20) / 4,
+                std::string(1 + i % 3, static_cast<char>('a' + (i * 7) % 5))};
+        rows.push_back(row);
+        char f[32];
+        snprintf(f, sizeof(f), "%.2f", row.f);
+        insert_rows("t", {std::to_string(row.id) + ", " + std::to_string(row.k) + ", " + f + ", '" + row.s + "'"});
+    }
+    auto ids = [&](const std::function<bool(const Row &, const Row &)> &less) {
+        std::vector<Row> order = rows;
+        std::sort(order.begin(), order.end(), less);
+        std::vector<std::string> result;
+        for (auto &row : order) result.push_back(std::to_string(row.id));
+        return result;
+    };
+    struct Case {
+        std::string order_by;
+        std::vector<TabCol> keys;
+        std::vector<bool> is_desc;
+        std::vector<std::string> expected;
+    };
+    std::vector<Case> cases = {
+        {"order by k, id", {{"t", "k"}, {"t", "id"}}, {false, false},
+         ids([](const Row &a, const Row &b) { return std::tie(a.k, a.id) < std::tie(b.k, b.id); })},
+        {"order by f desc, id desc", {{"t", "f"}, {"t", "id"}}, {true, true},
+         ids([](const Row &a, const Row &b) { return std::tie(b.f, b.id) < std::tie(a.f, a.id); })},
+        {"order by s, k desc, id", {{"t", "s"}, {"t", "k"}, {"t", "id"}}, {false, true, false},
+         ids([](const Row &a, const Row &b) {
+             return std::make_tuple(a.s, -a.k, a.id) < std::make_tuple(b.s, -b.k, b.id);
+         })},
+    };
+    // 直接构造排序算子，指定内存预算
+    auto sort_ids = [&](const Case &c, size_t mem_budget) {
+        auto scan = std::make_unique<SeqScanExecutor>(sm_manager_.get(), "t", std::vector<Condition>{}, nullptr);
+        SortExecutor sort(std::move(scan), c.keys, c.is_desc, mem_budget);
+        int id_offset = sort.get_col_offset({"t", "id"}).offset;
+        std::vector<std::string> result;
+        for (sort.beginTuple(); !sort.is_end(); sort.nextTuple()) {
+            int id;
+            memcpy(&id, sort.Next()->data + id_offset, sizeof(int));
+            result.push_back(std::to_string(id));
+        }
+        return result;
+    };
+    for (auto &c : cases) {
+        SCOPED_TRACE(c.order_by);
+        // 经过SQL的排序使用默认预算；只取一部分行，避免输出超过缓冲区
+        std::vector<std::string> expected_sql;
+        std::copy_if(c.expected.begin(), c.expected.end(), std::back_inserter(expected_sql),
+                     [](const std::string &id) { return std::stoi(id) < 60; });
+        EXPECT_EQ(column("select * from t where id < 60 " + c.order_by + ";", 0), expected_sql);
+        for (size_t mem_budget : {size_t(256), ExternalSorter::DEFAULT_MEM_BUDGET}) {
+            EXPECT_EQ(sort_ids(c, mem_budget), c.expected) << "budget " << mem_budget;
+        }
+        // 经过SQL时预算来自work_mem
+        for (int work_mem : {1, 4096}) {
+            exec_all({"set work_mem = " + std::to_string(work_mem) + ";"});
+            SCOPED_TRACE("work_mem = " + std::to_string(work_mem));
+            std::string plan = exec("explain analyze select * from t " + c.order_by + ";");
+            if (work_mem == 1) {
+                EXPECT_GT(analyze_stat(plan, "Spilled Runs"), 1) << plan;
+            } else {
+                EXPECT_EQ(analyze_stat(plan, "Spilled Runs"), 0) << plan;
+            }
+            EXPECT_EQ(analyze_stat(plan, "Rows"), 200) << plan;
+            EXPECT_EQ(column("select * from t where id < 60 " + c.order_by + ";", 0), expected_sql);
+        }
+    }
+
+    // 同样的输入直接交给ExternalSorter，确认小预算下确实写出了多个run
+    SeqScanExecutor scan(sm_manager_.get(), "t", {}, nullptr);
+    for (size_t mem_budget : {size_t(256), ExternalSorter::DEFAULT_MEM_BUDGET}) {
+        ExternalSorter sorter(scan.tupleLen(), {scan.get_col_offset({"t", "k"})}, {false}, mem_budget);
+        size_t added = 0;
+        for (scan.beginTuple(); !scan.is_end(); scan.nextTuple(), added++) {
+            sorter.add(scan.Next()->data);
+        }
+        sorter.finish();
+        if (mem_budget == 256) {
+            EXPECT_GT(sorter.num_runs(), 1u);
+        } else {
+            EXPECT_EQ(sorter.num_runs(), 0u);
+        }
+        size_t output = 0;
+        int prev_k = INT32_MIN;
+        for (; !sorter.is_end(); sorter.next(), output++) {
+            int k;
+            memcpy(&k, sorter.current() + scan.get_col_offset({"t", "k"}).offset, sizeof(int));
+            EXPECT_LE(prev_k, k);
+            prev_k = k;
+        }
+        EXPECT_EQ(output, added);
+        EXPECT_EQ(output, rows.size());
+    }
+}
+
+// ORDER BY ... LIMIT使用Top-N：偏移量在结果中间、越过结尾、超过总行数，升降序和重复的排序键，连接之上的Top-N，
+// 以及由索引提供顺序时的LIMIT偏移
+TEST_F(SqlTest, TopNWithOffset) {
+    const int ROWS = 50;
+    exec_all({"create table t (id int, k int);", "create table u (k int, name char(8));"});
+    std::vector<std::pair<int, int>> rows;      // (k, id)
+    for (int id = 0; id < ROWS; id++) {
+        rows.push_back({(id * 17) % 13, id});
+        insert_rows("t", {std::to_string(id) + ", " + std::to_string((id * 17) % 13)});
+    }
+    insert_rows("u", {"3, 'three'", "5, 'five'", "12, 'twelve'"});
+    std::sort(rows.begin(), rows.end());
+    auto slice = [](const std::vector<std::string> &all, int offset, int count) {
+        std::vector<std::string> result;
+        for (int i = offset; i < offset + count && i < static_cast<int>(all.size()); i++) result.push_back(all[i]);
+        return result;
+    };
+    std::vector<std::string> asc, desc;
+    for (auto &row : rows) asc.push_back(std::to_string(row.second));
+    // k降序、id升序
+    std::vector<std::pair<int, int>> desc_rows = rows;
+    std::sort(desc_rows.begin(), desc_rows.end(),
+              [](auto &a, auto &b) { return a.first != b.first ? a.first > b.first : a.second < b.second; });
+    for (auto &row : desc_rows) desc.push_back(std::to_string(row.second));
+
+    EXPECT_NE(exec("explain select id from t order by k, id limit 3, 4;").find("Count: 4, Offset: 3"),
+              std::string::npos);
+    for (auto [offset, count] : std::vector<std::pair<int, int>>{{0, 5}, {3, 4}, {47, 10}, {50, 3}, {60, 1}}) {
+        std::string limit = " limit " + std::to_string(offset) + ", " + std::to_string(count) + ";";
+        SCOPED_TRACE(limit);
+        EXPECT_EQ(column("select id, k from t order by k, id" + limit, 0), slice(asc, offset, count));
+        EXPECT_EQ(column("select id, k from t order by k desc, id" + limit, 0), slice(desc, offset, count));
+    }
+
+    // 连接之上的Top-N
+    std::vector<std::string> joined;
+    for (auto &row : rows) {
+        if (row.first == 3 || row.first == 5 || row.first == 12) joined.push_back(std::to_string(row.second));
+    }
+    EXPECT_EQ(column("select t.id, u.name from t, u where t.k = u.k order by t.k, t.id limit 2, 6;", 0),
+              slice(joined, 2, 6));
+
+    // 索引提供顺序，LIMIT直接跳过前面的元组
+    exec_all({"create nonunique index t(k, id);"});
+    EXPECT_EQ(exec("explain select id from t order by k, id limit 3, 4;").find("Top-N"), std::string::npos);
+    EXPECT_EQ(column("select id from t order by k, id limit 3, 4;", 0), slice(asc, 3, 4));
+    EXPECT_EQ(column("select id from t order by k, id limit 48, 4;", 0), slice(asc, 48, 4));
+}
+
+// 定长键哈希聚合：INT/CHAR分组键和各种聚合函数的结果、分组按第一次出现的顺序输出、
+// -0.0与+0.0归入同一组、HAVING AVG、INT的AVG按64位累加，以及没有GROUP BY且输入为空时的输出
+TEST_F(SqlTest, FixedWidthHashAggregate) {
+    const int ROWS = 40;
+    const std::vector<std::string> strs = {"x", "yy", "zzz"};
+    exec_all({"create table t (g int, s char(4), v int, f float);"});
+    struct Group {
+        int count = 0, sum = 0, max = INT32_MIN, min = INT32_MAX;
+        float max_f = -1e9;
+        std::string min_s = "~", max_s;
+    };
+    std::vector<int> order;                             // 分组第一次出现的顺序
+    std::map<int, Group> groups;
+    std::vector<std::pair<int, std::string>> pair_order;
+    std::map<std::pair<int, std::string>, Group> pairs;
+    for (int i = 0; i < ROWS; i++) {
+        int g = (i * 7) % 5, v = i * 10 - 100;
+        float f = static_cast<float>(i % 4) - 1.5f;
+        const std::string &s = strs[i % 3];
+        char f_str[32];
+        snprintf(f_str, sizeof(f_str), "%.1f", f);
+        insert_rows("t", {std::to_string(g) + ", '" + s + "', " + std::to_string(v) + ", " + f_str});
+        if (!groups.count(g)) order.push_back(g);
+        if (!pairs.count({g, s})) pair_order.push_back({g, s});
+        for (Group *grp : {&groups[g], &pairs[{g, s}]}) {
+            grp->count++;
+            grp->sum += v;
+            grp->max = std::max(grp->max, v);
+            grp->min = std::min(grp->min, v);
+            grp->max_f = std::max(grp->max_f, f);
+            grp->min_s = std::min(grp->min_s, s);
+            grp->max_s = std::max(grp->max_s, s);
+        }
+    }
+
+    std::vector<std::vector<std::string>> expected;
+    for (int g : order) {
+        auto &grp = groups[g];
+        expected.push_back({std::to_string(g), std::to_string(grp.count), std::to_string(grp.count),
+                            std::to_string(grp.sum), std::to_string(grp.max), std::to_string(grp.min),
+                            std::to_string(static_cast<float>(grp.sum) / grp.count)});
+    }
+    EXPECT_EQ(query("select g, count(*), count(v), sum(v), max(v), min(v), avg(v) from t group by g;"), expected);
+
+    expected.clear();
+    for (int g : order) {
+        expected.push_back({std::to_string(g), groups[g].min_s, groups[g].max_s});
+    }
+    EXPECT_EQ(query("select g, min(s), max(s) from t group by g;"), expected);
+
+    expected.clear();
+    for (auto &key : pair_order) {
+        auto &grp = pairs[key];
+        expected.push_back({std::to_string(key.first), key.second, std::to_string(grp.count), std::to_string(grp.sum),
+                            std::to_string(grp.max_f)});
+    }
+    EXPECT_EQ(query("select g, s, count(*), sum(v), max(f) from t group by g, s;"), expected);
+
+    // HAVING比较的是平均值而不是总和
+    expected.clear();
+    for (int g : order) {
+        if (groups[g].sum > 90 * groups[g].count) expected.push_back({std::to_string(g), std::to_string(groups[g].count)});
+    }
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(query("select g, count(*) from t group by g having avg(v) > 90;"), expected);
+
+    // 没有GROUP BY：混合多种聚合函数
+    int total = 0;
+    for (auto &[g, grp] : groups) total += grp.sum;
+    EXPECT_EQ(query("select count(*), sum(v), max(f), min(v) from t;"),
+              (std::vector<std::vector<std::string>>{
+                  {std::to_string(ROWS), std::to_string(total), std::to_string(1.5f), "-100"}}));
+    // 输入为空时，只有全部是COUNT才输出一行0
+    EXPECT_EQ(query("select count(*), count(v) from t where v > 10000;"),
+              (std::vector<std::vector<std::string>>{{"0", "0"}}));
+    EXPECT_TRUE(query("select count(*), sum(v) from t where v > 10000;").empty());
+    EXPECT_TRUE(query("select g, count(*) from t where v > 10000 group by g;").empty());
+    EXPECT_NE(exec("select avg(s) from t;").find("AVG"), std::string::npos);
+
+    // 浮点分组键：-0.0与+0.0是同一组
+    exec_all({"create table z (f float, v int);"});
+    insert_rows("z", {"0.0, 1", "-0.0, 2", "1.5, 3", "0.0, 4"});
+    EXPECT_EQ(query("select count(*), sum(v) from z group by f;"),
+              (std::vector<std::vector<std::string>>{{"3", "7"}, {"1", "3"}}));
+
+    // 两个2000000000的和超过INT范围，AVG仍然正确
+    exec_all({"create table w (k int, v int);"});
+    insert_rows("w", {"1, 2000000000", "2, 1", "1, 2000000000", "2, 4"});
+    EXPECT_EQ(column("select k from w group by k having avg(v) > 1000000000;", 0), (std::vector<std::string>{"1"}));
+    EXPECT_EQ(column("select k, avg(v) from w group by k having avg(v) < 1000000000;", 1),
+              (std::vector<std::string>{"2.500000"}));
+}
+
+// 聚合超出work_mem时把溢出的分组按哈希值写入分区，再逐个分区（必要时递归划分）聚合，结果与内存中聚合相同
+TEST_F(SqlTest, SpillingHashAggregate) {
+    const int GROUPS = 300, ROWS = 900, WINDOW = 50;
+    exec_all({"create table t (k int, v int);"});
+    struct Group {
+        int count = 0, sum = 0, min = INT32_MAX, max = INT32_MIN;
+    };
+    std::map<int, Group> groups;
+    for (int i = 0; i < ROWS; i++) {
+        int k = (i * 7) % GROUPS;
+        insert_rows("t", {std::to_string(k) + ", " + std::to_string(i)});
+        auto &grp = groups[k];
+        grp.count++;
+        grp.sum += i;
+        grp.min = std::min(grp.min, i);
+        grp.max = std::max(grp.max, i);
+    }
+    // 结果太多时客户端缓冲区放不下，用HAVING按min(v)分段取出所有分组（每组最小的v互不相同且都小于GROUPS）
+    auto check_results = [&]() {
+        for (int lo = 0; lo < GROUPS; lo += WINDOW) {
+            std::vector<std::vector<std::string>> expected;
+            for (auto &[k, grp] : groups) {
+                if (grp.min >= lo && grp.min < lo + WINDOW) {
+                    expected.push_back({std::to_string(k), std::to_string(grp.count), std::to_string(grp.sum),
+                                        std::to_string(grp.max)});
+                }
+            }
+            std::string sql = "select k, count(*), sum(v), max(v) from t group by k having min(v) >= " +
+                              std::to_string(lo) + " and min(v) < " + std::to_string(lo + WINDOW) + ";";
+            SCOPED_TRACE(sql);
+            EXPECT_EQ(sorted(query(sql)), sorted(expected));
+        }
+    };
+    const std::string sql = "select k, count(*), sum(v), max(v) from t group by k";
+
+    std::string plan = exec("explain analyze " + sql + ";");
+    EXPECT_EQ(analyze_stat(plan, "Groups"), GROUPS) << plan;
+    EXPECT_EQ(analyze_stat(plan, "Spilled Rows"), 0) << plan;
+    EXPECT_EQ(analyze_stat(plan, "Spill Partitions"), 0) << plan;
+    check_results();
+
+    exec_all({"set work_mem = 1;"});
+    plan = exec("explain analyze " + sql + ";");
+    EXPECT_EQ(analyze_stat(plan, "Groups"), GROUPS) << plan;
+    EXPECT_GT(analyze_stat(plan, "Spilled Rows"), 0) << plan;
+    EXPECT_GT(analyze_stat(plan, "Spill Partitions"), 0) << plan;
+    EXPECT_NE(plan.find("\nRows: " + std::to_string(GROUPS) + "\n"), std::string::npos) << plan;
+    check_results();
+    // 没有GROUP BY时只有一个分组，不会写出
+    EXPECT_EQ(query("select count(*), sum(v) from t;"),
+              (std::vector<std::vector<std::string>>{{std::to_string(ROWS), std::to_string(ROWS * (ROWS - 1) / 2)}}));
+    plan = exec("explain analyze select count(*), sum(v) from t;");
+    EXPECT_EQ(analyze_stat(plan, "Spilled Rows"), 0) << plan;
+}
+
+// 并行顺序扫描：表达到并行扫描的页数阈值时计划中出现Gather和Parallel Seq Scan，工作线程按morsel分担页面，
+// 过滤、聚合、排序和快照可见性的结果与串行扫描相同
+TEST_F(SqlTest, ParallelSeqScan) {
+    const int ROWS = 12000;
+    exec_all({"create table big (id int, k int, pad char(200));"});
+    bulk_load("big", ROWS, [](int i, char *buf) {
+        int k = i % 100;
+        memcpy(buf, &i, sizeof(int));
+        memcpy(buf + sizeof(int), &k, sizeof(int));
+        snprintf(buf + 2 * sizeof(int), 200, "row%d", i);
+    });
+    ASSERT_GE(sm_manager_->fhs_.at("big")->get_file_hdr().num_pages, 512);
+    // 删除k = 5中id < 1000的行，更新一行的k
+    exec_all({"delete from big where k = 5 and id < 1000;", "update big set k = 1000 where id = 10;"});
+    std::vector<int> ks(ROWS);
+    std::vector<bool> alive(ROWS, true);
+    for (int i = 0; i < ROWS; i++) ks[i] = i % 100;
+    for (int i = 5; i < 1000; i += 100) alive[i] = false;
+    ks[10] = 1000;
+
+    auto ids = [&](const std::function<bool(int)> &pred) {
+        std::vector<std::vector<std::string>> rows;
+        for (int i = 0; i < ROWS; i++) {
+            if (alive[i] && pred(i)) rows.push_back({std::to_string(i)});
+        }
+        return rows;
+    };
+    int alive_rows = 0;
+    long k_sum = 0;
+    for (int i = 0; i < ROWS; i++) {
+        if (!alive[i]) continue;
+        alive_rows++;
+        k_sum += ks[i];
+    }
+    auto check_results = [&]() {
+        EXPECT_EQ(query("select count(*), sum(k), min(id), max(id) from big;"),
+                  (std::vector<std::vector<std::string>>{
+                      {std::to_string(alive_rows), std::to_string(k_sum), "0", std::to_string(ROWS - 1)}}));
+        EXPECT_EQ(query("select count(*) from big where k = 5;"),
+                  (std::vector<std::vector<std::string>>{{std::to_string(ROWS / 100 - 10)}}));
+        EXPECT_EQ(sorted(query("select id from big where k = 42 and id >= 5000 and id < 7000;")),
+                  sorted(ids([&](int i) { return ks[i] == 42 && i >= 5000 && i < 7000; })));
+        EXPECT_EQ(query("select id from big where k = 1000;"), ids([&](int i) { return ks[i] == 1000; }));
+        EXPECT_EQ(column("select pad from big where id = 11999;", 0), (std::vector<std::string>{"row11999"}));
+        EXPECT_EQ(column("select id from big where k = 7 order by id desc limit 3;", 0),
+                  (std::vector<std::string>{"11907", "11807", "11707"}));
+    };
+
+    std::string plan = exec("explain select id from big where k = 42;");
+    EXPECT_NE(plan.find("Gather (Workers: 2)"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Parallel Seq Scan on big"), std::string::npos) << plan;
+    plan = exec("explain analyze select id from big where k = 42;");
+    EXPECT_GT(analyze_stat(plan, "Morsels"), 1) << plan;
+    EXPECT_NE(plan.find("\nRows: " + std::to_string(ROWS / 100) + "\n"), std::string::npos) << plan;
+    check_results();
+
+    // 关闭并行后使用串行扫描，结果相同
+    exec_all({"set max_parallel_workers = 0;"});
+    plan = exec("explain select id from big where k = 42;");
+    EXPECT_EQ(plan.find("Parallel"), std::string::npos) << plan;
+    EXPECT_EQ(plan.find("Gather"), std::string::npos) << plan;
+    check_results();
+}
+
+// 并行聚合：工作线程各自预聚合再按分区合并；预聚合的分组超出内存预算时退回串行（可能写出分区），结果不变
+TEST_F(SqlTest, ParallelHashAggregate) {
+    const int ROWS = 12000, GROUPS = 37;
+    exec_all({"create table big (id int, g int, v int, pad char(200));"});
+    bulk_load("big", ROWS, [&](int i, char *buf) {
+        int row[] = {i, i % GROUPS, i % 1000 - 500};
+        memcpy(buf, row, sizeof(row));
+        snprintf(buf + sizeof(row), 200, "row%d", i);
+    });
+    struct Group {
+        int count = 0, sum = 0, min = INT32_MAX, max = INT32_MIN;
+    };
+    std::map<int, Group> groups;
+    for (int i = 0; i < ROWS; i++) {
+        auto &grp = groups[i % GROUPS];
+        int v = i % 1000 - 500;
+        grp.count++;
+        grp.sum += v;
+        grp.min = std::min(grp.min, v);
+        grp.max = std::max(grp.max, v);
+    }
+    std::vector<std::vector<std::string>> expected, having;
+    for (auto &[g, grp] : groups) {
+        expected.push_back({std::to_string(g), std::to_string(grp.count), std::to_string(grp.sum),
+                            std::to_string(grp.min), std::to_string(grp.max)});
+        if (grp.sum > 0) having.push_back({std::to_string(g), std::to_string(grp.sum)});
+    }
+    ASSERT_FALSE(having.empty());
+    const std::string sql = "select g, count(*), sum(v), min(v), max(v) from big group by g";
+
+    std::string plan = exec("explain " + sql + ";");
+    EXPECT_NE(plan.find("Parallel Aggregate"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Gather (Workers: 2)"), std::string::npos) << plan;
+    plan = exec("explain analyze " + sql + ";");
+    EXPECT_NE(plan.find("Workers: 2, Groups: " + std::to_string(GROUPS)), std::string::npos) << plan;
+    EXPECT_EQ(sorted(query(sql + ";")), sorted(expected));
+    EXPECT_EQ(sorted(query("select g, sum(v) from big group by g having sum(v) > 0;")), sorted(having));
+    EXPECT_EQ(query("select count(*), min(id), max(id) from big;"),
+              (std::vector<std::vector<std::string>>{{std::to_string(ROWS), "0", std::to_string(ROWS - 1)}}));
+
+    // 内存预算只够几个分组：退回串行聚合并写出分区
+    exec_all({"set work_mem = 1;"});
+    plan = exec("explain analyze " + sql + ";");
+    EXPECT_NE(plan.find("Workers: 2 (fallback to serial)"), std::string::npos) << plan;
+    EXPECT_GT(analyze_stat(plan, "Spill Partitions"), 0) << plan;
+    EXPECT_EQ(sorted(query(sql + ";")), sorted(expected));
+    EXPECT_EQ(sorted(query("select g, sum(v) from big group by g having sum(v) > 0;")), sorted(having));
+}
+
+// 并行哈希连接：大表与小表连接时大表并行探测，两个大表连接时并行构建和探测，结果与串行连接相同
+TEST_F(SqlTest, ParallelHashJoin) {
+    const int ROWS = 12000;
+    exec_all({"create table big (id int, k int, pad char(200));", "create table big2 (id int, tag int, pad char(200));",
+              "create table s (k int, name char(12));"});
+    bulk_load("big", ROWS, [](int i, char *buf) {
+        int row[] = {i, i % 50};
+        memcpy(buf, row, sizeof(row));
+        snprintf(buf + sizeof(row), 200, "big%d", i);
+    });
+    bulk_load("big2", ROWS, [](int i, char *buf) {
+        int row[] = {ROWS - 1 - i, i % 7};
+        memcpy(buf, row, sizeof(row));
+        snprintf(buf + sizeof(row), 200, "big2_%d", i);
+    });
+    insert_rows("s", {"3, 'three'", "17, 'seventeen'", "42, 'fortytwo'", "99, 'none'"});
+
+    std::vector<std::vector<std::string>> small_join;
+    int small_count = 0;
+    long small_sum = 0;
+    for (int i = 0; i < ROWS; i++) {
+        int k = i % 50;
+        if (k != 3 && k != 17 && k != 42) continue;
+        small_count++;
+        small_sum += i;
+        if (i < 1000) small_join.push_back({std::to_string(i), k == 3 ? "three" : k == 17 ? "seventeen" : "fortytwo"});
+    }
+    long big_sum = 0;
+    for (int id = 11000; id < ROWS; id++) big_sum += id % 50 + (ROWS - 1 - id) % 7;
+
+    const std::string small_sql = "select big.id, s.name from big, s where big.k = s.k and big.id < 1000;";
+    const std::string count_sql = "select count(*), sum(big.id) from big, s where big.k = s.k;";
+    const std::string big_sql =
+        "select count(*), sum(big.k), sum(big2.tag) from big, big2 where big.id = big2.id and big2.id >= 11000;";
+    auto check_results = [&]() {
+        EXPECT_EQ(sorted(query(small_sql)), sorted(small_join));
+        EXPECT_EQ(query(count_sql), (std::vector<std::vector<std::string>>{
+                                        {std::to_string(small_count), std::to_string(small_sum)}}));
+        auto rows = query(big_sql);
+        ASSERT_EQ(rows.size(), 1u);
+        EXPECT_EQ(rows[0][0], "1000");
+        EXPECT_EQ(std::stol(rows[0][1]) + std::stol(rows[0][2]), big_sum);
+    };
+
+    std::string plan = exec("explain " + small_sql);
+    EXPECT_NE(plan.find("Parallel Hash Join"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Parallel Seq Scan on big"), std::string::npos) << plan;
+    plan = exec("explain " + big_sql);
+    EXPECT_NE(plan.find("Parallel Seq Scan on big\n"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Parallel Seq Scan on big2"), std::string::npos) << plan;
+    check_results();
+
+    exec_all({"set max_parallel_workers = 0;"});
+    EXPECT_EQ(exec("explain " + big_sql).find("Parallel"), std::string::npos);
+    check_results();
+}
+
+// 编译后的谓词与逐行比较的语义一致：每种字段类型和运算符，常量和字段两种右操作数，以及连接条件两侧的字段
+TEST(PredicateProgramTest, MatchesRowComparison) {
+    const std::vector<CompOp> ops = {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE};
+    auto expect = [](int cmp, CompOp op) {
+        switch (op) {
+            case OP_EQ: return cmp == 0;
+            case OP_NE: return cmp != 0;
+            case OP_LT: return cmp < 0;
+            case OP_GT: return cmp > 0;
+            case OP_LE: return cmp <= 0;
+            default: return cmp >= 0;
+        }
+    };
+    auto col = [](const std::string &tab, const std::string &name, ColType type, int len, int offset) {
+        return ColMeta{tab, name, type, len, offset, false};
+    };
+    auto str_of = [](const std::string &s, int len) {
+        std::string buf(len, '\0');
+        memcpy(&buf[0], s.data(), std::min<size_t>(s.size(), len));
+        return buf;
+    };
+
+    // 单表元组：a, b int；f, g float；s, u char(8)
+    std::vector<ColMeta> cols = {col("t", "a", TYPE_INT, 4, 0),    col("t", "b", TYPE_INT, 4, 4),
+                                 col("t", "f", TYPE_FLOAT, 4, 8),  col("t", "g", TYPE_FLOAT, 4, 12),
+                                 col("t", "s", TYPE_STRING, 8, 16), col("t", "u", TYPE_STRING, 8, 24)};
+    const std::vector<int> ints = {INT32_MIN, -3, 0, 7, INT32_MAX};
+    const std::vector<float> floats = {-1.5f, -0.0f, 0.0f, 2.25f};
+    const std::vector<std::string> strs = {str_of("", 8), str_of("ab", 8), str_of("abc", 8), str_of("abd", 8),
+                                           str_of("zzzzzzzz", 8)};
+    auto cond_col = [](const std::string &lhs, CompOp op, const std::string &rhs) {
+        Condition cond;
+        cond.lhs_col = {"t", lhs};
+        cond.op = op;
+        cond.is_rhs_val = false;
+        cond.rhs_col = {"t", rhs};
+        return cond;
+    };
+    auto cond_val = [](const std::string &lhs, CompOp op, Value val, int len) {
+        Condition cond;
+        cond.lhs_col = {"t", lhs};
+        cond.op = op;
+        cond.is_rhs_val = true;
+        val.init_raw(len);
+        cond.rhs_val = val;
+        return cond;
+    };
+
+    char rec[32];
+    for (auto op : ops) {
+        for (size_t i = 0; i < ints.size(); i++) {
+            for (size_t j = 0; j < ints.size(); j++) {
+                memcpy(rec, &ints[i], 4);
+                memcpy(rec + 4, &ints[j], 4);
+                bool want = expect(ix_compare(rec, rec + 4, TYPE_INT, 4), op);
+                EXPECT_EQ(PredicateProgram(cols, {cond_col("a", op, "b")}).eval(rec), want) << op << ' ' << i << j;
+                Value v;
+                v.set_int(ints[j]);
+                EXPECT_EQ(PredicateProgram(cols, {cond_val("a", op, v, 4)}).eval(rec), want) << op << ' ' << i << j;
+            }
+        }
+        for (size_t i = 0; i < floats.size(); i++) {
+            for (size_t j = 0; j < floats.size(); j++) {
+                memcpy(rec + 8, &floats[i], 4);
+                memcpy(rec + 12, &floats[j], 4);
+                bool want = expect(ix_compare(rec + 8, rec + 12, TYPE_FLOAT, 4), op);
+                EXPECT_EQ(PredicateProgram(cols, {cond_col("f", op, "g")}).eval(rec), want) << op << ' ' << i << j;
+                Value v;
+                v.set_float(floats[j]);
+                EXPECT_EQ(PredicateProgram(cols, {cond_val("f", op, v, 4)}).eval(rec), want) << op << ' ' << i << j;
+            }
+        }
+        for (size_t i = 0; i < strs.size(); i++) {
+            for (size_t j = 0; j < strs.size(); j++) {
+                memcpy(rec + 16, strs[i].data(), 8);
+                memcpy(rec + 24, strs[j].data(), 8);
+                bool want = expect(ix_compare(rec + 16, rec + 24, TYPE_STRING, 8), op);
+                EXPECT_EQ(PredicateProgram(cols, {cond_col("s", op, "u")}).eval(rec), want) << op << ' ' << i << j;
+                Value v;
+                v.set_str(strs[j].substr(0, strlen(strs[j].c_str())));
+                EXPECT_EQ(PredicateProgram(cols, {cond_val("s", op, v, 8)}).eval(rec), want) << op << ' ' << i << j;
+            }
+        }
+    }
+
+    // 多个条件是合取
+    int a = 5, b = 9;
+    memcpy(rec, &a, 4);
+    memcpy(rec + 4, &b, 4);
+    Value five;
+    five.set_int(5);
+    EXPECT_TRUE(PredicateProgram(cols, {cond_col("a", OP_LT, "b"), cond_val("a", OP_EQ, five, 4)}).eval(rec));
+    EXPECT_FALSE(PredicateProgram(cols, {cond_col("a", OP_LT, "b"), cond_val("a", OP_NE, five, 4)}).eval(rec));
+    EXPECT_TRUE(PredicateProgram().empty());
+    EXPECT_TRUE(PredicateProgram().eval(rec));
+
+    // 类型不同的条件在构造时不报错，求值时抛出IncompatibleTypeError
+    Value half;
+    half.set_float(0.5f);
+    PredicateProgram int_vs_float(cols, {cond_val("a", OP_EQ, half, 4)});
+    EXPECT_THROW(int_vs_float.eval(rec), IncompatibleTypeError);
+    PredicateProgram float_vs_str(cols, {cond_col("f", OP_LT, "s")});
+    EXPECT_THROW(float_vs_str.eval(rec), IncompatibleTypeError);
+
+    // 连接条件：左元组 a int, f float, s char(8)；右元组 b int, g float, u char(4)
+    // offset是拼接后元组中的偏移，字符串按两侧中较短的长度比较
+    const size_t left_len = 16;
+    ColMeta la = col("l", "a", TYPE_INT, 4, 0), lf = col("l", "f", TYPE_FLOAT, 4, 4),
+            ls = col("l", "s", TYPE_STRING, 8, 8);
+    ColMeta rb = col("r", "b", TYPE_INT, 4, 16), rg = col("r", "g", TYPE_FLOAT, 4, 20),
+            ru = col("r", "u", TYPE_STRING, 4, 24);
+    char joined[28];
+    char *left = joined, *right = joined + left_len;
+    char right_copy[12];
+    for (auto op : ops) {
+        for (size_t i = 0; i < strs.size(); i++) {
+            for (size_t j = 0; j < strs.size(); j++) {
+                int li = ints[i], ri = ints[j];
+                float lfv = floats[i % floats.size()], rfv = floats[j % floats.size()];
+                memcpy(left, &li, 4);
+                memcpy(left + 4, &lfv, 4);
+                memcpy(left + 8, strs[i].data(), 8);
+                memcpy(right, &ri, 4);
+                memcpy(right + 4, &rfv, 4);
+                memcpy(right + 8, strs[j].data(), 4);
+                // 右元组放在独立的缓冲区，确认程序不依赖两个元组相邻
+                memcpy(right_copy, right, sizeof(right_copy));
+                for (auto &pair : std::vector<std::pair<ColMeta, ColMeta>>{
+                         {la, rb}, {rb, la}, {lf, rg}, {rg, lf}, {ls, ru}, {ru, ls}}) {
+                    JoinResidualCond cond{pair.first, pair.second, op};
+                    PredicateProgram prog({cond}, left_len);
+                    bool want = eval_join_cond(cond, joined);
+                    EXPECT_EQ(prog.eval(left, right_copy), want)
+                        << op << ' ' << pair.first.name << ' ' << pair.second.name << ' ' << i << j;
+                    EXPECT_EQ(prog.eval(joined, joined + left_len), want);
+                }
+            }
+        }
+    }
+}
+
+// 三种级别的过滤内核在随机数据上输出相同的位图，并与逐行比较一致；
+// 覆盖全部运算符、NaN和正负零、不是64倍数的行数、不是4/8/16/32倍数的字符串长度
+TEST(SimdFilterTest, KernelsProduceIdenticalBitmaps) {
+    std::vector<const simd::FilterKernels *> levels;
+    for (auto level : {simd::Level::SCALAR, simd::Level::SSE4, simd::Level::AVX2}) {
+        auto &k = simd::kernels(level);
+        if (k.level != level) {
+            std::cout << "simd level " << simd::level_name(level) << " not supported, skipped" << std::endl;
+            continue;
+        }
+        levels.push_back(&k);
+    }
+    const std::vector<CompOp> ops = {OP_EQ, OP_NE, OP_LT, OP_GT, OP_LE, OP_GE};
+    auto apply = [](auto a, auto b, CompOp op) {
+        switch (op) {
+            case OP_EQ: return a == b;
+            case OP_NE: return a != b;
+            case OP_LT: return a < b;
+            case OP_GT: return a > b;
+            case OP_LE: return a <= b;
+            default: return a >= b;
+        }
+    };
+    // 位图的字预先填满1，检查n之后的位也被清零
+    auto run = [](size_t n, auto fn) {
+        std::vector<uint64_t> out((n + 63) / 64, ~0ull);
+        fn(out.data());
+        return out;
+    };
+    auto reference = [](size_t n, auto pred) {
+        std::vector<uint64_t> out((n + 63) / 64, 0);
+        for (size_t i = 0; i < n; i++) {
+            if (pred(i)) out[i / 64] |= 1ull << (i % 64);
+        }
+        return out;
+    };
+
+    std::mt19937 rng(20231027);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    const std::vector<size_t> sizes = {0, 1, 3, 31, 63, 64, 65, 127, 200, 1000};
+    for (size_t n : sizes) {
+        // 整数列：值域小，保证各种比较结果都出现，外加两端的极值
+        std::vector<int> ints(n);
+        for (auto &v : ints) {
+            int r = static_cast<int>(rng() % 20);
+            v = r == 0 ? INT32_MIN : r == 1 ? INT32_MAX : r - 10;
+        }
+        for (int val : {0, -3, 7, INT32_MIN, INT32_MAX}) {
+            for (auto op : ops) {
+                auto want = reference(n, [&](size_t i) { return apply(ints[i], val, op); });
+                for (auto k : levels) {
+                    EXPECT_EQ(run(n, [&](uint64_t *out) { k->filter_int(ints.data(), n, val, op, out); }), want)
+                        << simd::level_name(k->level) << " int n=" << n << " val=" << val << " op=" << op;
+                }
+            }
+        }
+
+        // 浮点数列：混入NaN、正负零和无穷
+        std::vector<float> floats(n);
+        for (auto &v : floats) {
+            int r = static_cast<int>(rng() % 16);
+            v = r == 0 ? nan : r == 1 ? 0.0f : r == 2 ? -0.0f : r == 3 ? inf : r == 4 ? -inf : (r - 10) * 0.5f;
+        }
+        for (float val : {0.0f, -0.0f, 1.5f, -inf, nan}) {
+            for (auto op : ops) {
+                auto want = reference(n, [&](size_t i) { return apply(floats[i], val, op); });
+                for (auto k : levels) {
+                    EXPECT_EQ(run(n, [&](uint64_t *out) { k->filter_float(floats.data(), n, val, op, out); }), want)
+                        << simd::level_name(k->level) << " float n=" << n << " val=" << val << " op=" << op;
+                }
+            }
+        }
+
+        // 字符串列：每行要么等于常量，要么在随机位置（包括最后一个字节）上不同
+        for (int len : {1, 3, 5, 7, 9, 15, 17, 20, 31, 33, 47, 63, 65}) {
+            std::string val(len, '\0');
+            for (auto &c : val) c = static_cast<char>('a' + rng() % 3);
+            std::vector<char> col(n * len);
+            for (size_t i = 0; i < n; i++) {
+                char *row = col.data() + i * len;
+                memcpy(row, val.data(), len);
+                int r = static_cast<int>(rng() % 4);
+                if (r == 1) row[len - 1] ^= 1;
+                if (r == 2) row[rng() % len] ^= 0x20;
+                if (r == 3) row[0] = '\0';
+            }
+            for (auto op : {OP_EQ, OP_NE}) {
+                auto want = reference(n, [&](size_t i) {
+                    return apply(memcmp(col.data() + i * len, val.data(), len), 0, op);
+                });
+                for (auto k : levels) {
+                    EXPECT_EQ(run(n, [&](uint64_t *out) { k->filter_string(col.data(), n, len, val.data(), op, out); }),
+                              want)
+                        << simd::level_name(k->level) << " string n=" << n << " len=" << len << " op=" << op;
+                }
+            }
+        }
+    }
+
+    // 字符串内核只支持等值比较
+    std::vector<uint64_t> out(1);
+    char row[4] = {'a', 'b', 'c', 'd'};
+    for (auto k : levels) {
+        EXPECT_THROW(k->filter_string(row, 1, 4, row, OP_LT, out.data()), InternalError);
+    }
+}
+
+// UPDATE SET中的表达式：类型推导、多个set子句、除零和溢出、常量折叠、嵌套深度和字符串赋值
+TEST_F(SqlTest, UpdateSetExpressions) {
+    exec_all({"create table t (id int, a int, i int, f float, s char(4), l char(8));"});
+    insert_rows("t", {"1, 10, 7, 2.5, 'ab', 'abc'", "2, -4, -3, 0.5, 'xy', 'abcdefg'"});
+    auto row = [&](int id) { return query("select * from t where id = " + std::to_string(id) + ";").at(0); };
+    auto expect_error = [&](const std::string &sql, const std::string &msg) {
+        std::string result = exec(sql);
+        EXPECT_NE(result.find(msg), std::string::npos) << sql << ": " << result;
+    };
+
+    exec_all({"update t set a = a + 1;"});
+    EXPECT_EQ(column("select a from t;", 0), (std::vector<std::string>{"11", "-3"}));
+    // 整数运算的结果赋给浮点数字段
+    exec_all({"update t set f = i / 2;"});
+    EXPECT_EQ(column("select f from t;", 0), (std::vector<std::string>{"3.000000", "-1.000000"}));
+    // 浮点数结果不能赋给整数字段
+    expect_error("update t set i = f * 2;", "Incompatible type");
+    EXPECT_EQ(column("select i from t;", 0), (std::vector<std::string>{"7", "-3"}));
+
+    // 多个set子句都读取更新前的值
+    exec_all({"update t set a = i, i = a, f = f + a where id = 1;"});
+    EXPECT_EQ(row(1), (std::vector<std::string>{"1", "7", "11", "14.000000", "ab", "abc"}));
+
+    expect_error("update t set a = a / (i - 11) where id = 1;", "division by zero");
+    expect_error("update t set f = f / (f - f) where id = 2;", "division by zero");
+    // INT_MIN / -1无法表示，无论是在求值时还是在常量折叠时
+    expect_error("update t set i = (0 - 2147483647 - 1) / (a - 8) where id = 1;", "integer overflow");
+    expect_error("update t set i = (0 - 2147483647 - 1) / (0 - 1);", "integer overflow");
+    EXPECT_EQ(row(1), (std::vector<std::string>{"1", "7", "11", "14.000000", "ab", "abc"}));
+    exec_all({"update t set i = (0 - 2147483647 - 1) / (a - 6) where id = 1;"});
+    EXPECT_EQ(row(1)[2], "-2147483648");
+
+    // 常量子表达式在编译时求值：整数除法截断，常量除零在没有元组需要更新时也报错
+    exec_all({"update t set a = 2 * 3 + 10 / 4 - 1, f = 1 / 2 + 0.5 where id = 2;"});
+    EXPECT_EQ(row(2), (std::vector<std::string>{"2", "7", "-3", "0.500000", "xy", "abcdefg"}));
+    expect_error("update t set a = 1 / 0 where id = 99;", "division by zero");
+
+    // 右侧嵌套的表达式每层占用一个寄存器，左侧嵌套只占用两个寄存器
+    auto right_nested = [](int depth) {
+        std::string expr = "a";
+        for (int k = 0; k < depth; k++) expr = "1 + (" + expr + ")";
+        return expr;
+    };
+    exec_all({"update t set a = " + right_nested(40) + " where id = 2;"});
+    EXPECT_EQ(row(2)[1], "47");
+    std::string left_nested = "a";
+    for (int k = 0; k < 200; k++) left_nested += " - 1";
+    exec_all({"update t set a = " + left_nested + " where id = 2;"});
+    EXPECT_EQ(row(2)[1], "-153");
+
+    // 语法分析器的栈不允许SQL嵌套到MAX_REGS层，直接编译表达式树检查上限
+    std::vector<ColMeta> cols = {{"t", "a", TYPE_INT, sizeof(int), 0, false}};
+    auto nested_tree = [&](int depth) {
+        Value one;
+        one.set_int(1);
+        auto expr = ExprNode::make_col({"t", "a"});
+        for (int k = 0; k < depth; k++) expr = ExprNode::make_binary(EXPR_ADD, ExprNode::make_const(one), expr);
+        return expr;
+    };
+    int in = 5, out = 0;
+    ExprProgram deepest(nested_tree(ExprProgram::MAX_REGS - 1).get(), cols, cols[0]);
+    deepest.eval(reinterpret_cast<const char *>(&in), reinterpret_cast<char *>(&out));
+    EXPECT_EQ(out, 5 + ExprProgram::MAX_REGS - 1);
+    EXPECT_THROW(ExprProgram(nested_tree(ExprProgram::MAX_REGS).get(), cols, cols[0]), InternalError);
+
+    // 字符串字段之间赋值：内容超过目标字段长度时报错，不足的部分补0
+    exec_all({"update t set s = l where id = 1;", "update t set l = s where id = 2;"});
+    EXPECT_EQ(row(1)[4], "abc");
+    EXPECT_EQ(row(2)[5], "xy");
+    exec_all({"update t set l = 'abcdefg' where id = 2;"});
+    expect_error("update t set s = l where id = 2;", "String is too long");
+    EXPECT_EQ(row(2)[4], "xy");
+    expect_error("update t set a = s + 1;", "Incompatible type");
+}
+
+
+// 扫描只输出需要的列、宽列延迟物化时，排序键要按投影输出的布局解析
+TEST_F(SqlTest, JoinOrderByWithLateMaterialization) {
+    exec_all({"create table a (id int, x int, name char(20));",
+              "create table b (id int, aid int, v int, note char(20));"});
+    for (int i = 1; i <= 10; i++) {
+        exec_all({"insert into a values (" + std::to_string(i) + ", " + std::to_string(i * 3) + ", 'a" +
+                  std::to_string(i) + "');"});
+    }
+    // b.id与插入顺序、a.id都不一致
+    std::vector<int> b_ids;
+    for (int i = 1; i <= 40; i++) {
+        int id = (i * 37) % 101;
+        int aid = i % 10 + 1;
+        int v = (i * 13) % 100;
+        exec_all({"insert into b values (" + std::to_string(id) + ", " + std::to_string(aid) + ", " +
+                  std::to_string(v) + ", 'n" + std::to_string(i) + "');"});
+        if (v > 45) b_ids.push_back(id);
+    }
+    std::sort(b_ids.begin(), b_ids.end());
+
+    auto rows = query("select * from a, b where a.id = b.aid and b.v > 45 order by b.id;");
+    ASSERT_EQ(rows.size(), b_ids.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        ASSERT_EQ(rows[i].size(), 7u);
+        EXPECT_EQ(rows[i][3], std::to_string(b_ids[i]));
+        // 延迟物化的宽列和连接键属于同一对元组
+        EXPECT_EQ(rows[i][0], rows[i][4]);
+        EXPECT_EQ(rows[i][2], "a" + rows[i][0]);
+    }
+
+    // 降序、OFFSET和Top-N
+    auto desc = column("select b.id, a.name from a, b where a.id = b.aid and b.v > 45 order by b.id desc limit 2, 3;", 0);
+    std::vector<std::string> expected;
+    for (size_t i = 2; i < 5; i++) {
+        expected.push_back(std::to_string(b_ids[b_ids.size() - 1 - i]));
+    }
+    EXPECT_EQ(desc, expected);
+
+    // 排序键不在select列表中时排序放在投影下面
+    auto names = column("select name from a order by x desc limit 3;", 0);
+    EXPECT_EQ(names, (std::vector<std::string>{"a10", "a9", "a8"}));
+}
+
+// LIMIT下推：取够元组后不再推进下层，连接上的LIMIT结果正确，只需要少量元组时不并行扫描
+TEST_F(SqlTest, LimitHints) {
+    const int ROWS = 12000;
+    exec_all({"create table big (id int, k int, pad char(200));", "create table small (id int, x int);"});
+    bulk_load("big", ROWS, [](int i, char *buf) {
+        int k = i % 100;
+        memcpy(buf, &i, sizeof(int));
+        memcpy(buf + sizeof(int), &k, sizeof(int));
+        snprintf(buf + 2 * sizeof(int), 200, "row%d", i);
+    });
+    for (int i = 0; i < 20; i++) {
+        insert_rows("small", {std::to_string(i * 50) + ", " + std::to_string(i)});
+    }
+
+    EXPECT_EQ(column("select id from big where k = 7 limit 3;", 0), (std::vector<std::string>{"7", "107", "207"}));
+    EXPECT_EQ(column("select id from big limit 2, 3;", 0), (std::vector<std::string>{"2", "3", "4"}));
+
+    // 输出最后一个元组后扫描停在这个元组上，没有继续寻找下一个满足条件的元组
+    Value three;
+    three.set_int(3);
+    three.init_raw(sizeof(int));
+    auto scan = std::make_unique<SeqScanExecutor>(sm_manager_.get(), "big",
+                                                  std::vector<Condition>{{{"big", "k"}, OP_EQ, true, {}, three}},
+                                                  nullptr);
+    auto scan_ptr = scan.get();
+    LimitExecutor limit(std::move(scan), 1);
+    int emitted = 0;
+    for (limit.beginTuple(); !limit.is_end(); limit.nextTuple()) emitted++;
+    EXPECT_EQ(emitted, 1);
+    ASSERT_FALSE(scan_ptr->is_end());
+    int id;
+    memcpy(&id, scan_ptr->Next()->data, sizeof(int));
+    EXPECT_EQ(id, 3);
+
+    // 哈希连接的probe侧逐个读取，嵌套循环连接的外层从小块开始
+    auto rows = query("select big.id, small.x from big, small where big.id = small.id limit 4;");
+    ASSERT_EQ(rows.size(), 4u);
+    for (auto &row : rows) EXPECT_EQ(std::stoi(row[0]), std::stoi(row[1]) * 50);
+    std::set<std::vector<std::string>> distinct(rows.begin(), rows.end());
+    EXPECT_EQ(distinct.size(), rows.size());
+    rows = query("select small.id, big.id from small, big where small.id > big.id limit 5;");
+    ASSERT_EQ(rows.size(), 5u);
+    for (auto &row : rows) EXPECT_GT(std::stoi(row[0]), std::stoi(row[1]));
+
+    // 上层只需要少量元组时扫描不并行；嵌套循环连接的内层要读完，仍然并行
+    EXPECT_NE(exec("explain select * from big;").find("Parallel Seq Scan on big"), std::string::npos);
+    EXPECT_EQ(exec("explain select * from big limit 5;").find("Parallel"), std::string::npos);
+    EXPECT_EQ(exec("explain select id from big where k = 3 limit 5;").find("Parallel"), std::string::npos);
+    std::string plan = exec("explain select small.id, big.id from small, big where small.id > big.id limit 5;");
+    EXPECT_NE(plan.find("Parallel Seq Scan on big"), std::string::npos) << plan;
+}
+
+/** B+树测试：在TEST_DB_NAME目录下创建单个字符串字段的索引，用有序集合作为对照，
+ * 每个阶段之后比较正向/反向扫描、点查询、范围查询和统计信息 */
+class BPlusTreeTest : public ::testing::Test {
+   public:
+    static constexpr int KEY_LEN = 200;
+    const std::string TEST_INDEX_TABLE = "bplus_tree";
+
+    using Entry = std::pair<std::string, std::pair<int, int>>;     // (key, (page_no, slot_no))
+
+    std::unique_ptr<DiskManager> disk_manager_;
+    std::unique_ptr<BufferPoolManager> bpm_;
+    std::unique_ptr<IxManager> ix_manager_;
+    std::unique_ptr<IxIndexHandle> ih_;
+    std::vector<ColMeta> cols_;
+    std::set<Entry> mock_;
+
+    void SetUp() override {
+        ::testing::Test::SetUp();
+        disk_manager_ = std::make_unique<DiskManager>();
+        bpm_ = std::make_unique<BufferPoolManager>(TEST_BUFFER_POOL_SIZE, disk_manager_.get());
+        ix_manager_ = std::make_unique<IxManager>(disk_manager_.get(), bpm_.get());
+        if (!disk_manager_->is_dir(TEST_DB_NAME)) {
+            disk_manager_->create_dir(TEST_DB_NAME);
+        }
+        if (chdir(TEST_DB_NAME.c_str()) < 0) {
+            throw UnixError();
+        }
+        cols_ = {ColMeta{.tab_name = TEST_INDEX_TABLE, .name = "k", .type = TYPE_STRING, .len = KEY_LEN, .offset = 0,
+                         .index = true}};
+        if (ix_manager_->exists(TEST_INDEX_TABLE, cols_)) {
+            ix_manager_->destroy_index(TEST_INDEX_TABLE, cols_);
+        }
+    }
+
+    void TearDown() override {
+        if (ih_ != nullptr) {
+            ix_manager_->close_index(ih_.get());
+            ih_.reset();
+            ix_manager_->destroy_index(TEST_INDEX_TABLE, cols_);
+        }
+        if (chdir("..") < 0) {
+            throw UnixError();
+        }
+    }
+
+    void create(bool unique) {
+        ix_manager_->create_index(TEST_INDEX_TABLE, cols_, unique);
+        ih_ = ix_manager_->open_index(TEST_INDEX_TABLE, cols_);
+    }
+
+    // 前prefix_len个字节是所有同族key共享的前缀，后面是定长的序号，分隔键的长度随族和位置变化
+    static std::string make_key(int family, int n) {
+        int prefix_len = 20 + family * 50;
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "%06d", n);
+        return std::string(prefix_len, static_cast<char>('a' + family)) + suffix;
+    }
+
+    static void fill_key(const std::string &key, char *buf) {
+        memset(buf, 0, KEY_LEN);
+        memcpy(buf, key.data(), key.size());
+    }
+
+    void insert(const std::string &key, const Rid &rid) {
+        char buf[KEY_LEN];
+        fill_key(key, buf);
+        ih_->insert_entry(buf, rid, nullptr);
+        mock_.insert({key, {rid.page_no, rid.slot_no}});
+    }
+
+    bool remove(const std::string &key, const Rid &rid) {
+        char buf[KEY_LEN];
+        fill_key(key, buf);
+        mock_.erase({key, {rid.page_no, rid.slot_no}});
+        return ih_->delete_entry(buf, rid, nullptr);
+    }
+
+    static std::string key_of(const char *buf) { return std::string(buf, strnlen(buf, KEY_LEN)); }
+
+    // 按key升序（相同key按Rid升序）读取[lower, upper)中的所有键值对
+    std::vector<Entry> scan(const Iid &lower, const Iid &upper, bool reverse = false) {
+        std::vector<Entry> entries;
+        char buf[IX_MAX_KEY_LEN];
+        for (IxScan scan(ih_.get(), lower, upper, bpm_.get(), reverse); !scan.is_end(); scan.next()) {
+            Rid rid = scan.entry(buf);
+            EXPECT_EQ(scan.rid(), rid);
+            entries.push_back({key_of(buf), {rid.page_no, rid.slot_no}});
+        }
+        return entries;
+    }
+
+    void check_get_values(bool unique);
+
+    void check_tree() {
+        std::vector<Entry> expected(mock_.begin(), mock_.end());
+        ASSERT_EQ(scan(ih_->leaf_begin(), ih_->leaf_end()), expected);
+        std::vector<Entry> reversed(mock_.rbegin(), mock_.rend());
+        ASSERT_EQ(scan(ih_->leaf_begin(), ih_->leaf_end(), true), reversed);
+
+        // 每个key的点查询和[key, key]范围查询都从根结点下降，检查内部结点的分隔键
+        char buf[KEY_LEN];
+        for (auto it = mock_.begin(); it != mock_.end();) {
+            auto end = mock_.upper_bound({it->first, {INT32_MAX, INT32_MAX}});
+            std::vector<Entry> same(it, end);
+            std::vector<Rid> rids;
+            fill_key(it->first, buf);
+            ASSERT_TRUE(ih_->get_value(buf, &rids, nullptr)) << it->first;
+            ASSERT_EQ(rids.size(), same.size());
+            for (size_t i = 0; i < rids.size(); i++) {
+                EXPECT_EQ(rids[i], (Rid{same[i].second.first, same[i].second.second}));
+            }
+            EXPECT_EQ(scan(ih_->lower_bound(buf), ih_->upper_bound(buf)), same);
+            it = end;
+        }
+
+        auto stats = ih_->collect_stats();
+        EXPECT_EQ(stats.num_keys, static_cast<int>(mock_.size()));
+        EXPECT_EQ(ih_->get_num_keys(), static_cast<int>(mock_.size()));
+        EXPECT_EQ(stats.height, ih_->get_height());
+    }
+};
+
+// 共享长前缀的key经过前缀压缩，分裂、合并和重分配按字节容量进行
+TEST_F(BPlusTreeTest, PrefixCompressedInsertDelete) {
+    create(true);
+    std::mt19937 rng(20231019);
+    std::vector<std::string> keys;
+    for (int family = 0; family < 4; family++) {
+        for (int n = 0; n < 600; n++) {
+            keys.push_back(make_key(family, n * 7 % 600));
+        }
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (size_t i = 0; i < keys.size(); i++) {
+        insert(keys[i], Rid{static_cast<int>(i / 100 + 1), static_cast<int>(i % 100)});
+    }
+    check_tree();
+    // 2400个平均长度约100字节的key放不进一个结点，前缀压缩后仍然需要分裂出多层
+    auto full_stats = ih_->collect_stats();
+    EXPECT_GE(full_stats.height, 2);
+    EXPECT_GT(full_stats.leaf_pages, 1);
+
+    // 唯一索引拒绝重复的key，树保持不变
+    char buf[KEY_LEN];
+    fill_key(keys[0], buf);
+    EXPECT_THROW(ih_->insert_entry(buf, Rid{999, 0}, nullptr), RMDBError);
+    check_tree();
+
+    // 交错删除一半：结点变空之前会与兄弟结点合并或从兄弟结点借入键值对
+    std::shuffle(keys.begin(), keys.end(), rng);
+    std::map<std::string, Rid> rid_of;
+    for (auto &entry : mock_) rid_of[entry.first] = Rid{entry.second.first, entry.second.second};
+    for (size_t i = 0; i < keys.size() / 2; i++) {
+        EXPECT_TRUE(remove(keys[i], rid_of[keys[i]]));
+    }
+    check_tree();
+    // 删除不存在的key返回false
+    EXPECT_FALSE(remove(keys[0], rid_of[keys[0]]));
+
+    // 删除到只剩少量key，树高随合并降低
+    for (size_t i = keys.size() / 2; i + 5 < keys.size(); i++) {
+        EXPECT_TRUE(remove(keys[i], rid_of[keys[i]]));
+    }
+    check_tree();
+    auto small_stats = ih_->collect_stats();
+    EXPECT_EQ(small_stats.height, 1);
+    EXPECT_EQ(small_stats.leaf_pages, 1);
+
+    // 删空之后可以重新插入
+    for (size_t i = keys.size() - 5; i < keys.size(); i++) {
+        EXPECT_TRUE(remove(keys[i], rid_of[keys[i]]));
+    }
+    check_tree();
+    for (int n = 0; n < 300; n++) {
+        insert(make_key(n % 4, n), Rid{1, n});
+    }
+    check_tree();
+}
+
+// 只在末尾几个字节不同的最长key：前缀压缩几乎去掉整个key，分隔键截断后仍要能区分左右子树
+TEST_F(BPlusTreeTest, LongSharedPrefixSequential) {
+    create(true);
+    std::string prefix(KEY_LEN - 6, 'x');
+    for (int n = 0; n < 3000; n++) {
+        char suffix[8];
+        snprintf(suffix, sizeof(suffix), "%06d", n);
+        insert(prefix + suffix, Rid{n / 100 + 1, n % 100});
+    }
+    check_tree();
+    // 从头部连续删除，左侧结点不断与右兄弟合并
+    for (int n = 0; n < 2500; n++) {
+        char suffix[8];
+        snprintf(suffix, sizeof(suffix), "%06d", n);
+        EXPECT_TRUE(remove(prefix + suffix, Rid{n / 100 + 1, n % 100}));
+        if (n % 500 == 0) check_tree();
+    }
+    check_tree();
+}
+
+// 多字段key：整数和浮点数按数值比较，它们的字节可能只有一部分落在结点的公共前缀中
+TEST_F(BPlusTreeTest, MixedColumnKeys) {
+    cols_ = {ColMeta{.tab_name = TEST_INDEX_TABLE, .name = "a", .type = TYPE_INT, .len = 4, .offset = 0, .index = true},
+             ColMeta{.tab_name = TEST_INDEX_TABLE, .name = "b", .type = TYPE_FLOAT, .len = 4, .offset = 4, .index = true},
+             ColMeta{.tab_name = TEST_INDEX_TABLE, .name = "c", .type = TYPE_STRING, .len = 16, .offset = 8,
+                     .index = true}};
+    if (ix_manager_->exists(TEST_INDEX_TABLE, cols_)) {
+        ix_manager_->destroy_index(TEST_INDEX_TABLE, cols_);
+    }
+    create(false);
+    using Key = std::tuple<int, float, std::string>;
+    auto fill = [](const Key &key, char *buf) {
+        memset(buf, 0, 24);
+        memcpy(buf, &std::get<0>(key), sizeof(int));
+        memcpy(buf + 4, &std::get<1>(key), sizeof(float));
+        memcpy(buf + 8, std::get<2>(key).data(), std::get<2>(key).size());
+    };
+    // 低位字节相同的整数（如256的倍数）和负数让公共前缀在整数字段中间结束
+    std::mt19937 rng(20231021);
+    std::set<std::pair<Key, std::pair<int, int>>> expected;     // (key, (page_no, slot_no))
+    for (int i = 0; i < 3000; i++) {
+        int a = static_cast<int>(rng() % 9) * 256 - 1024 + (i % 3 == 0 ? static_cast<int>(rng() % 2) : 0);
+        float b = static_cast<float>(static_cast<int>(rng() % 7) - 3) / 2;
+        std::string c = "k" + std::string(rng() % 4, 'x') + std::to_string(rng() % 5);
+        Key key{a, b, c};
+        Rid rid{i / 100 + 1, i % 100};
+        char buf[24];
+        fill(key, buf);
+        ih_->insert_entry(buf, rid, nullptr);
+        expected.insert({key, {rid.page_no, rid.slot_no}});
+    }
+    using Entry = std::pair<Key, std::pair<int, int>>;
+    std::vector<Entry> scanned;
+    char buf[IX_MAX_KEY_LEN];
+    for (IxScan scan(ih_.get(), ih_->leaf_begin(), ih_->leaf_end(), bpm_.get()); !scan.is_end(); scan.next()) {
+        Rid rid = scan.entry(buf);
+        Key key{0, 0, std::string(buf + 8, strnlen(buf + 8, 16))};
+        memcpy(&std::get<0>(key), buf, sizeof(int));
+        memcpy(&std::get<1>(key), buf + 4, sizeof(float));
+        scanned.push_back({key, {rid.page_no, rid.slot_no}});
+    }
+    ASSERT_EQ(scanned, std::vector<Entry>(expected.begin(), expected.end()));
+
+    // 每个不同的key从根结点查找，得到它的全部Rid
+    for (auto it = expected.begin(); it != expected.end();) {
+        auto end = it;
+        size_t count = 0;
+        for (; end != expected.end() && end->first == it->first; ++end) count++;
+        char key[24];
+        fill(it->first, key);
+        std::vector<Rid> rids;
+        ASSERT_TRUE(ih_->get_value(key, &rids, nullptr));
+        EXPECT_EQ(rids.size(), count);
+        EXPECT_EQ(rids.front(), (Rid{it->second.first, it->second.second}));
+        it = end;
+    }
+    char missing[24];
+    fill(Key{100, 0.0f, "k0"}, missing);
+    std::vector<Rid> rids;
+    EXPECT_FALSE(ih_->get_value(missing, &rids, nullptr));
+}
+
+// 加入格式版本之前的索引文件头没有magic和版本号，打开数据库时删除后按表中的记录重建
+TEST_F(SqlTest, RebuildIndexWithOldFileFormat) {
+    exec_all({"create table r (id int, name char(16));", "create index r(id);", "create index r(name);"});
+    for (int i = 0; i < 200; i++) {
+        exec_all({"insert into r values (" + std::to_string(i) + ", 'n" + std::to_string(i) + "');"});
+    }
+    reopen_db([&] {
+        // 去掉文件头开头的magic和版本号，得到加入版本号之前的文件头
+        for (auto &index_file : {ix_manager_->get_index_name("r", std::vector<std::string>{"id"}),
+                                 ix_manager_->get_index_name("r", std::vector<std::string>{"name"})}) {
+            int fd = disk_manager_->open_file(index_file);
+            char page[PAGE_SIZE];
+            disk_manager_->read_page(fd, IX_FILE_HDR_PAGE, page, PAGE_SIZE);
+            memmove(page, page + 2 * sizeof(int), PAGE_SIZE - 2 * sizeof(int));
+            disk_manager_->write_page(fd, IX_FILE_HDR_PAGE, page, PAGE_SIZE);
+            disk_manager_->close_file(fd);
+        }
+    });
+    EXPECT_EQ(sm_manager_->db_.get_table("r").indexes.size(), 2u);
+    EXPECT_EQ(column("select name from r where id = 123;", 0), (std::vector<std::string>{"n123"}));
+    EXPECT_EQ(column("select id from r where name = 'n77';", 0), (std::vector<std::string>{"77"}));
+    EXPECT_NE(exec("insert into r values (5, 'dup');").find("Error"), std::string::npos);
+    EXPECT_EQ(column("select id from r where id >= 197;", 0), (std::vector<std::string>{"197", "198", "199"}));
+
+    // 没有改动的文件重新打开后照常重建
+    reopen_db([] {});
+    EXPECT_EQ(column("select name from r where id = 199;", 0), (std::vector<std::string>{"n199"}));
+}
+
+// 非唯一索引：相同的key按Rid排列，可以跨越多个叶子结点
+TEST_F(BPlusTreeTest, NonUniqueDuplicates) {
+    create(false);
+    std::mt19937 rng(20231020);
+    // 每个key重复200次，一个key的所有键值对放不进一个叶子结点
+    std::vector<std::pair<std::string, Rid>> entries;
+    for (int n = 0; n < 6; n++) {
+        for (int dup = 0; dup < 200; dup++) {
+            entries.push_back({make_key(n % 3, n), Rid{dup / 50 + 1, dup % 50 + n * 50}});
+        }
+    }
+    std::shuffle(entries.begin(), entries.end(), rng);
+    for (auto &entry : entries) {
+        insert(entry.first, entry.second);
+    }
+    check_tree();
+    EXPECT_GT(ih_->collect_stats().leaf_pages, 2);
+
+    // 相同的key和Rid不能重复插入
+    char buf[KEY_LEN];
+    fill_key(entries[0].first, buf);
+    EXPECT_THROW(ih_->insert_entry(buf, entries[0].second, nullptr), RMDBError);
+
+    // 删除一个重复项只删除Rid对应的那一项
+    std::string key = make_key(1, 4);
+    Rid victim{3, 20 + 4 * 50};
+    EXPECT_TRUE(remove(key, victim));
+    EXPECT_FALSE(remove(key, victim));
+    std::vector<Rid> rids;
+    fill_key(key, buf);
+    ASSERT_TRUE(ih_->get_value(buf, &rids, nullptr));
+    EXPECT_EQ(rids.size(), 199u);
+    EXPECT_EQ(std::find(rids.begin(), rids.end(), victim), rids.end());
+    check_tree();
+
+    // 范围查询覆盖跨越叶子结点的重复key：[make_key(0, 0), make_key(0, 3)]
+    char lower[KEY_LEN], upper[KEY_LEN];
+    fill_key(make_key(0, 0), lower);
+    fill_key(make_key(0, 3), upper);
+    auto range = scan(ih_->lower_bound(lower), ih_->upper_bound(upper));
+    std::vector<Entry> expected(mock_.lower_bound({make_key(0, 0), {INT32_MIN, INT32_MIN}}),
+                                mock_.upper_bound({make_key(0, 3), {INT32_MAX, INT32_MAX}}));
+    EXPECT_EQ(range.size(), 400u);
+    EXPECT_EQ(range, expected);
+    EXPECT_EQ(scan(ih_->lower_bound(lower), ih_->upper_bound(upper), true),
+              std::vector<Entry>(expected.rbegin(), expected.rend()));
+
+    // 删除一个key的全部重复项，相邻key不受影响
+    for (int dup = 0; dup < 200; dup++) {
+        Rid rid{dup / 50 + 1, dup % 50 + 2 * 50};
+        EXPECT_TRUE(remove(make_key(2, 2), rid));
+    }
+    fill_key(make_key(2, 2), buf);
+    rids.clear();
+    EXPECT_FALSE(ih_->get_value(buf, &rids, nullptr));
+    check_tree();
+}
+
+// 非唯一二级索引上的等值、范围查询返回所有重复项，删除和修改只影响对应的记录
+TEST_F(SqlTest, NonUniqueIndexQueries) {
+    exec_all({"create table d (id int, grp int);", "create nonunique index d(grp);"});
+    for (int i = 0; i < 300; i++) {
+        exec_all({"insert into d values (" + std::to_string(i) + ", " + std::to_string(i % 5) + ");"});
+    }
+    EXPECT_EQ(query("select id from d where grp = 3;").size(), 60u);
+    EXPECT_EQ(query("select id from d where grp >= 1 and grp <= 2;").size(), 120u);
+    exec_all({"delete from d where id = 8;", "update d set grp = 9 where id = 13;"});
+    auto ids = column("select id from d where grp = 3;", 0);
+    EXPECT_EQ(ids.size(), 58u);
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), "8"), 0);
+    EXPECT_EQ(std::count(ids.begin(), ids.end(), "13"), 0);
+    EXPECT_EQ(column("select id from d where grp = 9;", 0), (std::vector<std::string>{"13"}));
+}
+
+// 批量探测：结果与输入的key一一对应，重复和不存在的key也占一个位置，返回时不留下固定的页面
+void BPlusTreeTest::check_get_values(bool unique) {
+    create(unique);
+    for (int n = 0; n < 1500; n += 2) {
+        int dups = unique ? 1 : 1 + n % 3;
+        for (int dup = 0; dup < dups; dup++) {
+            insert(make_key(n % 4, n), Rid{n / 100 + 1, (n % 100) * 3 + dup});
+        }
+    }
+    std::vector<std::string> probe;
+    for (int n = 0; n < 1500; n += 5) {
+        probe.push_back(make_key(n % 4, n));     // 偶数存在，奇数不存在
+    }
+    probe.push_back(make_key(2, 10));
+    probe.push_back(make_key(2, 10));
+    probe.push_back(make_key(3, 999999));       // 大于所有key
+    std::sort(probe.begin(), probe.end());
+
+    std::vector<std::vector<char>> bufs;
+    for (auto &key : probe) {
+        bufs.emplace_back(KEY_LEN);
+        fill_key(key, bufs.back().data());
+    }
+    std::vector<const char *> keys;
+    for (auto &buf : bufs) keys.push_back(buf.data());
+
+    // 唯一索引第一轮填充点查询缓存，第二轮命中缓存；预算为0时每次都探测B+树
+    for (size_t cache : {size_t{0}, size_t{1} << 20}) {
+        ih_->set_cache_budget(cache);
+        for (int round = 0; round < 2; round++) {
+            SCOPED_TRACE("cache " + std::to_string(cache) + " round " + std::to_string(round));
+            std::vector<std::vector<Rid>> results;
+            int found = ih_->get_values(keys, &results, nullptr);
+            ASSERT_EQ(results.size(), keys.size());
+            int expected_found = 0;
+            for (size_t i = 0; i < probe.size(); i++) {
+                std::vector<Rid> expected;
+                auto it = mock_.lower_bound({probe[i], {INT32_MIN, INT32_MIN}});
+                for (; it != mock_.end() && it->first == probe[i]; ++it) {
+                    expected.push_back(Rid{it->second.first, it->second.second});
+                }
+                if (!expected.empty()) expected_found++;
+                EXPECT_EQ(results[i], expected) << probe[i];
+            }
+            EXPECT_EQ(found, expected_found);
+            for (size_t frame = 0; frame < bpm_->pool_size_; frame++) {
+                EXPECT_EQ(bpm_->pages_[frame].pin_count_, 0) << "frame " << frame;
+            }
+        }
+    }
+}
+
+TEST_F(BPlusTreeTest, BatchedGetValuesUnique) { check_get_values(true); }
+
+TEST_F(BPlusTreeTest, BatchedGetValuesNonUnique) { check_get_values(false); }